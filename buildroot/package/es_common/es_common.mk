@@ -12,7 +12,7 @@ ES_COMMON_SITE = git@github.com:zczjx/es_common.git
 ES_COMMON_ALWAYS_BUILD = YES
 ES_COMMON_INSTALL_STAGING = YES
 ES_COMMON_CFLAGS = "-Wall -I $(STAGING_DIR)/usr/include -g -rdynamic  -fPIC  -L$(STAGING_DIR)/usr/lib"
-ES_COMMON_LDFLAGS = "-lm "
+ES_COMMON_LDFLAGS = "-lm -lpthread"
 ES_COMMON_OUT_SLIB = libes_common.a
 ES_COMMON_OUT_DLIB = libes_common.so
 ES_COMMON_MAKE_FLAGS += \
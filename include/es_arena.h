@@ -0,0 +1,150 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_arena.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_ARENA_H_
+#define _ES_ARENA_H_
+#include <es_common.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Arena (bump) allocator for scratch memory.
+ *
+ * Memory is handed out by moving a pointer forward through a chain of
+ * blocks; a new block is chained when the current one is full. There is
+ * no per-object free: es_arena_rewind() drops everything allocated after
+ * an es_arena_mark(), es_arena_reset() everything at all.
+ *
+ * Blocks dropped by a rewind or reset are kept as spares and reused by
+ * the next growth, so an arena reset once per request settles at its
+ * working set size and stops calling malloc(). es_arena_trim() gives the
+ * spares back to the system.
+ *
+ * Allocations larger than a quarter of the block size get a block of
+ * their own.
+ *
+ * An arena is not thread safe, use one per thread or lock around it.
+ */
+
+/* block size of es_arena_init() with 0 */
+#define ES_ARENA_BLOCK_SIZE	(64 * 1024)
+
+/* alignment of es_arena_alloc(), as malloc() */
+#define ES_ARENA_ALIGN		(2 * sizeof(void *))
+
+struct es_arena_block;
+
+struct es_arena {
+	char *ptr;			/* next free byte in block */
+	char *end;			/* end of block */
+	struct es_arena_block *block;	/* current block, newest first */
+	struct es_arena_block *spare;	/* dropped blocks to be reused */
+	size_t block_size;
+	size_t peak;			/* most bytes held in blocks */
+	size_t cur;			/* bytes held in blocks */
+};
+
+/* a point to rewind the arena to */
+struct es_arena_mark {
+	struct es_arena_block *block;
+	char *ptr;
+};
+
+struct es_arena_stats {
+	size_t used;			/* bytes handed out, with padding */
+	size_t held;			/* bytes of the blocks in use */
+	size_t spare;			/* bytes of the spare blocks */
+	size_t peak;			/* most bytes ever held */
+	unsigned int blocks;		/* blocks in use */
+	unsigned int spares;		/* spare blocks */
+};
+
+#define ES_ARENA_INIT(bs) { NULL, NULL, NULL, NULL, (bs), 0, 0 }
+
+extern int es_arena_init(struct es_arena *arena, size_t block_size);
+extern void es_arena_destroy(struct es_arena *arena);
+extern void *__es_arena_alloc_slow(struct es_arena *arena, size_t size,
+				size_t align);
+extern void *es_arena_calloc(struct es_arena *arena, size_t n, size_t size);
+extern void *es_arena_realloc(struct es_arena *arena, void *old,
+				size_t old_size, size_t size);
+extern void *es_arena_memdup(struct es_arena *arena, const void *src,
+				size_t size);
+extern char *es_arena_strdup(struct es_arena *arena, const char *s);
+extern void es_arena_rewind(struct es_arena *arena,
+				const struct es_arena_mark *mark);
+extern void es_arena_reset(struct es_arena *arena);
+extern void es_arena_trim(struct es_arena *arena);
+extern void es_arena_get_stats(struct es_arena *arena,
+				struct es_arena_stats *st);
+extern void es_arena_dump(struct es_arena *arena, FILE *fp);
+
+/**
+ * es_arena_alloc_aligned - allocate from an arena
+ * @arena: the arena to be used.
+ * @size: the size in bytes
+ * @align: the alignment, a power of 2
+ *
+ * The memory lives until the arena is rewound past it, reset or
+ * destroyed. Returns NULL if out of memory.
+ */
+static inline void *es_arena_alloc_aligned(struct es_arena *arena,
+				size_t size, size_t align)
+{
+	uintptr_t p = ((uintptr_t)arena->ptr + align - 1) & ~(uintptr_t)(align - 1);
+	uintptr_t end = (uintptr_t)arena->end;
+
+	if (p <= end && size <= end - p && size) {
+		arena->ptr = (char *)(p + size);
+		return (void *)p;
+	}
+	return __es_arena_alloc_slow(arena, size, align);
+}
+
+/**
+ * es_arena_alloc - allocate from an arena, aligned as malloc()
+ * @arena: the arena to be used.
+ * @size: the size in bytes
+ *
+ * Returns NULL if out of memory.
+ */
+static inline void *es_arena_alloc(struct es_arena *arena, size_t size)
+{
+	return es_arena_alloc_aligned(arena, size, ES_ARENA_ALIGN);
+}
+
+/**
+ * es_arena_mark - remember the current end of an arena
+ * @arena: the arena to be used.
+ * @mark: where to store it
+ *
+ * es_arena_rewind() to @mark frees everything allocated after this
+ * call. Marks nest: rewinding to a mark invalidates the later ones.
+ */
+static inline void es_arena_mark(struct es_arena *arena,
+				struct es_arena_mark *mark)
+{
+	mark->block = arena->block;
+	mark->ptr = arena->ptr;
+}
+
+#endif /* ifndef _ES_ARENA_H_.2026-10-16 20:47:18 zcz */
+
@@ -0,0 +1,93 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_atomic.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_ATOMIC_H_
+#define _ES_ATOMIC_H_
+#include <es_common.h>
+
+/*
+ * Memory ordering primitives in the spirit of the kernel's
+ * READ_ONCE()/WRITE_ONCE(), smp_*mb() and smp_load_acquire()/
+ * smp_store_release(). They are built on the compiler __atomic
+ * builtins, which implement the C11 memory model and also work on
+ * plain (non _Atomic) objects, so the existing structures keep their
+ * layout and can still be declared by the static initializers.
+ */
+
+#ifndef ES_CACHELINE_SIZE
+#define ES_CACHELINE_SIZE	64
+#endif
+
+#define __es_cacheline_aligned	__attribute__((__aligned__(ES_CACHELINE_SIZE)))
+
+#define ES_READ_ONCE(x)		__atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define ES_WRITE_ONCE(x, val)	__atomic_store_n(&(x), (val), __ATOMIC_RELAXED)
+
+#define es_smp_load_acquire(p)		__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define es_smp_store_release(p, val)	__atomic_store_n((p), (val), __ATOMIC_RELEASE)
+
+/*
+ * es_cmpxchg - compare and swap
+ * @p: pointer to the value
+ * @oldp: pointer to the expected value, updated with the current value
+ *	on failure
+ * @val: the new value
+ *
+ * Weak and relaxed: may fail spuriously and gives no ordering on its
+ * own, so it is meant for retry loops where ordering comes from an
+ * acquire/release elsewhere. Returns true on success.
+ */
+#define es_cmpxchg(p, oldp, val) \
+	__atomic_compare_exchange_n((p), (oldp), (val), 1, \
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED)
+
+/*
+ * es_cmpxchg_acq_rel - compare and swap with full acquire/release
+ * ordering on success and acquire ordering on failure
+ */
+#define es_cmpxchg_acq_rel(p, oldp, val) \
+	__atomic_compare_exchange_n((p), (oldp), (val), 0, \
+			__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#define es_xchg(p, val)			__atomic_exchange_n((p), (val), __ATOMIC_ACQ_REL)
+#define es_atomic_fetch_add(p, val)	__atomic_fetch_add((p), (val), __ATOMIC_RELAXED)
+#define es_atomic_fetch_sub(p, val)	__atomic_fetch_sub((p), (val), __ATOMIC_RELAXED)
+
+#define es_smp_mb()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define es_smp_rmb()	__atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define es_smp_wmb()	__atomic_thread_fence(__ATOMIC_RELEASE)
+#define es_barrier()	__asm__ __volatile__("" : : : "memory")
+
+/*
+ * es_cpu_relax - hint to the cpu that we are spinning on a shared value
+ */
+static inline void es_cpu_relax(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__("pause" : : : "memory");
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH_7A__))
+	__asm__ __volatile__("yield" : : : "memory");
+#else
+	es_barrier();
+#endif
+}
+
+#endif /* ifndef _ES_ATOMIC_H_.2026-10-16 10:02:11 zcz */
+
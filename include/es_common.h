@@ -68,9 +68,44 @@ typedef unsigned char bool;
 	_max1 > _max2 ? _max1 : _max2; })
 
 
+/*
+ * es_is_power_of_2() - check if a value is a power of two
+ * @n: the value to check
+ *
+ * Determine whether some value is a power of two, where zero is
+ * *not* considered a power of two.
+ */
+static inline bool es_is_power_of_2(unsigned long n)
+{
+	return (n != 0 && ((n & (n - 1)) == 0));
+}
+
+/*
+ * es_roundup_pow_of_two() - round up to nearest power of two
+ * @n: value to round up, must not be 0 and must not exceed the
+ * largest power of two an unsigned long can hold
+ */
+static inline unsigned long es_roundup_pow_of_two(unsigned long n)
+{
+	if (n <= 1)
+		return 1;
+	return 1UL << (sizeof(unsigned long) * 8 - __builtin_clzl(n - 1));
+}
+
+/*
+ * es_rounddown_pow_of_two() - round down to nearest power of two
+ * @n: value to round down, must not be 0
+ */
+static inline unsigned long es_rounddown_pow_of_two(unsigned long n)
+{
+	return 1UL << (sizeof(unsigned long) * 8 - 1 - __builtin_clzl(n));
+}
+
+
 #define ES_SUCCESS (0)
 #define ES_FAIL (-1)
 #define ES_INVALID_PARAM (-2)
+#define ES_TIMEOUT (-3)
 
 typedef int  es_error_t;
 
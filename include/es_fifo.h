@@ -21,25 +21,90 @@
 #ifndef _ES_FIFO_H_
 #define _ES_FIFO_H_
 #include <es_common.h>
+#include <es_atomic.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 
+#ifdef ES_FIFO_STATS
+#include <es_list.h>
+
+/* transfer size histogram buckets, bucket i counts sizes 2^i..2^(i+1)-1 */
+#define ES_FIFO_STATS_HIST	16
+
+/*
+ * Counters of one fifo, only with ES_FIFO_STATS defined for the library
+ * and its users alike. Every counter has a single writer, the producer
+ * or the consumer side, so updating it costs a plain add and no atomic
+ * read-modify-write.
+ */
+struct es_fifo_stats {
+	/* producer side */
+	unsigned long bytes_in;		/* bytes added */
+	unsigned long short_writes;	/* writes not stored completely */
+	unsigned long peak;		/* highest fill level seen */
+	unsigned long hist_in[ES_FIFO_STATS_HIST];	/* write sizes */
+
+	/* consumer side */
+	unsigned long bytes_out __es_cacheline_aligned;	/* bytes removed */
+	unsigned long empty_reads;	/* reads which found nothing */
+	unsigned long hist_out[ES_FIFO_STATS_HIST];	/* read sizes */
+};
+#endif
 
 struct es_fifo {
 	unsigned char *buffer;	/* the buffer holding the data */
 	unsigned int size;	/* the size of the allocated buffer */
 	unsigned int in;	/* data is added at offset (in % size) */
 	unsigned int out;	/* data is extracted from off. (out % size) */
+	unsigned int flags;	/* ES_FIFO_F_* flags */
+	unsigned long dropped;	/* bytes overwritten in ES_FIFO_F_OVERWRITE mode */
+#ifdef ES_FIFO_STATS
+	struct es_list_head stats_node;	/* es_fifo_stats registry, NULL if not */
+	const char *stats_name;	/* name in es_fifo_stats_dump() */
+	struct es_fifo_stats stats;
+#endif
 };
 
+/*
+ * es_fifo flags
+ */
+#define ES_FIFO_F_MIRROR	(1U << 0)	/* buffer is mapped twice back-to-back */
+#define ES_FIFO_F_MMAP		(1U << 1)	/* buffer comes from mmap() */
+#define ES_FIFO_F_OVERWRITE	(1U << 2)	/* es_fifo_in() drops the oldest bytes */
+#define ES_FIFO_F_STREAM	(1U << 3)	/* large copies bypass the cache */
+#define ES_FIFO_F_ARENA		(1U << 4)	/* buffer belongs to an es_arena */
+
+/*
+ * es_fifo_alloc_flags flags
+ */
+#define ES_FIFO_ALLOC_CACHEALIGN	(1U << 0)	/* cache line aligned buffer */
+#define ES_FIFO_ALLOC_HUGEPAGE		(1U << 1)	/* huge pages for large rings */
+#define ES_FIFO_ALLOC_MIRROR		(1U << 2)	/* see es_fifo_alloc_mirror() */
+
+#ifndef ES_FIFO_HUGEPAGE_SIZE
+#define ES_FIFO_HUGEPAGE_SIZE	(2UL * 1024 * 1024)
+#endif
+
+/* smallest copy ES_FIFO_F_STREAM sends through es_memcpy_stream() */
+#ifndef ES_FIFO_STREAM_MIN
+#define ES_FIFO_STREAM_MIN	4096
+#endif
+
 /*
  * Macros for declaration and initialization of the es_fifo datatype
  */
 
-/* helper macro */
+/* helper macros */
+#define __es_fifo_check_size(s) \
+	((s) + 0 * sizeof(char[((s) > 1 && ((s) & ((s) - 1)) == 0) ? 1 : -1]))
+
 #define __es_fifo_initializer(s, b) \
 	(struct es_fifo) { \
-		.size	= s, \
+		.size	= __es_fifo_check_size(s), \
 		.in	= 0, \
 		.out	= 0, \
+		.flags	= 0, \
+		.dropped = 0, \
 		.buffer = b \
 	}
 
@@ -82,7 +147,14 @@ union { \
 	unsigned char name##es_fifo_buffer[size]; \
 	struct es_fifo name = __es_fifo_initializer(size, name##es_fifo_buffer)
 
+extern int es_fifo_init(struct es_fifo *fifo, void *buffer, unsigned int size);
 extern  int es_fifo_alloc(struct es_fifo *fifo, unsigned int size);
+extern int es_fifo_alloc_flags(struct es_fifo *fifo, unsigned int size,
+				unsigned int flags);
+extern int es_fifo_alloc_mirror(struct es_fifo *fifo, unsigned int size);
+struct es_arena;
+extern int es_fifo_alloc_arena(struct es_fifo *fifo, unsigned int size,
+				struct es_arena *arena);
 extern void es_fifo_free(struct es_fifo *fifo);
 extern unsigned int es_fifo_in(struct es_fifo *fifo,
 				const void *from, unsigned int len);
@@ -90,6 +162,48 @@ extern  unsigned int es_fifo_out(struct es_fifo *fifo,
 				void *to, unsigned int len);
 extern  unsigned int es_fifo_out_peek(struct es_fifo *fifo,
 				void *to, unsigned int len, unsigned offset);
+extern unsigned int es_fifo_prepare_write(struct es_fifo *fifo,
+				struct iovec *vec, unsigned int len);
+extern void es_fifo_commit_write(struct es_fifo *fifo, unsigned int len);
+extern unsigned int es_fifo_peek_read(struct es_fifo *fifo,
+				struct iovec *vec, unsigned int len);
+extern void es_fifo_release_read(struct es_fifo *fifo, unsigned int len);
+extern ssize_t es_fifo_from_fd(struct es_fifo *fifo, int fd, unsigned int len);
+extern ssize_t es_fifo_to_fd(struct es_fifo *fifo, int fd, unsigned int len);
+extern ssize_t es_fifo_to_fd_splice(struct es_fifo *fifo, int pipefd[2],
+				int fd, unsigned int len);
+extern unsigned int es_fifo_in_rec(struct es_fifo *fifo,
+				const void *from, unsigned int n, unsigned int recsize);
+extern unsigned int es_fifo_out_rec(struct es_fifo *fifo,
+				void *to, unsigned int n, unsigned int recsize,
+				unsigned int *total);
+extern void es_fifo_skip_rec(struct es_fifo *fifo, unsigned int recsize);
+extern unsigned int es_fifo_in_recs(struct es_fifo *fifo,
+				const struct iovec *recs, unsigned int nrecs,
+				unsigned int recsize);
+extern unsigned int es_fifo_out_recs(struct es_fifo *fifo,
+				struct iovec *recs, unsigned int nrecs,
+				unsigned int recsize);
+
+/*
+ * es_fifo_drain_fn - callback of es_fifo_drain_elems()/es_fifo_drain_recs()
+ * @arg: the argument passed to the drain function
+ * @vec: the element or record, one or two spans
+ * @nvec: number of entries in @vec
+ *
+ * Return 0 to consume the item, nonzero to stop and leave it queued.
+ */
+typedef int (*es_fifo_drain_fn)(void *arg, const struct iovec *vec,
+				unsigned int nvec);
+
+extern unsigned int es_fifo_out_elems(struct es_fifo *fifo, void *to,
+				unsigned int esize, unsigned int n);
+extern unsigned int es_fifo_drain_elems(struct es_fifo *fifo,
+				unsigned int esize, unsigned int max,
+				es_fifo_drain_fn fn, void *arg);
+extern unsigned int es_fifo_drain_recs(struct es_fifo *fifo,
+				unsigned int recsize, unsigned int max,
+				es_fifo_drain_fn fn, void *arg);
 
 /**
  * es_fifo_initialized - Check if es_fifo is initialized.
@@ -102,6 +216,79 @@ static inline bool es_fifo_initialized(struct es_fifo *fifo)
 	return fifo->buffer != NULL;
 }
 
+/**
+ * es_fifo_is_mirrored - Check if the es_fifo buffer is mirror mapped
+ * @fifo: fifo to check
+ *
+ * Return %true if every region of the fifo is contiguous in memory,
+ * i.e. es_fifo_peek_read() and es_fifo_prepare_write() always return a
+ * single span.
+ */
+static inline bool es_fifo_is_mirrored(struct es_fifo *fifo)
+{
+	return !!(fifo->flags & ES_FIFO_F_MIRROR);
+}
+
+/**
+ * es_fifo_set_overwrite - switch the lossy overwrite-oldest mode
+ * @fifo: the fifo to be used.
+ * @enable: nonzero to overwrite, zero for the default truncating mode
+ *
+ * In overwrite mode es_fifo_in() never fails: when the fifo is full the
+ * oldest bytes are dropped to make room and counted in the dropped
+ * counter, and only the newest es_fifo_size() bytes of an oversized
+ * write are kept. es_fifo_out() then claims its bytes with a compare
+ * and swap, so it stays safe against a concurrent writer moving the
+ * out index.
+ *
+ * Every other read must take part in that compare and swap too, or it
+ * could return or skip bytes the writer has overwritten already:
+ *  - es_fifo_out_peek() copies, then retries if out moved meanwhile
+ *  - es_fifo_skip() advances out with a compare and swap
+ *  - es_fifo_peek_read() maps nothing and es_fifo_release_read() does
+ *    nothing, so es_fifo_to_fd() and es_fifo_to_fd_splice() fail with
+ *    EINVAL
+ *
+ * This is a byte stream mode: the record and batch functions must not
+ * be used on a fifo in overwrite mode. Switch it only while neither
+ * side is active.
+ */
+static inline void es_fifo_set_overwrite(struct es_fifo *fifo, int enable)
+{
+	if (enable)
+		fifo->flags |= ES_FIFO_F_OVERWRITE;
+	else
+		fifo->flags &= ~ES_FIFO_F_OVERWRITE;
+}
+
+/**
+ * es_fifo_set_stream - switch the copy strategy for large transfers
+ * @fifo: the fifo to be used.
+ * @enable: nonzero for streaming copies, zero for plain memcpy()
+ *
+ * With streaming enabled, copies of at least ES_FIFO_STREAM_MIN bytes
+ * into or out of the fifo go through es_memcpy_stream(), which avoids
+ * filling the cache of the copying cpu with data only the other side
+ * will read, much later. Worth it for big blocks crossing cores, a loss
+ * when the consumer reads the data while it is still hot.
+ */
+static inline void es_fifo_set_stream(struct es_fifo *fifo, int enable)
+{
+	if (enable)
+		fifo->flags |= ES_FIFO_F_STREAM;
+	else
+		fifo->flags &= ~ES_FIFO_F_STREAM;
+}
+
+/**
+ * es_fifo_dropped - returns the number of bytes lost to overwrites
+ * @fifo: the fifo to be used.
+ */
+static inline unsigned long es_fifo_dropped(struct es_fifo *fifo)
+{
+	return ES_READ_ONCE(fifo->dropped);
+}
+
 /**
  * es_fifo_reset - removes the entire FIFO contents
  * @fifo: the fifo to be emptied.
@@ -137,8 +324,8 @@ static inline unsigned int es_fifo_len(struct es_fifo *fifo)
 {
 	register unsigned int	out;
 
-	out = fifo->out;
-	return fifo->in - out;
+	out = ES_READ_ONCE(fifo->out);
+	return ES_READ_ONCE(fifo->in) - out;
 }
 
 /**
@@ -170,6 +357,81 @@ static inline  unsigned int es_fifo_avail(struct es_fifo *fifo)
 
 extern void es_fifo_skip(struct es_fifo *fifo, unsigned int len);
 
+/**
+ * es_fifo_avail_rec - returns the payload bytes a record could still hold
+ * @fifo: the fifo to be used.
+ * @recsize: size of the record length header: 0, 1 or 2 bytes
+ *
+ * Returns 0 for a @recsize greater than 2.
+ */
+static inline unsigned int es_fifo_avail_rec(struct es_fifo *fifo,
+				unsigned int recsize)
+{
+	unsigned int l = es_fifo_avail(fifo);
+
+	if (recsize == 0)
+		return l;
+	if (recsize > 2)
+		return 0;
+	l = l > recsize ? l - recsize : 0;
+	return min(l, (1U << (recsize << 3)) - 1);
+}
+
+
+#ifdef ES_FIFO_STATS
+static inline void __es_fifo_stat_add(unsigned long *ctr, unsigned long val)
+{
+	/* single writer, concurrent readers only need an untorn value */
+	ES_WRITE_ONCE(*ctr, *ctr + val);
+}
+
+static inline unsigned int __es_fifo_stat_bucket(unsigned int len)
+{
+	return min(31U - __builtin_clz(len), ES_FIFO_STATS_HIST - 1U);
+}
+
+/*
+ * __es_fifo_stat_in internal helper function for accounting @len bytes
+ * just published by the producer
+ */
+static inline void __es_fifo_stat_in(struct es_fifo *fifo, unsigned int len)
+{
+	unsigned int used;
+
+	if (!len)
+		return;
+
+	__es_fifo_stat_add(&fifo->stats.bytes_in, len);
+	__es_fifo_stat_add(&fifo->stats.hist_in[__es_fifo_stat_bucket(len)], 1);
+
+	used = fifo->in - ES_READ_ONCE(fifo->out);
+	if (used > fifo->stats.peak)
+		ES_WRITE_ONCE(fifo->stats.peak, used);
+}
+
+/*
+ * __es_fifo_stat_out internal helper function for accounting @len bytes
+ * just released by the consumer
+ */
+static inline void __es_fifo_stat_out(struct es_fifo *fifo, unsigned int len)
+{
+	if (!len)
+		return;
+
+	__es_fifo_stat_add(&fifo->stats.bytes_out, len);
+	__es_fifo_stat_add(&fifo->stats.hist_out[__es_fifo_stat_bucket(len)], 1);
+}
+
+#define __es_fifo_stat_short_write(fifo) \
+	__es_fifo_stat_add(&(fifo)->stats.short_writes, 1)
+#define __es_fifo_stat_empty_read(fifo) \
+	__es_fifo_stat_add(&(fifo)->stats.empty_reads, 1)
+#else
+#define __es_fifo_stat_in(fifo, len)		do { } while (0)
+#define __es_fifo_stat_out(fifo, len)		do { } while (0)
+#define __es_fifo_stat_short_write(fifo)	do { } while (0)
+#define __es_fifo_stat_empty_read(fifo)		do { } while (0)
+#endif
 
 /*
  * __es_fifo_add_out internal helper function for updating the out offset
@@ -177,8 +439,13 @@ extern void es_fifo_skip(struct es_fifo *fifo, unsigned int len);
 static inline void __es_fifo_add_out(struct es_fifo *fifo,
 				unsigned int off)
 {
-	
-	fifo->out += off;
+	/*
+	 * make sure all data has been read out of the buffer before the
+	 * writer is allowed to reuse the space
+	 */
+	es_smp_mb();
+	ES_WRITE_ONCE(fifo->out, fifo->out + off);
+	__es_fifo_stat_out(fifo, off);
 }
 
 /*
@@ -187,8 +454,10 @@ static inline void __es_fifo_add_out(struct es_fifo *fifo,
 static inline void __es_fifo_add_in(struct es_fifo *fifo,
 				unsigned int off)
 {
-	
-	fifo->in += off;
+	/* make sure the data is in the buffer before the reader sees it */
+	es_smp_wmb();
+	ES_WRITE_ONCE(fifo->in, fifo->in + off);
+	__es_fifo_stat_in(fifo, off);
 }
 
 /*
@@ -263,5 +532,20 @@ extern unsigned int __es_fifo_out_n(struct es_fifo *fifo,
 extern unsigned int __es_fifo_peek_generic(struct es_fifo *fifo,
 				unsigned int recsize);
 
+/**
+ * es_fifo_peek_rec - returns the size of the next FIFO record
+ * @fifo: the fifo to be used.
+ * @recsize: size of the record length header: 0, 1 or 2 bytes
+ *
+ * This function returns the size of the next FIFO record in number of
+ * bytes, 0 if the fifo is empty or @recsize is greater than 2. With
+ * @recsize 0 it is es_fifo_len().
+ */
+static inline unsigned int es_fifo_peek_rec(struct es_fifo *fifo,
+				unsigned int recsize)
+{
+	return __es_fifo_peek_generic(fifo, recsize);
+}
+
 #endif /* ifndef _ES_FIFO_H_.2016-10-18 23:09:43 zcz */
 
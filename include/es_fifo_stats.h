@@ -0,0 +1,73 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_stats.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_FIFO_STATS_H_
+#define _ES_FIFO_STATS_H_
+#include <es_fifo.h>
+#include <stdio.h>
+
+/*
+ * Optional es_fifo instrumentation.
+ *
+ * Build the library and its users with -DES_FIFO_STATS (see the top
+ * Makefile) and every struct es_fifo carries a struct es_fifo_stats:
+ * bytes in and out, writes which were cut short, reads which found
+ * nothing, the peak fill level and histograms of the transfer sizes.
+ *
+ * Fifos from es_fifo_alloc() and friends join a global registry on their
+ * own and leave it in es_fifo_free(); fifos set up with es_fifo_init()
+ * or DECLARE_ES_FIFO() join with es_fifo_stats_register(). Initializing
+ * a registered fifo again takes it out of the registry first, the alloc
+ * calls then add it back. The registry can then be walked or dumped from
+ * any thread.
+ *
+ * Without ES_FIFO_STATS the register calls and the dump are empty
+ * inlines, so callers need no #ifdef of their own.
+ */
+
+#ifdef ES_FIFO_STATS
+typedef int (*es_fifo_stats_fn)(struct es_fifo *fifo, const char *name,
+				const struct es_fifo_stats *st, void *arg);
+
+extern int es_fifo_stats_register(struct es_fifo *fifo, const char *name);
+extern void es_fifo_stats_unregister(struct es_fifo *fifo);
+extern void es_fifo_stats_forget(struct es_fifo *fifo);
+extern void es_fifo_stats_get(struct es_fifo *fifo, struct es_fifo_stats *st);
+extern void es_fifo_stats_reset(struct es_fifo *fifo);
+extern int es_fifo_stats_for_each(es_fifo_stats_fn fn, void *arg);
+extern void es_fifo_stats_dump(FILE *fp);
+#else
+static inline int es_fifo_stats_register(struct es_fifo *fifo,
+				const char *name)
+{
+	return ES_SUCCESS;
+}
+
+static inline void es_fifo_stats_unregister(struct es_fifo *fifo)
+{
+}
+
+static inline void es_fifo_stats_dump(FILE *fp)
+{
+}
+#endif
+
+#endif /* ifndef _ES_FIFO_STATS_H_.2026-10-16 17:02:18 zcz */
+
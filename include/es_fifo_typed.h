@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_typed.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_FIFO_TYPED_H_
+#define _ES_FIFO_TYPED_H_
+#include <es_common.h>
+#include <es_atomic.h>
+#include <string.h>
+
+/*
+ * Typed fixed-element FIFO generated by a macro template.
+ *
+ * Unlike struct es_fifo the storage is an array of @type indexed by
+ * element, and the element count is a compile time constant, so the
+ * index mask folds into the code and a push or pop is one struct
+ * assignment plus the index update. Same concurrency rule as es_fifo:
+ * one concurrent reader and one concurrent writer need no locking.
+ *
+ * DECLARE_ES_FIFO_TYPED(msg_fifo, struct msg, 64) declares
+ * struct msg_fifo and the functions:
+ *
+ *   msg_fifo_init(fifo)			empty the fifo
+ *   msg_fifo_len(fifo), msg_fifo_avail(fifo)	element counts
+ *   msg_fifo_is_empty(fifo), msg_fifo_is_full(fifo)
+ *   msg_fifo_push(fifo, &elem)			1 if stored, 0 if full
+ *   msg_fifo_pop(fifo, &elem)			1 if removed, 0 if empty
+ *   msg_fifo_peek(fifo)			pointer to the head or NULL
+ *   msg_fifo_in(fifo, elems, n)		batch push, returns count
+ *   msg_fifo_out(fifo, elems, n)		batch pop, returns count
+ *
+ * The functions are static inline, so the macro may be used in a
+ * header shared by several translation units.
+ */
+
+/* helper macros, copy @n elements between the ring and a linear array */
+#define __ES_FIFO_TYPED_COPY_IN(ring, size, pos, arr, n) \
+do { \
+	unsigned int __off = (pos) & ((size) - 1); \
+	unsigned int __l = min((n), (unsigned int)(size) - __off); \
+	memcpy((ring) + __off, (arr), __l * sizeof(*(ring))); \
+	memcpy((ring), (arr) + __l, ((n) - __l) * sizeof(*(ring))); \
+} while (0)
+
+#define __ES_FIFO_TYPED_COPY_OUT(ring, size, pos, arr, n) \
+do { \
+	unsigned int __off = (pos) & ((size) - 1); \
+	unsigned int __l = min((n), (unsigned int)(size) - __off); \
+	memcpy((arr), (ring) + __off, __l * sizeof(*(ring))); \
+	memcpy((arr) + __l, (ring), ((n) - __l) * sizeof(*(ring))); \
+} while (0)
+
+/**
+ * DECLARE_ES_FIFO_TYPED - declare a typed fifo and its functions
+ * @name: name of the struct and prefix of the functions
+ * @type: the element type
+ * @size: number of elements. Must be a power of two.
+ */
+#define DECLARE_ES_FIFO_TYPED(name, type, size) \
+\
+typedef char name##_size_must_be_power_of_2 \
+	[((size) > 0 && ((size) & ((size) - 1)) == 0) ? 1 : -1]; \
+\
+struct name { \
+	unsigned int in;	/* written by the producer */ \
+	unsigned int out;	/* written by the consumer */ \
+	type buf[size]; \
+}; \
+\
+static inline void name##_init(struct name *fifo) \
+{ \
+	fifo->in = fifo->out = 0; \
+} \
+\
+static inline unsigned int name##_len(struct name *fifo) \
+{ \
+	unsigned int out = es_smp_load_acquire(&fifo->out); \
+	return es_smp_load_acquire(&fifo->in) - out; \
+} \
+\
+static inline unsigned int name##_avail(struct name *fifo) \
+{ \
+	return (size) - name##_len(fifo); \
+} \
+\
+static inline int name##_is_empty(struct name *fifo) \
+{ \
+	return name##_len(fifo) == 0; \
+} \
+\
+static inline int name##_is_full(struct name *fifo) \
+{ \
+	return name##_len(fifo) == (size); \
+} \
+\
+static inline int name##_push(struct name *fifo, const type *elem) \
+{ \
+	unsigned int in = fifo->in; \
+	if (in - es_smp_load_acquire(&fifo->out) >= (size)) \
+		return 0; \
+	fifo->buf[in & ((size) - 1)] = *elem; \
+	es_smp_store_release(&fifo->in, in + 1); \
+	return 1; \
+} \
+\
+static inline int name##_pop(struct name *fifo, type *elem) \
+{ \
+	unsigned int out = fifo->out; \
+	if (es_smp_load_acquire(&fifo->in) == out) \
+		return 0; \
+	*elem = fifo->buf[out & ((size) - 1)]; \
+	es_smp_store_release(&fifo->out, out + 1); \
+	return 1; \
+} \
+\
+static inline type *name##_peek(struct name *fifo) \
+{ \
+	unsigned int out = fifo->out; \
+	if (es_smp_load_acquire(&fifo->in) == out) \
+		return NULL; \
+	return &fifo->buf[out & ((size) - 1)]; \
+} \
+\
+static inline unsigned int name##_in(struct name *fifo, \
+			const type *elems, unsigned int n) \
+{ \
+	unsigned int in = fifo->in; \
+	n = min((unsigned int)(size) - \
+		(in - es_smp_load_acquire(&fifo->out)), n); \
+	__ES_FIFO_TYPED_COPY_IN(fifo->buf, size, in, elems, n); \
+	es_smp_store_release(&fifo->in, in + n); \
+	return n; \
+} \
+\
+static inline unsigned int name##_out(struct name *fifo, \
+			type *elems, unsigned int n) \
+{ \
+	unsigned int out = fifo->out; \
+	n = min(es_smp_load_acquire(&fifo->in) - out, n); \
+	__ES_FIFO_TYPED_COPY_OUT(fifo->buf, size, out, elems, n); \
+	es_smp_store_release(&fifo->out, out + n); \
+	return n; \
+}
+
+#endif /* ifndef _ES_FIFO_TYPED_H_.2026-10-16 15:01:44 zcz */
+
@@ -0,0 +1,142 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_hash.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_HASH_H_
+#define _ES_HASH_H_
+#include <es_common.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Hash functions for the hash tables, fast and non-cryptographic.
+ *
+ * es_hash_32()/es_hash_64() are the multiplicative hashes of the
+ * kernel's <linux/hash.h>: good for integer keys and pointers, they keep
+ * the high @bits bits of the product with a golden ratio constant.
+ * es_hash_mem() is MurmurHash3 (x86_32) for byte strings of known length,
+ * es_hash_str() is FNV-1a for NUL terminated strings.
+ */
+
+#define ES_GOLDEN_RATIO_32	0x61C88647U
+#define ES_GOLDEN_RATIO_64	0x61C8864680B583EBULL
+
+/**
+ * es_hash_32 - hash a 32 bit value into @bits bits
+ * @val: the value
+ * @bits: number of result bits, 1..32
+ */
+static inline uint32_t es_hash_32(uint32_t val, unsigned int bits)
+{
+	return (val * ES_GOLDEN_RATIO_32) >> (32 - bits);
+}
+
+/**
+ * es_hash_64 - hash a 64 bit value into @bits bits
+ * @val: the value
+ * @bits: number of result bits, 1..32
+ */
+static inline uint32_t es_hash_64(uint64_t val, unsigned int bits)
+{
+	return (uint32_t)((val * ES_GOLDEN_RATIO_64) >> (64 - bits));
+}
+
+static inline uint32_t es_hash_long(unsigned long val, unsigned int bits)
+{
+	if (sizeof(val) == 8)
+		return es_hash_64(val, bits);
+	return es_hash_32(val, bits);
+}
+
+static inline uint32_t es_hash_ptr(const void *ptr, unsigned int bits)
+{
+	return es_hash_long((unsigned long)ptr, bits);
+}
+
+static inline uint32_t __es_rol32(uint32_t word, unsigned int shift)
+{
+	return (word << (shift & 31)) | (word >> ((-shift) & 31));
+}
+
+/**
+ * es_hash_mem - hash a byte string
+ * @key: the bytes
+ * @len: number of bytes
+ * @seed: start value, pick a random one against hash flooding
+ */
+static inline uint32_t es_hash_mem(const void *key, size_t len, uint32_t seed)
+{
+	const unsigned char *p = key;
+	uint32_t h = seed, k;
+	size_t i;
+
+	for (i = 0; i + 4 <= len; i += 4) {
+		memcpy(&k, p + i, 4);
+		k *= 0xcc9e2d51U;
+		k = __es_rol32(k, 15);
+		k *= 0x1b873593U;
+		h ^= k;
+		h = __es_rol32(h, 13);
+		h = h * 5 + 0xe6546b64U;
+	}
+
+	k = 0;
+	switch (len & 3) {
+	case 3:
+		k ^= p[i + 2] << 16;
+		/* fall through */
+	case 2:
+		k ^= p[i + 1] << 8;
+		/* fall through */
+	case 1:
+		k ^= p[i];
+		k *= 0xcc9e2d51U;
+		k = __es_rol32(k, 15);
+		k *= 0x1b873593U;
+		h ^= k;
+	}
+
+	/* final avalanche */
+	h ^= (uint32_t)len;
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+	return h;
+}
+
+/**
+ * es_hash_str - hash a NUL terminated string
+ * @str: the string
+ */
+static inline uint32_t es_hash_str(const char *str)
+{
+	uint32_t h = 0x811c9dc5U;
+
+	while (*str) {
+		h ^= (unsigned char)*str++;
+		h *= 0x01000193U;
+	}
+	return h;
+}
+
+#endif /* ifndef _ES_HASH_H_.2026-10-16 17:40:05 zcz */
+
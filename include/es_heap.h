@@ -0,0 +1,129 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_heap.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_HEAP_H_
+#define _ES_HEAP_H_
+#include <es_common.h>
+
+/*
+ * Array backed 4-ary min heap of intrusive nodes.
+ *
+ * Embed a struct es_heap_node in the object to be queued and get back
+ * to the object with es_heap_entry(), as with es_list_entry(). The
+ * order comes from a less function on two nodes.
+ *
+ * The heap array holds node pointers and every node knows its index in
+ * it, so a queued node can be removed or have its key changed in
+ * O(log n) without searching. Four children per node halve the depth of
+ * a binary heap; the four child pointers share one cache line, which
+ * makes the wider comparison on the way down cheap.
+ *
+ * es_heap_push_bulk() loads many nodes at once by heapifying the array
+ * bottom up, O(n) instead of O(n log n).
+ *
+ * A heap is not thread safe.
+ */
+
+#define ES_HEAP_ARITY		4
+#define ES_HEAP_NOT_QUEUED	(~0U)
+
+struct es_heap_node {
+	unsigned int index;	/* in the heap array, ES_HEAP_NOT_QUEUED */
+};
+
+typedef bool (*es_heap_less_t)(const struct es_heap_node *a,
+				const struct es_heap_node *b);
+
+struct es_heap {
+	struct es_heap_node **nodes;
+	unsigned int nr;		/* nodes queued */
+	unsigned int size;		/* of the array */
+	es_heap_less_t less;
+};
+
+extern int es_heap_init(struct es_heap *heap, unsigned int size,
+				es_heap_less_t less);
+extern void es_heap_destroy(struct es_heap *heap);
+extern int es_heap_push(struct es_heap *heap, struct es_heap_node *node);
+extern int es_heap_push_bulk(struct es_heap *heap,
+				struct es_heap_node **nodes, unsigned int n);
+extern struct es_heap_node *es_heap_pop(struct es_heap *heap);
+extern void es_heap_remove(struct es_heap *heap, struct es_heap_node *node);
+extern void es_heap_decrease(struct es_heap *heap, struct es_heap_node *node);
+extern void es_heap_update(struct es_heap *heap, struct es_heap_node *node);
+
+/**
+ * es_heap_entry - get the struct for this entry
+ * @ptr:	the &struct es_heap_node pointer.
+ * @type:	the type of the struct this is embedded in.
+ * @member:	the name of the es_heap_node within the struct.
+ */
+#define es_heap_entry(ptr, type, member) \
+	container_of(ptr, type, member)
+
+/**
+ * es_heap_node_init - initialize a heap node
+ * @node: the node to be initialized
+ */
+static inline void es_heap_node_init(struct es_heap_node *node)
+{
+	node->index = ES_HEAP_NOT_QUEUED;
+}
+
+/**
+ * es_heap_queued - is a node in a heap?
+ * @node: the node to be checked
+ */
+static inline bool es_heap_queued(const struct es_heap_node *node)
+{
+	return node->index != ES_HEAP_NOT_QUEUED;
+}
+
+/**
+ * es_heap_peek - the smallest node of a heap
+ * @heap: the heap to be used
+ *
+ * Return the node, or NULL if the heap is empty. It stays queued.
+ */
+static inline struct es_heap_node *es_heap_peek(const struct es_heap *heap)
+{
+	return heap->nr ? heap->nodes[0] : NULL;
+}
+
+/**
+ * es_heap_empty - tests whether a heap is empty
+ * @heap: the heap to be tested
+ */
+static inline bool es_heap_empty(const struct es_heap *heap)
+{
+	return !heap->nr;
+}
+
+/**
+ * es_heap_count - the number of nodes in a heap
+ * @heap: the heap to be used
+ */
+static inline unsigned int es_heap_count(const struct es_heap *heap)
+{
+	return heap->nr;
+}
+
+#endif /* ifndef _ES_HEAP_H_.2026-10-16 23:12:44 zcz */
+
@@ -0,0 +1,131 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_hmap.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_HMAP_H_
+#define _ES_HMAP_H_
+#include <es_common.h>
+#include <stdint.h>
+
+/*
+ * Open addressing hash map with Swiss table style control bytes.
+ *
+ * Keys and values are fixed size byte blobs stored in the table itself,
+ * no per entry allocation and no pointer chasing. Next to the slots sits
+ * one control byte per slot: empty, deleted, or the low 7 bits of the
+ * hash of a full slot. A probe loads a group of 16 control bytes and
+ * compares them all at once (SSE2 on x86, NEON on ARM, a plain loop
+ * elsewhere), so most lookups touch one control line and one slot.
+ *
+ * The table grows at 7/8 load. Growing is incremental: the new table is
+ * allocated, and every insert or erase moves a few groups of the old
+ * table over, while lookups search both, so no single call pays for a
+ * whole rehash. Both tables are alive until the move is done.
+ *
+ * Pointers returned into the map stay valid until the next insert or
+ * erase. No locking inside.
+ */
+
+/* hash of a key, @key points to ksize bytes */
+typedef uint32_t (*es_hmap_hash_fn)(const void *key, unsigned int ksize);
+/* nonzero if the keys are equal */
+typedef int (*es_hmap_eq_fn)(const void *a, const void *b, unsigned int ksize);
+
+struct es_hmap_table {
+	unsigned char *ctrl;	/* control bytes, one per slot */
+	unsigned char *slots;	/* key + value per slot */
+	unsigned int mask;	/* number of slots minus one */
+	unsigned int count;	/* full slots */
+	unsigned int growth_left;	/* inserts left before 7/8 load */
+};
+
+struct es_hmap {
+	struct es_hmap_table cur;	/* table taking the inserts */
+	struct es_hmap_table old;	/* table being moved, ctrl NULL if none */
+	unsigned int migrate_pos;	/* next slot of old to move */
+	unsigned int ksize;	/* size of a key in bytes */
+	unsigned int vsize;	/* size of a value in bytes */
+	unsigned int voff;	/* offset of the value in a slot */
+	unsigned int stride;	/* size of a slot in bytes */
+	es_hmap_hash_fn hashfn;
+	es_hmap_eq_fn eqfn;
+};
+
+struct es_hmap_iter {
+	unsigned int table;	/* 0: cur, 1: old */
+	unsigned int pos;	/* next slot */
+};
+
+extern int es_hmap_init(struct es_hmap *map, unsigned int ksize,
+				unsigned int vsize, unsigned int size,
+				es_hmap_hash_fn hashfn, es_hmap_eq_fn eqfn);
+extern void es_hmap_destroy(struct es_hmap *map);
+extern int es_hmap_reserve(struct es_hmap *map, unsigned int size);
+extern void *es_hmap_find(struct es_hmap *map, const void *key);
+extern void *es_hmap_insert(struct es_hmap *map, const void *key,
+				int *existed);
+extern int es_hmap_put(struct es_hmap *map, const void *key,
+				const void *value);
+extern int es_hmap_erase(struct es_hmap *map, const void *key);
+extern void es_hmap_clear(struct es_hmap *map);
+extern int es_hmap_iter_next(struct es_hmap *map, struct es_hmap_iter *iter,
+				void **key, void **value);
+
+/**
+ * es_hmap_count - returns the number of entries
+ * @map: the map to be used.
+ */
+static inline unsigned int es_hmap_count(struct es_hmap *map)
+{
+	return map->cur.count + map->old.count;
+}
+
+/**
+ * es_hmap_capacity - returns the number of slots of the current table
+ * @map: the map to be used.
+ */
+static inline unsigned int es_hmap_capacity(struct es_hmap *map)
+{
+	return map->cur.mask + 1;
+}
+
+/**
+ * es_hmap_rehashing - returns true while an old table is being moved
+ * @map: the map to be used.
+ */
+static inline bool es_hmap_rehashing(struct es_hmap *map)
+{
+	return map->old.ctrl != NULL;
+}
+
+/**
+ * es_hmap_iter_init - start an iteration over all entries
+ * @iter: the iterator
+ *
+ * The map must not be changed while iterating, except through the
+ * value pointers.
+ */
+static inline void es_hmap_iter_init(struct es_hmap_iter *iter)
+{
+	iter->table = 0;
+	iter->pos = 0;
+}
+
+#endif /* ifndef _ES_HMAP_H_.2026-10-16 18:21:09 zcz */
+
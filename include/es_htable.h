@@ -0,0 +1,153 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_htable.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_HTABLE_H_
+#define _ES_HTABLE_H_
+#include <es_common.h>
+#include <es_hash.h>
+#include <es_list.h>
+
+/*
+ * Intrusive chained hash table on es_hlist buckets.
+ *
+ * The objects embed a struct es_hlist_node and are found again with
+ * es_hlist_entry()/container_of(), the table itself never allocates per
+ * object. A bucket is one pointer, half the size of an es_list_head.
+ *
+ * The user supplies the hash functions and the key compare in a struct
+ * es_htable_ops; es_hash.h has ready made hash functions. The bucket
+ * array doubles when there are more objects than buckets, and shrinks
+ * only on request with es_htable_resize().
+ *
+ * No locking inside: serialize writers, and readers against writers.
+ */
+
+struct es_htable_ops {
+	/* hash of a lookup key */
+	uint32_t (*hashfn)(const void *key);
+	/* hash of a stored object, equal to hashfn() of its key */
+	uint32_t (*obj_hashfn)(const struct es_hlist_node *node);
+	/* nonzero if the object at @node has the key @key */
+	int (*matchfn)(const struct es_hlist_node *node, const void *key);
+};
+
+struct es_htable {
+	struct es_hlist_head *buckets;	/* 1 << bits buckets */
+	unsigned int bits;		/* log2 of the number of buckets */
+	unsigned int min_bits;		/* es_htable_resize() stays above */
+	unsigned int nelems;		/* number of objects */
+	unsigned int flags;		/* ES_HTABLE_F_* flags */
+	const struct es_htable_ops *ops;
+};
+
+/*
+ * es_htable_init flags
+ */
+#define ES_HTABLE_F_FIXED	(1U << 0)	/* never grow on its own */
+
+/* largest bucket array, 2^ES_HTABLE_MAX_BITS buckets */
+#define ES_HTABLE_MAX_BITS	30
+
+extern int es_htable_init(struct es_htable *ht,
+				const struct es_htable_ops *ops,
+				unsigned int size, unsigned int flags);
+extern void es_htable_destroy(struct es_htable *ht);
+extern int es_htable_resize(struct es_htable *ht, unsigned int size);
+extern void es_htable_add(struct es_htable *ht, struct es_hlist_node *node);
+extern struct es_hlist_node *es_htable_insert(struct es_htable *ht,
+				struct es_hlist_node *node, const void *key);
+extern struct es_hlist_node *es_htable_lookup(struct es_htable *ht,
+				const void *key);
+extern void es_htable_del(struct es_htable *ht, struct es_hlist_node *node);
+extern struct es_hlist_node *es_htable_remove(struct es_htable *ht,
+				const void *key);
+
+/**
+ * es_htable_count - returns the number of objects in the table
+ * @ht: the table to be used.
+ */
+static inline unsigned int es_htable_count(struct es_htable *ht)
+{
+	return ht->nelems;
+}
+
+/**
+ * es_htable_size - returns the number of buckets
+ * @ht: the table to be used.
+ */
+static inline unsigned int es_htable_size(struct es_htable *ht)
+{
+	return 1U << ht->bits;
+}
+
+/**
+ * es_htable_bucket - returns the bucket of a hash value
+ * @ht: the table to be used.
+ * @hash: the hash, as returned by the hashfn of the table
+ *
+ * The hash is mixed once more, so a plain identity hash of an integer
+ * key still spreads over all buckets.
+ */
+static inline struct es_hlist_head *es_htable_bucket(struct es_htable *ht,
+				uint32_t hash)
+{
+	return &ht->buckets[es_hash_32(hash, ht->bits)];
+}
+
+/**
+ * es_htable_for_each_entry - iterate over all objects of a table
+ * @ht:		the table to be used.
+ * @bkt:	unsigned int to use as bucket cursor
+ * @pos:	the type * to use as a loop cursor.
+ * @member:	the name of the es_hlist_node within the struct.
+ *
+ * Adding objects while iterating may resize the table, don't.
+ */
+#define es_htable_for_each_entry(ht, bkt, pos, member)			\
+	for ((bkt) = 0; (bkt) < es_htable_size(ht); (bkt)++)		\
+		es_hlist_for_each_entry(pos, &(ht)->buckets[bkt], member)
+
+/**
+ * es_htable_for_each_entry_safe - iterate over all objects, safe against removal
+ * @ht:		the table to be used.
+ * @bkt:	unsigned int to use as bucket cursor
+ * @tmp:	a &struct es_hlist_node used for temporary storage
+ * @pos:	the type * to use as a loop cursor.
+ * @member:	the name of the es_hlist_node within the struct.
+ */
+#define es_htable_for_each_entry_safe(ht, bkt, tmp, pos, member)	\
+	for ((bkt) = 0; (bkt) < es_htable_size(ht); (bkt)++)		\
+		es_hlist_for_each_entry_safe(pos, tmp, &(ht)->buckets[bkt], member)
+
+/**
+ * es_htable_for_each_possible - iterate over the objects which may have a key
+ * @ht:		the table to be used.
+ * @pos:	the type * to use as a loop cursor.
+ * @member:	the name of the es_hlist_node within the struct.
+ * @hash:	hash of the key
+ *
+ * Walks the bucket of @hash without calling the matchfn, for lookups
+ * with an inline key compare or for tables with duplicate keys.
+ */
+#define es_htable_for_each_possible(ht, pos, member, hash)		\
+	es_hlist_for_each_entry(pos, es_htable_bucket(ht, hash), member)
+
+#endif /* ifndef _ES_HTABLE_H_.2026-10-16 17:52:37 zcz */
+
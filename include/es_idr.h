@@ -0,0 +1,138 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_idr.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_IDR_H_
+#define _ES_IDR_H_
+#include <es_common.h>
+#include <es_rcu.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/*
+ * ID allocator, mapping small integers to pointers, after the IDR and
+ * xarray of the Linux kernel.
+ *
+ * The IDs are kept in a radix tree of 64 slot nodes, so a million IDs
+ * are three levels deep and a lookup is three dependent loads. The tree
+ * only grows as tall as the largest ID needs; dense IDs cost a little
+ * more than 8 bytes each.
+ *
+ * Every node has a bitmap of its full slots: a slot in use at the
+ * bottom level, a subtree without a free ID above it. The lowest free ID
+ * is found by following the first clear bit down, which makes
+ * es_idr_alloc() O(depth) however crowded the tree is.
+ *
+ * es_idr_find() and es_idr_get_next() take no lock, they may run under
+ * es_rcu_read_lock() concurrently with the writers. Writers are
+ * serialized by a mutex of the idr. A pointer removed from the idr may
+ * still be returned to readers which started before the removal, free
+ * its object after es_synchronize_rcu().
+ *
+ * Nodes emptied by es_idr_remove() stay in the tree to be reused,
+ * es_idr_shrink() frees them after a grace period; inside a read-side
+ * section it cannot wait for one and does nothing.
+ */
+
+#define ES_IDR_BITS	6
+#define ES_IDR_SLOTS	(1UL << ES_IDR_BITS)
+#define ES_IDR_MASK	(ES_IDR_SLOTS - 1)
+
+struct es_idr_node {
+	unsigned char shift;		/* of the IDs below a slot */
+	unsigned char offset;		/* slot in the parent */
+	struct es_idr_node *parent;	/* NULL for the root */
+	uint64_t full;			/* slots without a free ID */
+	void *slots[ES_IDR_SLOTS];	/* entries, or nodes if shift > 0 */
+};
+
+struct es_idr {
+	struct es_idr_node *root;	/* NULL when empty */
+	pthread_mutex_t lock;		/* serializes the writers */
+	unsigned long nr_nodes;
+};
+
+#define ES_IDR_INIT(name) { \
+		.root = NULL, \
+		.lock = PTHREAD_MUTEX_INITIALIZER, \
+		.nr_nodes = 0 }
+
+#define ES_DEFINE_IDR(name)	struct es_idr name = ES_IDR_INIT(name)
+
+extern void es_idr_init(struct es_idr *idr);
+extern void es_idr_destroy(struct es_idr *idr);
+extern int es_idr_alloc(struct es_idr *idr, void *ptr, unsigned long *id,
+				unsigned long max);
+extern void *es_idr_replace(struct es_idr *idr, void *ptr, unsigned long id);
+extern void *es_idr_remove(struct es_idr *idr, unsigned long id);
+extern void *es_idr_get_next(const struct es_idr *idr, unsigned long *id);
+extern void es_idr_shrink(struct es_idr *idr);
+
+/**
+ * es_idr_find - return the pointer of an ID
+ * @idr: the idr to be searched
+ * @id: the ID to look up
+ *
+ * Lock free, call it under es_rcu_read_lock() when writers may run
+ * concurrently. Return the pointer, or NULL if @id is not allocated.
+ */
+static inline void *es_idr_find(const struct es_idr *idr, unsigned long id)
+{
+	struct es_idr_node *node = es_rcu_dereference(idr->root);
+	unsigned long offset;
+	void *entry;
+
+	while (node) {
+		offset = id >> node->shift;
+		if (offset >= ES_IDR_SLOTS)
+			return NULL;
+		entry = es_rcu_dereference(node->slots[offset]);
+		if (!node->shift)
+			return entry;
+		id &= (1UL << node->shift) - 1;
+		node = entry;
+	}
+	return NULL;
+}
+
+/**
+ * es_idr_is_empty - is any ID allocated?
+ * @idr: the idr to be checked
+ */
+static inline bool es_idr_is_empty(const struct es_idr *idr)
+{
+	unsigned long id = 0;
+
+	return !es_idr_get_next(idr, &id);
+}
+
+/**
+ * es_idr_for_each_entry - iterate over the allocated IDs in order
+ * @idr: the idr to be iterated
+ * @entry: the pointer of the current ID
+ * @id: unsigned long, the current ID
+ *
+ * May run under es_rcu_read_lock() concurrently with the writers.
+ */
+#define es_idr_for_each_entry(idr, entry, id) \
+	for ((id) = 0; ((entry) = es_idr_get_next((idr), &(id))) != NULL; \
+		(id)++)
+
+#endif /* ifndef _ES_IDR_H_.2026-10-16 22:41:07 zcz */
+
@@ -0,0 +1,66 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_interval_tree.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_INTERVAL_TREE_H_
+#define _ES_INTERVAL_TREE_H_
+#include <es_rbtree.h>
+#include <stdint.h>
+
+/*
+ * Interval tree of closed [start;last] ranges with 64 bit endpoints,
+ * e.g. address ranges or nanosecond time ranges. It is an augmented
+ * es_rbtree ordered by start, every node keeping the largest last of its
+ * subtree, so all intervals overlapping a query are found in
+ * O(log n + matches):
+ *
+ *	for (it = es_interval_tree_iter_first(&root, start, last); it;
+ *	     it = es_interval_tree_iter_next(it, start, last))
+ *		...
+ *
+ * Embed struct es_interval_tree_node in the object and get back with
+ * container_of(). Other endpoint types or layouts can instantiate their
+ * own tree with ES_INTERVAL_TREE_DEFINE() of es_interval_tree_generic.h.
+ */
+
+struct es_interval_tree_node {
+	struct es_rb_node rb;
+	uint64_t start;		/* Start of interval */
+	uint64_t last;		/* Last location _in_ interval */
+	uint64_t __subtree_last;
+};
+
+extern void
+es_interval_tree_insert(struct es_interval_tree_node *node,
+			struct es_rb_root_cached *root);
+
+extern void
+es_interval_tree_remove(struct es_interval_tree_node *node,
+			struct es_rb_root_cached *root);
+
+extern struct es_interval_tree_node *
+es_interval_tree_iter_first(struct es_rb_root_cached *root,
+			uint64_t start, uint64_t last);
+
+extern struct es_interval_tree_node *
+es_interval_tree_iter_next(struct es_interval_tree_node *node,
+			uint64_t start, uint64_t last);
+
+#endif /* ifndef _ES_INTERVAL_TREE_H_.2026-10-16 21:42:13 zcz */
+
@@ -551,6 +551,207 @@ static inline void es_list_splice_tail_init(struct es_list_head *es_list,
 		n = es_list_entry(pos->member.prev, typeof(*pos), member);	\
 	     &pos->member != (head); 					\
 	     pos = n, n = es_list_entry(n->member.prev, typeof(*n), member))
-	     
+
+/*
+ * es_list_cmp_func_t - comparison for es_list_sort() and es_list_merge()
+ *
+ * Returns > 0 if @a sorts after @b, <= 0 otherwise; a plain
+ * "a->key > b->key" is enough, the sort is stable either way.
+ */
+typedef int (*es_list_cmp_func_t)(void *priv, const struct es_list_head *a,
+				const struct es_list_head *b);
+
+extern void es_list_sort(void *priv, struct es_list_head *head,
+				es_list_cmp_func_t cmp);
+extern void es_list_merge(void *priv, struct es_list_head *head,
+				struct es_list_head *es_list,
+				es_list_cmp_func_t cmp);
+
+/*
+ * Double linked es_lists with a single pointer es_list head.
+ * Mostly useful for hash tables where the two pointer es_list head is
+ * too wasteful.
+ * You lose the ability to access the tail in O(1).
+ */
+
+struct es_hlist_head {
+	struct es_hlist_node *first;
+};
+
+struct es_hlist_node {
+	struct es_hlist_node *next, **pprev;
+};
+
+#define ES_HLIST_HEAD_INIT { .first = NULL }
+#define ES_HLIST_HEAD(name) struct es_hlist_head name = {  .first = NULL }
+#define INIT_ES_HLIST_HEAD(ptr) ((ptr)->first = NULL)
+
+static inline void INIT_ES_HLIST_NODE(struct es_hlist_node *h)
+{
+	h->next = NULL;
+	h->pprev = NULL;
+}
+
+static inline int es_hlist_unhashed(const struct es_hlist_node *h)
+{
+	return !h->pprev;
+}
+
+static inline int es_hlist_empty(const struct es_hlist_head *h)
+{
+	return !h->first;
+}
+
+static inline void __es_hlist_del(struct es_hlist_node *n)
+{
+	struct es_hlist_node *next = n->next;
+	struct es_hlist_node **pprev = n->pprev;
+
+	*pprev = next;
+	if (next)
+		next->pprev = pprev;
+}
+
+/**
+ * es_hlist_del - deletes entry from es_hlist.
+ * @n: the element to delete from the es_hlist.
+ * Note: es_hlist_unhashed() on entry does not return true after this,
+ * the entry is in an undefined state.
+ */
+static inline void es_hlist_del(struct es_hlist_node *n)
+{
+	__es_hlist_del(n);
+	n->next = NULL;
+	n->pprev = NULL;
+}
+
+/**
+ * es_hlist_del_init - deletes entry from es_hlist and reinitialize it.
+ * @n: the element to delete from the es_hlist.
+ */
+static inline void es_hlist_del_init(struct es_hlist_node *n)
+{
+	if (!es_hlist_unhashed(n)) {
+		__es_hlist_del(n);
+		INIT_ES_HLIST_NODE(n);
+	}
+}
+
+/**
+ * es_hlist_add_head - add a new entry at the beginning of the es_hlist
+ * @n: new entry to be added
+ * @h: es_hlist head to add it after
+ */
+static inline void es_hlist_add_head(struct es_hlist_node *n,
+				struct es_hlist_head *h)
+{
+	struct es_hlist_node *first = h->first;
+
+	n->next = first;
+	if (first)
+		first->pprev = &n->next;
+	h->first = n;
+	n->pprev = &h->first;
+}
+
+/**
+ * es_hlist_add_before - add a new entry before the one specified
+ * @n: new entry to be added
+ * @next: es_hlist node to add it before, which must be non-NULL
+ */
+static inline void es_hlist_add_before(struct es_hlist_node *n,
+				struct es_hlist_node *next)
+{
+	n->pprev = next->pprev;
+	n->next = next;
+	next->pprev = &n->next;
+	*(n->pprev) = n;
+}
+
+/**
+ * es_hlist_add_behind - add a new entry after the one specified
+ * @n: new entry to be added
+ * @prev: es_hlist node to add it after, which must be non-NULL
+ */
+static inline void es_hlist_add_behind(struct es_hlist_node *n,
+				struct es_hlist_node *prev)
+{
+	n->next = prev->next;
+	prev->next = n;
+	n->pprev = &prev->next;
+
+	if (n->next)
+		n->next->pprev = &n->next;
+}
+
+/*
+ * Move a es_list from one es_list head to another. Fixup the pprev
+ * reference of the first entry if it exists.
+ */
+static inline void es_hlist_move_list(struct es_hlist_head *old,
+				struct es_hlist_head *new)
+{
+	new->first = old->first;
+	if (new->first)
+		new->first->pprev = &new->first;
+	old->first = NULL;
+}
+
+#define es_hlist_entry(ptr, type, member) container_of(ptr, type, member)
+
+#define es_hlist_for_each(pos, head) \
+	for (pos = (head)->first; pos ; pos = pos->next)
+
+#define es_hlist_for_each_safe(pos, n, head) \
+	for (pos = (head)->first; pos && ({ n = pos->next; 1; }); \
+	     pos = n)
+
+#define es_hlist_entry_safe(ptr, type, member) \
+	({ typeof(ptr) ____ptr = (ptr); \
+	   ____ptr ? es_hlist_entry(____ptr, type, member) : NULL; \
+	})
+
+/**
+ * es_hlist_for_each_entry	- iterate over es_list of given type
+ * @pos:	the type * to use as a loop cursor.
+ * @head:	the head for your es_list.
+ * @member:	the name of the es_hlist_node within the struct.
+ */
+#define es_hlist_for_each_entry(pos, head, member)				\
+	for (pos = es_hlist_entry_safe((head)->first, typeof(*(pos)), member);\
+	     pos;							\
+	     pos = es_hlist_entry_safe((pos)->member.next, typeof(*(pos)), member))
+
+/**
+ * es_hlist_for_each_entry_continue - iterate over a es_hlist continuing after current point
+ * @pos:	the type * to use as a loop cursor.
+ * @member:	the name of the es_hlist_node within the struct.
+ */
+#define es_hlist_for_each_entry_continue(pos, member)			\
+	for (pos = es_hlist_entry_safe((pos)->member.next, typeof(*(pos)), member);\
+	     pos;							\
+	     pos = es_hlist_entry_safe((pos)->member.next, typeof(*(pos)), member))
+
+/**
+ * es_hlist_for_each_entry_from - iterate over a es_hlist continuing from current point
+ * @pos:	the type * to use as a loop cursor.
+ * @member:	the name of the es_hlist_node within the struct.
+ */
+#define es_hlist_for_each_entry_from(pos, member)				\
+	for (; pos;							\
+	     pos = es_hlist_entry_safe((pos)->member.next, typeof(*(pos)), member))
+
+/**
+ * es_hlist_for_each_entry_safe - iterate over es_list of given type safe against removal of es_list entry
+ * @pos:	the type * to use as a loop cursor.
+ * @n:		another &struct es_hlist_node to use as temporary storage
+ * @head:	the head for your es_list.
+ * @member:	the name of the es_hlist_node within the struct.
+ */
+#define es_hlist_for_each_entry_safe(pos, n, head, member) 		\
+	for (pos = es_hlist_entry_safe((head)->first, typeof(*pos), member);\
+	     pos && ({ n = pos->member.next; 1; });			\
+	     pos = es_hlist_entry_safe(n, typeof(*pos), member))
+
 #endif /* ifndef _ES_LIST_H_.2016-10-17 22:12:50 zcz */
 
@@ -0,0 +1,276 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_llist.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_LLIST_H_
+#define _ES_LLIST_H_
+#include <es_common.h>
+#include <es_atomic.h>
+
+/*
+ * Lock-less NULL terminated single linked list, ported from the Linux
+ * Kernel llist.
+ *
+ * Cases where locking is not needed:
+ * If there are multiple producers and multiple consumers, es_llist_add
+ * can be used in producers and es_llist_del_all can be used in consumers
+ * simultaneously without locking. Also a single consumer can use
+ * es_llist_del_first while multiple producers simultaneously use
+ * es_llist_add, without any locking.
+ *
+ * Cases where locking is needed:
+ * If we have multiple consumers with es_llist_del_first used in one
+ * consumer, and es_llist_del_first or es_llist_del_all used in other
+ * consumers, then a lock is needed. This is because es_llist_del_first
+ * depends on list->first->next not changing, but without lock
+ * protection, there's no way to be sure about that if a preemption
+ * happens in the middle of the delete operation and on being preempted
+ * back, the list->first is the same as before causing the cmpxchg in
+ * es_llist_del_first to succeed. For example, while a es_llist_del_first
+ * operation is in progress in one consumer, then a es_llist_del_first,
+ * es_llist_add, es_llist_add (or es_llist_del_all, es_llist_add,
+ * es_llist_add) sequence in another consumer may cause violations.
+ *
+ * This can be summarized as follows:
+ *
+ *           |   add    | del_first |  del_all
+ * add       |    -     |     -     |     -
+ * del_first |          |     L     |     L
+ * del_all   |          |           |     -
+ *
+ * Where, a particular row's operation can happen concurrently with a
+ * column's operation, with "-" being no lock needed, while "L" being
+ * lock is needed.
+ *
+ * The list entries deleted via es_llist_del_all can be traversed with
+ * traversing function such as es_llist_for_each etc. But the list
+ * entries can not be traversed safely before deleted from the list.
+ * The order of deleted entries is from the newest to the oldest added
+ * one. If you want to traverse from the oldest to the newest, you must
+ * reverse the order by yourself before traversing.
+ *
+ * The basic atomic operations of this list are cmpxchg and xchg on a
+ * pointer, so the nodes are embedded in the caller's structures and
+ * nothing is allocated.
+ */
+
+struct es_llist_head {
+	struct es_llist_node *first;
+};
+
+struct es_llist_node {
+	struct es_llist_node *next;
+};
+
+#define ES_LLIST_HEAD_INIT(name)	{ NULL }
+#define ES_LLIST_HEAD(name)	struct es_llist_head name = ES_LLIST_HEAD_INIT(name)
+
+/**
+ * INIT_ES_LLIST_HEAD - initialize lock-less list head
+ * @head:	the head for your lock-less list
+ */
+static inline void INIT_ES_LLIST_HEAD(struct es_llist_head *list)
+{
+	list->first = NULL;
+}
+
+/**
+ * es_init_llist_node - initialize lock-less list node
+ * @node:	the node to be initialised
+ *
+ * In cases where there is a need to test if a node is on
+ * a list or not, this initialises the node to clearly
+ * not be on any list.
+ */
+static inline void es_init_llist_node(struct es_llist_node *node)
+{
+	node->next = node;
+}
+
+/**
+ * es_llist_on_list - test if a lock-list list node is on a list
+ * @node:	the node to test
+ *
+ * When a node is on a list the ->next pointer will be NULL or
+ * some other node. It can never point to itself. We use that
+ * in es_init_llist_node() to record that a node is not on any list,
+ * and here to test whether it is on any list.
+ */
+static inline bool es_llist_on_list(const struct es_llist_node *node)
+{
+	return node->next != node;
+}
+
+/**
+ * es_llist_entry - get the struct of this entry
+ * @ptr:	the &struct es_llist_node pointer.
+ * @type:	the type of the struct this is embedded in.
+ * @member:	the name of the es_llist_node within the struct.
+ */
+#define es_llist_entry(ptr, type, member)		\
+	container_of(ptr, type, member)
+
+#define es_llist_entry_safe(ptr, type, member) \
+	({ typeof(ptr) ____ptr = (ptr); \
+	   ____ptr ? es_llist_entry(____ptr, type, member) : NULL; \
+	})
+
+/**
+ * es_llist_for_each - iterate over some deleted entries of a lock-less list
+ * @pos:	the &struct es_llist_node to use as a loop cursor
+ * @node:	the first entry of deleted list entries
+ *
+ * In general, some entries of the lock-less list can be traversed
+ * safely only after being deleted from list, so start with an entry
+ * instead of list head.
+ *
+ * If being used on entries deleted from lock-less list directly, the
+ * traverse order is from the newest to the oldest added entry.  If
+ * you want to traverse from the oldest to the newest, you must
+ * reverse the order by yourself before traversing.
+ */
+#define es_llist_for_each(pos, node)			\
+	for ((pos) = (node); pos; (pos) = (pos)->next)
+
+/**
+ * es_llist_for_each_safe - iterate over some deleted entries of a lock-less list
+ *			 safe against removal of list entry
+ * @pos:	the &struct es_llist_node to use as a loop cursor
+ * @n:		another &struct es_llist_node to use as temporary storage
+ * @node:	the first entry of deleted list entries
+ *
+ * In general, some entries of the lock-less list can be traversed
+ * safely only after being deleted from list, so start with an entry
+ * instead of list head.
+ */
+#define es_llist_for_each_safe(pos, n, node)			\
+	for ((pos) = (node); (pos) && ((n) = (pos)->next, es_true); (pos) = (n))
+
+/**
+ * es_llist_for_each_entry - iterate over some deleted entries of lock-less list of given type
+ * @pos:	the type * to use as a loop cursor.
+ * @node:	the fist entry of deleted list entries.
+ * @member:	the name of the es_llist_node with the struct.
+ *
+ * In general, some entries of the lock-less list can be traversed
+ * safely only after being removed from list, so start with an entry
+ * instead of list head.
+ */
+#define es_llist_for_each_entry(pos, node, member)				\
+	for ((pos) = es_llist_entry_safe((node), typeof(*(pos)), member);	\
+	     pos;								\
+	     (pos) = es_llist_entry_safe((pos)->member.next, typeof(*(pos)),	\
+			member))
+
+/**
+ * es_llist_for_each_entry_safe - iterate over some deleted entries of lock-less list of given type
+ *			       safe against removal of list entry
+ * @pos:	the type * to use as a loop cursor.
+ * @n:		another type * to use as temporary storage
+ * @node:	the first entry of deleted list entries.
+ * @member:	the name of the es_llist_node with the struct.
+ *
+ * In general, some entries of the lock-less list can be traversed
+ * safely only after being removed from list, so start with an entry
+ * instead of list head.
+ */
+#define es_llist_for_each_entry_safe(pos, n, node, member)			       \
+	for (pos = es_llist_entry_safe((node), typeof(*pos), member);		       \
+	     pos &&								       \
+		(n = es_llist_entry_safe(pos->member.next, typeof(*n), member),     \
+		 es_true);							       \
+	     pos = n)
+
+/**
+ * es_llist_empty - tests whether a lock-less list is empty
+ * @head:	the list to test
+ *
+ * Not guaranteed to be accurate or up to date.  Just a quick way to
+ * test whether the list is empty without deleting something from the
+ * list.
+ */
+static inline bool es_llist_empty(const struct es_llist_head *head)
+{
+	return ES_READ_ONCE(head->first) == NULL;
+}
+
+static inline struct es_llist_node *es_llist_next(struct es_llist_node *node)
+{
+	return node->next;
+}
+
+extern bool es_llist_add_batch(struct es_llist_node *new_first,
+			    struct es_llist_node *new_last,
+			    struct es_llist_head *head);
+extern struct es_llist_node *es_llist_del_first(struct es_llist_head *head);
+extern struct es_llist_node *es_llist_reverse_order(
+			    struct es_llist_node *head);
+
+static inline bool __es_llist_add_batch(struct es_llist_node *new_first,
+				     struct es_llist_node *new_last,
+				     struct es_llist_head *head)
+{
+	new_last->next = head->first;
+	head->first = new_first;
+	return new_last->next == NULL;
+}
+
+/**
+ * es_llist_add - add a new entry
+ * @new:	new entry to be added
+ * @head:	the head for your lock-less list
+ *
+ * Returns true if the list was empty prior to adding this entry.
+ */
+static inline bool es_llist_add(struct es_llist_node *new,
+		struct es_llist_head *head)
+{
+	return es_llist_add_batch(new, new, head);
+}
+
+static inline bool __es_llist_add(struct es_llist_node *new,
+		struct es_llist_head *head)
+{
+	return __es_llist_add_batch(new, new, head);
+}
+
+/**
+ * es_llist_del_all - delete all entries from lock-less list
+ * @head:	the head of lock-less list to delete all entries
+ *
+ * If list is empty, return NULL, otherwise, delete all entries and
+ * return the pointer to the first entry.  The order of entries
+ * deleted is from the newest to the oldest added one.
+ */
+static inline struct es_llist_node *es_llist_del_all(struct es_llist_head *head)
+{
+	return es_xchg(&head->first, NULL);
+}
+
+static inline struct es_llist_node *__es_llist_del_all(
+		struct es_llist_head *head)
+{
+	struct es_llist_node *first = head->first;
+
+	head->first = NULL;
+	return first;
+}
+
+#endif /* ifndef _ES_LLIST_H_.2026-10-16 19:58:12 zcz */
+
@@ -0,0 +1,98 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_memcpy.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_MEMCPY_H_
+#define _ES_MEMCPY_H_
+#include <es_common.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Copy kernels for moving data through the fifos.
+ *
+ * es_memcpy_small() is an inline copy for short transfers, it turns into
+ * a handful of possibly overlapping loads and stores instead of a libc
+ * call.
+ *
+ * es_memcpy_stream() is meant for large blocks whose destination will
+ * not be touched again soon by this cpu, typically a ring buffer drained
+ * by another core much later. The implementation is picked at runtime:
+ * non-temporal SSE2/AVX stores on x86, NEON on ARM, libc memcpy
+ * elsewhere. Streaming stores are weakly ordered, es_memcpy_stream()
+ * fences them before returning, so the usual release barrier of the
+ * caller still publishes the data.
+ */
+
+/* largest copy es_memcpy_small() handles */
+#define ES_MEMCPY_SMALL_MAX	64
+
+/*
+ * es_memcpy_stream implementations
+ */
+enum es_memcpy_impl {
+	ES_MEMCPY_AUTO = 0,	/* best one the cpu supports */
+	ES_MEMCPY_LIBC,		/* plain memcpy() */
+	ES_MEMCPY_SSE2_NT,	/* x86 movntdq */
+	ES_MEMCPY_AVX_NT,	/* x86 vmovntdq */
+	ES_MEMCPY_NEON,		/* ARM NEON, stnp on aarch64 */
+	ES_MEMCPY_IMPL_MAX,
+};
+
+extern void es_memcpy_stream(void *to, const void *from, size_t len);
+extern int es_memcpy_set_impl(enum es_memcpy_impl impl);
+extern enum es_memcpy_impl es_memcpy_get_impl(void);
+extern bool es_memcpy_impl_supported(enum es_memcpy_impl impl);
+extern const char *es_memcpy_impl_name(enum es_memcpy_impl impl);
+
+/**
+ * es_memcpy_small - copy a short block inline
+ * @to: the destination
+ * @from: the source, must not overlap @to
+ * @len: number of bytes, at most ES_MEMCPY_SMALL_MAX
+ *
+ * The fixed size memcpy() calls are expanded by the compiler into plain
+ * moves; head and tail moves overlap so there is no byte loop.
+ */
+static inline void es_memcpy_small(void *to, const void *from, size_t len)
+{
+	unsigned char *d = to;
+	const unsigned char *s = from;
+	size_t i;
+
+	if (len >= 16) {
+		for (i = 0; i + 16 <= len; i += 16)
+			memcpy(d + i, s + i, 16);
+		if (i != len)
+			memcpy(d + len - 16, s + len - 16, 16);
+	} else if (len >= 8) {
+		memcpy(d, s, 8);
+		memcpy(d + len - 8, s + len - 8, 8);
+	} else if (len >= 4) {
+		memcpy(d, s, 4);
+		memcpy(d + len - 4, s + len - 4, 4);
+	} else if (len) {
+		d[0] = s[0];
+		d[len / 2] = s[len / 2];
+		d[len - 1] = s[len - 1];
+	}
+}
+
+#endif /* ifndef _ES_MEMCPY_H_.2026-10-16 16:20:31 zcz */
+
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_mpmc_fifo.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_MPMC_FIFO_H_
+#define _ES_MPMC_FIFO_H_
+#include <es_common.h>
+#include <es_atomic.h>
+
+/*
+ * Bounded lock-free multi-producer/multi-consumer FIFO of fixed size
+ * elements (D. Vyukov's bounded MPMC queue).
+ *
+ * Every slot carries a sequence number: a slot at position pos is free
+ * for the producer which claimed pos when seq == pos, and holds data for
+ * the consumer which claimed pos when seq == pos + 1. Producers and
+ * consumers claim positions with a CAS on their own index, so the only
+ * shared writes are the two indices and the slot they work on.
+ *
+ * Any number of threads may call es_mpmc_fifo_in() and es_mpmc_fifo_out()
+ * concurrently without extra locking.
+ */
+struct es_mpmc_fifo {
+	/* read-only after init */
+	unsigned char *slots;	/* the buffer holding seq + data per slot */
+	unsigned int mask;	/* number of slots minus one */
+	unsigned int esize;	/* size of one element in bytes */
+	unsigned int stride;	/* size of one slot in bytes */
+
+	unsigned int in __es_cacheline_aligned;	/* next position to fill */
+	unsigned int out __es_cacheline_aligned;	/* next position to drain */
+};
+
+extern int es_mpmc_fifo_alloc(struct es_mpmc_fifo *fifo, unsigned int esize,
+				unsigned int count);
+extern void es_mpmc_fifo_free(struct es_mpmc_fifo *fifo);
+extern unsigned int es_mpmc_fifo_in(struct es_mpmc_fifo *fifo,
+				const void *from, unsigned int n);
+extern unsigned int es_mpmc_fifo_out(struct es_mpmc_fifo *fifo,
+				void *to, unsigned int n);
+
+/**
+ * es_mpmc_fifo_initialized - Check if es_mpmc_fifo is initialized.
+ * @fifo: fifo to check
+ */
+static inline bool es_mpmc_fifo_initialized(struct es_mpmc_fifo *fifo)
+{
+	return fifo->slots != NULL;
+}
+
+/**
+ * es_mpmc_fifo_size - returns the number of elements the fifo can hold
+ * @fifo: the fifo to be used.
+ */
+static inline unsigned int es_mpmc_fifo_size(struct es_mpmc_fifo *fifo)
+{
+	return fifo->mask + 1;
+}
+
+/**
+ * es_mpmc_fifo_esize - returns the size of one element
+ * @fifo: the fifo to be used.
+ */
+static inline unsigned int es_mpmc_fifo_esize(struct es_mpmc_fifo *fifo)
+{
+	return fifo->esize;
+}
+
+/**
+ * es_mpmc_fifo_len - returns the number of elements in the FIFO
+ * @fifo: the fifo to be used.
+ *
+ * Only a snapshot while other threads are active.
+ */
+static inline unsigned int es_mpmc_fifo_len(struct es_mpmc_fifo *fifo)
+{
+	unsigned int out = ES_READ_ONCE(fifo->out);
+	int len = (int)(ES_READ_ONCE(fifo->in) - out);
+
+	return len > 0 ? (unsigned int)len : 0;
+}
+
+/**
+ * es_mpmc_fifo_is_empty - returns true if the fifo is empty
+ * @fifo: the fifo to be used.
+ */
+static inline int es_mpmc_fifo_is_empty(struct es_mpmc_fifo *fifo)
+{
+	return es_mpmc_fifo_len(fifo) == 0;
+}
+
+#endif /* ifndef _ES_MPMC_FIFO_H_.2026-10-16 11:05:42 zcz */
+
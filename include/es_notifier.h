@@ -0,0 +1,175 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_notifier.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_NOTIFIER_H_
+#define _ES_NOTIFIER_H_
+#include <es_common.h>
+#include <es_list.h>
+#include <es_rcu.h>
+#include <pthread.h>
+
+/*
+ * Notifier chains, ported from the Linux Kernel: lists of callbacks
+ * which are called in priority order when an event is published.
+ *
+ * There are three kinds:
+ *
+ *  Atomic notifier chains: the chain is walked without any lock inside
+ *	a read-side section of the SRCU domain of the chain. Callbacks
+ *	must not block, since every unregister waits for the running
+ *	walks.
+ *  Blocking notifier chains: walked the same way, callbacks may block.
+ *	Writers take a mutex instead of a spin lock.
+ *  Raw notifier chains: no locking at all, the caller serializes.
+ *
+ * Registering and unregistering on atomic and blocking chains is safe
+ * against concurrent publishers, unregister returns once no walk can
+ * use the block any more, so it may be freed right away.
+ *
+ * Every chain is a grace period domain of its own: unregister waits only
+ * for the walks of its chain, so it must not run inside a walk of that
+ * chain, i.e. from one of its callbacks, which would wait for itself. A
+ * callback may unregister from other chains, and a sleeping blocking
+ * callback holds up the unregisters of its own chain only.
+ */
+
+struct es_notifier_block;
+
+typedef int (*es_notifier_fn_t)(struct es_notifier_block *nb,
+			unsigned long action, void *data);
+
+struct es_notifier_block {
+	es_notifier_fn_t notifier_call;
+	struct es_list_head list;
+	int priority;	/* higher priorities are called first */
+};
+
+struct es_atomic_notifier_head {
+	unsigned int lock;	/* writer spin lock */
+	struct es_srcu_struct srcu;
+	struct es_list_head head;
+};
+
+struct es_blocking_notifier_head {
+	pthread_mutex_t lock;	/* writer lock */
+	struct es_srcu_struct srcu;
+	struct es_list_head head;
+};
+
+struct es_raw_notifier_head {
+	struct es_list_head head;
+};
+
+#define ES_ATOMIC_NOTIFIER_INIT(name) { \
+		.lock = 0, \
+		.srcu = ES_SRCU_INIT((name).srcu), \
+		.head = ES_LIST_HEAD_INIT((name).head) }
+#define ES_BLOCKING_NOTIFIER_INIT(name) { \
+		.lock = PTHREAD_MUTEX_INITIALIZER, \
+		.srcu = ES_SRCU_INIT((name).srcu), \
+		.head = ES_LIST_HEAD_INIT((name).head) }
+#define ES_RAW_NOTIFIER_INIT(name) { \
+		.head = ES_LIST_HEAD_INIT((name).head) }
+
+#define ES_ATOMIC_NOTIFIER_HEAD(name) \
+	struct es_atomic_notifier_head name = ES_ATOMIC_NOTIFIER_INIT(name)
+#define ES_BLOCKING_NOTIFIER_HEAD(name) \
+	struct es_blocking_notifier_head name = ES_BLOCKING_NOTIFIER_INIT(name)
+#define ES_RAW_NOTIFIER_HEAD(name) \
+	struct es_raw_notifier_head name = ES_RAW_NOTIFIER_INIT(name)
+
+static inline void INIT_ES_ATOMIC_NOTIFIER_HEAD(
+		struct es_atomic_notifier_head *nh)
+{
+	nh->lock = 0;
+	es_init_srcu_struct(&nh->srcu);
+	INIT_ES_LIST_HEAD(&nh->head);
+}
+
+static inline void INIT_ES_BLOCKING_NOTIFIER_HEAD(
+		struct es_blocking_notifier_head *nh)
+{
+	pthread_mutex_init(&nh->lock, NULL);
+	es_init_srcu_struct(&nh->srcu);
+	INIT_ES_LIST_HEAD(&nh->head);
+}
+
+static inline void INIT_ES_RAW_NOTIFIER_HEAD(struct es_raw_notifier_head *nh)
+{
+	INIT_ES_LIST_HEAD(&nh->head);
+}
+
+/* return values of the callbacks and of the call_chain functions */
+#define ES_NOTIFY_DONE		0x0000		/* don't care */
+#define ES_NOTIFY_OK		0x0001		/* suits me */
+#define ES_NOTIFY_STOP_MASK	0x8000		/* don't call further */
+#define ES_NOTIFY_BAD		(ES_NOTIFY_STOP_MASK | 0x0002)
+						/* bad/veto action */
+#define ES_NOTIFY_STOP		(ES_NOTIFY_OK | ES_NOTIFY_STOP_MASK)
+						/* clean way to return from
+						 * the notifier and stop
+						 * further calls */
+
+/**
+ * es_notifier_from_errno - encode an error code as a notifier result
+ * @err: a negative error code, or 0
+ */
+static inline int es_notifier_from_errno(int err)
+{
+	if (err)
+		return ES_NOTIFY_STOP_MASK | (ES_NOTIFY_OK - err);
+	return ES_NOTIFY_OK;
+}
+
+/**
+ * es_notifier_to_errno - restore the error code of a notifier result
+ * @ret: the value returned by a call_chain function
+ */
+static inline int es_notifier_to_errno(int ret)
+{
+	ret &= ~ES_NOTIFY_STOP_MASK;
+	return ret > ES_NOTIFY_OK ? ES_NOTIFY_OK - ret : 0;
+}
+
+extern int es_atomic_notifier_chain_register(
+		struct es_atomic_notifier_head *nh, struct es_notifier_block *nb);
+extern int es_atomic_notifier_chain_unregister(
+		struct es_atomic_notifier_head *nh, struct es_notifier_block *nb);
+extern int es_atomic_notifier_call_chain(struct es_atomic_notifier_head *nh,
+		unsigned long val, void *v);
+
+extern int es_blocking_notifier_chain_register(
+		struct es_blocking_notifier_head *nh,
+		struct es_notifier_block *nb);
+extern int es_blocking_notifier_chain_unregister(
+		struct es_blocking_notifier_head *nh,
+		struct es_notifier_block *nb);
+extern int es_blocking_notifier_call_chain(
+		struct es_blocking_notifier_head *nh, unsigned long val, void *v);
+
+extern int es_raw_notifier_chain_register(struct es_raw_notifier_head *nh,
+		struct es_notifier_block *nb);
+extern int es_raw_notifier_chain_unregister(struct es_raw_notifier_head *nh,
+		struct es_notifier_block *nb);
+extern int es_raw_notifier_call_chain(struct es_raw_notifier_head *nh,
+		unsigned long val, void *v);
+
+#endif /* ifndef _ES_NOTIFIER_H_.2026-10-16 19:40:27 zcz */
+
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_pool.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_POOL_H_
+#define _ES_POOL_H_
+#include <es_common.h>
+#include <es_list.h>
+#include <pthread.h>
+#include <stdio.h>
+
+/*
+ * Fixed size object pool, a small slab allocator.
+ *
+ * Objects are carved from large slabs and never given back to the
+ * system before es_pool_destroy(); es_pool_set_arena() takes them from
+ * an es_arena instead of malloc(). Free objects are kept on a depot
+ * list under a mutex, linked through an es_list_head stored in the free
+ * object itself (or right behind it when there is a constructor, so the
+ * constructed state survives).
+ *
+ * Every thread has its own magazine of free objects per pool. Allocation
+ * and free work on the magazine without any lock; only when it runs
+ * empty or full a batch of objects moves from or to the depot. Objects
+ * may be freed by another thread than the one which allocated them.
+ *
+ * The optional constructor runs once per object, when its slab is
+ * carved. Objects must be freed in their constructed state.
+ *
+ * Each pool uses one pthread key.
+ */
+
+/* objects a magazine holds, half of them move to or from the depot */
+#ifndef ES_POOL_MAG_SIZE
+#define ES_POOL_MAG_SIZE	64
+#endif
+
+/* slab size, larger for objects which would not fit 8 times */
+#define ES_POOL_SLAB_SIZE	(64 * 1024)
+#define ES_POOL_SLAB_MIN_OBJS	8
+
+struct es_arena;
+
+typedef void (*es_pool_ctor_t)(void *obj, void *arg);
+
+struct es_pool_stats {
+	unsigned long allocs;		/* es_pool_alloc() calls served */
+	unsigned long frees;		/* es_pool_free() calls */
+	unsigned long refills;		/* magazine refills from the depot */
+	unsigned long flushes;		/* magazine flushes to the depot */
+	unsigned int slabs;		/* slabs allocated */
+	unsigned int objs_total;	/* objects carved */
+	unsigned int objs_depot;	/* free objects in the depot */
+	unsigned int objs_cached;	/* free objects in magazines */
+	unsigned int caches;		/* threads with a magazine */
+};
+
+struct es_pool {
+	const char *name;
+	unsigned int size;		/* object size asked for */
+	unsigned int align;		/* alignment of the objects */
+	unsigned int stride;		/* distance of two objects in a slab */
+	unsigned int link_off;		/* offset of the free list link */
+	unsigned int slab_size;
+	unsigned int objs_per_slab;
+	es_pool_ctor_t ctor;
+	void *ctor_arg;
+	struct es_arena *arena;		/* slabs come from here, or NULL */
+	pthread_key_t key;		/* the thread's struct es_pool_cache */
+	pthread_mutex_t lock;		/* protects everything below */
+	struct es_list_head free_list;	/* depot */
+	unsigned int nr_free;
+	struct es_list_head slabs;
+	struct es_list_head caches;	/* all magazines */
+	struct es_pool_stats dead;	/* counters of exited threads */
+	unsigned int nr_slabs;
+	unsigned long refills;
+	unsigned long flushes;
+};
+
+extern int es_pool_init(struct es_pool *pool, const char *name,
+				unsigned int size, unsigned int align,
+				es_pool_ctor_t ctor, void *ctor_arg);
+extern void es_pool_set_arena(struct es_pool *pool, struct es_arena *arena);
+extern void es_pool_destroy(struct es_pool *pool);
+extern void *es_pool_alloc(struct es_pool *pool);
+extern void es_pool_free(struct es_pool *pool, void *obj);
+extern void es_pool_flush_cache(struct es_pool *pool);
+extern void es_pool_get_stats(struct es_pool *pool, struct es_pool_stats *st);
+extern void es_pool_dump(struct es_pool *pool, FILE *fp);
+
+#endif /* ifndef _ES_POOL_H_.2026-10-16 20:10:41 zcz */
+
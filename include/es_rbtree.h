@@ -0,0 +1,386 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rbtree.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_RBTREE_H_
+#define _ES_RBTREE_H_
+#include <es_common.h>
+#include <es_atomic.h>
+
+/*
+ * Red-black trees, ported from the Linux kernel (include/linux/rbtree.h).
+ *
+ * Like es_list, the tree is intrusive: a struct es_rb_node is embedded
+ * in the user's structure and es_rb_entry() gets back from it. The tree
+ * does not know about keys; searching and inserting are done by the
+ * user walking the tree, which gives the compiler the comparison inline:
+ *
+ *	struct es_rb_node **link = &root->rb_node, *parent = NULL;
+ *
+ *	while (*link) {
+ *		parent = *link;
+ *		if (key < es_rb_entry(parent, struct obj, node)->key)
+ *			link = &parent->rb_left;
+ *		else
+ *			link = &parent->rb_right;
+ *	}
+ *	es_rb_link_node(&obj->node, parent, link);
+ *	es_rb_insert_color(&obj->node, root);
+ *
+ * es_rb_add(), es_rb_find() and friends wrap those loops for a less or
+ * cmp callback.
+ *
+ * The es_rb_root_cached variant also keeps the leftmost node, so the
+ * smallest element is found in O(1), e.g. for timers or schedulers.
+ * Augmented trees, which keep per subtree data up to date through the
+ * rotations, are in es_rbtree_augmented.h; es_interval_tree.h builds an
+ * interval tree on them.
+ */
+
+/* the color lives in the low bit of the parent pointer, hence the alignment */
+struct es_rb_node {
+	unsigned long  __rb_parent_color;
+	struct es_rb_node *rb_right;
+	struct es_rb_node *rb_left;
+} __attribute__((aligned(sizeof(long))));
+
+struct es_rb_root {
+	struct es_rb_node *rb_node;
+};
+
+/*
+ * Leftmost-cached rbtrees.
+ *
+ * We do not cache the rightmost node based on footprint
+ * size vs number of potential users that could benefit
+ * from O(1) es_rb_last(). Just not worth it, users that want
+ * this feature can always implement the logic explicitly.
+ * Furthermore, users that want to cache both pointers may
+ * find it a bit asymmetric, but that's ok.
+ */
+struct es_rb_root_cached {
+	struct es_rb_root rb_root;
+	struct es_rb_node *rb_leftmost;
+};
+
+#define es_rb_parent(r)   ((struct es_rb_node *)((r)->__rb_parent_color & ~3))
+
+#define ES_RB_ROOT	(struct es_rb_root) { NULL, }
+#define ES_RB_ROOT_CACHED (struct es_rb_root_cached) { {NULL, }, NULL }
+#define	es_rb_entry(ptr, type, member) container_of(ptr, type, member)
+
+#define ES_RB_EMPTY_ROOT(root)  (ES_READ_ONCE((root)->rb_node) == NULL)
+
+/* 'empty' nodes are nodes that are known not to be inserted in an rbtree */
+#define ES_RB_EMPTY_NODE(node)  \
+	((node)->__rb_parent_color == (unsigned long)(node))
+#define ES_RB_CLEAR_NODE(node)  \
+	((node)->__rb_parent_color = (unsigned long)(node))
+
+extern void es_rb_insert_color(struct es_rb_node *node,
+				struct es_rb_root *root);
+extern void es_rb_erase(struct es_rb_node *node, struct es_rb_root *root);
+
+/* Find logical next and previous nodes in a tree */
+extern struct es_rb_node *es_rb_next(const struct es_rb_node *node);
+extern struct es_rb_node *es_rb_prev(const struct es_rb_node *node);
+extern struct es_rb_node *es_rb_first(const struct es_rb_root *root);
+extern struct es_rb_node *es_rb_last(const struct es_rb_root *root);
+
+/* Postorder iteration - always visit the parent after its children */
+extern struct es_rb_node *es_rb_first_postorder(const struct es_rb_root *root);
+extern struct es_rb_node *es_rb_next_postorder(const struct es_rb_node *node);
+
+/* Fast replacement of a single node without remove/rebalance/add/rebalance */
+extern void es_rb_replace_node(struct es_rb_node *victim,
+				struct es_rb_node *new,
+				struct es_rb_root *root);
+
+static inline void es_rb_link_node(struct es_rb_node *node,
+				struct es_rb_node *parent,
+				struct es_rb_node **rb_link)
+{
+	node->__rb_parent_color = (unsigned long)parent;
+	node->rb_left = node->rb_right = NULL;
+
+	*rb_link = node;
+}
+
+#define es_rb_entry_safe(ptr, type, member) \
+	({ typeof(ptr) ____ptr = (ptr); \
+	   ____ptr ? es_rb_entry(____ptr, type, member) : NULL; \
+	})
+
+/**
+ * es_rbtree_postorder_for_each_entry_safe - iterate in post-order over
+ * es_rb_root of given type allowing the backing memory of @pos to be
+ * invalidated
+ *
+ * @pos:	the 'type *' to use as a loop cursor.
+ * @n:		another 'type *' to use as temporary storage
+ * @root:	'es_rb_root *' of the rbtree.
+ * @field:	the name of the es_rb_node field within 'type'.
+ *
+ * es_rbtree_postorder_for_each_entry_safe() provides a similar guarantee
+ * as es_list_for_each_entry_safe() and allows the iteration to continue
+ * independent of changes to @pos by the body of the loop.
+ *
+ * Note, however, that it cannot handle other modifications that re-order
+ * the rbtree it is iterating over. This includes calling es_rb_erase()
+ * on @pos, as es_rb_erase() may rebalance the tree, causing us to miss
+ * some nodes.
+ */
+#define es_rbtree_postorder_for_each_entry_safe(pos, n, root, field) \
+	for (pos = es_rb_entry_safe(es_rb_first_postorder(root), \
+			typeof(*pos), field); \
+	     pos && ({ n = es_rb_entry_safe(es_rb_next_postorder(&pos->field), \
+			typeof(*pos), field); 1; }); \
+	     pos = n)
+
+/* Same as es_rb_first(), but O(1) */
+#define es_rb_first_cached(root) (root)->rb_leftmost
+
+static inline void es_rb_insert_color_cached(struct es_rb_node *node,
+				struct es_rb_root_cached *root,
+				bool leftmost)
+{
+	if (leftmost)
+		root->rb_leftmost = node;
+	es_rb_insert_color(node, &root->rb_root);
+}
+
+static inline struct es_rb_node *
+es_rb_erase_cached(struct es_rb_node *node, struct es_rb_root_cached *root)
+{
+	struct es_rb_node *leftmost = NULL;
+
+	if (root->rb_leftmost == node)
+		leftmost = root->rb_leftmost = es_rb_next(node);
+
+	es_rb_erase(node, &root->rb_root);
+
+	return leftmost;
+}
+
+static inline void es_rb_replace_node_cached(struct es_rb_node *victim,
+				struct es_rb_node *new,
+				struct es_rb_root_cached *root)
+{
+	if (root->rb_leftmost == victim)
+		root->rb_leftmost = new;
+	es_rb_replace_node(victim, new, &root->rb_root);
+}
+
+/*
+ * The below helper functions use 2 operators with 3 different
+ * calling conventions. The operators are related like:
+ *
+ *	comp(a->key,b) < 0  := less(a,b)
+ *	comp(a->key,b) > 0  := less(b,a)
+ *	comp(a->key,b) == 0 := !less(a,b) && !less(b,a)
+ *
+ * If these operators define a partial order on the elements we make no
+ * guarantee on which of the elements matching the key is found. See
+ * es_rb_find().
+ *
+ * The reason for this is to allow the find() interface without requiring
+ * an on-stack dummy object, which might not be feasible due to object
+ * size.
+ */
+
+/**
+ * es_rb_add_cached() - insert @node into the leftmost cached tree @tree
+ * @node: node to insert
+ * @tree: leftmost cached tree to insert @node into
+ * @less: operator defining the (partial) node order
+ *
+ * Returns @node when it is the new leftmost, or NULL.
+ */
+static inline struct es_rb_node *
+es_rb_add_cached(struct es_rb_node *node, struct es_rb_root_cached *tree,
+		bool (*less)(struct es_rb_node *, const struct es_rb_node *))
+{
+	struct es_rb_node **link = &tree->rb_root.rb_node;
+	struct es_rb_node *parent = NULL;
+	bool leftmost = es_true;
+
+	while (*link) {
+		parent = *link;
+		if (less(node, parent)) {
+			link = &parent->rb_left;
+		} else {
+			link = &parent->rb_right;
+			leftmost = es_false;
+		}
+	}
+
+	es_rb_link_node(node, parent, link);
+	es_rb_insert_color_cached(node, tree, leftmost);
+
+	return leftmost ? node : NULL;
+}
+
+/**
+ * es_rb_add() - insert @node into @tree
+ * @node: node to insert
+ * @tree: tree to insert @node into
+ * @less: operator defining the (partial) node order
+ */
+static inline void
+es_rb_add(struct es_rb_node *node, struct es_rb_root *tree,
+		bool (*less)(struct es_rb_node *, const struct es_rb_node *))
+{
+	struct es_rb_node **link = &tree->rb_node;
+	struct es_rb_node *parent = NULL;
+
+	while (*link) {
+		parent = *link;
+		if (less(node, parent))
+			link = &parent->rb_left;
+		else
+			link = &parent->rb_right;
+	}
+
+	es_rb_link_node(node, parent, link);
+	es_rb_insert_color(node, tree);
+}
+
+/**
+ * es_rb_find_add() - find equivalent @node in @tree, or add @node
+ * @node: node to look-for / insert
+ * @tree: tree to search / modify
+ * @cmp: operator defining the node order
+ *
+ * Returns the es_rb_node matching @node, or NULL when no match is found
+ * and @node is inserted.
+ */
+static inline struct es_rb_node *
+es_rb_find_add(struct es_rb_node *node, struct es_rb_root *tree,
+		int (*cmp)(struct es_rb_node *, const struct es_rb_node *))
+{
+	struct es_rb_node **link = &tree->rb_node;
+	struct es_rb_node *parent = NULL;
+	int c;
+
+	while (*link) {
+		parent = *link;
+		c = cmp(node, parent);
+
+		if (c < 0)
+			link = &parent->rb_left;
+		else if (c > 0)
+			link = &parent->rb_right;
+		else
+			return parent;
+	}
+
+	es_rb_link_node(node, parent, link);
+	es_rb_insert_color(node, tree);
+	return NULL;
+}
+
+/**
+ * es_rb_find() - find @key in tree @tree
+ * @key: key to match
+ * @tree: tree to search
+ * @cmp: operator defining the node order
+ *
+ * Returns the es_rb_node matching @key or NULL.
+ */
+static inline struct es_rb_node *
+es_rb_find(const void *key, const struct es_rb_root *tree,
+		int (*cmp)(const void *key, const struct es_rb_node *))
+{
+	struct es_rb_node *node = tree->rb_node;
+
+	while (node) {
+		int c = cmp(key, node);
+
+		if (c < 0)
+			node = node->rb_left;
+		else if (c > 0)
+			node = node->rb_right;
+		else
+			return node;
+	}
+
+	return NULL;
+}
+
+/**
+ * es_rb_find_first() - find the first @key in @tree
+ * @key: key to match
+ * @tree: tree to search
+ * @cmp: operator defining node order
+ *
+ * Returns the leftmost node matching @key, or NULL.
+ */
+static inline struct es_rb_node *
+es_rb_find_first(const void *key, const struct es_rb_root *tree,
+		int (*cmp)(const void *key, const struct es_rb_node *))
+{
+	struct es_rb_node *node = tree->rb_node;
+	struct es_rb_node *match = NULL;
+
+	while (node) {
+		int c = cmp(key, node);
+
+		if (c <= 0) {
+			if (!c)
+				match = node;
+			node = node->rb_left;
+		} else if (c > 0) {
+			node = node->rb_right;
+		}
+	}
+
+	return match;
+}
+
+/**
+ * es_rb_next_match() - find the next @key in @tree
+ * @key: key to match
+ * @node: node to continue from
+ * @cmp: operator defining node order
+ *
+ * Returns the next node matching @key, or NULL.
+ */
+static inline struct es_rb_node *
+es_rb_next_match(const void *key, struct es_rb_node *node,
+		int (*cmp)(const void *key, const struct es_rb_node *))
+{
+	node = es_rb_next(node);
+	if (node && cmp(key, node))
+		node = NULL;
+	return node;
+}
+
+/**
+ * es_rb_for_each() - iterates a subtree matching @key
+ * @node: iterator
+ * @key: key to match
+ * @tree: tree to search
+ * @cmp: operator defining node order
+ */
+#define es_rb_for_each(node, key, tree, cmp) \
+	for ((node) = es_rb_find_first((key), (tree), (cmp)); \
+	     (node); (node) = es_rb_next_match((key), (node), (cmp)))
+
+#endif /* ifndef _ES_RBTREE_H_.2026-10-16 21:24:06 zcz */
+
@@ -0,0 +1,318 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rbtree_augmented.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_RBTREE_AUGMENTED_H_
+#define _ES_RBTREE_AUGMENTED_H_
+#include <es_rbtree.h>
+
+/*
+ * Please note - only struct es_rb_augment_callbacks and the prototypes
+ * for es_rb_insert_augmented() and es_rb_erase_augmented() are intended
+ * to be public. The rest are implementation details you are not expected
+ * to depend on.
+ *
+ * An augmented rbtree keeps, in every node, a value computed over the
+ * node's subtree (e.g. the largest interval end below it). The callbacks
+ * keep that value right through insertion, erase and the rotations.
+ */
+
+struct es_rb_augment_callbacks {
+	void (*propagate)(struct es_rb_node *node, struct es_rb_node *stop);
+	void (*copy)(struct es_rb_node *old, struct es_rb_node *new);
+	void (*rotate)(struct es_rb_node *old, struct es_rb_node *new);
+};
+
+extern void __es_rb_insert_augmented(struct es_rb_node *node,
+	struct es_rb_root *root,
+	void (*augment_rotate)(struct es_rb_node *old, struct es_rb_node *new));
+
+/*
+ * Fixup the rbtree and update the augmented information when rebalancing.
+ *
+ * On insertion, the user must update the augmented information on the
+ * path leading to the inserted node, then call es_rb_link_node() as
+ * usual and es_rb_insert_augmented() instead of the usual
+ * es_rb_insert_color() call. If es_rb_insert_augmented() rebalances the
+ * rbtree, it will callback into a user provided function to update the
+ * augmented information on the affected subtrees.
+ */
+static inline void
+es_rb_insert_augmented(struct es_rb_node *node, struct es_rb_root *root,
+		const struct es_rb_augment_callbacks *augment)
+{
+	__es_rb_insert_augmented(node, root, augment->rotate);
+}
+
+static inline void
+es_rb_insert_augmented_cached(struct es_rb_node *node,
+		struct es_rb_root_cached *root, bool newleft,
+		const struct es_rb_augment_callbacks *augment)
+{
+	if (newleft)
+		root->rb_leftmost = node;
+	es_rb_insert_augmented(node, &root->rb_root, augment);
+}
+
+/*
+ * Template for declaring augmented rbtree callbacks (generic case)
+ *
+ * RBSTATIC:    'static' or empty
+ * RBNAME:      name of the es_rb_augment_callbacks structure
+ * RBSTRUCT:    struct type of the tree nodes
+ * RBFIELD:     name of struct es_rb_node field within RBSTRUCT
+ * RBAUGMENTED: name of field within RBSTRUCT holding data for subtree
+ * RBCOMPUTE:   name of function that recomputes the RBAUGMENTED data
+ */
+#define ES_RB_DECLARE_CALLBACKS(RBSTATIC, RBNAME,				\
+			     RBSTRUCT, RBFIELD, RBAUGMENTED, RBCOMPUTE)	\
+static inline void							\
+RBNAME ## _propagate(struct es_rb_node *rb, struct es_rb_node *stop)	\
+{									\
+	while (rb != stop) {						\
+		RBSTRUCT *node = es_rb_entry(rb, RBSTRUCT, RBFIELD);	\
+		if (RBCOMPUTE(node, es_true))				\
+			break;						\
+		rb = es_rb_parent(&node->RBFIELD);			\
+	}								\
+}									\
+static inline void							\
+RBNAME ## _copy(struct es_rb_node *rb_old, struct es_rb_node *rb_new)	\
+{									\
+	RBSTRUCT *old = es_rb_entry(rb_old, RBSTRUCT, RBFIELD);		\
+	RBSTRUCT *new = es_rb_entry(rb_new, RBSTRUCT, RBFIELD);		\
+	new->RBAUGMENTED = old->RBAUGMENTED;				\
+}									\
+static void								\
+RBNAME ## _rotate(struct es_rb_node *rb_old, struct es_rb_node *rb_new)	\
+{									\
+	RBSTRUCT *old = es_rb_entry(rb_old, RBSTRUCT, RBFIELD);		\
+	RBSTRUCT *new = es_rb_entry(rb_new, RBSTRUCT, RBFIELD);		\
+	new->RBAUGMENTED = old->RBAUGMENTED;				\
+	RBCOMPUTE(old, es_false);					\
+}									\
+RBSTATIC const struct es_rb_augment_callbacks RBNAME = {		\
+	.propagate = RBNAME ## _propagate,				\
+	.copy = RBNAME ## _copy,					\
+	.rotate = RBNAME ## _rotate					\
+};
+
+/*
+ * Template for declaring augmented rbtree callbacks,
+ * computing RBAUGMENTED scalar as max(RBCOMPUTE(node)) for all subtree nodes.
+ *
+ * RBSTATIC:    'static' or empty
+ * RBNAME:      name of the es_rb_augment_callbacks structure
+ * RBSTRUCT:    struct type of the tree nodes
+ * RBFIELD:     name of struct es_rb_node field within RBSTRUCT
+ * RBTYPE:      type of the RBAUGMENTED field
+ * RBAUGMENTED: name of RBTYPE field within RBSTRUCT holding data for subtree
+ * RBCOMPUTE:   name of function that returns the per-node RBTYPE scalar
+ */
+#define ES_RB_DECLARE_CALLBACKS_MAX(RBSTATIC, RBNAME, RBSTRUCT, RBFIELD,	      \
+				 RBTYPE, RBAUGMENTED, RBCOMPUTE)	      \
+static inline bool RBNAME ## _compute_max(RBSTRUCT *node, bool exit)	      \
+{									      \
+	RBSTRUCT *child;						      \
+	RBTYPE max = RBCOMPUTE(node);					      \
+	if (node->RBFIELD.rb_left) {					      \
+		child = es_rb_entry(node->RBFIELD.rb_left, RBSTRUCT, RBFIELD);\
+		if (child->RBAUGMENTED > max)				      \
+			max = child->RBAUGMENTED;			      \
+	}								      \
+	if (node->RBFIELD.rb_right) {					      \
+		child = es_rb_entry(node->RBFIELD.rb_right, RBSTRUCT, RBFIELD);\
+		if (child->RBAUGMENTED > max)				      \
+			max = child->RBAUGMENTED;			      \
+	}								      \
+	if (exit && node->RBAUGMENTED == max)				      \
+		return es_true;						      \
+	node->RBAUGMENTED = max;					      \
+	return es_false;						      \
+}									      \
+ES_RB_DECLARE_CALLBACKS(RBSTATIC, RBNAME,				      \
+		     RBSTRUCT, RBFIELD, RBAUGMENTED, RBNAME ## _compute_max)
+
+
+#define	ES_RB_RED		0
+#define	ES_RB_BLACK	1
+
+#define __es_rb_parent(pc)    ((struct es_rb_node *)(pc & ~3))
+
+#define __es_rb_color(pc)     ((pc) & 1)
+#define __es_rb_is_black(pc)  __es_rb_color(pc)
+#define __es_rb_is_red(pc)    (!__es_rb_color(pc))
+#define es_rb_color(rb)       __es_rb_color((rb)->__rb_parent_color)
+#define es_rb_is_red(rb)      __es_rb_is_red((rb)->__rb_parent_color)
+#define es_rb_is_black(rb)    __es_rb_is_black((rb)->__rb_parent_color)
+
+static inline void es_rb_set_parent(struct es_rb_node *rb,
+				struct es_rb_node *p)
+{
+	rb->__rb_parent_color = es_rb_color(rb) + (unsigned long)p;
+}
+
+static inline void es_rb_set_parent_color(struct es_rb_node *rb,
+				struct es_rb_node *p, int color)
+{
+	rb->__rb_parent_color = (unsigned long)p + color;
+}
+
+static inline void
+__es_rb_change_child(struct es_rb_node *old, struct es_rb_node *new,
+		struct es_rb_node *parent, struct es_rb_root *root)
+{
+	if (parent) {
+		if (parent->rb_left == old)
+			ES_WRITE_ONCE(parent->rb_left, new);
+		else
+			ES_WRITE_ONCE(parent->rb_right, new);
+	} else
+		ES_WRITE_ONCE(root->rb_node, new);
+}
+
+extern void __es_rb_erase_color(struct es_rb_node *parent,
+	struct es_rb_root *root,
+	void (*augment_rotate)(struct es_rb_node *old, struct es_rb_node *new));
+
+static inline struct es_rb_node *
+__es_rb_erase_augmented(struct es_rb_node *node, struct es_rb_root *root,
+		const struct es_rb_augment_callbacks *augment)
+{
+	struct es_rb_node *child = node->rb_right;
+	struct es_rb_node *tmp = node->rb_left;
+	struct es_rb_node *parent, *rebalance;
+	unsigned long pc;
+
+	if (!tmp) {
+		/*
+		 * Case 1: node to erase has no more than 1 child (easy!)
+		 *
+		 * Note that if there is one child it must be red due to 5)
+		 * and node must be black due to 4). We adjust colors locally
+		 * so as to bypass __es_rb_erase_color() later on.
+		 */
+		pc = node->__rb_parent_color;
+		parent = __es_rb_parent(pc);
+		__es_rb_change_child(node, child, parent, root);
+		if (child) {
+			child->__rb_parent_color = pc;
+			rebalance = NULL;
+		} else
+			rebalance = __es_rb_is_black(pc) ? parent : NULL;
+		tmp = parent;
+	} else if (!child) {
+		/* Still case 1, but this time the child is node->rb_left */
+		tmp->__rb_parent_color = pc = node->__rb_parent_color;
+		parent = __es_rb_parent(pc);
+		__es_rb_change_child(node, tmp, parent, root);
+		rebalance = NULL;
+		tmp = parent;
+	} else {
+		struct es_rb_node *successor = child, *child2;
+
+		tmp = child->rb_left;
+		if (!tmp) {
+			/*
+			 * Case 2: node's successor is its right child
+			 *
+			 *    (n)          (s)
+			 *    / \          / \
+			 *  (x) (s)  ->  (x) (c)
+			 *        \
+			 *        (c)
+			 */
+			parent = successor;
+			child2 = successor->rb_right;
+
+			augment->copy(node, successor);
+		} else {
+			/*
+			 * Case 3: node's successor is leftmost under
+			 * node's right child subtree
+			 *
+			 *    (n)          (s)
+			 *    / \          / \
+			 *  (x) (y)  ->  (x) (y)
+			 *      /            /
+			 *    (p)          (p)
+			 *    /            /
+			 *  (s)          (c)
+			 *    \
+			 *    (c)
+			 */
+			do {
+				parent = successor;
+				successor = tmp;
+				tmp = tmp->rb_left;
+			} while (tmp);
+			child2 = successor->rb_right;
+			ES_WRITE_ONCE(parent->rb_left, child2);
+			ES_WRITE_ONCE(successor->rb_right, child);
+			es_rb_set_parent(child, successor);
+
+			augment->copy(node, successor);
+			augment->propagate(parent, successor);
+		}
+
+		tmp = node->rb_left;
+		ES_WRITE_ONCE(successor->rb_left, tmp);
+		es_rb_set_parent(tmp, successor);
+
+		pc = node->__rb_parent_color;
+		tmp = __es_rb_parent(pc);
+		__es_rb_change_child(node, successor, tmp, root);
+
+		if (child2) {
+			es_rb_set_parent_color(child2, parent, ES_RB_BLACK);
+			rebalance = NULL;
+		} else {
+			rebalance = es_rb_is_black(successor) ? parent : NULL;
+		}
+		successor->__rb_parent_color = pc;
+		tmp = successor;
+	}
+
+	augment->propagate(tmp, NULL);
+	return rebalance;
+}
+
+static inline void
+es_rb_erase_augmented(struct es_rb_node *node, struct es_rb_root *root,
+		const struct es_rb_augment_callbacks *augment)
+{
+	struct es_rb_node *rebalance = __es_rb_erase_augmented(node, root,
+				augment);
+
+	if (rebalance)
+		__es_rb_erase_color(rebalance, root, augment->rotate);
+}
+
+static inline void
+es_rb_erase_augmented_cached(struct es_rb_node *node,
+		struct es_rb_root_cached *root,
+		const struct es_rb_augment_callbacks *augment)
+{
+	if (root->rb_leftmost == node)
+		root->rb_leftmost = es_rb_next(node);
+	es_rb_erase_augmented(node, &root->rb_root, augment);
+}
+
+#endif /* ifndef _ES_RBTREE_AUGMENTED_H_.2026-10-16 21:31:52 zcz */
+
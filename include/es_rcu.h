@@ -0,0 +1,253 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rcu.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_RCU_H_
+#define _ES_RCU_H_
+#include <es_common.h>
+#include <es_atomic.h>
+#include <es_list.h>
+#include <pthread.h>
+
+/*
+ * Read-copy-update for user space, in the spirit of the kernel's RCU and
+ * of liburcu's memory barrier flavor.
+ *
+ * A reader brackets its accesses with es_rcu_read_lock() and
+ * es_rcu_read_unlock(). That stores a snapshot of the global grace period
+ * counter into a per-thread word and issues one barrier: no shared
+ * cache line is written and no lock is taken, so readers on many threads
+ * do not slow each other down. Read-side sections nest.
+ *
+ * A writer unlinks an object, calls es_synchronize_rcu(), which returns
+ * once every reader that could still see the object has left its
+ * read-side section, and frees the object. es_synchronize_rcu() sleeps
+ * and must not be called inside any read-side section, it would wait for
+ * its own caller; it fails with ES_FAIL there instead of hanging. All
+ * users share this one domain, so a reader which sleeps holds up every
+ * grace period in the process.
+ *
+ * Threads register themselves on their first es_rcu_read_lock() and
+ * unregister when they exit.
+ *
+ * Sleepable RCU, after the kernel's SRCU, gives a user a grace period
+ * domain of its own: struct es_srcu_struct. Its readers cost an atomic
+ * add on a counter of the domain instead of a per-thread store, in
+ * exchange es_synchronize_srcu() only waits for the readers of that
+ * domain. A reader may sleep, or synchronize other domains, without
+ * stalling anyone else.
+ */
+
+/* low bits: read-side nesting, one high bit: grace period phase */
+#define ES_RCU_GP_COUNT		1UL
+#define ES_RCU_GP_CTR_PHASE	(1UL << (sizeof(unsigned long) << 2))
+#define ES_RCU_GP_CTR_NEST_MASK	(ES_RCU_GP_CTR_PHASE - 1)
+
+struct es_rcu_reader {
+	unsigned long ctr;		/* gp counter snapshot + nesting */
+	struct es_list_head node;	/* in the list of reader threads */
+	bool registered;
+};
+
+extern unsigned long es_rcu_gp_ctr;
+extern __thread struct es_rcu_reader __es_rcu_reader;
+
+extern void __es_rcu_register_thread(void);
+extern int es_synchronize_rcu(void);
+
+/**
+ * es_rcu_read_lock_held - is the calling thread in a read-side section?
+ */
+static inline bool es_rcu_read_lock_held(void)
+{
+	return !!(__es_rcu_reader.ctr & ES_RCU_GP_CTR_NEST_MASK);
+}
+
+/**
+ * es_rcu_read_lock - mark the beginning of a read-side critical section
+ *
+ * Objects read through es_rcu_dereference() stay valid until the
+ * matching es_rcu_read_unlock().
+ */
+static inline void es_rcu_read_lock(void)
+{
+	struct es_rcu_reader *r = &__es_rcu_reader;
+	unsigned long tmp = r->ctr;
+
+	if (!(tmp & ES_RCU_GP_CTR_NEST_MASK)) {
+		if (!r->registered)
+			__es_rcu_register_thread();
+		ES_WRITE_ONCE(r->ctr, ES_READ_ONCE(es_rcu_gp_ctr));
+		/* publish the snapshot before reading any protected data */
+		es_smp_mb();
+	} else {
+		ES_WRITE_ONCE(r->ctr, tmp + ES_RCU_GP_COUNT);
+	}
+}
+
+/**
+ * es_rcu_read_unlock - mark the end of a read-side critical section
+ */
+static inline void es_rcu_read_unlock(void)
+{
+	struct es_rcu_reader *r = &__es_rcu_reader;
+
+	/* finish reading protected data before leaving */
+	es_smp_mb();
+	ES_WRITE_ONCE(r->ctr, r->ctr - ES_RCU_GP_COUNT);
+}
+
+struct es_srcu_struct {
+	unsigned long idx;		/* the low bit picks readers[] */
+	unsigned long readers[2];	/* read-side sections per phase */
+	pthread_mutex_t lock;		/* serializes grace periods */
+};
+
+#define ES_SRCU_INIT(name) { \
+		.idx = 0, \
+		.readers = {0, 0}, \
+		.lock = PTHREAD_MUTEX_INITIALIZER }
+
+#define ES_DEFINE_SRCU(name) \
+	struct es_srcu_struct name = ES_SRCU_INIT(name)
+
+extern void es_synchronize_srcu(struct es_srcu_struct *sp);
+
+static inline void es_init_srcu_struct(struct es_srcu_struct *sp)
+{
+	sp->idx = 0;
+	sp->readers[0] = sp->readers[1] = 0;
+	pthread_mutex_init(&sp->lock, NULL);
+}
+
+/**
+ * es_srcu_read_lock - enter a read-side section of an SRCU domain
+ * @sp: the domain
+ *
+ * Returns the index to be passed to es_srcu_read_unlock(). Sections
+ * nest, also across domains.
+ */
+static inline int es_srcu_read_lock(struct es_srcu_struct *sp)
+{
+	int idx = ES_READ_ONCE(sp->idx) & 1;
+
+	es_atomic_fetch_add(&sp->readers[idx], 1);
+	/* count the reader before reading any protected data */
+	es_smp_mb();
+	return idx;
+}
+
+/**
+ * es_srcu_read_unlock - leave a read-side section of an SRCU domain
+ * @sp: the domain
+ * @idx: the return value of the matching es_srcu_read_lock()
+ */
+static inline void es_srcu_read_unlock(struct es_srcu_struct *sp, int idx)
+{
+	/* finish reading protected data before leaving */
+	es_smp_mb();
+	es_atomic_fetch_sub(&sp->readers[idx], 1);
+}
+
+/**
+ * es_rcu_dereference - fetch an RCU protected pointer
+ * @p: the pointer, read once
+ *
+ * The object is read after the pointer, pairs with
+ * es_rcu_assign_pointer().
+ */
+#define es_rcu_dereference(p)		es_smp_load_acquire(&(p))
+
+/**
+ * es_rcu_assign_pointer - publish an RCU protected pointer
+ * @p: the pointer to be set
+ * @v: the new value
+ *
+ * The object is initialized before it becomes visible to readers.
+ */
+#define es_rcu_assign_pointer(p, v)	es_smp_store_release(&(p), (v))
+
+/*
+ * RCU variants of the list functions. Writers still serialize among
+ * themselves, readers may walk the list meanwhile.
+ */
+static inline void __es_list_add_rcu(struct es_list_head *new,
+		struct es_list_head *prev, struct es_list_head *next)
+{
+	new->next = next;
+	new->prev = prev;
+	es_rcu_assign_pointer(prev->next, new);
+	next->prev = new;
+}
+
+/**
+ * es_list_add_rcu - add a new entry to rcu-protected list
+ * @new: new entry to be added
+ * @head: list head to add it after
+ */
+static inline void es_list_add_rcu(struct es_list_head *new,
+		struct es_list_head *head)
+{
+	__es_list_add_rcu(new, head, head->next);
+}
+
+/**
+ * es_list_add_tail_rcu - add a new entry to rcu-protected list
+ * @new: new entry to be added
+ * @head: list head to add it before
+ */
+static inline void es_list_add_tail_rcu(struct es_list_head *new,
+		struct es_list_head *head)
+{
+	__es_list_add_rcu(new, head->prev, head);
+}
+
+/**
+ * es_list_del_rcu - deletes entry from list without re-initialization
+ * @entry: the element to delete from the list.
+ *
+ * entry->next is left alone, a reader standing on the entry still finds
+ * its way back into the list. The entry may be reused or freed only
+ * after es_synchronize_rcu().
+ */
+static inline void es_list_del_rcu(struct es_list_head *entry)
+{
+	entry->next->prev = entry->prev;
+	ES_WRITE_ONCE(entry->prev->next, entry->next);
+	entry->prev = NULL;
+}
+
+/**
+ * es_list_for_each_entry_rcu - iterate over rcu list of given type
+ * @pos: the type * to use as a loop cursor.
+ * @head: the head for your list.
+ * @member: the name of the es_list_struct within the struct.
+ *
+ * Call it inside es_rcu_read_lock(), concurrent es_list_add_rcu() and
+ * es_list_del_rcu() are fine.
+ */
+#define es_list_for_each_entry_rcu(pos, head, member) \
+	for (pos = es_list_entry(es_rcu_dereference((head)->next), \
+			typeof(*pos), member); \
+		&pos->member != (head); \
+		pos = es_list_entry(es_rcu_dereference(pos->member.next), \
+			typeof(*pos), member))
+
+#endif /* ifndef _ES_RCU_H_.2026-10-16 19:32:05 zcz */
+
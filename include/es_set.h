@@ -0,0 +1,123 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_set.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_SET_H_
+#define _ES_SET_H_
+#include <es_common.h>
+#include <es_hmap.h>
+#include <stdint.h>
+
+/*
+ * Set of 32 bit integers (device ids, handles, ...) which picks its
+ * representation by its content:
+ *
+ *  ES_SET_BITMAP	one bit per possible id up to the largest one, when
+ *			the ids are dense enough that the bitmap is smaller
+ *			than a list of them
+ *  ES_SET_ARRAY	a sorted array, for up to ES_SET_ARRAY_MAX sparse ids
+ *  ES_SET_HASH		an es_hmap, for more sparse ids
+ *
+ * The representation follows adds and deletes with some hysteresis, and
+ * the result of a set operation gets the one that fits it. Union,
+ * intersection and difference of two bitmaps run 128 bits at a time,
+ * intersection and difference of sorted arrays compare blocks of 4 ids
+ * against 4 ids (SSE2 or NEON, a plain loop elsewhere).
+ *
+ * No locking inside.
+ */
+
+enum es_set_type {
+	ES_SET_ARRAY = 0,
+	ES_SET_BITMAP,
+	ES_SET_HASH,
+};
+
+/* sparse sets with more ids than this become hashes */
+#ifndef ES_SET_ARRAY_MAX
+#define ES_SET_ARRAY_MAX	4096
+#endif
+
+struct es_set {
+	enum es_set_type type;
+	unsigned int count;	/* number of ids */
+	union {
+		struct {
+			uint32_t *ids;	/* sorted ascending */
+			unsigned int cap;	/* room in ids */
+		} array;
+		struct {
+			uint64_t *words;	/* bit i: id i is in the set */
+			unsigned int nwords;
+		} bitmap;
+		struct {
+			struct es_hmap map;	/* ids as keys, no values */
+			uint32_t max;	/* bound of the largest id */
+		} hash;
+	};
+};
+
+typedef int (*es_set_fn)(uint32_t id, void *arg);
+
+extern void es_set_init(struct es_set *set);
+extern void es_set_destroy(struct es_set *set);
+extern void es_set_clear(struct es_set *set);
+extern int es_set_add(struct es_set *set, uint32_t id);
+extern int es_set_del(struct es_set *set, uint32_t id);
+extern bool es_set_contains(struct es_set *set, uint32_t id);
+extern int es_set_copy(struct es_set *dst, struct es_set *src);
+extern int es_set_union(struct es_set *dst, struct es_set *a,
+				struct es_set *b);
+extern int es_set_intersect(struct es_set *dst, struct es_set *a,
+				struct es_set *b);
+extern int es_set_diff(struct es_set *dst, struct es_set *a,
+				struct es_set *b);
+extern unsigned int es_set_to_array(struct es_set *set, uint32_t *ids,
+				unsigned int n);
+extern int es_set_for_each(struct es_set *set, es_set_fn fn, void *arg);
+
+/**
+ * es_set_count - returns the number of ids in the set
+ * @set: the set to be used.
+ */
+static inline unsigned int es_set_count(struct es_set *set)
+{
+	return set->count;
+}
+
+/**
+ * es_set_is_empty - returns true if the set is empty
+ * @set: the set to be used.
+ */
+static inline int es_set_is_empty(struct es_set *set)
+{
+	return set->count == 0;
+}
+
+/**
+ * es_set_type - returns the current representation of the set
+ * @set: the set to be used.
+ */
+static inline enum es_set_type es_set_type(struct es_set *set)
+{
+	return set->type;
+}
+
+#endif /* ifndef _ES_SET_H_.2026-10-16 19:03:44 zcz */
+
@@ -0,0 +1,145 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_spsc_fifo.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_SPSC_FIFO_H_
+#define _ES_SPSC_FIFO_H_
+#include <es_common.h>
+#include <es_atomic.h>
+
+/*
+ * Lock-free single-producer/single-consumer byte FIFO.
+ *
+ * Same semantic as struct es_fifo, but each index lives on its own
+ * cache line together with a private copy of the other side's index.
+ * The producer only re-reads @out (and the consumer @in) when its
+ * cached copy says the fifo looks full (empty), so the hot path does
+ * not bounce cache lines between the two cores.
+ *
+ * Exactly one thread may call the producer functions (es_spsc_fifo_in,
+ * es_spsc_fifo_avail) and exactly one thread the consumer functions
+ * (es_spsc_fifo_out, es_spsc_fifo_out_peek, es_spsc_fifo_len).
+ *
+ * Note: the structure is cache line aligned, allocate it statically or
+ * with aligned_alloc()/posix_memalign() to keep the indices apart.
+ */
+struct es_spsc_fifo {
+	/* read-only after init, shared by both sides */
+	unsigned char *buffer;	/* the buffer holding the data */
+	unsigned int mask;	/* size of the buffer minus one */
+
+	/* producer side */
+	unsigned int in __es_cacheline_aligned;	/* written by producer only */
+	unsigned int out_cache;			/* producer's copy of out */
+
+	/* consumer side */
+	unsigned int out __es_cacheline_aligned;	/* written by consumer only */
+	unsigned int in_cache;			/* consumer's copy of in */
+};
+
+/**
+ * DEFINE_ES_SPSC_FIFO - macro to define and initialize a es_spsc_fifo
+ * @name: name of the declared es_spsc_fifo datatype
+ * @size: size of the fifo buffer. Must be a power of two.
+ */
+#define DEFINE_ES_SPSC_FIFO(name, size) \
+	unsigned char name##es_spsc_fifo_buffer[size]; \
+	struct es_spsc_fifo name = { \
+		.buffer	= name##es_spsc_fifo_buffer, \
+		.mask	= (size) - 1, \
+	}
+
+extern int es_spsc_fifo_init(struct es_spsc_fifo *fifo, void *buffer,
+				unsigned int size);
+extern int es_spsc_fifo_alloc(struct es_spsc_fifo *fifo, unsigned int size);
+extern void es_spsc_fifo_free(struct es_spsc_fifo *fifo);
+extern unsigned int es_spsc_fifo_in(struct es_spsc_fifo *fifo,
+				const void *from, unsigned int len);
+extern unsigned int es_spsc_fifo_out(struct es_spsc_fifo *fifo,
+				void *to, unsigned int len);
+extern unsigned int es_spsc_fifo_out_peek(struct es_spsc_fifo *fifo,
+				void *to, unsigned int len);
+
+/**
+ * es_spsc_fifo_size - returns the size of the fifo in bytes
+ * @fifo: the fifo to be used.
+ */
+static inline unsigned int es_spsc_fifo_size(struct es_spsc_fifo *fifo)
+{
+	return fifo->mask + 1;
+}
+
+/**
+ * es_spsc_fifo_len - returns the number of used bytes in the FIFO
+ * @fifo: the fifo to be used.
+ *
+ * Exact when called by the consumer, a snapshot otherwise.
+ */
+static inline unsigned int es_spsc_fifo_len(struct es_spsc_fifo *fifo)
+{
+	unsigned int out = ES_READ_ONCE(fifo->out);
+
+	return es_smp_load_acquire(&fifo->in) - out;
+}
+
+/**
+ * es_spsc_fifo_avail - returns the number of bytes available in the FIFO
+ * @fifo: the fifo to be used.
+ *
+ * Exact when called by the producer, a snapshot otherwise.
+ */
+static inline unsigned int es_spsc_fifo_avail(struct es_spsc_fifo *fifo)
+{
+	unsigned int in = ES_READ_ONCE(fifo->in);
+
+	return es_spsc_fifo_size(fifo) - (in - es_smp_load_acquire(&fifo->out));
+}
+
+/**
+ * es_spsc_fifo_is_empty - returns true if the fifo is empty
+ * @fifo: the fifo to be used.
+ */
+static inline int es_spsc_fifo_is_empty(struct es_spsc_fifo *fifo)
+{
+	return es_spsc_fifo_len(fifo) == 0;
+}
+
+/**
+ * es_spsc_fifo_is_full - returns true if the fifo is full
+ * @fifo: the fifo to be used.
+ */
+static inline int es_spsc_fifo_is_full(struct es_spsc_fifo *fifo)
+{
+	return es_spsc_fifo_avail(fifo) == 0;
+}
+
+/**
+ * es_spsc_fifo_reset - removes the entire FIFO contents
+ * @fifo: the fifo to be emptied.
+ *
+ * Note: neither producer nor consumer may be active while calling this.
+ */
+static inline void es_spsc_fifo_reset(struct es_spsc_fifo *fifo)
+{
+	fifo->in = fifo->out = 0;
+	fifo->in_cache = fifo->out_cache = 0;
+}
+
+#endif /* ifndef _ES_SPSC_FIFO_H_.2026-10-16 10:20:37 zcz */
+
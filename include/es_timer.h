@@ -0,0 +1,142 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_timer.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_TIMER_H_
+#define _ES_TIMER_H_
+#include <es_common.h>
+#include <es_list.h>
+#include <stdint.h>
+
+/*
+ * Hierarchical timing wheel, after the classic cascading timer wheel of
+ * the Linux kernel.
+ *
+ * Time is counted in ticks of whatever unit the user picks. The wheel
+ * has five levels of es_list_head buckets: 256 slots of one tick, then
+ * 4 levels of 64 slots, each slot of a level spanning a whole turn of
+ * the level below. A timer is put into the bucket of the level its
+ * expiry falls in, so adding, cancelling and modifying a timer is a list
+ * operation, O(1), whatever the number of timers.
+ *
+ * Cascading is lazy: a bucket of an upper level is only broken up into
+ * the level below when the wheel gets to it, once every 256, 16K, 1M
+ * and 64M ticks. Timers cancelled or modified before that (the common
+ * fate of timeouts) are never touched by the wheel at all. Expiries past
+ * 2^32 ticks are parked in the last level and cascaded again later.
+ *
+ * Expired timers are handed out in batches, the whole bucket of a tick
+ * at once, see es_timer_wheel_advance(). Idle stretches of the wheel are
+ * skipped with per level occupancy bitmaps.
+ *
+ * A wheel is not thread safe, it is meant to be driven by one event
+ * loop. es_timer_del() does not need the wheel.
+ */
+
+#define ES_TVR_BITS	8
+#define ES_TVN_BITS	6
+#define ES_TVR_SIZE	(1 << ES_TVR_BITS)
+#define ES_TVN_SIZE	(1 << ES_TVN_BITS)
+#define ES_TVR_MASK	(ES_TVR_SIZE - 1)
+#define ES_TVN_MASK	(ES_TVN_SIZE - 1)
+#define ES_TVN_LEVELS	4
+
+struct es_timer;
+
+typedef void (*es_timer_fn_t)(struct es_timer *timer);
+
+/* gets the expired timers of one tick, see es_timer_wheel_advance() */
+typedef void (*es_timer_batch_fn_t)(struct es_list_head *expired, void *arg);
+
+struct es_timer {
+	struct es_list_head entry;	/* in a bucket, empty when idle */
+	uint64_t expires;		/* tick to expire at */
+	es_timer_fn_t function;		/* for es_timer_wheel_run() */
+};
+
+struct es_timer_wheel {
+	uint64_t now;			/* next tick to be processed */
+	uint64_t tv1_map[ES_TVR_SIZE / 64];
+	uint64_t tvn_map[ES_TVN_LEVELS];
+	struct es_list_head tv1[ES_TVR_SIZE];
+	struct es_list_head tvn[ES_TVN_LEVELS][ES_TVN_SIZE];
+};
+
+extern void es_timer_wheel_init(struct es_timer_wheel *wheel, uint64_t now);
+extern int es_timer_add(struct es_timer_wheel *wheel, struct es_timer *timer,
+				uint64_t expires);
+extern int es_timer_mod(struct es_timer_wheel *wheel, struct es_timer *timer,
+				uint64_t expires);
+extern void es_timer_wheel_advance(struct es_timer_wheel *wheel, uint64_t now,
+				es_timer_batch_fn_t fn, void *arg);
+extern unsigned long es_timer_wheel_run(struct es_timer_wheel *wheel,
+				uint64_t now);
+extern uint64_t es_timer_wheel_next(struct es_timer_wheel *wheel);
+
+/**
+ * es_timer_setup - initialize a timer
+ * @timer: the timer to be initialized
+ * @function: called by es_timer_wheel_run() on expiry, may be NULL
+ */
+static inline void es_timer_setup(struct es_timer *timer,
+				es_timer_fn_t function)
+{
+	INIT_ES_LIST_HEAD(&timer->entry);
+	timer->expires = 0;
+	timer->function = function;
+}
+
+/**
+ * es_timer_pending - is a timer armed?
+ * @timer: the timer to be checked
+ *
+ * A timer handed out by es_timer_wheel_advance() stays pending while it
+ * is on the expired list.
+ */
+static inline bool es_timer_pending(const struct es_timer *timer)
+{
+	return !es_list_empty(&timer->entry);
+}
+
+/**
+ * es_timer_del - cancel a timer
+ * @timer: the timer to be cancelled
+ *
+ * O(1), the wheel is not touched. Return 1 if the timer was pending,
+ * 0 otherwise.
+ */
+static inline int es_timer_del(struct es_timer *timer)
+{
+	if (!es_timer_pending(timer))
+		return 0;
+	es_list_del_init(&timer->entry);
+	return 1;
+}
+
+/**
+ * es_timer_wheel_now - the next tick a wheel will process
+ * @wheel: the wheel to be used.
+ */
+static inline uint64_t es_timer_wheel_now(const struct es_timer_wheel *wheel)
+{
+	return wheel->now;
+}
+
+#endif /* ifndef _ES_TIMER_H_.2026-10-16 21:58:36 zcz */
+
@@ -0,0 +1,82 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_wait_fifo.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_WAIT_FIFO_H_
+#define _ES_WAIT_FIFO_H_
+#include <es_fifo.h>
+
+/*
+ * Optional wait layer on top of struct es_fifo.
+ *
+ * A sleeping side announces itself in a waiter counter before it
+ * re-checks the fifo and blocks on a futex word; the other side only
+ * issues the wake-up syscall when that counter is non zero, so the
+ * non-blocking fast path stays as cheap as es_fifo_in()/es_fifo_out().
+ *
+ * With ES_WAIT_FIFO_F_EVENTFD an eventfd is kept readable whenever the
+ * consumer has run out of data and new data was published, so the fifo
+ * can be watched by poll()/epoll() like any other fd.
+ *
+ * The one reader / one writer rule of es_fifo still applies.
+ */
+struct es_wait_fifo {
+	struct es_fifo fifo;		/* the fifo, allocate it as usual */
+	unsigned int rd_waiters;	/* consumers sleeping for data */
+	unsigned int wr_waiters;	/* producers sleeping for space */
+	unsigned int rd_seq;		/* futex word, bumped to wake readers */
+	unsigned int wr_seq;		/* futex word, bumped to wake writers */
+	unsigned int fd_armed;		/* consumer waits on the eventfd */
+	int efd;			/* eventfd or -1 */
+};
+
+/*
+ * es_wait_fifo_init flags
+ */
+#define ES_WAIT_FIFO_F_EVENTFD	(1U << 0)	/* create a pollable eventfd */
+
+extern int es_wait_fifo_init(struct es_wait_fifo *wf, unsigned int flags);
+extern void es_wait_fifo_exit(struct es_wait_fifo *wf);
+extern int es_wait_fifo_wait_data(struct es_wait_fifo *wf, unsigned int len,
+				int timeout_ms);
+extern int es_wait_fifo_wait_space(struct es_wait_fifo *wf, unsigned int len,
+				int timeout_ms);
+extern void es_wait_fifo_wake_readers(struct es_wait_fifo *wf);
+extern void es_wait_fifo_wake_writers(struct es_wait_fifo *wf);
+extern int es_wait_fifo_arm_fd(struct es_wait_fifo *wf);
+extern unsigned int es_fifo_in_wait(struct es_wait_fifo *wf,
+				const void *from, unsigned int len, int timeout_ms);
+extern unsigned int es_fifo_out_wait(struct es_wait_fifo *wf,
+				void *to, unsigned int len, int timeout_ms);
+
+/**
+ * es_wait_fifo_fd - returns the pollable fd of the fifo
+ * @wf: the fifo to be used.
+ *
+ * The fd becomes readable when data is published after the consumer
+ * called es_wait_fifo_arm_fd(). Returns -1 if the fifo was initialized
+ * without ES_WAIT_FIFO_F_EVENTFD.
+ */
+static inline int es_wait_fifo_fd(struct es_wait_fifo *wf)
+{
+	return wf->efd;
+}
+
+#endif /* ifndef _ES_WAIT_FIFO_H_.2026-10-16 14:12:09 zcz */
+
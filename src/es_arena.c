@@ -0,0 +1,352 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_arena.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_arena.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ES_ARENA_ROUNDUP(x, a)	(((x) + (a) - 1) & ~((size_t)(a) - 1))
+
+/* header at the start of every block, the data follows */
+struct es_arena_block {
+	struct es_arena_block *prev;	/* older block, or next spare */
+	size_t size;			/* data bytes */
+	size_t used;			/* data bytes used when it was left */
+};
+
+#define ES_ARENA_HDR	ES_ARENA_ROUNDUP(sizeof(struct es_arena_block), \
+					ES_ARENA_ALIGN)
+
+static inline char *__es_arena_data(struct es_arena_block *b)
+{
+	return (char *)b + ES_ARENA_HDR;
+}
+
+/*
+ * _es_arena_push internal helper function for making @b the current
+ * block of @arena
+ */
+static void _es_arena_push(struct es_arena *arena, struct es_arena_block *b)
+{
+	if (arena->block)
+		arena->block->used = arena->ptr - __es_arena_data(arena->block);
+
+	b->prev = arena->block;
+	b->used = 0;
+	arena->block = b;
+	arena->ptr = __es_arena_data(b);
+	arena->end = arena->ptr + b->size;
+
+	arena->cur += b->size;
+	if (arena->cur > arena->peak)
+		arena->peak = arena->cur;
+}
+
+/*
+ * _es_arena_new_block internal helper function for getting a block of
+ * @size data bytes, a normal block from the spares when there is one
+ */
+static struct es_arena_block *_es_arena_new_block(struct es_arena *arena,
+		size_t size)
+{
+	struct es_arena_block *b;
+
+	if (size == arena->block_size && arena->spare) {
+		b = arena->spare;
+		arena->spare = b->prev;
+		return b;
+	}
+
+	b = malloc(ES_ARENA_HDR + size);
+	if (b)
+		b->size = size;
+	return b;
+}
+
+/**
+ * es_arena_init - initialize an arena
+ * @arena: the arena to be initialized
+ * @block_size: data bytes per block, 0 for ES_ARENA_BLOCK_SIZE
+ *
+ * No memory is allocated before the first allocation.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_arena_init(struct es_arena *arena, size_t block_size)
+{
+	memset(arena, 0, sizeof(*arena));
+	if (!block_size)
+		block_size = ES_ARENA_BLOCK_SIZE;
+	if (block_size > ((size_t)-1) / 2)
+		return ES_INVALID_PARAM;
+
+	arena->block_size = ES_ARENA_ROUNDUP(block_size, ES_ARENA_ALIGN);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_arena_destroy - free all memory of an arena
+ * @arena: the arena to be used.
+ *
+ * The arena may be used again afterwards, it starts out empty.
+ */
+void es_arena_destroy(struct es_arena *arena)
+{
+	es_arena_reset(arena);
+	es_arena_trim(arena);
+	free(arena->block);
+	arena->block = NULL;
+	arena->ptr = arena->end = NULL;
+	arena->cur = arena->peak = 0;
+}
+
+/*
+ * __es_arena_alloc_slow internal helper function for
+ * es_arena_alloc_aligned(), chaining a new block when the current one is
+ * full
+ */
+void *__es_arena_alloc_slow(struct es_arena *arena, size_t size,
+				size_t align)
+{
+	struct es_arena_block *b;
+	uintptr_t p;
+	size_t need;
+
+	if (!es_is_power_of_2(align))
+		return NULL;
+	/* a zero sized allocation still gets its own address */
+	if (!size)
+		return es_arena_alloc_aligned(arena, 1, align);
+	if (size > ((size_t)-1) / 2 || align > ((size_t)-1) / 4)
+		return NULL;
+
+	/* the block data is ES_ARENA_ALIGN aligned already */
+	need = size;
+	if (align > ES_ARENA_ALIGN)
+		need += align - ES_ARENA_ALIGN;
+
+	/* a large allocation would waste most of a normal block */
+	b = _es_arena_new_block(arena, need > arena->block_size / 4 ?
+			need : arena->block_size);
+	if (!b)
+		return NULL;
+	_es_arena_push(arena, b);
+
+	p = ((uintptr_t)arena->ptr + align - 1) & ~(uintptr_t)(align - 1);
+	arena->ptr = (char *)(p + size);
+	return (void *)p;
+}
+
+/**
+ * es_arena_calloc - allocate zeroed memory for an array from an arena
+ * @arena: the arena to be used.
+ * @n: number of elements
+ * @size: the size of an element
+ *
+ * Returns NULL if out of memory or if @n * @size overflows.
+ */
+void *es_arena_calloc(struct es_arena *arena, size_t n, size_t size)
+{
+	void *p;
+
+	if (size && n > ((size_t)-1) / size)
+		return NULL;
+	p = es_arena_alloc(arena, n * size);
+	if (p)
+		memset(p, 0, n * size);
+	return p;
+}
+
+/**
+ * es_arena_realloc - resize memory allocated from an arena
+ * @arena: the arena to be used.
+ * @old: the memory to be resized, may be NULL
+ * @old_size: its size
+ * @size: the new size
+ *
+ * The newest allocation of the arena grows or shrinks in place while it
+ * fits its block, which makes arrays appended one element at a time
+ * cheap. Otherwise the data is copied and the old memory stays in the
+ * arena until it is rewound. Returns NULL if out of memory, @old is left
+ * intact then.
+ */
+void *es_arena_realloc(struct es_arena *arena, void *old, size_t old_size,
+			size_t size)
+{
+	char *o = old;
+	void *p;
+
+	if (!o)
+		return es_arena_alloc(arena, size);
+
+	if (o + old_size == arena->ptr && size <= (size_t)(arena->end - o)) {
+		arena->ptr = o + (size ? size : 1);
+		return o;
+	}
+	if (size <= old_size)
+		return o;
+
+	p = es_arena_alloc(arena, size);
+	if (p)
+		memcpy(p, o, old_size);
+	return p;
+}
+
+/**
+ * es_arena_memdup - copy memory into an arena
+ * @arena: the arena to be used.
+ * @src: the memory to be copied
+ * @size: its size
+ *
+ * Returns the copy, NULL if out of memory.
+ */
+void *es_arena_memdup(struct es_arena *arena, const void *src, size_t size)
+{
+	void *p = es_arena_alloc(arena, size);
+
+	if (p)
+		memcpy(p, src, size);
+	return p;
+}
+
+/**
+ * es_arena_strdup - copy a string into an arena
+ * @arena: the arena to be used.
+ * @s: the string to be copied
+ *
+ * Returns the copy, NULL if out of memory.
+ */
+char *es_arena_strdup(struct es_arena *arena, const char *s)
+{
+	size_t len = strlen(s) + 1;
+	char *p = es_arena_alloc_aligned(arena, len, 1);
+
+	if (p)
+		memcpy(p, s, len);
+	return p;
+}
+
+/**
+ * es_arena_rewind - free everything allocated after a mark
+ * @arena: the arena to be used.
+ * @mark: filled by es_arena_mark() on this arena
+ *
+ * Blocks which become unused are kept as spares, except those of large
+ * allocations, which are freed. Rewinding to a mark of the empty arena
+ * keeps the first block in place.
+ */
+void es_arena_rewind(struct es_arena *arena, const struct es_arena_mark *mark)
+{
+	struct es_arena_block *b;
+
+	while (arena->block && arena->block != mark->block) {
+		b = arena->block;
+		/* back to empty, the first block stays for the next round */
+		if (!b->prev && !mark->block && b->size == arena->block_size)
+			break;
+		arena->block = b->prev;
+		arena->cur -= b->size;
+		if (b->size == arena->block_size) {
+			b->prev = arena->spare;
+			arena->spare = b;
+		} else {
+			free(b);
+		}
+	}
+
+	if (arena->block) {
+		arena->ptr = arena->block == mark->block ? mark->ptr :
+			__es_arena_data(arena->block);
+		arena->end = __es_arena_data(arena->block) + arena->block->size;
+	} else {
+		arena->ptr = arena->end = NULL;
+	}
+}
+
+/**
+ * es_arena_reset - free everything allocated from an arena
+ * @arena: the arena to be used.
+ *
+ * The first block stays in place, the others are kept as spares for
+ * the next allocations, so an arena reset once per request stops
+ * calling malloc().
+ */
+void es_arena_reset(struct es_arena *arena)
+{
+	static const struct es_arena_mark empty;
+
+	es_arena_rewind(arena, &empty);
+}
+
+/**
+ * es_arena_trim - give the spare blocks of an arena back to the system
+ * @arena: the arena to be used.
+ */
+void es_arena_trim(struct es_arena *arena)
+{
+	struct es_arena_block *b;
+
+	while ((b = arena->spare)) {
+		arena->spare = b->prev;
+		free(b);
+	}
+}
+
+/**
+ * es_arena_get_stats - read the counters of an arena
+ * @arena: the arena to be used.
+ * @st: where to store them
+ */
+void es_arena_get_stats(struct es_arena *arena, struct es_arena_stats *st)
+{
+	struct es_arena_block *b;
+
+	memset(st, 0, sizeof(*st));
+	st->peak = arena->peak;
+
+	for (b = arena->block; b; b = b->prev) {
+		if (b == arena->block)
+			st->used += arena->ptr - __es_arena_data(b);
+		else
+			st->used += b->used;
+		st->held += b->size;
+		st->blocks++;
+	}
+	for (b = arena->spare; b; b = b->prev) {
+		st->spare += b->size;
+		st->spares++;
+	}
+}
+
+/**
+ * es_arena_dump - print the counters of an arena
+ * @arena: the arena to be used.
+ * @fp: where to print, e.g. stderr
+ */
+void es_arena_dump(struct es_arena *arena, FILE *fp)
+{
+	struct es_arena_stats st;
+
+	es_arena_get_stats(arena, &st);
+	fprintf(fp, "%p: block_size %zu used %zu held %zu in %u blocks, "
+		"spare %zu in %u blocks, peak %zu\n", (void *)arena,
+		arena->block_size, st.used, st.held, st.blocks,
+		st.spare, st.spares, st.peak);
+}
+
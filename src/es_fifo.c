@@ -19,14 +19,39 @@
 * @comment           
 *******************************************************************************/
 #include <es_fifo.h> 
+#include <es_arena.h>
+#include <es_fifo_stats.h>
+#include <es_memcpy.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_memfd_create) && defined(MAP_FIXED)
+#define ES_FIFO_HAVE_MIRROR
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC	0x0001U
+#endif
+#endif
+
 static void _es_fifo_init(struct es_fifo *fifo, void *buffer,
 		unsigned int size)
 {
 	fifo->buffer = buffer;
 	fifo->size = size;
+	fifo->flags = 0;
+	fifo->dropped = 0;
+#ifdef ES_FIFO_STATS
+	/* a registered fifo must not be linked twice */
+	es_fifo_stats_forget(fifo);
+	fifo->stats_node.next = fifo->stats_node.prev = NULL;
+	fifo->stats_name = NULL;
+	memset(&fifo->stats, 0, sizeof(fifo->stats));
+#endif
 
 	es_fifo_reset(fifo);
 }
@@ -37,20 +62,207 @@ static void _es_fifo_init(struct es_fifo *fifo, void *buffer,
  * @buffer: the preallocated buffer to be used.
  * @size: the size of the internal buffer, this has to be a power of 2.
  *
+ * A size which is not a power of 2 is rounded down, the tail of the
+ * buffer is then left unused; check es_fifo_size() if that matters.
+ * Return 0 if no error, otherwise the an error code
  */
-void es_fifo_init(struct es_fifo *fifo, void *buffer, unsigned int size)
+int es_fifo_init(struct es_fifo *fifo, void *buffer, unsigned int size)
 {
+	if (!buffer || size < 2) {
+		_es_fifo_init(fifo, NULL, 0);
+		return ES_INVALID_PARAM;
+	}
+
 	/* size must be a power of 2 */
+	if (!es_is_power_of_2(size))
+		size = es_rounddown_pow_of_two(size);
+
+	_es_fifo_init(fifo, buffer, size);
+	return 0;
+}
+
+#ifdef ES_FIFO_HAVE_MIRROR
+/*
+ * _es_fifo_map_mirror internal helper function for mapping the same
+ * @size bytes of a memfd twice back-to-back
+ */
+static unsigned char *_es_fifo_map_mirror(unsigned int size)
+{
+	unsigned char *base;
+	void *addr;
+	int fd;
+
+	fd = syscall(SYS_memfd_create, "es_fifo", MFD_CLOEXEC);
+	if (fd < 0)
+		return NULL;
+
+	if (ftruncate(fd, size) < 0)
+		goto out_close;
+
+	/* reserve the address range for both views first */
+	base = mmap(NULL, 2 * (size_t)size, PROT_NONE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED)
+		goto out_close;
+
+	addr = mmap(base, size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_FIXED, fd, 0);
+	if (addr != base)
+		goto out_unmap;
+
+	addr = mmap(base + size, size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_FIXED, fd, 0);
+	if (addr != base + size)
+		goto out_unmap;
+
+	close(fd);
+	return base;
+
+out_unmap:
+	munmap(base, 2 * (size_t)size);
+out_close:
+	close(fd);
+	return NULL;
+}
+#endif
+
+/*
+ * _es_fifo_alloc_mirror internal helper function for the
+ * ES_FIFO_ALLOC_MIRROR case, @size is already a power of 2
+ */
+static int _es_fifo_alloc_mirror(struct es_fifo *fifo, unsigned int size)
+{
+#ifdef ES_FIFO_HAVE_MIRROR
+	unsigned char *buffer;
+	long page_size = sysconf(_SC_PAGESIZE);
+
+	if (page_size <= 0 || !es_is_power_of_2(page_size))
+		return ES_FAIL;
+	if (size < page_size)
+		size = page_size;
+
+	buffer = _es_fifo_map_mirror(size);
+	if (buffer) {
+		_es_fifo_init(fifo, buffer, size);
+		fifo->flags |= ES_FIFO_F_MIRROR;
+		return 0;
+	}
+#endif
+	return ES_FAIL;
+}
+
+/*
+ * _es_fifo_alloc_huge internal helper function for the
+ * ES_FIFO_ALLOC_HUGEPAGE case, @size is already a power of 2
+ */
+static int _es_fifo_alloc_huge(struct es_fifo *fifo, unsigned int size)
+{
+#if defined(__linux__) && (defined(MAP_HUGETLB) || defined(MADV_HUGEPAGE))
+	unsigned char *buffer, *aligned;
+	size_t huge = ES_FIFO_HUGEPAGE_SIZE;
+
+	if (size < huge)
+		return ES_FAIL;
+
+#ifdef MAP_HUGETLB
+	/* explicit huge pages, if the administrator reserved some */
+	buffer = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (buffer != MAP_FAILED) {
+		_es_fifo_init(fifo, buffer, size);
+		fifo->flags |= ES_FIFO_F_MMAP;
+		return 0;
+	}
+#endif
+
+#ifdef MADV_HUGEPAGE
+	/* transparent huge pages: map huge page aligned and ask for them */
+	buffer = mmap(NULL, size + huge, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (buffer == MAP_FAILED)
+		return ES_FAIL;
+
+	aligned = (unsigned char *)(((unsigned long)buffer + huge - 1) &
+				~(huge - 1));
+	if (aligned != buffer)
+		munmap(buffer, aligned - buffer);
+	munmap(aligned + size, buffer + huge - aligned);
+
+	madvise(aligned, size, MADV_HUGEPAGE);
+	_es_fifo_init(fifo, aligned, size);
+	fifo->flags |= ES_FIFO_F_MMAP;
+	return 0;
+#endif
+#endif
+	return ES_FAIL;
+}
+
+/*
+ * _es_fifo_alloc_flags internal helper function for picking and setting
+ * up the buffer of es_fifo_alloc_flags()
+ */
+static int _es_fifo_alloc_flags(struct es_fifo *fifo, unsigned int size,
+			unsigned int flags)
+{
+	void *buffer;
+
+	_es_fifo_init(fifo, NULL, 0);
+	if (size < 2 || size > (1U << 31))
+		return ES_INVALID_PARAM;
+
+	size = es_roundup_pow_of_two(size);
+
+	if ((flags & ES_FIFO_ALLOC_MIRROR) && !_es_fifo_alloc_mirror(fifo, size))
+		return 0;
+	if ((flags & ES_FIFO_ALLOC_HUGEPAGE) && !_es_fifo_alloc_huge(fifo, size))
+		return 0;
+
+	if (flags & (ES_FIFO_ALLOC_CACHEALIGN | ES_FIFO_ALLOC_HUGEPAGE)) {
+		if (posix_memalign(&buffer, ES_CACHELINE_SIZE, size))
+			buffer = NULL;
+	} else {
+		buffer = malloc(size);
+	}
+
+	if (!buffer)
+		return ES_FAIL;
 
 	_es_fifo_init(fifo, buffer, size);
+	return 0;
 }
 
+/**
+ * es_fifo_alloc_flags - allocates a new FIFO internal buffer
+ * @fifo: the fifo to assign then new buffer
+ * @size: the size of the buffer to be allocated
+ * @flags: ES_FIFO_ALLOC_* flags
+ *
+ * ES_FIFO_ALLOC_CACHEALIGN aligns the buffer to ES_CACHELINE_SIZE.
+ * ES_FIFO_ALLOC_HUGEPAGE backs buffers of at least ES_FIFO_HUGEPAGE_SIZE
+ * bytes with huge pages (hugetlbfs reservations first, then transparent
+ * huge pages) to cut TLB misses on large rings; smaller buffers or a
+ * failed mapping fall back to a cache line aligned heap buffer.
+ * ES_FIFO_ALLOC_MIRROR is described at es_fifo_alloc_mirror().
+ *
+ * The size will be rounded-up to a power of 2.
+ * The buffer will be release with es_fifo_free().
+ * With ES_FIFO_STATS the fifo is added to the stats registry.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_fifo_alloc_flags(struct es_fifo *fifo, unsigned int size,
+			unsigned int flags)
+{
+	int ret = _es_fifo_alloc_flags(fifo, size, flags);
+
+	if (!ret)
+		es_fifo_stats_register(fifo, NULL);
+	return ret;
+}
 
 /**
  * es_fifo_alloc - allocates a new FIFO internal buffer
  * @fifo: the fifo to assign then new buffer
  * @size: the size of the buffer to be allocated, this have to be a power of 2.
- * @gfp_mask: get_free_pages mask, passed to kmalloc()
  *
  * This function dynamically allocates a new fifo internal buffer
  *
@@ -60,15 +272,61 @@ void es_fifo_init(struct es_fifo *fifo, void *buffer, unsigned int size)
  */
 int es_fifo_alloc(struct es_fifo *fifo, unsigned int size)
 {
-	unsigned char *buffer;
+	return es_fifo_alloc_flags(fifo, size, 0);
+}
 
+/**
+ * es_fifo_alloc_mirror - allocates a mirror mapped FIFO internal buffer
+ * @fifo: the fifo to assign then new buffer
+ * @size: the size of the buffer to be allocated
+ *
+ * Like es_fifo_alloc(), but the buffer pages are mapped twice in a row,
+ * so that fifo->buffer[i + size] aliases fifo->buffer[i]. Every read or
+ * write region is then contiguous and the copies never have to be split
+ * at the end of the buffer.
+ *
+ * The size will be rounded-up to a power of 2 of at least one page.
+ * If the platform cannot mirror the pages, it falls back to a plain
+ * es_fifo_alloc(); check es_fifo_is_mirrored() when contiguity matters.
+ * The buffer will be release with es_fifo_free().
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_fifo_alloc_mirror(struct es_fifo *fifo, unsigned int size)
+{
+	return es_fifo_alloc_flags(fifo, size, ES_FIFO_ALLOC_MIRROR);
+}
+
+/**
+ * es_fifo_alloc_arena - allocates a FIFO internal buffer from an arena
+ * @fifo: the fifo to assign then new buffer
+ * @size: the size of the buffer to be allocated
+ * @arena: the arena to draw the buffer from
+ *
+ * Like es_fifo_alloc(), but the cache line aligned buffer is carved from
+ * @arena, which is cheaper for short lived fifos. es_fifo_free() leaves
+ * the buffer to the arena; the fifo must not be used any more once the
+ * arena is rewound past it, reset or destroyed.
+ *
+ * The size will be rounded-up to a power of 2.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_fifo_alloc_arena(struct es_fifo *fifo, unsigned int size,
+			struct es_arena *arena)
+{
+	void *buffer;
+
+	_es_fifo_init(fifo, NULL, 0);
+	if (!arena || size < 2 || size > (1U << 31))
+		return ES_INVALID_PARAM;
+
+	size = es_roundup_pow_of_two(size);
+	buffer = es_arena_alloc_aligned(arena, size, ES_CACHELINE_SIZE);
+	if (!buffer)
+		return ES_FAIL;
 
-	buffer = malloc(size);
-	if (!buffer) {
-		_es_fifo_init(fifo, NULL, 0);
-		return -1;
-	}
 	_es_fifo_init(fifo, buffer, size);
+	fifo->flags |= ES_FIFO_F_ARENA;
+	es_fifo_stats_register(fifo, NULL);
 	return 0;
 }
 
@@ -78,10 +336,40 @@ int es_fifo_alloc(struct es_fifo *fifo, unsigned int size)
  */
 void es_fifo_free(struct es_fifo *fifo)
 {
-	free(fifo->buffer);
+	es_fifo_stats_unregister(fifo);
+
+	/* the arena owns the buffer */
+	if (fifo->flags & ES_FIFO_F_ARENA)
+		fifo->buffer = NULL;
+
+#ifdef __linux__
+	if (fifo->flags & ES_FIFO_F_MIRROR)
+		munmap(fifo->buffer, 2 * (size_t)fifo->size);
+	else if (fifo->flags & ES_FIFO_F_MMAP)
+		munmap(fifo->buffer, fifo->size);
+	else
+#endif
+		free(fifo->buffer);
 	_es_fifo_init(fifo, NULL, 0);
 }
 
+/*
+ * __es_fifo_skip_overwrite internal helper function for es_fifo_skip() in
+ * ES_FIFO_F_OVERWRITE mode
+ */
+static void __es_fifo_skip_overwrite(struct es_fifo *fifo, unsigned int len)
+{
+	unsigned int out, n;
+
+	out = es_smp_load_acquire(&fifo->out);
+	do {
+		n = min(es_smp_load_acquire(&fifo->in) - out, len);
+		n = min(n, fifo->size);
+		if (!n)
+			return;
+	} while (!es_cmpxchg_acq_rel(&fifo->out, &out, out + n));
+}
+
 /**
  * es_fifo_skip - skip output data
  * @fifo: the fifo to be used.
@@ -89,6 +377,10 @@ void es_fifo_free(struct es_fifo *fifo)
  */
 void es_fifo_skip(struct es_fifo *fifo, unsigned int len)
 {
+	if (fifo->flags & ES_FIFO_F_OVERWRITE) {
+		__es_fifo_skip_overwrite(fifo, len);
+		return;
+	}
 	if (len < es_fifo_len(fifo)) {
 		__es_fifo_add_out(fifo, len);
 		return;
@@ -96,55 +388,187 @@ void es_fifo_skip(struct es_fifo *fifo, unsigned int len)
 	es_fifo_reset_out(fifo);
 }
 
-static inline void __es_fifo_in_data(struct es_fifo *fifo,
-		const void *from, unsigned int len, unsigned int off)
+/*
+ * __es_fifo_memcpy internal helper function for picking the copy kernel,
+ * inline for short copies and streaming stores for large ones if the
+ * fifo asks for them
+ */
+static inline void __es_fifo_memcpy(struct es_fifo *fifo, void *to,
+		const void *from, unsigned int len)
+{
+	if (len <= ES_MEMCPY_SMALL_MAX)
+		es_memcpy_small(to, from, len);
+	else if ((fifo->flags & ES_FIFO_F_STREAM) && len >= ES_FIFO_STREAM_MIN)
+		es_memcpy_stream(to, from, len);
+	else
+		memcpy(to, from, len);
+}
+
+/*
+ * __es_fifo_copy_in internal helper function for copying @len bytes to
+ * the ring index @pos, no barriers and no index update
+ */
+static inline void __es_fifo_copy_in(struct es_fifo *fifo,
+		const void *from, unsigned int len, unsigned int pos)
 {
 	unsigned int l;
+	unsigned int off = __es_fifo_off(fifo, pos);
 
+	if (es_fifo_is_mirrored(fifo)) {
+		__es_fifo_memcpy(fifo, fifo->buffer + off, from, len);
+		return;
+	}
+
+	/* first put the data starting from fifo->in to buffer end */
+	l = min(len, fifo->size - off);
+	__es_fifo_memcpy(fifo, fifo->buffer + off, from, l);
+	/* then put the rest (if any) at the beginning of the buffer */
+	__es_fifo_memcpy(fifo, fifo->buffer, from + l, len - l);
+}
+
+/*
+ * __es_fifo_copy_out internal helper function for copying @len bytes
+ * from the ring index @pos, no barriers and no index update
+ */
+static inline void __es_fifo_copy_out(struct es_fifo *fifo,
+		void *to, unsigned int len, unsigned int pos)
+{
+	unsigned int l;
+	unsigned int off = __es_fifo_off(fifo, pos);
+
+	if (es_fifo_is_mirrored(fifo)) {
+		__es_fifo_memcpy(fifo, to, fifo->buffer + off, len);
+		return;
+	}
+
+	/* first get the data from fifo->out until the end of the buffer */
+	l = min(len, fifo->size - off);
+	__es_fifo_memcpy(fifo, to, fifo->buffer + off, l);
+
+	/* then get the rest (if any) from the beginning of the buffer */
+	__es_fifo_memcpy(fifo, to + l, fifo->buffer, len - l);
+}
+
+static inline void __es_fifo_in_data(struct es_fifo *fifo,
+		const void *from, unsigned int len, unsigned int off)
+{
 	/*
 	 * Ensure that we sample the fifo->out index -before- we
 	 * start putting bytes into the es_fifo.
 	 */
+	es_smp_mb();
 
-
-	off = __es_fifo_off(fifo, fifo->in + off);
-
-	/* first put the data starting from fifo->in to buffer end */
-	l = min(len, fifo->size - off);
-	memcpy(fifo->buffer + off, from, l);
-	/* then put the rest (if any) at the beginning of the buffer */
-	memcpy(fifo->buffer, from + l, len - l);
+	__es_fifo_copy_in(fifo, from, len, fifo->in + off);
 }
 
 static inline void __es_fifo_out_data(struct es_fifo *fifo,
 		void *to, unsigned int len, unsigned int off)
 {
-	unsigned int l;
-
 	/*
 	 * Ensure that we sample the fifo->in index -before- we
 	 * start removing bytes from the es_fifo.
 	 */
-	off = __es_fifo_off(fifo, fifo->out + off);
+	es_smp_rmb();
 
-	/* first get the data from fifo->out until the end of the buffer */
-	l = min(len, fifo->size - off);
-	memcpy(to, fifo->buffer + off, l);
+	__es_fifo_copy_out(fifo, to, len, fifo->out + off);
+}
 
-	/* then get the rest (if any) from the beginning of the buffer */
-	memcpy(to + l, fifo->buffer, len - l);
+/*
+ * __es_fifo_max_r internal helper function for the largest record
+ * length a @recsize bytes header can describe
+ */
+static inline unsigned int __es_fifo_max_r(unsigned int recsize)
+{
+	return (1U << (recsize << 3)) - 1;
 }
 
 unsigned int __es_fifo_in_n(struct es_fifo *fifo,
 	const void *from, unsigned int len, unsigned int recsize)
 {
-	if (es_fifo_avail(fifo) < len + recsize)
+	if (len > __es_fifo_max_r(recsize) ||
+		es_fifo_avail(fifo) < len + recsize) {
+		__es_fifo_stat_short_write(fifo);
 		return len + 1;
+	}
 
 	__es_fifo_in_data(fifo, from, len, recsize);
+	__es_fifo_poke_n(fifo, recsize, len);
+	__es_fifo_add_in(fifo, len + recsize);
 	return 0;
 }
 
+/*
+ * __es_fifo_in_overwrite internal helper function for es_fifo_in() in
+ * ES_FIFO_F_OVERWRITE mode
+ */
+static unsigned int __es_fifo_in_overwrite(struct es_fifo *fifo,
+		const void *from, unsigned int len)
+{
+	unsigned int in = fifo->in;
+	unsigned int out, new_out, skip = 0;
+	unsigned int ret = len;
+
+	/* only the newest size bytes of the write can survive */
+	if (len > fifo->size) {
+		skip = len - fifo->size;
+		from += skip;
+		len = fifo->size;
+	}
+
+	out = es_smp_load_acquire(&fifo->out);
+	while (fifo->size - (in - out) < len) {
+		new_out = in + len - fifo->size;
+		/*
+		 * push the reader out of the way first; a reader which was
+		 * copying the dropped bytes will fail its own cmpxchg
+		 */
+		if (es_cmpxchg_acq_rel(&fifo->out, &out, new_out)) {
+			skip += new_out - out;
+			break;
+		}
+	}
+
+	/* the new out must be visible before we overwrite the old bytes */
+	es_smp_wmb();
+
+	if (skip)
+		ES_WRITE_ONCE(fifo->dropped, fifo->dropped + skip);
+
+	__es_fifo_copy_in(fifo, from, len, in);
+	__es_fifo_add_in(fifo, len);
+	return ret;
+}
+
+/*
+ * __es_fifo_out_overwrite internal helper function for es_fifo_out() in
+ * ES_FIFO_F_OVERWRITE mode
+ */
+static unsigned int __es_fifo_out_overwrite(struct es_fifo *fifo,
+		void *to, unsigned int len)
+{
+	unsigned int out, n;
+
+	out = es_smp_load_acquire(&fifo->out);
+	for (;;) {
+		/* a stale out may lag more than size behind a fast writer */
+		n = min(es_smp_load_acquire(&fifo->in) - out, len);
+		n = min(n, fifo->size);
+		if (!n) {
+			__es_fifo_stat_empty_read(fifo);
+			return 0;
+		}
+
+		__es_fifo_copy_out(fifo, to, n, out);
+
+		/* finish the copy before checking whether it was overwritten */
+		es_smp_rmb();
+		if (es_cmpxchg_acq_rel(&fifo->out, &out, out + n)) {
+			__es_fifo_stat_out(fifo, n);
+			return n;
+		}
+	}
+}
+
 /**
  * es_fifo_in - puts some data into the FIFO
  * @fifo: the fifo to be used.
@@ -153,7 +577,8 @@ unsigned int __es_fifo_in_n(struct es_fifo *fifo,
  *
  * This function copies at most @len bytes from the @from buffer into
  * the FIFO depending on the free space, and returns the number of
- * bytes copied.
+ * bytes copied. In overwrite mode all @len bytes are always accepted,
+ * see es_fifo_set_overwrite().
  *
  * Note that with only one concurrent reader and one concurrent
  * writer, you don't need extra locking to use these functions.
@@ -161,7 +586,16 @@ unsigned int __es_fifo_in_n(struct es_fifo *fifo,
 unsigned int es_fifo_in(struct es_fifo *fifo, const void *from,
 				unsigned int len)
 {
-	len = min(es_fifo_avail(fifo), len);
+	unsigned int avail;
+
+	if (fifo->flags & ES_FIFO_F_OVERWRITE)
+		return __es_fifo_in_overwrite(fifo, from, len);
+
+	avail = es_fifo_avail(fifo);
+	if (avail < len) {
+		__es_fifo_stat_short_write(fifo);
+		len = avail;
+	}
 
 	__es_fifo_in_data(fifo, from, len, 0);
 	__es_fifo_add_in(fifo, len);
@@ -195,7 +629,12 @@ unsigned int __es_fifo_out_n(struct es_fifo *fifo,
  */
 unsigned int es_fifo_out(struct es_fifo *fifo, void *to, unsigned int len)
 {
+	if (fifo->flags & ES_FIFO_F_OVERWRITE)
+		return __es_fifo_out_overwrite(fifo, to, len);
+
 	len = min(es_fifo_len(fifo), len);
+	if (!len)
+		__es_fifo_stat_empty_read(fifo);
 
 	__es_fifo_out_data(fifo, to, len, 0);
 	__es_fifo_add_out(fifo, len);
@@ -203,6 +642,36 @@ unsigned int es_fifo_out(struct es_fifo *fifo, void *to, unsigned int len)
 	return len;
 }
 
+/*
+ * __es_fifo_out_peek_overwrite internal helper function for
+ * es_fifo_out_peek() in ES_FIFO_F_OVERWRITE mode
+ */
+static unsigned int __es_fifo_out_peek_overwrite(struct es_fifo *fifo,
+		void *to, unsigned int len, unsigned int offset)
+{
+	unsigned int out, cur, n;
+
+	out = es_smp_load_acquire(&fifo->out);
+	for (;;) {
+		n = min(es_smp_load_acquire(&fifo->in) - out, fifo->size);
+		if (n <= offset)
+			return 0;
+		n = min(n - offset, len);
+
+		__es_fifo_copy_out(fifo, to, n, out + offset);
+
+		/*
+		 * the writer moves out before it overwrites, the copy is
+		 * intact if out did not move while it ran
+		 */
+		es_smp_rmb();
+		cur = ES_READ_ONCE(fifo->out);
+		if (cur == out)
+			return n;
+		out = cur;
+	}
+}
+
 /**
  * es_fifo_out_peek - copy some data from the FIFO, but do not remove it
  * @fifo: the fifo to be used.
@@ -211,27 +680,479 @@ unsigned int es_fifo_out(struct es_fifo *fifo, void *to, unsigned int len)
  * @offset: offset into the fifo
  *
  * This function copies at most @len bytes at @offset from the FIFO
- * into the @to buffer and returns the number of copied bytes.
- * The data is not removed from the FIFO.
+ * into the @to buffer and returns the number of copied bytes, 0 if
+ * nothing is queued past @offset. The data is not removed from the FIFO.
  */
 unsigned int es_fifo_out_peek(struct es_fifo *fifo, void *to, unsigned int len,
 			    unsigned offset)
 {
-	len = min(es_fifo_len(fifo), len + offset);
+	unsigned int n;
+
+	if (fifo->flags & ES_FIFO_F_OVERWRITE)
+		return __es_fifo_out_peek_overwrite(fifo, to, len, offset);
+
+	n = es_fifo_len(fifo);
+	if (n <= offset)
+		return 0;
+	len = min(n - offset, len);
 
 	__es_fifo_out_data(fifo, to, len, offset);
 	return len;
 }
 
 
+/*
+ * __es_fifo_setup_iov internal helper function for describing @len bytes
+ * of the ring starting at index @off as one or two contiguous spans
+ */
+static unsigned int __es_fifo_setup_iov(struct es_fifo *fifo,
+		struct iovec *vec, unsigned int len, unsigned int off)
+{
+	unsigned int l;
+
+	if (!len)
+		return 0;
+
+	off = __es_fifo_off(fifo, off);
+	l = es_fifo_is_mirrored(fifo) ? len : min(len, fifo->size - off);
+
+	vec[0].iov_base = fifo->buffer + off;
+	vec[0].iov_len = l;
+	if (l == len)
+		return 1;
+
+	vec[1].iov_base = fifo->buffer;
+	vec[1].iov_len = len - l;
+	return 2;
+}
+
+/**
+ * es_fifo_prepare_write - reserve free space for zero-copy input
+ * @fifo: the fifo to be used.
+ * @vec: array of two iovecs to be filled with the free space
+ * @len: the maximum number of bytes to reserve
+ *
+ * This function describes at most @len bytes of free space at the tail
+ * of the FIFO in @vec, so the data can be produced in place (e.g. by
+ * readv() or recvmsg()). Nothing becomes visible to the reader before
+ * es_fifo_commit_write() is called.
+ *
+ * Returns the number of entries in @vec which are used (0, 1 or 2).
+ *
+ * Note that with only one concurrent reader and one concurrent
+ * writer, you don't need extra locking to use these functions.
+ */
+unsigned int es_fifo_prepare_write(struct es_fifo *fifo,
+				struct iovec *vec, unsigned int len)
+{
+	len = min(es_fifo_avail(fifo), len);
+
+	/* sample fifo->out before the caller starts writing the space */
+	es_smp_mb();
+
+	return __es_fifo_setup_iov(fifo, vec, len, fifo->in);
+}
+
+/**
+ * es_fifo_commit_write - publish data written by es_fifo_prepare_write()
+ * @fifo: the fifo to be used.
+ * @len: number of bytes written into the reserved space
+ *
+ * @len must not exceed the space returned by es_fifo_prepare_write().
+ */
+void es_fifo_commit_write(struct es_fifo *fifo, unsigned int len)
+{
+	__es_fifo_add_in(fifo, min(es_fifo_avail(fifo), len));
+}
+
+/**
+ * es_fifo_peek_read - map queued data for zero-copy output
+ * @fifo: the fifo to be used.
+ * @vec: array of two iovecs to be filled with the queued data
+ * @len: the maximum number of bytes to map
+ *
+ * This function describes at most @len bytes at the head of the FIFO in
+ * @vec, so the data can be consumed in place (e.g. by writev()). The
+ * data stays in the FIFO until es_fifo_release_read() is called.
+ *
+ * Returns the number of entries in @vec which are used (0, 1 or 2), 0 in
+ * overwrite mode, where the writer could overwrite the mapped bytes.
+ */
+unsigned int es_fifo_peek_read(struct es_fifo *fifo,
+				struct iovec *vec, unsigned int len)
+{
+	if (fifo->flags & ES_FIFO_F_OVERWRITE)
+		return 0;
+
+	len = min(es_fifo_len(fifo), len);
+	if (!len)
+		__es_fifo_stat_empty_read(fifo);
+
+	/* sample fifo->in before the caller starts reading the data */
+	es_smp_rmb();
 
+	return __es_fifo_setup_iov(fifo, vec, len, fifo->out);
+}
 
+/**
+ * es_fifo_release_read - drop data consumed via es_fifo_peek_read()
+ * @fifo: the fifo to be used.
+ * @len: number of bytes consumed
+ *
+ * Does nothing in overwrite mode, see es_fifo_peek_read().
+ */
+void es_fifo_release_read(struct es_fifo *fifo, unsigned int len)
+{
+	if (fifo->flags & ES_FIFO_F_OVERWRITE)
+		return;
+
+	__es_fifo_add_out(fifo, min(es_fifo_len(fifo), len));
+}
 
 unsigned int __es_fifo_peek_generic(struct es_fifo *fifo, unsigned int recsize)
 {
 	if (recsize == 0)
-		return es_fifo_avail(fifo);
+		return es_fifo_len(fifo);
+
+	if (recsize > 2 || es_fifo_len(fifo) < recsize)
+		return 0;
 
+	/* the header must not be read before it was published */
+	es_smp_rmb();
 	return __es_fifo_peek_n(fifo, recsize);
 }
 
+/**
+ * es_fifo_in_rec - puts a record into the FIFO
+ * @fifo: the fifo to be used.
+ * @from: the data to be added.
+ * @n: the length of the data to be added.
+ * @recsize: size of the record length header: 0, 1 or 2 bytes
+ *
+ * This function copies @n bytes from @from into the FIFO, prefixed by a
+ * @recsize bytes length header, and returns the number of bytes which
+ * cannot be copied. A record is stored completely or not at all: a
+ * returned value greater than @n means that the record doesn't fit into
+ * the FIFO (or is too long for the header). A @recsize greater than 2
+ * returns ES_INVALID_PARAM, which is greater than @n as well.
+ *
+ * With @recsize 0 this is the plain byte stream es_fifo_in().
+ *
+ * Note that with only one concurrent reader and one concurrent
+ * writer, you don't need extra locking to use these functions.
+ */
+unsigned int es_fifo_in_rec(struct es_fifo *fifo, const void *from,
+				unsigned int n, unsigned int recsize)
+{
+	if (recsize == 0)
+		return n - es_fifo_in(fifo, from, n);
+	if (recsize > 2)
+		return ES_INVALID_PARAM;
+
+	return __es_fifo_in_n(fifo, from, n, recsize);
+}
+
+/**
+ * es_fifo_out_rec - gets a record from the FIFO
+ * @fifo: the fifo to be used.
+ * @to: where the data must be copied.
+ * @n: the size of the destination buffer.
+ * @recsize: size of the record length header: 0, 1 or 2 bytes
+ * @total: pointer where the length of the record should be stored
+ *
+ * This function copies the next record from the FIFO to @to and returns
+ * the number of bytes which cannot be copied. A returned value greater
+ * than zero means that the record doesn't fit into @to; it stays in the
+ * FIFO and *@total tells the buffer size needed. On an empty FIFO
+ * *@total is 0, use es_fifo_is_empty() to tell it from an empty record.
+ * A @recsize greater than 2 returns ES_INVALID_PARAM with *@total 0.
+ *
+ * With @recsize 0 this is the plain byte stream es_fifo_out().
+ */
+unsigned int es_fifo_out_rec(struct es_fifo *fifo, void *to,
+				unsigned int n, unsigned int recsize,
+				unsigned int *total)
+{
+	unsigned int l;
+
+	if (recsize == 0) {
+		l = es_fifo_out(fifo, to, n);
+		if (total)
+			*total = l;
+		return n - l;
+	}
+	if (recsize > 2) {
+		if (total)
+			*total = 0;
+		return ES_INVALID_PARAM;
+	}
+
+	if (es_fifo_len(fifo) < recsize)
+		__es_fifo_stat_empty_read(fifo);
+
+	l = __es_fifo_peek_generic(fifo, recsize);
+	if (total)
+		*total = l;
+	if (n < l)
+		return l;
+
+	return __es_fifo_out_n(fifo, to, l, recsize);
+}
+
+/**
+ * es_fifo_skip_rec - skip the next record
+ * @fifo: the fifo to be used.
+ * @recsize: size of the record length header: 0, 1 or 2 bytes
+ *
+ * With @recsize 0 the whole FIFO content is skipped, a @recsize greater
+ * than 2 skips nothing.
+ */
+void es_fifo_skip_rec(struct es_fifo *fifo, unsigned int recsize)
+{
+	unsigned int l;
+
+	if (recsize == 0) {
+		es_fifo_reset_out(fifo);
+		return;
+	}
+
+	if (recsize > 2 || es_fifo_len(fifo) < recsize)
+		return;
+
+	l = __es_fifo_peek_generic(fifo, recsize);
+	__es_fifo_add_out(fifo, l + recsize);
+}
+
+/**
+ * es_fifo_in_recs - puts a batch of records into the FIFO
+ * @fifo: the fifo to be used.
+ * @recs: array of records, one iovec per record
+ * @nrecs: number of records in @recs
+ * @recsize: size of the record length header: 1 or 2 bytes
+ *
+ * This function stores the records of @recs in order until one does
+ * not fit, and returns the number of records stored. The free space is
+ * sampled once and all stored records are published with a single
+ * update of the in index.
+ */
+unsigned int es_fifo_in_recs(struct es_fifo *fifo, const struct iovec *recs,
+				unsigned int nrecs, unsigned int recsize)
+{
+	unsigned int avail, pos, len, i;
+	unsigned char hdr[2];
+
+	if (recsize == 0 || recsize > 2)
+		return 0;
+
+	avail = es_fifo_avail(fifo);
+
+	/* sample fifo->out before putting bytes into the es_fifo */
+	es_smp_mb();
+
+	pos = fifo->in;
+	for (i = 0; i < nrecs; i++) {
+		len = recs[i].iov_len;
+		if (len > __es_fifo_max_r(recsize) || avail < len + recsize)
+			break;
+
+		hdr[0] = (unsigned char)len;
+		hdr[1] = (unsigned char)(len >> 8);
+		__es_fifo_copy_in(fifo, hdr, recsize, pos);
+		__es_fifo_copy_in(fifo, recs[i].iov_base, len, pos + recsize);
+
+		pos += len + recsize;
+		avail -= len + recsize;
+	}
+
+	if (i < nrecs)
+		__es_fifo_stat_short_write(fifo);
+	if (i)
+		__es_fifo_add_in(fifo, pos - fifo->in);
+	return i;
+}
+
+/**
+ * es_fifo_out_recs - gets a batch of records from the FIFO
+ * @fifo: the fifo to be used.
+ * @recs: array of destination buffers, one iovec per record
+ * @nrecs: number of buffers in @recs
+ * @recsize: size of the record length header: 1 or 2 bytes
+ *
+ * This function copies the next records into the buffers of @recs in
+ * order, sets each iov_len to the length of the record copied, and
+ * returns the number of records copied. It stops at the first record
+ * which doesn't fit into its buffer; that one stays in the FIFO. The
+ * queued length is sampled once and all copied records are released
+ * with a single update of the out index.
+ */
+unsigned int es_fifo_out_recs(struct es_fifo *fifo, struct iovec *recs,
+				unsigned int nrecs, unsigned int recsize)
+{
+	unsigned int used, pos, len, i;
+	unsigned char hdr[2] = {0, 0};
+
+	if (recsize == 0 || recsize > 2)
+		return 0;
+
+	used = es_fifo_len(fifo);
+	if (used < recsize)
+		__es_fifo_stat_empty_read(fifo);
+
+	/* sample fifo->in before removing bytes from the es_fifo */
+	es_smp_rmb();
+
+	pos = fifo->out;
+	for (i = 0; i < nrecs && used >= recsize; i++) {
+		__es_fifo_copy_out(fifo, hdr, recsize, pos);
+		len = hdr[0] | (recsize > 1 ? hdr[1] << 8 : 0);
+		if (len > recs[i].iov_len || used < len + recsize)
+			break;
+
+		__es_fifo_copy_out(fifo, recs[i].iov_base, len, pos + recsize);
+		recs[i].iov_len = len;
+
+		pos += len + recsize;
+		used -= len + recsize;
+	}
+
+	if (i)
+		__es_fifo_add_out(fifo, pos - fifo->out);
+	return i;
+}
+
+/**
+ * es_fifo_out_elems - gets a batch of fixed size elements from the FIFO
+ * @fifo: the fifo to be used.
+ * @to: where the elements must be copied.
+ * @esize: the size of one element in bytes
+ * @n: the number of elements the destination buffer can hold.
+ *
+ * This function copies at most @n whole elements from the FIFO into the
+ * @to buffer and returns the number of copied elements. A partially
+ * written element at the end of the FIFO is left alone.
+ */
+unsigned int es_fifo_out_elems(struct es_fifo *fifo, void *to,
+				unsigned int esize, unsigned int n)
+{
+	if (!esize)
+		return 0;
+
+	n = min(es_fifo_len(fifo) / esize, n);
+	if (!n) {
+		__es_fifo_stat_empty_read(fifo);
+		return 0;
+	}
+
+	__es_fifo_out_data(fifo, to, n * esize, 0);
+	__es_fifo_add_out(fifo, n * esize);
+	return n;
+}
+
+/*
+ * __es_fifo_drain_one internal helper function for handing @len bytes
+ * at the ring index @pos to a drain callback
+ */
+static inline int __es_fifo_drain_one(struct es_fifo *fifo,
+		unsigned int pos, unsigned int len,
+		es_fifo_drain_fn fn, void *arg)
+{
+	struct iovec vec[2];
+	unsigned int nvec;
+
+	nvec = __es_fifo_setup_iov(fifo, vec, len, pos);
+	if (!nvec) {
+		/* zero length record */
+		vec[0].iov_base = fifo->buffer;
+		vec[0].iov_len = 0;
+		nvec = 1;
+	}
+	return fn(arg, vec, nvec);
+}
+
+/**
+ * es_fifo_drain_elems - hand a batch of fixed size elements to a callback
+ * @fifo: the fifo to be used.
+ * @esize: the size of one element in bytes
+ * @max: the maximum number of elements to drain
+ * @fn: the callback, called once per element
+ * @arg: passed to @fn
+ *
+ * Every element is passed to @fn in place, as one iovec or as two when
+ * it wraps around the end of the buffer. When @fn returns nonzero the
+ * drain stops and that element stays in the FIFO.
+ *
+ * The queued length is sampled once and all drained elements are
+ * released with a single update of the out index, after the last
+ * callback returned. Returns the number of elements drained.
+ */
+unsigned int es_fifo_drain_elems(struct es_fifo *fifo, unsigned int esize,
+				unsigned int max, es_fifo_drain_fn fn, void *arg)
+{
+	unsigned int n, i, pos;
+
+	if (!esize)
+		return 0;
+
+	n = min(es_fifo_len(fifo) / esize, max);
+	if (!n)
+		__es_fifo_stat_empty_read(fifo);
+
+	/* sample fifo->in before reading the elements */
+	es_smp_rmb();
+
+	pos = fifo->out;
+	for (i = 0; i < n; i++) {
+		if (__es_fifo_drain_one(fifo, pos, esize, fn, arg))
+			break;
+		pos += esize;
+	}
+
+	if (i)
+		__es_fifo_add_out(fifo, pos - fifo->out);
+	return i;
+}
+
+/**
+ * es_fifo_drain_recs - hand a batch of records to a callback
+ * @fifo: the fifo to be used.
+ * @recsize: size of the record length header: 1 or 2 bytes
+ * @max: the maximum number of records to drain
+ * @fn: the callback, called once per record with its payload
+ * @arg: passed to @fn
+ *
+ * Same as es_fifo_drain_elems(), for a FIFO filled by es_fifo_in_rec().
+ * Returns the number of records drained.
+ */
+unsigned int es_fifo_drain_recs(struct es_fifo *fifo, unsigned int recsize,
+				unsigned int max, es_fifo_drain_fn fn, void *arg)
+{
+	unsigned int used, pos, len, i;
+	unsigned char hdr[2] = {0, 0};
+
+	if (recsize == 0 || recsize > 2)
+		return 0;
+
+	used = es_fifo_len(fifo);
+	if (used < recsize)
+		__es_fifo_stat_empty_read(fifo);
+
+	/* sample fifo->in before reading the records */
+	es_smp_rmb();
+
+	pos = fifo->out;
+	for (i = 0; i < max && used >= recsize; i++) {
+		__es_fifo_copy_out(fifo, hdr, recsize, pos);
+		len = hdr[0] | (recsize > 1 ? hdr[1] << 8 : 0);
+		if (used < len + recsize)
+			break;
+		if (__es_fifo_drain_one(fifo, pos + recsize, len, fn, arg))
+			break;
+
+		pos += len + recsize;
+		used -= len + recsize;
+	}
+
+	if (i)
+		__es_fifo_add_out(fifo, pos - fifo->out);
+	return i;
+}
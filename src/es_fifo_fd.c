@@ -0,0 +1,193 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_fd.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE	/* splice(), vmsplice() */
+#endif
+#include <es_fifo.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * es_fifo_from_fd - read from a file descriptor straight into the FIFO
+ * @fifo: the fifo to be used.
+ * @fd: the file descriptor to read from
+ * @len: the maximum number of bytes to read
+ *
+ * One readv() into the free space of the FIFO, no bounce buffer.
+ *
+ * Returns the number of bytes added, 0 on end of file, or -1 with errno
+ * set: ENOBUFS if the FIFO is full, or the error of readv().
+ */
+ssize_t es_fifo_from_fd(struct es_fifo *fifo, int fd, unsigned int len)
+{
+	struct iovec vec[2];
+	unsigned int n;
+	ssize_t ret;
+
+	n = es_fifo_prepare_write(fifo, vec, len);
+	if (!n) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	ret = readv(fd, vec, n);
+	if (ret > 0)
+		es_fifo_commit_write(fifo, ret);
+	return ret;
+}
+
+/**
+ * es_fifo_to_fd - write FIFO data straight to a file descriptor
+ * @fifo: the fifo to be used.
+ * @fd: the file descriptor to write to
+ * @len: the maximum number of bytes to write
+ *
+ * One writev() from the queued data of the FIFO, no bounce buffer. Only
+ * the bytes accepted by writev() are removed from the FIFO.
+ *
+ * Returns the number of bytes removed (0 if the FIFO is empty), or -1
+ * with errno set: EINVAL in overwrite mode, which has no zero-copy
+ * reads, or the error of writev().
+ */
+ssize_t es_fifo_to_fd(struct es_fifo *fifo, int fd, unsigned int len)
+{
+	struct iovec vec[2];
+	unsigned int n;
+	ssize_t ret;
+
+	if (fifo->flags & ES_FIFO_F_OVERWRITE) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	n = es_fifo_peek_read(fifo, vec, len);
+	if (!n)
+		return 0;
+
+	ret = writev(fd, vec, n);
+	if (ret > 0)
+		es_fifo_release_read(fifo, ret);
+	return ret;
+}
+
+#if defined(__linux__) && defined(SPLICE_F_MOVE)
+/*
+ * _es_pipe_discard internal helper function for throwing away @len bytes
+ * queued in a pipe
+ */
+static void _es_pipe_discard(int rfd, ssize_t len)
+{
+	char sink[256];
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = read(rfd, sink, min((ssize_t)sizeof(sink), len));
+		if (ret <= 0 && errno != EINTR)
+			break;
+		if (ret > 0)
+			len -= ret;
+	}
+}
+#endif
+
+/**
+ * es_fifo_to_fd_splice - move FIFO data to a file descriptor via a pipe
+ * @fifo: the fifo to be used.
+ * @pipefd: an empty pipe, as created by pipe()
+ * @fd: the file descriptor to write to
+ * @len: the maximum number of bytes to move
+ *
+ * The queued data is attached to the pipe with vmsplice(), which maps
+ * the ring pages instead of copying them, then spliced into @fd. The
+ * bytes are released from the FIFO only after they left the pipe, since
+ * the pipe still references the ring memory until then, so the pipe is
+ * empty again on return.
+ *
+ * The pages are only referenced, not gifted: whoever holds a reference
+ * reads the ring as it is then, so @fd must take its copy before
+ * splice() returns. A regular file copies into the page cache; a socket
+ * or another pipe keeps the references after splice() returned, and
+ * would see the bytes the producer writes over the released space.
+ * Only regular files are accepted, use es_fifo_to_fd() for the others.
+ *
+ * For small transfers es_fifo_to_fd() is cheaper too. There is no
+ * es_fifo_from_fd_splice(): getting data from a pipe into user memory is
+ * always a copy, which readv() already does.
+ *
+ * Returns the number of bytes removed, or -1 with errno set: EINVAL if
+ * @fd is not a regular file or the fifo is in overwrite mode, ENOSYS if
+ * the platform has no splice support.
+ */
+ssize_t es_fifo_to_fd_splice(struct es_fifo *fifo, int pipefd[2], int fd,
+				unsigned int len)
+{
+#if defined(__linux__) && defined(SPLICE_F_MOVE)
+	struct iovec vec[2];
+	unsigned int n;
+	struct stat st;
+	ssize_t in, out, ret;
+	int err;
+
+	if (fstat(fd, &st))
+		return -1;
+	if (!S_ISREG(st.st_mode) || (fifo->flags & ES_FIFO_F_OVERWRITE)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	n = es_fifo_peek_read(fifo, vec, len);
+	if (!n)
+		return 0;
+
+	in = vmsplice(pipefd[1], vec, n, 0);
+	if (in <= 0)
+		return in;
+
+	for (out = 0; out < in; out += ret) {
+		ret = splice(pipefd[0], NULL, fd, NULL, in - out, SPLICE_F_MOVE);
+		if (ret > 0)
+			continue;
+		if (ret < 0 && errno == EINTR) {
+			ret = 0;
+			continue;
+		}
+
+		/*
+		 * the rest is still queued in the fifo, drop it from the pipe
+		 * so the next call starts with an empty pipe again
+		 */
+		err = ret ? errno : EIO;
+		_es_pipe_discard(pipefd[0], in - out);
+		errno = err;
+		break;
+	}
+
+	if (out)
+		es_fifo_release_read(fifo, out);
+	return out ? out : -1;
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
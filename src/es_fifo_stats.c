@@ -0,0 +1,194 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_stats.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo_stats.h>
+
+#ifdef ES_FIFO_STATS
+#include <pthread.h>
+#include <string.h>
+
+static ES_LIST_HEAD(es_fifo_registry);
+static pthread_mutex_t es_fifo_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * es_fifo_stats_register - add a fifo to the stats registry
+ * @fifo: the fifo, initialized already
+ * @name: name shown by es_fifo_stats_dump(), may be NULL. The string is
+ *	not copied and must stay valid while the fifo is registered.
+ *
+ * Registering a registered fifo again only changes its name. Unregister
+ * it before the fifo goes away, es_fifo_free() does that on its own.
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_fifo_stats_register(struct es_fifo *fifo, const char *name)
+{
+	if (!fifo)
+		return ES_INVALID_PARAM;
+
+	pthread_mutex_lock(&es_fifo_registry_lock);
+	if (!fifo->stats_node.next)
+		es_list_add_tail(&fifo->stats_node, &es_fifo_registry);
+	fifo->stats_name = name;
+	pthread_mutex_unlock(&es_fifo_registry_lock);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_fifo_stats_unregister - remove a fifo from the stats registry
+ * @fifo: the fifo, registered or not
+ */
+void es_fifo_stats_unregister(struct es_fifo *fifo)
+{
+	pthread_mutex_lock(&es_fifo_registry_lock);
+	if (fifo->stats_node.next) {
+		es_list_del(&fifo->stats_node);
+		fifo->stats_node.next = fifo->stats_node.prev = NULL;
+	}
+	pthread_mutex_unlock(&es_fifo_registry_lock);
+}
+
+/**
+ * es_fifo_stats_forget - remove a fifo from the stats registry, if there
+ * @fifo: the fifo, its links may be garbage
+ *
+ * Unlike es_fifo_stats_unregister() this does not trust @fifo->stats_node,
+ * it looks for @fifo in the registry, so it is safe on a fifo which was
+ * never initialized. Used when a fifo is (re)initialized, O(registered).
+ */
+void es_fifo_stats_forget(struct es_fifo *fifo)
+{
+	struct es_fifo *pos;
+
+	pthread_mutex_lock(&es_fifo_registry_lock);
+	es_list_for_each_entry(pos, &es_fifo_registry, stats_node)
+		if (pos == fifo) {
+			es_list_del(&fifo->stats_node);
+			break;
+		}
+	pthread_mutex_unlock(&es_fifo_registry_lock);
+}
+
+/**
+ * es_fifo_stats_get - take a snapshot of the counters of a fifo
+ * @fifo: the fifo to be used.
+ * @st: where the counters are copied
+ *
+ * Safe while both sides are running and costs nothing to them; every
+ * counter is read untorn, but the counters are not sampled at a single
+ * instant, e.g. bytes_out may already include bytes not yet in bytes_in.
+ */
+void es_fifo_stats_get(struct es_fifo *fifo, struct es_fifo_stats *st)
+{
+	unsigned int i;
+
+	memset(st, 0, sizeof(*st));
+	st->bytes_in = ES_READ_ONCE(fifo->stats.bytes_in);
+	st->short_writes = ES_READ_ONCE(fifo->stats.short_writes);
+	st->peak = ES_READ_ONCE(fifo->stats.peak);
+	st->bytes_out = ES_READ_ONCE(fifo->stats.bytes_out);
+	st->empty_reads = ES_READ_ONCE(fifo->stats.empty_reads);
+	for (i = 0; i < ES_FIFO_STATS_HIST; i++) {
+		st->hist_in[i] = ES_READ_ONCE(fifo->stats.hist_in[i]);
+		st->hist_out[i] = ES_READ_ONCE(fifo->stats.hist_out[i]);
+	}
+}
+
+/**
+ * es_fifo_stats_reset - clear the counters of a fifo
+ * @fifo: the fifo to be used.
+ *
+ * The counters belong to the producer and the consumer, only reset them
+ * while neither side is active.
+ */
+void es_fifo_stats_reset(struct es_fifo *fifo)
+{
+	memset(&fifo->stats, 0, sizeof(fifo->stats));
+}
+
+/**
+ * es_fifo_stats_for_each - walk the registered fifos
+ * @fn: called with a snapshot of every registered fifo
+ * @arg: passed to @fn
+ *
+ * The registry lock is held while @fn runs, @fn must not register or
+ * unregister fifos. The walk stops when @fn returns nonzero.
+ *
+ * Return the value of the last @fn call, 0 for an empty registry
+ */
+int es_fifo_stats_for_each(es_fifo_stats_fn fn, void *arg)
+{
+	struct es_fifo *fifo;
+	struct es_fifo_stats st;
+	int ret = 0;
+
+	pthread_mutex_lock(&es_fifo_registry_lock);
+	es_list_for_each_entry(fifo, &es_fifo_registry, stats_node) {
+		es_fifo_stats_get(fifo, &st);
+		ret = fn(fifo, fifo->stats_name, &st, arg);
+		if (ret)
+			break;
+	}
+	pthread_mutex_unlock(&es_fifo_registry_lock);
+	return ret;
+}
+
+static void _es_fifo_stats_dump_hist(FILE *fp, const char *tag,
+				const unsigned long *hist)
+{
+	unsigned int i;
+
+	fprintf(fp, "  %s", tag);
+	for (i = 0; i < ES_FIFO_STATS_HIST; i++) {
+		if (hist[i])
+			fprintf(fp, " %u+:%lu", 1U << i, hist[i]);
+	}
+	fprintf(fp, "\n");
+}
+
+static int _es_fifo_stats_dump_one(struct es_fifo *fifo, const char *name,
+				const struct es_fifo_stats *st, void *arg)
+{
+	FILE *fp = arg;
+
+	if (name)
+		fprintf(fp, "%s:", name);
+	else
+		fprintf(fp, "%p:", (void *)fifo);
+	fprintf(fp, " size %u len %u peak %lu in %lu out %lu "
+		"short_writes %lu empty_reads %lu dropped %lu\n",
+		es_fifo_size(fifo), es_fifo_len(fifo), st->peak,
+		st->bytes_in, st->bytes_out, st->short_writes,
+		st->empty_reads, es_fifo_dropped(fifo));
+	_es_fifo_stats_dump_hist(fp, "in ", st->hist_in);
+	_es_fifo_stats_dump_hist(fp, "out", st->hist_out);
+	return 0;
+}
+
+/**
+ * es_fifo_stats_dump - print the counters of all registered fifos
+ * @fp: where to print, e.g. stderr
+ */
+void es_fifo_stats_dump(FILE *fp)
+{
+	es_fifo_stats_for_each(_es_fifo_stats_dump_one, fp);
+}
+#endif
+
@@ -0,0 +1,257 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_heap.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_heap.h>
+#include <stdlib.h>
+
+#define ES_HEAP_MIN_SIZE	16
+/* keeps the child index of the last node in range */
+#define ES_HEAP_MAX_SIZE	(~0U / (ES_HEAP_ARITY * 2))
+
+#define ES_HEAP_PARENT(i)	(((i) - 1) / ES_HEAP_ARITY)
+#define ES_HEAP_CHILD(i)	((i) * ES_HEAP_ARITY + 1)
+
+/*
+ * _es_heap_sift_up internal helper function for moving @node up from the
+ * hole at @i to where its parent is not larger
+ */
+static void _es_heap_sift_up(struct es_heap *heap, struct es_heap_node *node,
+			unsigned int i)
+{
+	struct es_heap_node **nodes = heap->nodes, *parent;
+
+	while (i) {
+		parent = nodes[ES_HEAP_PARENT(i)];
+		if (!heap->less(node, parent))
+			break;
+		nodes[i] = parent;
+		parent->index = i;
+		i = ES_HEAP_PARENT(i);
+	}
+	nodes[i] = node;
+	node->index = i;
+}
+
+/*
+ * _es_heap_sift_down internal helper function for moving @node down from
+ * the hole at @i to where no child is smaller
+ */
+static void _es_heap_sift_down(struct es_heap *heap, struct es_heap_node *node,
+			unsigned int i)
+{
+	struct es_heap_node **nodes = heap->nodes;
+	unsigned int c, last, best;
+
+	while ((c = ES_HEAP_CHILD(i)) < heap->nr) {
+		last = min(c + ES_HEAP_ARITY, heap->nr);
+		for (best = c++; c < last; c++)
+			if (heap->less(nodes[c], nodes[best]))
+				best = c;
+		if (!heap->less(nodes[best], node))
+			break;
+		nodes[i] = nodes[best];
+		nodes[i]->index = i;
+		i = best;
+	}
+	nodes[i] = node;
+	node->index = i;
+}
+
+/*
+ * _es_heap_reserve internal helper function for making room for @n more
+ * nodes
+ */
+static int _es_heap_reserve(struct es_heap *heap, unsigned int n)
+{
+	struct es_heap_node **nodes;
+	unsigned int size;
+
+	if (n <= heap->size - heap->nr)
+		return ES_SUCCESS;
+	if (n > ES_HEAP_MAX_SIZE - heap->nr)
+		return ES_FAIL;
+
+	size = max(heap->size, (unsigned int)ES_HEAP_MIN_SIZE / 2);
+	while (size < heap->nr + n)
+		size = min(size * 2, (unsigned int)ES_HEAP_MAX_SIZE);
+	nodes = realloc(heap->nodes, size * sizeof(*nodes));
+	if (!nodes)
+		return ES_FAIL;
+	heap->nodes = nodes;
+	heap->size = size;
+	return ES_SUCCESS;
+}
+
+/**
+ * es_heap_init - initialize a heap
+ * @heap: the heap to be initialized
+ * @size: the number of nodes to make room for, it grows when needed
+ * @less: true if the first node sorts before the second
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_heap_init(struct es_heap *heap, unsigned int size, es_heap_less_t less)
+{
+	if (!less)
+		return ES_INVALID_PARAM;
+
+	heap->nodes = NULL;
+	heap->nr = 0;
+	heap->size = 0;
+	heap->less = less;
+	return size ? _es_heap_reserve(heap, size) : ES_SUCCESS;
+}
+
+/**
+ * es_heap_destroy - free the array of a heap
+ * @heap: the heap to be destroyed
+ *
+ * The nodes still queued are left alone, reinitialize them with
+ * es_heap_node_init() before queueing them again.
+ */
+void es_heap_destroy(struct es_heap *heap)
+{
+	free(heap->nodes);
+	heap->nodes = NULL;
+	heap->nr = 0;
+	heap->size = 0;
+}
+
+/**
+ * es_heap_push - queue a node
+ * @heap: the heap to be used
+ * @node: the node, not queued
+ *
+ * Return 0 if no error, ES_FAIL if @node is queued already or out of
+ * memory.
+ */
+int es_heap_push(struct es_heap *heap, struct es_heap_node *node)
+{
+	if (es_heap_queued(node) || _es_heap_reserve(heap, 1))
+		return ES_FAIL;
+
+	_es_heap_sift_up(heap, node, heap->nr++);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_heap_push_bulk - queue many nodes at once
+ * @heap: the heap to be used
+ * @nodes: the nodes, none of them queued
+ * @n: the number of nodes
+ *
+ * When the batch is at least as large as the heap, the whole array is
+ * heapified bottom up in O(n), otherwise each node sifts up on its own.
+ * Return 0 if no error, ES_FAIL if a node is queued already or out of
+ * memory, in which case nothing is queued.
+ */
+int es_heap_push_bulk(struct es_heap *heap, struct es_heap_node **nodes,
+			unsigned int n)
+{
+	unsigned int i, old = heap->nr;
+
+	for (i = 0; i < n; i++)
+		if (es_heap_queued(nodes[i]))
+			return ES_FAIL;
+	if (_es_heap_reserve(heap, n))
+		return ES_FAIL;
+
+	if (n < old) {
+		for (i = 0; i < n; i++)
+			_es_heap_sift_up(heap, nodes[i], heap->nr++);
+		return ES_SUCCESS;
+	}
+
+	for (i = 0; i < n; i++) {
+		heap->nodes[old + i] = nodes[i];
+		nodes[i]->index = old + i;
+	}
+	heap->nr += n;
+	if (heap->nr < 2)
+		return ES_SUCCESS;
+	/* from the parent of the last node back to the root */
+	for (i = ES_HEAP_PARENT(heap->nr - 1) + 1; i-- > 0;)
+		_es_heap_sift_down(heap, heap->nodes[i], i);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_heap_remove - dequeue a node
+ * @heap: the heap to be used
+ * @node: the node, queued on @heap
+ */
+void es_heap_remove(struct es_heap *heap, struct es_heap_node *node)
+{
+	unsigned int i = node->index;
+	struct es_heap_node *last = heap->nodes[--heap->nr];
+
+	node->index = ES_HEAP_NOT_QUEUED;
+	if (last == node)
+		return;
+
+	/* the last node fills the hole, in either direction */
+	if (i && heap->less(last, heap->nodes[ES_HEAP_PARENT(i)]))
+		_es_heap_sift_up(heap, last, i);
+	else
+		_es_heap_sift_down(heap, last, i);
+}
+
+/**
+ * es_heap_pop - dequeue the smallest node
+ * @heap: the heap to be used
+ *
+ * Return the node, or NULL if the heap is empty.
+ */
+struct es_heap_node *es_heap_pop(struct es_heap *heap)
+{
+	struct es_heap_node *node = es_heap_peek(heap);
+
+	if (node)
+		es_heap_remove(heap, node);
+	return node;
+}
+
+/**
+ * es_heap_decrease - restore the order after the key of a node decreased
+ * @heap: the heap to be used
+ * @node: the node, queued on @heap
+ *
+ * The key must not have grown, use es_heap_update() when unsure.
+ */
+void es_heap_decrease(struct es_heap *heap, struct es_heap_node *node)
+{
+	_es_heap_sift_up(heap, node, node->index);
+}
+
+/**
+ * es_heap_update - restore the order after the key of a node changed
+ * @heap: the heap to be used
+ * @node: the node, queued on @heap
+ */
+void es_heap_update(struct es_heap *heap, struct es_heap_node *node)
+{
+	unsigned int i = node->index;
+
+	if (i && heap->less(node, heap->nodes[ES_HEAP_PARENT(i)]))
+		_es_heap_sift_up(heap, node, i);
+	else
+		_es_heap_sift_down(heap, node, i);
+}
+
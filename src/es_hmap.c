@@ -0,0 +1,614 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_hmap.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_hmap.h>
+#include <es_hash.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ES_HMAP_NEON
+#endif
+
+#define ES_HMAP_GROUP		16	/* control bytes probed at once */
+#define ES_HMAP_EMPTY		0x80
+#define ES_HMAP_DELETED		0xfe
+#define ES_HMAP_MIN_CAP		ES_HMAP_GROUP
+#define ES_HMAP_MAX_CAP		(1U << 29)	/* 25 bits of hash pick the group */
+
+/* groups of the old table moved per insert or erase while rehashing */
+#define ES_HMAP_MIGRATE_GROUPS	2
+
+#define ES_HMAP_NOT_FOUND	(~0U)
+
+/*
+ * Group match masks: one bit per control byte for SSE2 and the loop,
+ * the top bit of one nibble per control byte for NEON, which has no
+ * movemask. Either way the lowest set bit is the first matching slot.
+ */
+#ifdef ES_HMAP_NEON
+typedef uint64_t es_hmap_mask;
+#define ES_HMAP_MASK_SHIFT	2
+
+static inline es_hmap_mask __es_hmap_neon_mask(uint8x16_t cmp)
+{
+	uint8x8_t nib = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+
+	return vget_lane_u64(vreinterpret_u64_u8(nib), 0) &
+		0x8888888888888888ULL;
+}
+
+static inline es_hmap_mask __es_hmap_match(const unsigned char *g,
+		unsigned char h2)
+{
+	return __es_hmap_neon_mask(vceqq_u8(vld1q_u8(g), vdupq_n_u8(h2)));
+}
+
+/* empty or deleted, both have the top bit set */
+static inline es_hmap_mask __es_hmap_match_free(const unsigned char *g)
+{
+	return __es_hmap_neon_mask(vtstq_u8(vld1q_u8(g), vdupq_n_u8(0x80)));
+}
+#else
+typedef uint32_t es_hmap_mask;
+#define ES_HMAP_MASK_SHIFT	0
+
+#ifdef __SSE2__
+static inline es_hmap_mask __es_hmap_match(const unsigned char *g,
+		unsigned char h2)
+{
+	__m128i ctrl = _mm_load_si128((const __m128i *)g);
+
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)));
+}
+
+static inline es_hmap_mask __es_hmap_match_free(const unsigned char *g)
+{
+	return _mm_movemask_epi8(_mm_load_si128((const __m128i *)g));
+}
+#else
+static inline es_hmap_mask __es_hmap_match(const unsigned char *g,
+		unsigned char h2)
+{
+	es_hmap_mask m = 0;
+	unsigned int i;
+
+	for (i = 0; i < ES_HMAP_GROUP; i++)
+		m |= (es_hmap_mask)(g[i] == h2) << i;
+	return m;
+}
+
+static inline es_hmap_mask __es_hmap_match_free(const unsigned char *g)
+{
+	es_hmap_mask m = 0;
+	unsigned int i;
+
+	for (i = 0; i < ES_HMAP_GROUP; i++)
+		m |= (es_hmap_mask)(g[i] >> 7) << i;
+	return m;
+}
+#endif
+#endif
+
+static inline es_hmap_mask __es_hmap_match_empty(const unsigned char *g)
+{
+	return __es_hmap_match(g, ES_HMAP_EMPTY);
+}
+
+static inline unsigned int __es_hmap_lane(es_hmap_mask m)
+{
+	return __builtin_ctzll(m) >> ES_HMAP_MASK_SHIFT;
+}
+
+static uint32_t _es_hmap_hash_bytes(const void *key, unsigned int ksize)
+{
+	return es_hash_mem(key, ksize, 0);
+}
+
+static int _es_hmap_eq_bytes(const void *a, const void *b, unsigned int ksize)
+{
+	return !memcmp(a, b, ksize);
+}
+
+/*
+ * __es_hmap_hash internal helper function for the hash of @key, mixed so
+ * that both the group index (high bits) and the control byte (low 7
+ * bits) are usable even for an identity hash
+ */
+static inline uint32_t __es_hmap_hash(struct es_hmap *map, const void *key)
+{
+	uint32_t h = map->hashfn(key, map->ksize);
+
+	h ^= h >> 16;
+	h *= 0x85ebca6bU;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35U;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline unsigned char __es_hmap_h2(uint32_t hash)
+{
+	return hash & 0x7f;
+}
+
+static inline unsigned char *__es_hmap_slot(struct es_hmap *map,
+		struct es_hmap_table *t, unsigned int idx)
+{
+	return t->slots + (size_t)idx * map->stride;
+}
+
+static inline unsigned int __es_hmap_max_load(unsigned int cap)
+{
+	return cap - cap / 8;
+}
+
+static int _es_hmap_table_alloc(struct es_hmap *map, struct es_hmap_table *t,
+		unsigned int cap)
+{
+	void *ctrl;
+
+	if (posix_memalign(&ctrl, ES_HMAP_GROUP, cap))
+		return ES_FAIL;
+	t->slots = malloc((size_t)cap * map->stride);
+	if (!t->slots) {
+		free(ctrl);
+		return ES_FAIL;
+	}
+
+	t->ctrl = ctrl;
+	memset(t->ctrl, ES_HMAP_EMPTY, cap);
+	t->mask = cap - 1;
+	t->count = 0;
+	t->growth_left = __es_hmap_max_load(cap);
+	return ES_SUCCESS;
+}
+
+static void _es_hmap_table_free(struct es_hmap_table *t)
+{
+	free(t->ctrl);
+	free(t->slots);
+	memset(t, 0, sizeof(*t));
+}
+
+/*
+ * __es_hmap_probe_find internal helper function for the slot holding
+ * @key in @t, ES_HMAP_NOT_FOUND if none. Groups are probed in
+ * triangular order, which visits every group of a power of 2 table.
+ */
+static inline unsigned int __es_hmap_probe_find(struct es_hmap *map,
+		struct es_hmap_table *t, const void *key, uint32_t hash)
+{
+	unsigned int gmask = t->mask / ES_HMAP_GROUP;
+	unsigned int g = (hash >> 7) & gmask;
+	unsigned char h2 = __es_hmap_h2(hash);
+	const unsigned char *ctrl;
+	unsigned int i, idx;
+	es_hmap_mask m;
+
+	for (i = 0; i <= gmask; i++) {
+		ctrl = t->ctrl + g * ES_HMAP_GROUP;
+		for (m = __es_hmap_match(ctrl, h2); m; m &= m - 1) {
+			idx = g * ES_HMAP_GROUP + __es_hmap_lane(m);
+			if (map->eqfn(__es_hmap_slot(map, t, idx), key,
+				map->ksize))
+				return idx;
+		}
+		/* the key would have been stored in the first free group */
+		if (__es_hmap_match_empty(ctrl))
+			break;
+		g = (g + i + 1) & gmask;
+	}
+	return ES_HMAP_NOT_FOUND;
+}
+
+/*
+ * __es_hmap_probe_free internal helper function for the first empty or
+ * deleted slot on the probe sequence of @hash; the load limit keeps at
+ * least one empty slot in every table
+ */
+static inline unsigned int __es_hmap_probe_free(struct es_hmap_table *t,
+		uint32_t hash)
+{
+	unsigned int gmask = t->mask / ES_HMAP_GROUP;
+	unsigned int g = (hash >> 7) & gmask;
+	unsigned int i;
+	es_hmap_mask m;
+
+	for (i = 0; ; i++) {
+		m = __es_hmap_match_free(t->ctrl + g * ES_HMAP_GROUP);
+		if (m)
+			return g * ES_HMAP_GROUP + __es_hmap_lane(m);
+		g = (g + i + 1) & gmask;
+	}
+}
+
+/*
+ * __es_hmap_place internal helper function for claiming a slot for a key
+ * known to be absent from @t, returns the slot index
+ */
+static inline unsigned int __es_hmap_place(struct es_hmap_table *t,
+		uint32_t hash)
+{
+	unsigned int idx = __es_hmap_probe_free(t, hash);
+
+	if (t->ctrl[idx] == ES_HMAP_EMPTY && t->growth_left)
+		t->growth_left--;
+	t->ctrl[idx] = __es_hmap_h2(hash);
+	t->count++;
+	return idx;
+}
+
+/*
+ * __es_hmap_clear_slot internal helper function for freeing a full slot.
+ * A probe never stops in a group with an empty slot left, so such a
+ * slot can go back to empty; otherwise it must become a tombstone to
+ * keep the probe chains running through the group intact.
+ */
+static inline void __es_hmap_clear_slot(struct es_hmap_table *t,
+		unsigned int idx)
+{
+	const unsigned char *g = t->ctrl + (idx & ~(ES_HMAP_GROUP - 1));
+
+	if (__es_hmap_match_empty(g)) {
+		t->ctrl[idx] = ES_HMAP_EMPTY;
+		t->growth_left++;
+	} else {
+		t->ctrl[idx] = ES_HMAP_DELETED;
+	}
+	t->count--;
+}
+
+/*
+ * __es_hmap_move internal helper function for moving slot @idx of the old
+ * table into the current one
+ */
+static inline unsigned int __es_hmap_move(struct es_hmap *map,
+		unsigned int idx)
+{
+	unsigned char *src = __es_hmap_slot(map, &map->old, idx);
+	uint32_t hash = __es_hmap_hash(map, src);
+	unsigned int to = __es_hmap_place(&map->cur, hash);
+
+	memcpy(__es_hmap_slot(map, &map->cur, to), src, map->stride);
+	/* a tombstone, the old table is still probed for the others */
+	map->old.ctrl[idx] = ES_HMAP_DELETED;
+	map->old.count--;
+	return to;
+}
+
+/*
+ * _es_hmap_migrate internal helper function for moving @ngroups groups
+ * of the old table, frees it once it is empty
+ */
+static void _es_hmap_migrate(struct es_hmap *map, unsigned int ngroups)
+{
+	unsigned int end, idx;
+
+	if (!map->old.ctrl)
+		return;
+
+	while (ngroups-- && map->old.count) {
+		end = map->migrate_pos + ES_HMAP_GROUP;
+		for (idx = map->migrate_pos; idx < end; idx++) {
+			if (!(map->old.ctrl[idx] & 0x80))
+				__es_hmap_move(map, idx);
+		}
+		map->migrate_pos = end;
+	}
+
+	if (!map->old.count)
+		_es_hmap_table_free(&map->old);
+}
+
+static unsigned int _es_hmap_cap(unsigned int size)
+{
+	unsigned long long cap = (unsigned long long)size * 8 / 7 + 1;
+
+	if (cap > ES_HMAP_MAX_CAP)
+		return 0;
+	return max((unsigned int)es_roundup_pow_of_two(cap),
+		(unsigned int)ES_HMAP_MIN_CAP);
+}
+
+/*
+ * _es_hmap_start_rehash internal helper function for switching to a new
+ * table of @cap slots; the entries follow in _es_hmap_migrate()
+ */
+static int _es_hmap_start_rehash(struct es_hmap *map, unsigned int cap)
+{
+	struct es_hmap_table t;
+
+	/* at most one move in flight */
+	_es_hmap_migrate(map, ~0U);
+
+	if (_es_hmap_table_alloc(map, &t, cap))
+		return ES_FAIL;
+
+	map->old = map->cur;
+	map->cur = t;
+	map->migrate_pos = 0;
+	if (!map->old.count)
+		_es_hmap_table_free(&map->old);
+	return ES_SUCCESS;
+}
+
+/*
+ * _es_hmap_make_room internal helper function for ensuring one more
+ * insert fits the current table
+ */
+static int _es_hmap_make_room(struct es_hmap *map)
+{
+	unsigned int cap = es_hmap_capacity(map);
+
+	if (map->cur.growth_left)
+		return ES_SUCCESS;
+
+	/*
+	 * Full of tombstones rather than entries: rehash at the same size.
+	 * Both cases leave room for the entries still in flight, the new
+	 * table has at least 7/16 of its slots free when the move starts
+	 * and the move finishes within cap / 32 inserts.
+	 */
+	if (es_hmap_count(map) > cap * 7 / 16) {
+		if (cap >= ES_HMAP_MAX_CAP)
+			return ES_FAIL;
+		cap *= 2;
+	}
+	return _es_hmap_start_rehash(map, cap);
+}
+
+/**
+ * es_hmap_init - initialize a hash map
+ * @map: the map to be initialized
+ * @ksize: the size of a key in bytes
+ * @vsize: the size of a value in bytes, may be 0 for a set
+ * @size: expected number of entries, 0 for a small start
+ * @hashfn: hash function, NULL to hash the key bytes
+ * @eqfn: key compare, NULL to compare the key bytes
+ *
+ * Keys with padding or pointers inside need their own @hashfn and @eqfn.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_hmap_init(struct es_hmap *map, unsigned int ksize, unsigned int vsize,
+			unsigned int size, es_hmap_hash_fn hashfn,
+			es_hmap_eq_fn eqfn)
+{
+	unsigned int cap = _es_hmap_cap(size);
+
+	memset(map, 0, sizeof(*map));
+	if (!ksize || !cap)
+		return ES_INVALID_PARAM;
+
+	map->ksize = ksize;
+	map->vsize = vsize;
+	map->voff = (ksize + 7) & ~7U;
+	map->stride = (map->voff + vsize + 7) & ~7U;
+	map->hashfn = hashfn ? hashfn : _es_hmap_hash_bytes;
+	map->eqfn = eqfn ? eqfn : _es_hmap_eq_bytes;
+
+	return _es_hmap_table_alloc(map, &map->cur, cap);
+}
+
+/**
+ * es_hmap_destroy - free the tables of a map
+ * @map: the map to be used.
+ */
+void es_hmap_destroy(struct es_hmap *map)
+{
+	_es_hmap_table_free(&map->cur);
+	_es_hmap_table_free(&map->old);
+}
+
+/**
+ * es_hmap_reserve - make room for a number of entries at once
+ * @map: the map to be used.
+ * @size: number of entries the map shall hold without growing
+ *
+ * Unlike the growth on insert, this rehashes all entries in the call.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_hmap_reserve(struct es_hmap *map, unsigned int size)
+{
+	unsigned int cap = _es_hmap_cap(max(size, es_hmap_count(map)));
+
+	if (!cap)
+		return ES_INVALID_PARAM;
+
+	_es_hmap_migrate(map, ~0U);
+	if (cap <= es_hmap_capacity(map))
+		return ES_SUCCESS;
+
+	if (_es_hmap_start_rehash(map, cap))
+		return ES_FAIL;
+	_es_hmap_migrate(map, ~0U);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_hmap_find - look up a key
+ * @map: the map to be used.
+ * @key: the key, ksize bytes
+ *
+ * Returns a pointer to the value of @key, or NULL. Never changes the
+ * map, so any number of readers may look up at once as long as nobody
+ * writes.
+ */
+void *es_hmap_find(struct es_hmap *map, const void *key)
+{
+	uint32_t hash = __es_hmap_hash(map, key);
+	unsigned int idx;
+
+	idx = __es_hmap_probe_find(map, &map->cur, key, hash);
+	if (idx != ES_HMAP_NOT_FOUND)
+		return __es_hmap_slot(map, &map->cur, idx) + map->voff;
+
+	if (map->old.ctrl) {
+		idx = __es_hmap_probe_find(map, &map->old, key, hash);
+		if (idx != ES_HMAP_NOT_FOUND)
+			return __es_hmap_slot(map, &map->old, idx) + map->voff;
+	}
+	return NULL;
+}
+
+/**
+ * es_hmap_insert - look up a key, adding it if missing
+ * @map: the map to be used.
+ * @key: the key, ksize bytes
+ * @existed: if not NULL, set to 1 if the key was there already, else 0
+ *
+ * Returns a pointer to the value of @key; the value of a new key is not
+ * initialized. NULL if the map could not grow.
+ */
+void *es_hmap_insert(struct es_hmap *map, const void *key, int *existed)
+{
+	uint32_t hash = __es_hmap_hash(map, key);
+	unsigned int idx;
+
+	_es_hmap_migrate(map, ES_HMAP_MIGRATE_GROUPS);
+
+	if (existed)
+		*existed = 1;
+	idx = __es_hmap_probe_find(map, &map->cur, key, hash);
+	if (idx != ES_HMAP_NOT_FOUND)
+		return __es_hmap_slot(map, &map->cur, idx) + map->voff;
+
+	if (map->old.ctrl) {
+		idx = __es_hmap_probe_find(map, &map->old, key, hash);
+		if (idx != ES_HMAP_NOT_FOUND) {
+			/* the move leaves room in cur, it never grows here */
+			idx = __es_hmap_move(map, idx);
+			return __es_hmap_slot(map, &map->cur, idx) + map->voff;
+		}
+	}
+
+	if (existed)
+		*existed = 0;
+	if (_es_hmap_make_room(map))
+		return NULL;
+
+	idx = __es_hmap_place(&map->cur, hash);
+	memcpy(__es_hmap_slot(map, &map->cur, idx), key, map->ksize);
+	return __es_hmap_slot(map, &map->cur, idx) + map->voff;
+}
+
+/**
+ * es_hmap_put - set the value of a key
+ * @map: the map to be used.
+ * @key: the key, ksize bytes
+ * @value: the value, vsize bytes
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_hmap_put(struct es_hmap *map, const void *key, const void *value)
+{
+	void *v = es_hmap_insert(map, key, NULL);
+
+	if (!v)
+		return ES_FAIL;
+	memcpy(v, value, map->vsize);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_hmap_erase - remove a key
+ * @map: the map to be used.
+ * @key: the key, ksize bytes
+ *
+ * Return 0 if removed, ES_FAIL if the key was not in the map
+ */
+int es_hmap_erase(struct es_hmap *map, const void *key)
+{
+	uint32_t hash = __es_hmap_hash(map, key);
+	unsigned int idx;
+
+	_es_hmap_migrate(map, ES_HMAP_MIGRATE_GROUPS);
+
+	idx = __es_hmap_probe_find(map, &map->cur, key, hash);
+	if (idx != ES_HMAP_NOT_FOUND) {
+		__es_hmap_clear_slot(&map->cur, idx);
+		return ES_SUCCESS;
+	}
+
+	if (map->old.ctrl) {
+		idx = __es_hmap_probe_find(map, &map->old, key, hash);
+		if (idx != ES_HMAP_NOT_FOUND) {
+			map->old.ctrl[idx] = ES_HMAP_DELETED;
+			map->old.count--;
+			if (!map->old.count)
+				_es_hmap_table_free(&map->old);
+			return ES_SUCCESS;
+		}
+	}
+	return ES_FAIL;
+}
+
+/**
+ * es_hmap_clear - remove all entries
+ * @map: the map to be used.
+ *
+ * The current table keeps its size.
+ */
+void es_hmap_clear(struct es_hmap *map)
+{
+	_es_hmap_table_free(&map->old);
+	memset(map->cur.ctrl, ES_HMAP_EMPTY, es_hmap_capacity(map));
+	map->cur.count = 0;
+	map->cur.growth_left = __es_hmap_max_load(es_hmap_capacity(map));
+}
+
+/**
+ * es_hmap_iter_next - get the next entry of an iteration
+ * @map: the map to be used.
+ * @iter: the iterator, set up by es_hmap_iter_init()
+ * @key: where the pointer to the key is stored, may be NULL
+ * @value: where the pointer to the value is stored, may be NULL
+ *
+ * Return 1 if an entry was found, 0 at the end of the map
+ */
+int es_hmap_iter_next(struct es_hmap *map, struct es_hmap_iter *iter,
+			void **key, void **value)
+{
+	struct es_hmap_table *t;
+	unsigned char *slot;
+
+	for (; iter->table < 2; iter->table++, iter->pos = 0) {
+		t = iter->table ? &map->old : &map->cur;
+		if (!t->ctrl)
+			continue;
+
+		for (; iter->pos <= t->mask; iter->pos++) {
+			if (t->ctrl[iter->pos] & 0x80)
+				continue;
+
+			slot = __es_hmap_slot(map, t, iter->pos++);
+			if (key)
+				*key = slot;
+			if (value)
+				*value = slot + map->voff;
+			return 1;
+		}
+	}
+	return 0;
+}
+
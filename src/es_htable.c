@@ -0,0 +1,235 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_htable.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_htable.h>
+#include <stdlib.h>
+
+/*
+ * _es_htable_bits internal helper function for the number of bucket bits
+ * holding @size objects at a load factor of at most one
+ */
+static unsigned int _es_htable_bits(unsigned int size)
+{
+	unsigned int bits = 1;
+
+	while (bits < ES_HTABLE_MAX_BITS && (1U << bits) < size)
+		bits++;
+	return bits;
+}
+
+/**
+ * es_htable_init - initialize a hash table
+ * @ht: the table to be initialized
+ * @ops: hash and compare functions, must stay valid for the table life
+ * @size: expected number of objects, 0 for a small start
+ * @flags: ES_HTABLE_F_* flags
+ *
+ * The bucket array is never shrunk below the size needed for @size.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_htable_init(struct es_htable *ht, const struct es_htable_ops *ops,
+			unsigned int size, unsigned int flags)
+{
+	unsigned int i;
+
+	ht->buckets = NULL;
+	ht->nelems = 0;
+	if (!ops || !ops->hashfn || !ops->obj_hashfn || !ops->matchfn)
+		return ES_INVALID_PARAM;
+
+	ht->ops = ops;
+	ht->flags = flags;
+	ht->bits = ht->min_bits = _es_htable_bits(size);
+	ht->buckets = malloc(sizeof(*ht->buckets) << ht->bits);
+	if (!ht->buckets)
+		return ES_FAIL;
+
+	for (i = 0; i < es_htable_size(ht); i++)
+		INIT_ES_HLIST_HEAD(&ht->buckets[i]);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_htable_destroy - free the bucket array of a table
+ * @ht: the table to be used.
+ *
+ * The objects are not touched, remove and free them first if they are
+ * owned by the table.
+ */
+void es_htable_destroy(struct es_htable *ht)
+{
+	free(ht->buckets);
+	ht->buckets = NULL;
+	ht->nelems = 0;
+}
+
+/**
+ * es_htable_resize - rehash into a new bucket array
+ * @ht: the table to be used.
+ * @size: number of objects to make room for, 0 to fit the current ones
+ *
+ * Shrinking happens only here, never behind the back of an iteration.
+ * On allocation failure the table keeps working with the old array.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_htable_resize(struct es_htable *ht, unsigned int size)
+{
+	struct es_hlist_head *old = ht->buckets, *buckets;
+	struct es_hlist_node *node, *tmp;
+	unsigned int old_size = es_htable_size(ht);
+	unsigned int bits, i;
+
+	bits = max(_es_htable_bits(max(size, ht->nelems)), ht->min_bits);
+	if (bits == ht->bits)
+		return ES_SUCCESS;
+
+	buckets = malloc(sizeof(*buckets) << bits);
+	if (!buckets)
+		return ES_FAIL;
+	for (i = 0; i < (1U << bits); i++)
+		INIT_ES_HLIST_HEAD(&buckets[i]);
+
+	ht->buckets = buckets;
+	ht->bits = bits;
+	/*
+	 * Walk each old chain from its tail, adding at the head keeps the
+	 * relative order: the duplicate added last is still found first.
+	 */
+	for (i = 0; i < old_size; i++) {
+		for (node = old[i].first; node && node->next; node = node->next)
+			;
+		while (node) {
+			tmp = node->pprev == &old[i].first ? NULL :
+				container_of(node->pprev, struct es_hlist_node,
+					next);
+			es_hlist_add_head(node,
+				es_htable_bucket(ht, ht->ops->obj_hashfn(node)));
+			node = tmp;
+		}
+	}
+
+	free(old);
+	return ES_SUCCESS;
+}
+
+static inline void __es_htable_grow(struct es_htable *ht)
+{
+	if (ht->nelems > es_htable_size(ht) && ht->bits < ES_HTABLE_MAX_BITS &&
+		!(ht->flags & ES_HTABLE_F_FIXED))
+		es_htable_resize(ht, es_htable_size(ht) * 2);
+}
+
+/**
+ * es_htable_add - add an object without looking for its key
+ * @ht: the table to be used.
+ * @node: the node embedded in the object
+ *
+ * Duplicate keys are allowed, es_htable_lookup() then finds the one
+ * added last.
+ */
+void es_htable_add(struct es_htable *ht, struct es_hlist_node *node)
+{
+	es_hlist_add_head(node, es_htable_bucket(ht, ht->ops->obj_hashfn(node)));
+	ht->nelems++;
+	__es_htable_grow(ht);
+}
+
+static inline struct es_hlist_node *__es_htable_find(struct es_htable *ht,
+		struct es_hlist_head *head, const void *key)
+{
+	struct es_hlist_node *node;
+
+	es_hlist_for_each(node, head) {
+		if (ht->ops->matchfn(node, key))
+			return node;
+	}
+	return NULL;
+}
+
+/**
+ * es_htable_insert - add an object unless its key is in the table
+ * @ht: the table to be used.
+ * @node: the node embedded in the object
+ * @key: the key of the object
+ *
+ * Returns NULL if @node was added, otherwise the node already holding
+ * @key, the table is then left alone.
+ */
+struct es_hlist_node *es_htable_insert(struct es_htable *ht,
+			struct es_hlist_node *node, const void *key)
+{
+	struct es_hlist_head *head;
+	struct es_hlist_node *old;
+
+	head = es_htable_bucket(ht, ht->ops->hashfn(key));
+	old = __es_htable_find(ht, head, key);
+	if (old)
+		return old;
+
+	es_hlist_add_head(node, head);
+	ht->nelems++;
+	__es_htable_grow(ht);
+	return NULL;
+}
+
+/**
+ * es_htable_lookup - find the object holding a key
+ * @ht: the table to be used.
+ * @key: the key to look for
+ *
+ * Returns the node of the object, or NULL. Use es_hlist_entry() to get
+ * the object.
+ */
+struct es_hlist_node *es_htable_lookup(struct es_htable *ht, const void *key)
+{
+	return __es_htable_find(ht, es_htable_bucket(ht, ht->ops->hashfn(key)),
+				key);
+}
+
+/**
+ * es_htable_del - remove an object
+ * @ht: the table to be used.
+ * @node: the node of the object, which must be in @ht
+ *
+ * O(1), the bucket needs not be searched. The table is not shrunk, so
+ * it is safe inside es_htable_for_each_entry_safe().
+ */
+void es_htable_del(struct es_htable *ht, struct es_hlist_node *node)
+{
+	es_hlist_del_init(node);
+	ht->nelems--;
+}
+
+/**
+ * es_htable_remove - find and remove the object holding a key
+ * @ht: the table to be used.
+ * @key: the key to look for
+ *
+ * Returns the node of the removed object, or NULL.
+ */
+struct es_hlist_node *es_htable_remove(struct es_htable *ht, const void *key)
+{
+	struct es_hlist_node *node = es_htable_lookup(ht, key);
+
+	if (node)
+		es_htable_del(ht, node);
+	return node;
+}
+
@@ -0,0 +1,437 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_idr.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_idr.h>
+#include <stdlib.h>
+
+#define ES_IDR_LONG_BITS	(sizeof(unsigned long) * 8)
+
+/*
+ * _es_idr_maxindex internal helper function for the largest ID below a
+ * node of @shift
+ */
+static inline unsigned long _es_idr_maxindex(unsigned int shift)
+{
+	if (shift + ES_IDR_BITS >= ES_IDR_LONG_BITS)
+		return ~0UL;
+	return (1UL << (shift + ES_IDR_BITS)) - 1;
+}
+
+/*
+ * _es_idr_base internal helper function for the first ID of the node of
+ * @shift which covers @id
+ */
+static inline unsigned long _es_idr_base(unsigned int shift, unsigned long id)
+{
+	return id & ~_es_idr_maxindex(shift);
+}
+
+static struct es_idr_node *_es_idr_node_alloc(struct es_idr *idr,
+			unsigned int shift, struct es_idr_node *parent,
+			unsigned int offset)
+{
+	struct es_idr_node *node = calloc(1, sizeof(*node));
+
+	if (!node)
+		return NULL;
+	node->shift = shift;
+	node->offset = offset;
+	node->parent = parent;
+	/* slots past the last ID of a top node never have a free ID */
+	if (shift + ES_IDR_BITS > ES_IDR_LONG_BITS)
+		node->full = ~0ULL << (1U << (ES_IDR_LONG_BITS - shift));
+	idr->nr_nodes++;
+	return node;
+}
+
+static void _es_idr_node_free(struct es_idr *idr, struct es_idr_node *node)
+{
+	unsigned int i;
+
+	if (node->shift)
+		for (i = 0; i < ES_IDR_SLOTS; i++)
+			if (node->slots[i])
+				_es_idr_node_free(idr, node->slots[i]);
+	free(node);
+	idr->nr_nodes--;
+}
+
+/**
+ * es_idr_init - initialize an idr
+ * @idr: the idr to be initialized
+ */
+void es_idr_init(struct es_idr *idr)
+{
+	idr->root = NULL;
+	pthread_mutex_init(&idr->lock, NULL);
+	idr->nr_nodes = 0;
+}
+
+/**
+ * es_idr_destroy - free the nodes of an idr
+ * @idr: the idr to be destroyed
+ *
+ * The pointers stored in the idr are left alone. No reader may use the
+ * idr any more.
+ */
+void es_idr_destroy(struct es_idr *idr)
+{
+	if (idr->root)
+		_es_idr_node_free(idr, idr->root);
+	idr->root = NULL;
+	pthread_mutex_destroy(&idr->lock);
+}
+
+/*
+ * _es_idr_find_free internal helper function for finding the lowest
+ * free ID at or above @start below @node, which covers @start
+ */
+static bool _es_idr_find_free(struct es_idr_node *node, unsigned long start,
+			unsigned long *id)
+{
+	unsigned long base = _es_idr_base(node->shift, start), slot_id;
+	unsigned int offset = (start - base) >> node->shift;
+	uint64_t bits;
+
+	for (;;) {
+		bits = ~node->full & (~0ULL << offset);
+		if (!bits)
+			return es_false;
+		offset = __builtin_ctzll(bits);
+		slot_id = base + ((unsigned long)offset << node->shift);
+		if (slot_id < start)
+			slot_id = start;
+		if (!node->shift || !node->slots[offset]) {
+			*id = slot_id;
+			return es_true;
+		}
+		/* free IDs of the subtree may all be below @start */
+		if (_es_idr_find_free(node->slots[offset], slot_id, id))
+			return es_true;
+		if (++offset == ES_IDR_SLOTS)
+			return es_false;
+	}
+}
+
+/*
+ * _es_idr_insert internal helper function for storing @ptr at the free
+ * @id, growing the tree as needed
+ */
+static int _es_idr_insert(struct es_idr *idr, unsigned long id, void *ptr)
+{
+	struct es_idr_node *root = idr->root, *node, *child;
+	unsigned int shift, offset;
+
+	if (!root) {
+		for (shift = 0; id > _es_idr_maxindex(shift); shift += ES_IDR_BITS)
+			;
+		root = _es_idr_node_alloc(idr, shift, NULL, 0);
+		if (!root)
+			return ES_FAIL;
+		es_rcu_assign_pointer(idr->root, root);
+	}
+
+	/* a taller root, the old one becomes its first slot */
+	while (id > _es_idr_maxindex(root->shift)) {
+		node = _es_idr_node_alloc(idr, root->shift + ES_IDR_BITS,
+				NULL, 0);
+		if (!node)
+			return ES_FAIL;
+		node->slots[0] = root;
+		if (root->full == ~0ULL)
+			node->full |= 1;
+		root->parent = node;
+		es_rcu_assign_pointer(idr->root, node);
+		root = node;
+	}
+
+	for (node = root; node->shift; node = child) {
+		offset = (id >> node->shift) & ES_IDR_MASK;
+		child = node->slots[offset];
+		if (!child) {
+			child = _es_idr_node_alloc(idr, node->shift - ES_IDR_BITS,
+					node, offset);
+			if (!child)
+				return ES_FAIL;
+			es_rcu_assign_pointer(node->slots[offset], child);
+		}
+	}
+
+	offset = id & ES_IDR_MASK;
+	es_rcu_assign_pointer(node->slots[offset], ptr);
+	node->full |= 1ULL << offset;
+	while (node->full == ~0ULL && node->parent) {
+		node->parent->full |= 1ULL << node->offset;
+		node = node->parent;
+	}
+	return ES_SUCCESS;
+}
+
+/**
+ * es_idr_alloc - allocate the lowest free ID in a range
+ * @idr: the idr to be used
+ * @ptr: the pointer to be stored, not NULL
+ * @id: the lowest ID to be allocated on input, the allocated ID on output
+ * @max: the highest ID to be allocated
+ *
+ * To allocate a given ID, pass it in @id and as @max.
+ * Return 0 if no error, ES_FAIL if the range is full or out of memory,
+ * ES_INVALID_PARAM for a bad argument.
+ */
+int es_idr_alloc(struct es_idr *idr, void *ptr, unsigned long *id,
+			unsigned long max)
+{
+	unsigned long start = *id, found;
+	struct es_idr_node *root;
+	int ret = ES_FAIL;
+
+	if (!ptr || start > max)
+		return ES_INVALID_PARAM;
+
+	pthread_mutex_lock(&idr->lock);
+	root = idr->root;
+	if (!root || start > _es_idr_maxindex(root->shift)) {
+		found = start;
+	} else if (!_es_idr_find_free(root, start, &found)) {
+		/* the first ID past the tree */
+		found = _es_idr_maxindex(root->shift) + 1;
+		if (!found)
+			goto out;
+	}
+	if (found <= max) {
+		ret = _es_idr_insert(idr, found, ptr);
+		if (!ret)
+			*id = found;
+	}
+out:
+	pthread_mutex_unlock(&idr->lock);
+	return ret;
+}
+
+/*
+ * _es_idr_leaf internal helper function for the bottom node holding
+ * @id, NULL if there is none
+ */
+static struct es_idr_node *_es_idr_leaf(struct es_idr *idr, unsigned long id)
+{
+	struct es_idr_node *node = idr->root;
+
+	if (!node || id > _es_idr_maxindex(node->shift))
+		return NULL;
+	while (node && node->shift)
+		node = node->slots[(id >> node->shift) & ES_IDR_MASK];
+	return node;
+}
+
+/**
+ * es_idr_replace - replace the pointer of an allocated ID
+ * @idr: the idr to be used
+ * @ptr: the new pointer, not NULL
+ * @id: the ID
+ *
+ * Return the old pointer, or NULL if @id is not allocated, in which
+ * case nothing is stored.
+ */
+void *es_idr_replace(struct es_idr *idr, void *ptr, unsigned long id)
+{
+	struct es_idr_node *node;
+	void *old = NULL;
+
+	if (!ptr)
+		return NULL;
+
+	pthread_mutex_lock(&idr->lock);
+	node = _es_idr_leaf(idr, id);
+	if (node) {
+		old = node->slots[id & ES_IDR_MASK];
+		if (old)
+			es_rcu_assign_pointer(node->slots[id & ES_IDR_MASK], ptr);
+	}
+	pthread_mutex_unlock(&idr->lock);
+	return old;
+}
+
+/**
+ * es_idr_remove - free an ID
+ * @idr: the idr to be used
+ * @id: the ID to be freed
+ *
+ * Readers may still find the pointer until es_synchronize_rcu().
+ * Return the pointer of @id, or NULL if it was not allocated.
+ */
+void *es_idr_remove(struct es_idr *idr, unsigned long id)
+{
+	struct es_idr_node *node;
+	unsigned int offset;
+	void *old = NULL;
+
+	pthread_mutex_lock(&idr->lock);
+	node = _es_idr_leaf(idr, id);
+	if (node)
+		old = node->slots[id & ES_IDR_MASK];
+	if (old) {
+		offset = id & ES_IDR_MASK;
+		ES_WRITE_ONCE(node->slots[offset], NULL);
+		node->full &= ~(1ULL << offset);
+		/* the ancestors which were full are not any more */
+		while (node->parent &&
+		       (node->parent->full & (1ULL << node->offset))) {
+			node->parent->full &= ~(1ULL << node->offset);
+			node = node->parent;
+		}
+	}
+	pthread_mutex_unlock(&idr->lock);
+	return old;
+}
+
+/*
+ * _es_idr_next internal helper function for finding the lowest
+ * allocated ID at or above *@id below @node, which covers *@id
+ */
+static void *_es_idr_next(struct es_idr_node *node, unsigned long *id)
+{
+	unsigned long base = _es_idr_base(node->shift, *id), slot_id;
+	unsigned int offset = (*id - base) >> node->shift;
+	void *entry;
+
+	for (; offset < ES_IDR_SLOTS; offset++) {
+		entry = es_rcu_dereference(node->slots[offset]);
+		if (!entry)
+			continue;
+		slot_id = base + ((unsigned long)offset << node->shift);
+		if (slot_id < *id)
+			slot_id = *id;
+		if (node->shift)
+			entry = _es_idr_next(entry, &slot_id);
+		if (entry) {
+			*id = slot_id;
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * es_idr_get_next - find the next allocated ID
+ * @idr: the idr to be searched
+ * @id: the ID to start at on input, the ID found on output
+ *
+ * Lock free like es_idr_find().
+ * Return the pointer of the lowest allocated ID at or above *@id, or
+ * NULL if there is none.
+ */
+void *es_idr_get_next(const struct es_idr *idr, unsigned long *id)
+{
+	struct es_idr_node *root = es_rcu_dereference(idr->root);
+
+	if (!root || *id > _es_idr_maxindex(root->shift))
+		return NULL;
+	return _es_idr_next(root, id);
+}
+
+/*
+ * _es_idr_shrink_node internal helper function for unlinking the empty
+ * subtrees below @node onto @dead, true if @node is empty after that
+ */
+static bool _es_idr_shrink_node(struct es_idr_node *node,
+			struct es_idr_node **dead)
+{
+	struct es_idr_node *child;
+	bool empty = es_true;
+	unsigned int i;
+
+	for (i = 0; i < ES_IDR_SLOTS; i++) {
+		child = node->slots[i];
+		if (!child)
+			continue;
+		if (node->shift && _es_idr_shrink_node(child, dead)) {
+			ES_WRITE_ONCE(node->slots[i], NULL);
+			/* readers never follow ->parent, it links the dead */
+			child->parent = *dead;
+			*dead = child;
+		} else {
+			empty = es_false;
+		}
+	}
+	return empty;
+}
+
+/*
+ * _es_idr_only_first internal helper function, true if slot 0 is the
+ * only one in use
+ */
+static bool _es_idr_only_first(struct es_idr_node *node)
+{
+	unsigned int i;
+
+	for (i = 1; i < ES_IDR_SLOTS; i++)
+		if (node->slots[i])
+			return es_false;
+	return node->slots[0] != NULL;
+}
+
+/**
+ * es_idr_shrink - free the nodes emptied by es_idr_remove()
+ * @idr: the idr to be shrunk
+ *
+ * Unlinks the empty nodes and lowers the tree to what its largest ID
+ * needs, then waits for es_synchronize_rcu() before freeing them. Must
+ * not be called inside a read-side section, it does nothing there.
+ */
+void es_idr_shrink(struct es_idr *idr)
+{
+	struct es_idr_node *root, *dead = NULL, *node;
+
+	/* the grace period would wait for the caller */
+	if (es_rcu_read_lock_held())
+		return;
+
+	pthread_mutex_lock(&idr->lock);
+	root = idr->root;
+	if (root && _es_idr_shrink_node(root, &dead)) {
+		ES_WRITE_ONCE(idr->root, NULL);
+		root->parent = dead;
+		dead = root;
+	} else if (root) {
+		while (root->shift && _es_idr_only_first(root)) {
+			node = root->slots[0];
+			node->parent = NULL;
+			es_rcu_assign_pointer(idr->root, node);
+			root->parent = dead;
+			dead = root;
+			root = node;
+		}
+	}
+	pthread_mutex_unlock(&idr->lock);
+
+	if (!dead)
+		return;
+	es_synchronize_rcu();
+
+	pthread_mutex_lock(&idr->lock);
+	while (dead) {
+		node = dead;
+		dead = node->parent;
+		free(node);
+		idr->nr_nodes--;
+	}
+	pthread_mutex_unlock(&idr->lock);
+}
+
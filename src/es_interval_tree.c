@@ -0,0 +1,30 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_interval_tree.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_interval_tree.h>
+#include <es_interval_tree_generic.h>
+
+#define ES_IT_START(node) ((node)->start)
+#define ES_IT_LAST(node)  ((node)->last)
+
+ES_INTERVAL_TREE_DEFINE(struct es_interval_tree_node, rb,
+			uint64_t, __subtree_last,
+			ES_IT_START, ES_IT_LAST,, es_interval_tree)
+
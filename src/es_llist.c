@@ -0,0 +1,92 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_llist.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_llist.h>
+
+/**
+ * es_llist_add_batch - add several linked entries in batch
+ * @new_first:	first entry in batch to be added
+ * @new_last:	last entry in batch to be added
+ * @head:	the head for your lock-less list
+ *
+ * Return whether list is empty before adding.
+ */
+bool es_llist_add_batch(struct es_llist_node *new_first,
+		struct es_llist_node *new_last, struct es_llist_head *head)
+{
+	struct es_llist_node *first = ES_READ_ONCE(head->first);
+
+	/* release: the entries are written before they can be taken */
+	do {
+		new_last->next = first;
+	} while (!es_cmpxchg_acq_rel(&head->first, &first, new_first));
+
+	return !first;
+}
+
+/**
+ * es_llist_del_first - delete the first entry of lock-less list
+ * @head:	the head for your lock-less list
+ *
+ * If list is empty, return NULL, otherwise, return the first entry
+ * deleted, this is the newest added one.
+ *
+ * Only one es_llist_del_first user can be used simultaneously with
+ * multiple es_llist_add users without lock.  Because otherwise
+ * es_llist_del_first, es_llist_add, es_llist_add (or es_llist_del_all,
+ * es_llist_add, es_llist_add) may change @head->first->next, but keep
+ * @head->first.  If multiple consumers are needed, please use
+ * es_llist_del_all or use lock between consumers.
+ */
+struct es_llist_node *es_llist_del_first(struct es_llist_head *head)
+{
+	struct es_llist_node *entry, *next;
+
+	entry = es_smp_load_acquire(&head->first);
+	do {
+		if (entry == NULL)
+			return NULL;
+		next = ES_READ_ONCE(entry->next);
+	} while (!es_cmpxchg_acq_rel(&head->first, &entry, next));
+
+	return entry;
+}
+
+/**
+ * es_llist_reverse_order - reverse order of a llist chain
+ * @head:	first item of the list to be reversed
+ *
+ * Reverse the order of a chain of llist entries and return the
+ * new first entry.
+ */
+struct es_llist_node *es_llist_reverse_order(struct es_llist_node *head)
+{
+	struct es_llist_node *new_head = NULL;
+
+	while (head) {
+		struct es_llist_node *tmp = head;
+
+		head = head->next;
+		tmp->next = new_head;
+		new_head = tmp;
+	}
+	return new_head;
+}
+
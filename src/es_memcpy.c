@@ -0,0 +1,276 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_memcpy.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_memcpy.h>
+#include <es_atomic.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ES_MEMCPY_HAVE_X86
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ES_MEMCPY_HAVE_NEON
+#if !defined(__aarch64__) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_NEON
+#define HWCAP_NEON	(1 << 12)
+#endif
+#endif
+#endif
+
+/* below this streaming stores cost more than the cache they save */
+#define ES_MEMCPY_STREAM_MIN	256
+
+typedef void (*es_memcpy_fn)(void *to, const void *from, size_t len);
+
+static void _es_memcpy_libc(void *to, const void *from, size_t len)
+{
+	memcpy(to, from, len);
+}
+
+#ifdef ES_MEMCPY_HAVE_X86
+__attribute__((target("sse2")))
+static void _es_memcpy_sse2_nt(void *to, const void *from, size_t len)
+{
+	unsigned char *d = to;
+	const unsigned char *s = from;
+	size_t head;
+	__m128i a, b, c, e;
+
+	if (len < ES_MEMCPY_STREAM_MIN) {
+		memcpy(to, from, len);
+		return;
+	}
+
+	/* movntdq wants an aligned destination */
+	head = -(uintptr_t)d & 15;
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	len -= head;
+
+	for (; len >= 64; len -= 64, d += 64, s += 64) {
+		_mm_prefetch((const char *)s + 512, _MM_HINT_NTA);
+		a = _mm_loadu_si128((const __m128i *)s);
+		b = _mm_loadu_si128((const __m128i *)(s + 16));
+		c = _mm_loadu_si128((const __m128i *)(s + 32));
+		e = _mm_loadu_si128((const __m128i *)(s + 48));
+		_mm_stream_si128((__m128i *)d, a);
+		_mm_stream_si128((__m128i *)(d + 16), b);
+		_mm_stream_si128((__m128i *)(d + 32), c);
+		_mm_stream_si128((__m128i *)(d + 48), e);
+	}
+	_mm_sfence();
+	memcpy(d, s, len);
+}
+
+__attribute__((target("avx")))
+static void _es_memcpy_avx_nt(void *to, const void *from, size_t len)
+{
+	unsigned char *d = to;
+	const unsigned char *s = from;
+	size_t head;
+	__m256i a, b;
+
+	if (len < ES_MEMCPY_STREAM_MIN) {
+		memcpy(to, from, len);
+		return;
+	}
+
+	head = -(uintptr_t)d & 31;
+	memcpy(d, s, head);
+	d += head;
+	s += head;
+	len -= head;
+
+	for (; len >= 64; len -= 64, d += 64, s += 64) {
+		_mm_prefetch((const char *)s + 512, _MM_HINT_NTA);
+		a = _mm256_loadu_si256((const __m256i *)s);
+		b = _mm256_loadu_si256((const __m256i *)(s + 32));
+		_mm256_stream_si256((__m256i *)d, a);
+		_mm256_stream_si256((__m256i *)(d + 32), b);
+	}
+	_mm_sfence();
+	memcpy(d, s, len);
+}
+#endif
+
+#ifdef ES_MEMCPY_HAVE_NEON
+static void _es_memcpy_neon(void *to, const void *from, size_t len)
+{
+	unsigned char *d = to;
+	const unsigned char *s = from;
+	uint8x16_t a, b, c, e;
+
+	if (len < ES_MEMCPY_STREAM_MIN) {
+		memcpy(to, from, len);
+		return;
+	}
+
+	for (; len >= 64; len -= 64, d += 64, s += 64) {
+		__builtin_prefetch(s + 512, 0, 0);
+		a = vld1q_u8(s);
+		b = vld1q_u8(s + 16);
+		c = vld1q_u8(s + 32);
+		e = vld1q_u8(s + 48);
+#ifdef __aarch64__
+		/* store pair with the non-temporal hint */
+		__asm__ __volatile__(
+			"stnp %q1, %q2, [%0]\n\t"
+			"stnp %q3, %q4, [%0, #32]"
+			: : "r" (d), "w" (a), "w" (b), "w" (c), "w" (e)
+			: "memory");
+#else
+		vst1q_u8(d, a);
+		vst1q_u8(d + 16, b);
+		vst1q_u8(d + 32, c);
+		vst1q_u8(d + 48, e);
+#endif
+	}
+#ifdef __aarch64__
+	__asm__ __volatile__("dmb ishst" : : : "memory");
+#endif
+	memcpy(d, s, len);
+}
+#endif
+
+static const struct {
+	const char *name;
+	es_memcpy_fn fn;
+} es_memcpy_impls[ES_MEMCPY_IMPL_MAX] = {
+	[ES_MEMCPY_AUTO]	= { "auto", NULL },
+	[ES_MEMCPY_LIBC]	= { "libc", _es_memcpy_libc },
+#ifdef ES_MEMCPY_HAVE_X86
+	[ES_MEMCPY_SSE2_NT]	= { "sse2-nt", _es_memcpy_sse2_nt },
+	[ES_MEMCPY_AVX_NT]	= { "avx-nt", _es_memcpy_avx_nt },
+#else
+	[ES_MEMCPY_SSE2_NT]	= { "sse2-nt", NULL },
+	[ES_MEMCPY_AVX_NT]	= { "avx-nt", NULL },
+#endif
+#ifdef ES_MEMCPY_HAVE_NEON
+	[ES_MEMCPY_NEON]	= { "neon", _es_memcpy_neon },
+#else
+	[ES_MEMCPY_NEON]	= { "neon", NULL },
+#endif
+};
+
+static es_memcpy_fn es_memcpy_stream_fn;
+static enum es_memcpy_impl es_memcpy_cur_impl = ES_MEMCPY_AUTO;
+
+/**
+ * es_memcpy_impl_supported - check if this cpu can run an implementation
+ * @impl: the implementation, ES_MEMCPY_AUTO is always supported
+ */
+bool es_memcpy_impl_supported(enum es_memcpy_impl impl)
+{
+	if (impl == ES_MEMCPY_AUTO)
+		return es_true;
+	if (impl >= ES_MEMCPY_IMPL_MAX || !es_memcpy_impls[impl].fn)
+		return es_false;
+
+#ifdef ES_MEMCPY_HAVE_X86
+	__builtin_cpu_init();
+	if (impl == ES_MEMCPY_SSE2_NT)
+		return __builtin_cpu_supports("sse2") ? es_true : es_false;
+	if (impl == ES_MEMCPY_AVX_NT)
+		return __builtin_cpu_supports("avx") ? es_true : es_false;
+#endif
+#if defined(ES_MEMCPY_HAVE_NEON) && !defined(__aarch64__) && defined(__linux__)
+	if (impl == ES_MEMCPY_NEON)
+		return (getauxval(AT_HWCAP) & HWCAP_NEON) ? es_true : es_false;
+#endif
+	return es_true;
+}
+
+/**
+ * es_memcpy_impl_name - returns a printable name of an implementation
+ * @impl: the implementation
+ */
+const char *es_memcpy_impl_name(enum es_memcpy_impl impl)
+{
+	if (impl >= ES_MEMCPY_IMPL_MAX)
+		return "unknown";
+	return es_memcpy_impls[impl].name;
+}
+
+/**
+ * es_memcpy_set_impl - select the implementation of es_memcpy_stream()
+ * @impl: the implementation, ES_MEMCPY_AUTO picks the best supported
+ *
+ * Mostly for benchmarks and tests, without a call the best one is
+ * picked on first use. Do not switch while other threads copy.
+ *
+ * Return 0 if no error, ES_INVALID_PARAM if the cpu lacks @impl
+ */
+int es_memcpy_set_impl(enum es_memcpy_impl impl)
+{
+	if (!es_memcpy_impl_supported(impl))
+		return ES_INVALID_PARAM;
+
+	if (impl == ES_MEMCPY_AUTO) {
+		if (es_memcpy_impl_supported(ES_MEMCPY_AVX_NT))
+			impl = ES_MEMCPY_AVX_NT;
+		else if (es_memcpy_impl_supported(ES_MEMCPY_SSE2_NT))
+			impl = ES_MEMCPY_SSE2_NT;
+		else if (es_memcpy_impl_supported(ES_MEMCPY_NEON))
+			impl = ES_MEMCPY_NEON;
+		else
+			impl = ES_MEMCPY_LIBC;
+	}
+
+	ES_WRITE_ONCE(es_memcpy_cur_impl, impl);
+	ES_WRITE_ONCE(es_memcpy_stream_fn, es_memcpy_impls[impl].fn);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_memcpy_get_impl - returns the implementation es_memcpy_stream() uses
+ */
+enum es_memcpy_impl es_memcpy_get_impl(void)
+{
+	if (!ES_READ_ONCE(es_memcpy_stream_fn))
+		es_memcpy_set_impl(ES_MEMCPY_AUTO);
+	return ES_READ_ONCE(es_memcpy_cur_impl);
+}
+
+/**
+ * es_memcpy_stream - copy a large block bypassing the cache if possible
+ * @to: the destination
+ * @from: the source, must not overlap @to
+ * @len: number of bytes
+ *
+ * All stores are visible to other cpus in the usual order once it
+ * returns, i.e. a following release barrier publishes them.
+ */
+void es_memcpy_stream(void *to, const void *from, size_t len)
+{
+	es_memcpy_fn fn = ES_READ_ONCE(es_memcpy_stream_fn);
+
+	if (!fn) {
+		/* first use, racing threads all pick the same one */
+		es_memcpy_set_impl(ES_MEMCPY_AUTO);
+		fn = ES_READ_ONCE(es_memcpy_stream_fn);
+	}
+	fn(to, from, len);
+}
+
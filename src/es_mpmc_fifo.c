@@ -0,0 +1,186 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_mpmc_fifo.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_mpmc_fifo.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* every slot starts with its sequence number, followed by the element */
+#define ES_MPMC_SEQ_SIZE	sizeof(unsigned long long)
+
+static inline unsigned int *__es_mpmc_seq(struct es_mpmc_fifo *fifo,
+				unsigned int pos)
+{
+	return (unsigned int *)(fifo->slots + (pos & fifo->mask) * fifo->stride);
+}
+
+static inline void *__es_mpmc_data(struct es_mpmc_fifo *fifo,
+				unsigned int pos)
+{
+	return fifo->slots + (pos & fifo->mask) * fifo->stride + ES_MPMC_SEQ_SIZE;
+}
+
+/**
+ * es_mpmc_fifo_alloc - allocates a new MPMC FIFO
+ * @fifo: the fifo to assign the new buffer
+ * @esize: the size of one element in bytes
+ * @count: number of elements the fifo shall hold
+ *
+ * The count will be rounded-up to a power of 2.
+ * The buffer will be release with es_mpmc_fifo_free().
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_mpmc_fifo_alloc(struct es_mpmc_fifo *fifo, unsigned int esize,
+			unsigned int count)
+{
+	void *slots;
+	unsigned int i;
+
+	if (!esize || count < 2)
+		return ES_INVALID_PARAM;
+
+	count = es_roundup_pow_of_two(count);
+	fifo->esize = esize;
+	fifo->stride = (ES_MPMC_SEQ_SIZE + esize + ES_MPMC_SEQ_SIZE - 1) &
+			~(ES_MPMC_SEQ_SIZE - 1);
+
+	if (posix_memalign(&slots, ES_CACHELINE_SIZE,
+			(size_t)count * fifo->stride)) {
+		fifo->slots = NULL;
+		return ES_FAIL;
+	}
+
+	fifo->slots = slots;
+	fifo->mask = count - 1;
+	for (i = 0; i < count; i++)
+		*__es_mpmc_seq(fifo, i) = i;
+	fifo->in = fifo->out = 0;
+	return ES_SUCCESS;
+}
+
+/**
+ * es_mpmc_fifo_free - frees the MPMC FIFO buffer
+ * @fifo: the fifo to be freed.
+ */
+void es_mpmc_fifo_free(struct es_mpmc_fifo *fifo)
+{
+	free(fifo->slots);
+	fifo->slots = NULL;
+	fifo->mask = 0;
+	fifo->in = fifo->out = 0;
+}
+
+static int __es_mpmc_fifo_put(struct es_mpmc_fifo *fifo, const void *from)
+{
+	unsigned int pos = ES_READ_ONCE(fifo->in);
+	unsigned int *seq;
+	int diff;
+
+	for (;;) {
+		seq = __es_mpmc_seq(fifo, pos);
+		diff = (int)(es_smp_load_acquire(seq) - pos);
+		if (diff == 0) {
+			if (es_cmpxchg(&fifo->in, &pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			/* the slot still holds data from the previous lap */
+			return 0;
+		} else {
+			pos = ES_READ_ONCE(fifo->in);
+		}
+	}
+
+	memcpy(__es_mpmc_data(fifo, pos), from, fifo->esize);
+	/* hand the slot over to the consumer of this position */
+	es_smp_store_release(seq, pos + 1);
+	return 1;
+}
+
+static int __es_mpmc_fifo_get(struct es_mpmc_fifo *fifo, void *to)
+{
+	unsigned int pos = ES_READ_ONCE(fifo->out);
+	unsigned int *seq;
+	int diff;
+
+	for (;;) {
+		seq = __es_mpmc_seq(fifo, pos);
+		diff = (int)(es_smp_load_acquire(seq) - (pos + 1));
+		if (diff == 0) {
+			if (es_cmpxchg(&fifo->out, &pos, pos + 1))
+				break;
+		} else if (diff < 0) {
+			/* the producer of this position did not finish yet */
+			return 0;
+		} else {
+			pos = ES_READ_ONCE(fifo->out);
+		}
+	}
+
+	memcpy(to, __es_mpmc_data(fifo, pos), fifo->esize);
+	/* give the slot back to the producer of the next lap */
+	es_smp_store_release(seq, pos + fifo->mask + 1);
+	return 1;
+}
+
+/**
+ * es_mpmc_fifo_in - puts some elements into the FIFO
+ * @fifo: the fifo to be used.
+ * @from: the elements to be added.
+ * @n: the number of elements to be added.
+ *
+ * This function copies at most @n elements from the @from buffer into
+ * the FIFO depending on the free space, and returns the number of
+ * elements copied. Elements of concurrent producers may interleave.
+ */
+unsigned int es_mpmc_fifo_in(struct es_mpmc_fifo *fifo, const void *from,
+				unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		if (!__es_mpmc_fifo_put(fifo, from))
+			break;
+		from += fifo->esize;
+	}
+	return i;
+}
+
+/**
+ * es_mpmc_fifo_out - gets some elements from the FIFO
+ * @fifo: the fifo to be used.
+ * @to: where the elements must be copied.
+ * @n: the number of elements the destination buffer can hold.
+ *
+ * This function copies at most @n elements from the FIFO into the
+ * @to buffer and returns the number of copied elements.
+ */
+unsigned int es_mpmc_fifo_out(struct es_mpmc_fifo *fifo, void *to,
+				unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		if (!__es_mpmc_fifo_get(fifo, to))
+			break;
+		to += fifo->esize;
+	}
+	return i;
+}
+
@@ -0,0 +1,297 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_notifier.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_notifier.h>
+#include <es_rcu.h>
+#include <sched.h>
+
+/*
+ *	Notifier chain core routines. The exported routines below
+ *	are layered on top of these, with appropriate locking added.
+ */
+
+static int _es_notifier_chain_register(struct es_list_head *head,
+		struct es_notifier_block *n)
+{
+	struct es_notifier_block *pos;
+
+	es_list_for_each_entry(pos, head, list) {
+		if (pos == n) {
+			ES_PRINTF("es_notifier: double register %p \n", n);
+			return ES_FAIL;
+		}
+		if (n->priority > pos->priority)
+			break;
+	}
+	/* equal priorities keep the order of registration */
+	es_list_add_tail_rcu(&n->list, &pos->list);
+	return ES_SUCCESS;
+}
+
+static int _es_notifier_chain_unregister(struct es_list_head *head,
+		struct es_notifier_block *n)
+{
+	struct es_notifier_block *pos;
+
+	es_list_for_each_entry(pos, head, list) {
+		if (pos == n) {
+			es_list_del_rcu(&n->list);
+			return ES_SUCCESS;
+		}
+	}
+	return ES_FAIL;
+}
+
+/**
+ * _es_notifier_call_chain - Informs the registered notifiers about an event.
+ * @head: Head of the notifier chain
+ * @val: Value passed unmodified to notifier function
+ * @v: Pointer passed unmodified to notifier function
+ *
+ * Return: es_notifier_call_chain returns the value returned by the
+ *	last notifier function called.
+ */
+static int _es_notifier_call_chain(struct es_list_head *head,
+		unsigned long val, void *v)
+{
+	struct es_notifier_block *nb;
+	int ret = ES_NOTIFY_DONE;
+
+	es_list_for_each_entry_rcu(nb, head, list) {
+		ret = nb->notifier_call(nb, val, v);
+		if (ret & ES_NOTIFY_STOP_MASK)
+			break;
+	}
+	return ret;
+}
+
+static void _es_notifier_spin_lock(unsigned int *lock)
+{
+	while (ES_READ_ONCE(*lock) || es_xchg(lock, 1)) {
+		while (ES_READ_ONCE(*lock))
+			sched_yield();
+	}
+}
+
+static void _es_notifier_spin_unlock(unsigned int *lock)
+{
+	es_smp_store_release(lock, 0);
+}
+
+/*
+ *	Atomic notifier chain routines.  Registration and unregistration
+ *	use a spinlock, and call_chain is synchronized by SRCU (no locks).
+ */
+
+/**
+ * es_atomic_notifier_chain_register - Add notifier to an atomic notifier chain
+ * @nh: Pointer to head of the atomic notifier chain
+ * @n: New entry in notifier chain
+ *
+ * Adds a notifier to an atomic notifier chain.
+ *
+ * Returns 0 on success, ES_FAIL if @n is registered already.
+ */
+int es_atomic_notifier_chain_register(struct es_atomic_notifier_head *nh,
+		struct es_notifier_block *n)
+{
+	int ret;
+
+	_es_notifier_spin_lock(&nh->lock);
+	ret = _es_notifier_chain_register(&nh->head, n);
+	_es_notifier_spin_unlock(&nh->lock);
+	return ret;
+}
+
+/**
+ * es_atomic_notifier_chain_unregister - Remove notifier from an atomic notifier chain
+ * @nh: Pointer to head of the atomic notifier chain
+ * @n: Entry to remove from notifier chain
+ *
+ * Removes a notifier from an atomic notifier chain and waits for the
+ * walks which might still call it.
+ *
+ * Returns zero on success or ES_FAIL if @n is not on the chain.
+ */
+int es_atomic_notifier_chain_unregister(struct es_atomic_notifier_head *nh,
+		struct es_notifier_block *n)
+{
+	int ret;
+
+	_es_notifier_spin_lock(&nh->lock);
+	ret = _es_notifier_chain_unregister(&nh->head, n);
+	_es_notifier_spin_unlock(&nh->lock);
+	if (!ret)
+		es_synchronize_srcu(&nh->srcu);
+	return ret;
+}
+
+/**
+ * es_atomic_notifier_call_chain - Call functions in an atomic notifier chain
+ * @nh: Pointer to head of the atomic notifier chain
+ * @val: Value passed unmodified to notifier function
+ * @v: Pointer passed unmodified to notifier function
+ *
+ * Calls each function in a notifier chain in turn, without taking a
+ * lock. The callbacks must not block.
+ *
+ * If the return value of the notifier can be and'ed
+ * with ES_NOTIFY_STOP_MASK then es_atomic_notifier_call_chain()
+ * will return immediately, with the return value of
+ * the notifier function which halted execution.
+ * Otherwise the return value is the return value
+ * of the last notifier function called.
+ */
+int es_atomic_notifier_call_chain(struct es_atomic_notifier_head *nh,
+		unsigned long val, void *v)
+{
+	int ret, idx;
+
+	idx = es_srcu_read_lock(&nh->srcu);
+	ret = _es_notifier_call_chain(&nh->head, val, v);
+	es_srcu_read_unlock(&nh->srcu, idx);
+	return ret;
+}
+
+/*
+ *	Blocking notifier chain routines.  Registration and unregistration
+ *	use a mutex, and call_chain is synchronized by SRCU (no locks), the
+ *	callbacks are allowed to block.
+ */
+
+/**
+ * es_blocking_notifier_chain_register - Add notifier to a blocking notifier chain
+ * @nh: Pointer to head of the blocking notifier chain
+ * @n: New entry in notifier chain
+ *
+ * Returns 0 on success, ES_FAIL if @n is registered already.
+ */
+int es_blocking_notifier_chain_register(struct es_blocking_notifier_head *nh,
+		struct es_notifier_block *n)
+{
+	int ret;
+
+	pthread_mutex_lock(&nh->lock);
+	ret = _es_notifier_chain_register(&nh->head, n);
+	pthread_mutex_unlock(&nh->lock);
+	return ret;
+}
+
+/**
+ * es_blocking_notifier_chain_unregister - Remove notifier from a blocking notifier chain
+ * @nh: Pointer to head of the blocking notifier chain
+ * @n: Entry to remove from notifier chain
+ *
+ * Waits for the walks which might still call @n, including ones
+ * blocked inside a callback.
+ *
+ * Returns zero on success or ES_FAIL if @n is not on the chain.
+ */
+int es_blocking_notifier_chain_unregister(struct es_blocking_notifier_head *nh,
+		struct es_notifier_block *n)
+{
+	int ret;
+
+	pthread_mutex_lock(&nh->lock);
+	ret = _es_notifier_chain_unregister(&nh->head, n);
+	pthread_mutex_unlock(&nh->lock);
+	if (!ret)
+		es_synchronize_srcu(&nh->srcu);
+	return ret;
+}
+
+/**
+ * es_blocking_notifier_call_chain - Call functions in a blocking notifier chain
+ * @nh: Pointer to head of the blocking notifier chain
+ * @val: Value passed unmodified to notifier function
+ * @v: Pointer passed unmodified to notifier function
+ *
+ * Calls each function in a notifier chain in turn, without taking a
+ * lock. The callbacks may block.
+ *
+ * Returns like es_atomic_notifier_call_chain().
+ */
+int es_blocking_notifier_call_chain(struct es_blocking_notifier_head *nh,
+		unsigned long val, void *v)
+{
+	int ret = ES_NOTIFY_DONE, idx;
+
+	/* skip the read-side section if nobody listens */
+	if (es_rcu_dereference(nh->head.next) == &nh->head)
+		return ret;
+
+	idx = es_srcu_read_lock(&nh->srcu);
+	ret = _es_notifier_call_chain(&nh->head, val, v);
+	es_srcu_read_unlock(&nh->srcu, idx);
+	return ret;
+}
+
+/*
+ *	Raw notifier chain routines.  There is no protection;
+ *	the caller must provide it.  Use at your own risk!
+ */
+
+/**
+ * es_raw_notifier_chain_register - Add notifier to a raw notifier chain
+ * @nh: Pointer to head of the raw notifier chain
+ * @n: New entry in notifier chain
+ *
+ * All locking must be provided by the caller.
+ *
+ * Returns 0 on success, ES_FAIL if @n is registered already.
+ */
+int es_raw_notifier_chain_register(struct es_raw_notifier_head *nh,
+		struct es_notifier_block *n)
+{
+	return _es_notifier_chain_register(&nh->head, n);
+}
+
+/**
+ * es_raw_notifier_chain_unregister - Remove notifier from a raw notifier chain
+ * @nh: Pointer to head of the raw notifier chain
+ * @n: Entry to remove from notifier chain
+ *
+ * All locking must be provided by the caller. A callback may unregister
+ * its own block while the chain is being called.
+ *
+ * Returns zero on success or ES_FAIL if @n is not on the chain.
+ */
+int es_raw_notifier_chain_unregister(struct es_raw_notifier_head *nh,
+		struct es_notifier_block *n)
+{
+	return _es_notifier_chain_unregister(&nh->head, n);
+}
+
+/**
+ * es_raw_notifier_call_chain - Call functions in a raw notifier chain
+ * @nh: Pointer to head of the raw notifier chain
+ * @val: Value passed unmodified to notifier function
+ * @v: Pointer passed unmodified to notifier function
+ *
+ * All locking must be provided by the caller.
+ *
+ * Returns like es_atomic_notifier_call_chain().
+ */
+int es_raw_notifier_call_chain(struct es_raw_notifier_head *nh,
+		unsigned long val, void *v)
+{
+	return _es_notifier_call_chain(&nh->head, val, v);
+}
+
@@ -0,0 +1,402 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_pool.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_pool.h>
+#include <es_atomic.h>
+#include <es_arena.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ES_POOL_ALIGN(x, a)	(((x) + (a) - 1) & ~((a) - 1))
+
+/* objects moved between a magazine and the depot at once */
+#define ES_POOL_BATCH		(ES_POOL_MAG_SIZE / 2)
+
+/* header at the start of every slab, the objects follow */
+struct es_pool_slab {
+	struct es_list_head node;	/* in pool->slabs */
+};
+
+/* per thread magazine */
+struct es_pool_cache {
+	unsigned int count;		/* free objects in objs[] */
+	unsigned long allocs;
+	unsigned long frees;
+	struct es_pool *pool;
+	struct es_list_head node;	/* in pool->caches */
+	void *objs[ES_POOL_MAG_SIZE];
+};
+
+static inline struct es_list_head *__es_pool_link(struct es_pool *pool,
+		void *obj)
+{
+	return (struct es_list_head *)((char *)obj + pool->link_off);
+}
+
+static inline void *__es_pool_obj(struct es_pool *pool,
+		struct es_list_head *link)
+{
+	return (char *)link - pool->link_off;
+}
+
+static inline unsigned int __es_pool_slab_hdr(struct es_pool *pool)
+{
+	return ES_POOL_ALIGN(sizeof(struct es_pool_slab), pool->align);
+}
+
+/*
+ * _es_pool_new_slab internal helper function for allocating a slab and
+ * putting its constructed objects on @objs, called without the lock
+ * unless the slabs come from an arena
+ */
+static struct es_pool_slab *_es_pool_new_slab(struct es_pool *pool,
+		struct es_list_head *objs)
+{
+	struct es_pool_slab *slab;
+	char *obj;
+	void *mem;
+	unsigned int i;
+
+	if (pool->arena)
+		mem = es_arena_alloc_aligned(pool->arena, pool->slab_size,
+				ES_CACHELINE_SIZE);
+	else if (posix_memalign(&mem, ES_CACHELINE_SIZE, pool->slab_size))
+		mem = NULL;
+	if (!mem)
+		return NULL;
+
+	slab = mem;
+	obj = (char *)mem + __es_pool_slab_hdr(pool);
+	for (i = 0; i < pool->objs_per_slab; i++, obj += pool->stride) {
+		if (pool->ctor)
+			pool->ctor(obj, pool->ctor_arg);
+		es_list_add_tail(__es_pool_link(pool, obj), objs);
+	}
+	return slab;
+}
+
+/*
+ * _es_pool_refill internal helper function for moving a batch of free
+ * objects from the depot into the empty magazine @c, carving a new slab
+ * when the depot runs short
+ */
+static int _es_pool_refill(struct es_pool *pool, struct es_pool_cache *c)
+{
+	struct es_pool_slab *slab;
+	struct es_list_head *link;
+	ES_LIST_HEAD(fresh);
+
+	pthread_mutex_lock(&pool->lock);
+	if (pool->nr_free < ES_POOL_BATCH) {
+		/* an arena is not thread safe, the lock covers it */
+		if (!pool->arena)
+			pthread_mutex_unlock(&pool->lock);
+		slab = _es_pool_new_slab(pool, &fresh);
+		if (!pool->arena)
+			pthread_mutex_lock(&pool->lock);
+		if (slab) {
+			es_list_add(&slab->node, &pool->slabs);
+			pool->nr_slabs++;
+			es_list_splice_tail(&fresh, &pool->free_list);
+			pool->nr_free += pool->objs_per_slab;
+		}
+	}
+
+	while (c->count < ES_POOL_BATCH && pool->nr_free) {
+		link = pool->free_list.next;
+		es_list_del(link);
+		pool->nr_free--;
+		c->objs[c->count++] = __es_pool_obj(pool, link);
+	}
+	pool->refills++;
+	pthread_mutex_unlock(&pool->lock);
+
+	return c->count ? ES_SUCCESS : ES_FAIL;
+}
+
+/*
+ * _es_pool_flush internal helper function for giving the @n objects on
+ * top of the magazine back to the depot
+ */
+static void _es_pool_flush(struct es_pool *pool, struct es_pool_cache *c,
+		unsigned int n)
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->nr_free += n;
+	/* to the front, the most recently used objects go out first */
+	while (n--)
+		es_list_add(__es_pool_link(pool, c->objs[--c->count]),
+			&pool->free_list);
+	pool->flushes++;
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/* pthread key destructor, the thread exits */
+static void _es_pool_cache_release(void *arg)
+{
+	struct es_pool_cache *c = arg;
+	struct es_pool *pool = c->pool;
+
+	if (c->count)
+		_es_pool_flush(pool, c, c->count);
+
+	pthread_mutex_lock(&pool->lock);
+	es_list_del(&c->node);
+	pool->dead.allocs += c->allocs;
+	pool->dead.frees += c->frees;
+	pthread_mutex_unlock(&pool->lock);
+	free(c);
+}
+
+static struct es_pool_cache *_es_pool_cache_create(struct es_pool *pool)
+{
+	struct es_pool_cache *c = calloc(1, sizeof(*c));
+
+	if (!c)
+		return NULL;
+	c->pool = pool;
+	if (pthread_setspecific(pool->key, c)) {
+		free(c);
+		return NULL;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	es_list_add(&c->node, &pool->caches);
+	pthread_mutex_unlock(&pool->lock);
+	return c;
+}
+
+static inline struct es_pool_cache *__es_pool_cache(struct es_pool *pool)
+{
+	struct es_pool_cache *c = pthread_getspecific(pool->key);
+
+	return c ? c : _es_pool_cache_create(pool);
+}
+
+/**
+ * es_pool_init - initialize an object pool
+ * @pool: the pool to be initialized
+ * @name: name for es_pool_dump(), may be NULL, not copied
+ * @size: the size of an object in bytes
+ * @align: alignment of the objects, a power of 2, 0 for pointer alignment
+ * @ctor: called once for every object when it is carved, may be NULL
+ * @ctor_arg: passed to @ctor
+ *
+ * No memory is allocated before the first es_pool_alloc().
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_pool_init(struct es_pool *pool, const char *name, unsigned int size,
+			unsigned int align, es_pool_ctor_t ctor, void *ctor_arg)
+{
+	unsigned int hdr;
+
+	if (!align)
+		align = sizeof(void *);
+	if (!size || !es_is_power_of_2(align) || align > ES_CACHELINE_SIZE)
+		return ES_INVALID_PARAM;
+
+	memset(pool, 0, sizeof(*pool));
+	pool->name = name;
+	pool->size = size;
+	pool->ctor = ctor;
+	pool->ctor_arg = ctor_arg;
+
+	/* the link must not overwrite a constructed object */
+	if (ctor) {
+		pool->link_off = ES_POOL_ALIGN(size, sizeof(void *));
+		pool->stride = pool->link_off + sizeof(struct es_list_head);
+	} else {
+		pool->stride = max(size, (unsigned int)sizeof(struct es_list_head));
+	}
+	pool->align = max(align, (unsigned int)sizeof(void *));
+	pool->stride = ES_POOL_ALIGN(pool->stride, pool->align);
+
+	hdr = __es_pool_slab_hdr(pool);
+	pool->slab_size = max((unsigned int)ES_POOL_SLAB_SIZE,
+			hdr + pool->stride * ES_POOL_SLAB_MIN_OBJS);
+	pool->objs_per_slab = (pool->slab_size - hdr) / pool->stride;
+
+	INIT_ES_LIST_HEAD(&pool->free_list);
+	INIT_ES_LIST_HEAD(&pool->slabs);
+	INIT_ES_LIST_HEAD(&pool->caches);
+	if (pthread_mutex_init(&pool->lock, NULL))
+		return ES_FAIL;
+	if (pthread_key_create(&pool->key, _es_pool_cache_release)) {
+		pthread_mutex_destroy(&pool->lock);
+		return ES_FAIL;
+	}
+	return ES_SUCCESS;
+}
+
+/**
+ * es_pool_set_arena - carve the slabs of a pool from an arena
+ * @pool: the pool to be used.
+ * @arena: the arena, NULL for malloc()
+ *
+ * Must be called before the first es_pool_alloc(). The pool allocates
+ * from the arena under its own lock, so nothing else may use @arena
+ * while the pool is alive. es_pool_destroy() leaves the slabs to
+ * the arena, and the pool must be destroyed before the arena is rewound
+ * past them, reset or destroyed.
+ */
+void es_pool_set_arena(struct es_pool *pool, struct es_arena *arena)
+{
+	pool->arena = arena;
+}
+
+/**
+ * es_pool_destroy - free all memory of a pool
+ * @pool: the pool to be used.
+ *
+ * All objects become invalid, whether freed or not. No other thread
+ * may use the pool any more.
+ */
+void es_pool_destroy(struct es_pool *pool)
+{
+	struct es_pool_cache *c, *cn;
+	struct es_pool_slab *slab, *sn;
+
+	pthread_setspecific(pool->key, NULL);
+	pthread_key_delete(pool->key);
+
+	es_list_for_each_entry_safe(c, cn, &pool->caches, node)
+		free(c);
+	if (!pool->arena)
+		es_list_for_each_entry_safe(slab, sn, &pool->slabs, node)
+			free(slab);
+
+	pthread_mutex_destroy(&pool->lock);
+	INIT_ES_LIST_HEAD(&pool->free_list);
+	INIT_ES_LIST_HEAD(&pool->slabs);
+	INIT_ES_LIST_HEAD(&pool->caches);
+	pool->nr_free = pool->nr_slabs = 0;
+}
+
+/**
+ * es_pool_alloc - allocate an object
+ * @pool: the pool to be used.
+ *
+ * Returns the object, constructed if the pool has a constructor,
+ * otherwise with undefined content. NULL if out of memory.
+ */
+void *es_pool_alloc(struct es_pool *pool)
+{
+	struct es_pool_cache *c = __es_pool_cache(pool);
+
+	if (!c)
+		return NULL;
+	if (!c->count && _es_pool_refill(pool, c))
+		return NULL;
+
+	c->allocs++;
+	return c->objs[--c->count];
+}
+
+/**
+ * es_pool_free - give an object back to its pool
+ * @pool: the pool the object was allocated from
+ * @obj: the object, may come from another thread
+ */
+void es_pool_free(struct es_pool *pool, void *obj)
+{
+	struct es_pool_cache *c = __es_pool_cache(pool);
+
+	if (!c) {
+		/* no magazine for this thread, straight to the depot */
+		pthread_mutex_lock(&pool->lock);
+		es_list_add(__es_pool_link(pool, obj), &pool->free_list);
+		pool->nr_free++;
+		pool->dead.frees++;
+		pthread_mutex_unlock(&pool->lock);
+		return;
+	}
+
+	if (c->count == ES_POOL_MAG_SIZE)
+		_es_pool_flush(pool, c, ES_POOL_BATCH);
+	c->objs[c->count++] = obj;
+	c->frees++;
+}
+
+/**
+ * es_pool_flush_cache - empty the magazine of the calling thread
+ * @pool: the pool to be used.
+ *
+ * Gives the free objects the thread holds back to the depot, e.g.
+ * before it goes idle for long. Exiting threads do this by themselves.
+ */
+void es_pool_flush_cache(struct es_pool *pool)
+{
+	struct es_pool_cache *c = pthread_getspecific(pool->key);
+
+	if (c && c->count)
+		_es_pool_flush(pool, c, c->count);
+}
+
+/**
+ * es_pool_get_stats - read the counters of a pool
+ * @pool: the pool to be used.
+ * @st: where to store them
+ *
+ * The counters of running threads are read without stopping them, so
+ * they may be slightly behind.
+ */
+void es_pool_get_stats(struct es_pool *pool, struct es_pool_stats *st)
+{
+	struct es_pool_cache *c;
+
+	pthread_mutex_lock(&pool->lock);
+	*st = pool->dead;
+	st->refills = pool->refills;
+	st->flushes = pool->flushes;
+	st->slabs = pool->nr_slabs;
+	st->objs_total = pool->nr_slabs * pool->objs_per_slab;
+	st->objs_depot = pool->nr_free;
+	es_list_for_each_entry(c, &pool->caches, node) {
+		st->allocs += ES_READ_ONCE(c->allocs);
+		st->frees += ES_READ_ONCE(c->frees);
+		st->objs_cached += ES_READ_ONCE(c->count);
+		st->caches++;
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * es_pool_dump - print the counters of a pool
+ * @pool: the pool to be used.
+ * @fp: where to print, e.g. stderr
+ */
+void es_pool_dump(struct es_pool *pool, FILE *fp)
+{
+	struct es_pool_stats st;
+
+	es_pool_get_stats(pool, &st);
+	if (pool->name)
+		fprintf(fp, "%s:", pool->name);
+	else
+		fprintf(fp, "%p:", (void *)pool);
+	fprintf(fp, " size %u stride %u slabs %u objs %u in_use %u "
+		"depot %u cached %u caches %u\n",
+		pool->size, pool->stride, st.slabs, st.objs_total,
+		st.objs_total - st.objs_depot - st.objs_cached,
+		st.objs_depot, st.objs_cached, st.caches);
+	fprintf(fp, "  allocs %lu frees %lu refills %lu flushes %lu\n",
+		st.allocs, st.frees, st.refills, st.flushes);
+}
+
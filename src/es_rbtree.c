@@ -0,0 +1,624 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rbtree.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_rbtree_augmented.h>
+
+/*
+ * red-black trees properties:  https://en.wikipedia.org/wiki/Rbtree
+ *
+ *  1) A node is either red or black
+ *  2) The root is black
+ *  3) All leaves (NULL) are black
+ *  4) Both children of every red node are black
+ *  5) Every simple path from root to leaves contains the same number
+ *     of black nodes.
+ *
+ *  4 and 5 give the O(log n) guarantee, since 4 implies you cannot have two
+ *  consecutive red nodes in a path and every red node is therefore followed by
+ *  a black. So if B is the number of black nodes on every simple path (as per
+ *  5), then the longest possible path due to 4 is 2B.
+ *
+ *  We shall indicate color with case, where black nodes are uppercase and red
+ *  nodes will be lowercase. Unknown color nodes shall be drawn as red within
+ *  parentheses and have some accompanying text comment.
+ */
+
+/*
+ * Notes on lockless lookups:
+ *
+ * All stores to the tree structure (rb_left and rb_right) must be done
+ * using ES_WRITE_ONCE(). And we must not inadvertently cause (temporary)
+ * loops in the tree structure as seen in program order.
+ *
+ * These two requirements will allow lockless iteration of the tree -- not
+ * correct iteration mind you, tree rotations are not atomic so a lookup
+ * might miss entire subtrees.
+ *
+ * But they do guarantee that any such traversal will only see valid
+ * elements and that it will indeed complete -- does not get stuck in a
+ * loop.
+ *
+ * It also guarantees that if the lookup returns an element it is the
+ * 'correct' one. But not returning an element does _NOT_ mean it's not
+ * present.
+ *
+ * NOTE:
+ *
+ * Stores to __rb_parent_color are not important for simple lookups so
+ * those are left undone as of now. Nor were loops involving
+ * parent pointers checked.
+ */
+
+static inline void es_rb_set_black(struct es_rb_node *rb)
+{
+	rb->__rb_parent_color += ES_RB_BLACK;
+}
+
+static inline struct es_rb_node *es_rb_red_parent(struct es_rb_node *red)
+{
+	return (struct es_rb_node *)red->__rb_parent_color;
+}
+
+/*
+ * Helper function for rotations:
+ * - old's parent and color get assigned to new
+ * - old gets assigned new as a parent and 'color' as a color.
+ */
+static inline void
+__es_rb_rotate_set_parents(struct es_rb_node *old, struct es_rb_node *new,
+			struct es_rb_root *root, int color)
+{
+	struct es_rb_node *parent = es_rb_parent(old);
+
+	new->__rb_parent_color = old->__rb_parent_color;
+	es_rb_set_parent_color(old, new, color);
+	__es_rb_change_child(old, new, parent, root);
+}
+
+static inline void
+__es_rb_insert(struct es_rb_node *node, struct es_rb_root *root,
+	void (*augment_rotate)(struct es_rb_node *old, struct es_rb_node *new))
+{
+	struct es_rb_node *parent = es_rb_red_parent(node), *gparent, *tmp;
+
+	while (es_true) {
+		/*
+		 * Loop invariant: node is red.
+		 */
+		if (!parent) {
+			/*
+			 * The inserted node is root. Either this is the
+			 * first node, or we recursed at Case 1 below and
+			 * are no longer violating 4).
+			 */
+			es_rb_set_parent_color(node, NULL, ES_RB_BLACK);
+			break;
+		}
+
+		/*
+		 * If there is a black parent, we are done.
+		 * Otherwise, take some corrective action as,
+		 * per 4), we don't want a red root or two
+		 * consecutive red nodes.
+		 */
+		if (es_rb_is_black(parent))
+			break;
+
+		gparent = es_rb_red_parent(parent);
+
+		tmp = gparent->rb_right;
+		if (parent != tmp) {	/* parent == gparent->rb_left */
+			if (tmp && es_rb_is_red(tmp)) {
+				/*
+				 * Case 1 - node's uncle is red (color flips).
+				 *
+				 *       G            g
+				 *      / \          / \
+				 *     p   u  -->   P   U
+				 *    /            /
+				 *   n            n
+				 *
+				 * However, since g's parent might be red, and
+				 * 4) does not allow this, we need to recurse
+				 * at g.
+				 */
+				es_rb_set_parent_color(tmp, gparent, ES_RB_BLACK);
+				es_rb_set_parent_color(parent, gparent, ES_RB_BLACK);
+				node = gparent;
+				parent = es_rb_parent(node);
+				es_rb_set_parent_color(node, parent, ES_RB_RED);
+				continue;
+			}
+
+			tmp = parent->rb_right;
+			if (node == tmp) {
+				/*
+				 * Case 2 - node's uncle is black and node is
+				 * the parent's right child (left rotate at parent).
+				 *
+				 *      G             G
+				 *     / \           / \
+				 *    p   U  -->    n   U
+				 *     \           /
+				 *      n         p
+				 *
+				 * This still leaves us in violation of 4), the
+				 * continuation into Case 3 will fix that.
+				 */
+				tmp = node->rb_left;
+				ES_WRITE_ONCE(parent->rb_right, tmp);
+				ES_WRITE_ONCE(node->rb_left, parent);
+				if (tmp)
+					es_rb_set_parent_color(tmp, parent,
+							ES_RB_BLACK);
+				es_rb_set_parent_color(parent, node, ES_RB_RED);
+				augment_rotate(parent, node);
+				parent = node;
+				tmp = node->rb_right;
+			}
+
+			/*
+			 * Case 3 - node's uncle is black and node is
+			 * the parent's left child (right rotate at gparent).
+			 *
+			 *        G           P
+			 *       / \         / \
+			 *      p   U  -->  n   g
+			 *     /                 \
+			 *    n                   U
+			 */
+			ES_WRITE_ONCE(gparent->rb_left, tmp); /* == parent->rb_right */
+			ES_WRITE_ONCE(parent->rb_right, gparent);
+			if (tmp)
+				es_rb_set_parent_color(tmp, gparent, ES_RB_BLACK);
+			__es_rb_rotate_set_parents(gparent, parent, root, ES_RB_RED);
+			augment_rotate(gparent, parent);
+			break;
+		} else {
+			tmp = gparent->rb_left;
+			if (tmp && es_rb_is_red(tmp)) {
+				/* Case 1 - color flips */
+				es_rb_set_parent_color(tmp, gparent, ES_RB_BLACK);
+				es_rb_set_parent_color(parent, gparent, ES_RB_BLACK);
+				node = gparent;
+				parent = es_rb_parent(node);
+				es_rb_set_parent_color(node, parent, ES_RB_RED);
+				continue;
+			}
+
+			tmp = parent->rb_left;
+			if (node == tmp) {
+				/* Case 2 - right rotate at parent */
+				tmp = node->rb_right;
+				ES_WRITE_ONCE(parent->rb_left, tmp);
+				ES_WRITE_ONCE(node->rb_right, parent);
+				if (tmp)
+					es_rb_set_parent_color(tmp, parent,
+							ES_RB_BLACK);
+				es_rb_set_parent_color(parent, node, ES_RB_RED);
+				augment_rotate(parent, node);
+				parent = node;
+				tmp = node->rb_left;
+			}
+
+			/* Case 3 - left rotate at gparent */
+			ES_WRITE_ONCE(gparent->rb_right, tmp); /* == parent->rb_left */
+			ES_WRITE_ONCE(parent->rb_left, gparent);
+			if (tmp)
+				es_rb_set_parent_color(tmp, gparent, ES_RB_BLACK);
+			__es_rb_rotate_set_parents(gparent, parent, root, ES_RB_RED);
+			augment_rotate(gparent, parent);
+			break;
+		}
+	}
+}
+
+/*
+ * Inline version for es_rb_erase() use - we want to be able to inline
+ * and eliminate the dummy_rotate callback there
+ */
+static inline void
+____es_rb_erase_color(struct es_rb_node *parent, struct es_rb_root *root,
+	void (*augment_rotate)(struct es_rb_node *old, struct es_rb_node *new))
+{
+	struct es_rb_node *node = NULL, *sibling, *tmp1, *tmp2;
+
+	while (es_true) {
+		/*
+		 * Loop invariants:
+		 * - node is black (or NULL on first iteration)
+		 * - node is not the root (parent is not NULL)
+		 * - All leaf paths going through parent and node have a
+		 *   black node count that is 1 lower than other leaf paths.
+		 */
+		sibling = parent->rb_right;
+		if (node != sibling) {	/* node == parent->rb_left */
+			if (es_rb_is_red(sibling)) {
+				/*
+				 * Case 1 - left rotate at parent
+				 *
+				 *     P               S
+				 *    / \             / \
+				 *   N   s    -->    p   Sr
+				 *      / \         / \
+				 *     Sl  Sr      N   Sl
+				 */
+				tmp1 = sibling->rb_left;
+				ES_WRITE_ONCE(parent->rb_right, tmp1);
+				ES_WRITE_ONCE(sibling->rb_left, parent);
+				es_rb_set_parent_color(tmp1, parent, ES_RB_BLACK);
+				__es_rb_rotate_set_parents(parent, sibling, root,
+						ES_RB_RED);
+				augment_rotate(parent, sibling);
+				sibling = tmp1;
+			}
+			tmp1 = sibling->rb_right;
+			if (!tmp1 || es_rb_is_black(tmp1)) {
+				tmp2 = sibling->rb_left;
+				if (!tmp2 || es_rb_is_black(tmp2)) {
+					/*
+					 * Case 2 - sibling color flip
+					 * (p could be either color here)
+					 *
+					 *    (p)           (p)
+					 *    / \           / \
+					 *   N   S    -->  N   s
+					 *      / \           / \
+					 *     Sl  Sr        Sl  Sr
+					 *
+					 * This leaves us violating 5) which
+					 * can be fixed by flipping p to black
+					 * if it was red, or by recursing at p.
+					 * p is red when coming from Case 1.
+					 */
+					es_rb_set_parent_color(sibling, parent,
+							ES_RB_RED);
+					if (es_rb_is_red(parent))
+						es_rb_set_black(parent);
+					else {
+						node = parent;
+						parent = es_rb_parent(node);
+						if (parent)
+							continue;
+					}
+					break;
+				}
+				/*
+				 * Case 3 - right rotate at sibling
+				 * (p could be either color here)
+				 *
+				 *   (p)           (p)
+				 *   / \           / \
+				 *  N   S    -->  N   sl
+				 *     / \             \
+				 *    sl  Sr            S
+				 *                       \
+				 *                        Sr
+				 *
+				 * Note: p might be red, and then both
+				 * p and sl are red after rotation(which
+				 * breaks property 4). This is fixed in
+				 * Case 4 (in __es_rb_rotate_set_parents()
+				 *         which set sl the color of p
+				 *         and set p ES_RB_BLACK)
+				 *
+				 *   (p)            (sl)
+				 *   / \            /  \
+				 *  N   sl   -->   P    S
+				 *       \        /      \
+				 *        S      N        Sr
+				 *         \
+				 *          Sr
+				 */
+				tmp1 = tmp2->rb_right;
+				ES_WRITE_ONCE(sibling->rb_left, tmp1);
+				ES_WRITE_ONCE(tmp2->rb_right, sibling);
+				ES_WRITE_ONCE(parent->rb_right, tmp2);
+				if (tmp1)
+					es_rb_set_parent_color(tmp1, sibling,
+							ES_RB_BLACK);
+				augment_rotate(sibling, tmp2);
+				tmp1 = sibling;
+				sibling = tmp2;
+			}
+			/*
+			 * Case 4 - left rotate at parent + color flips
+			 * (p and sl could be either color here.
+			 *  After rotation, p becomes black, s acquires
+			 *  p's color, and sl keeps its color)
+			 *
+			 *      (p)             (s)
+			 *      / \             / \
+			 *     N   S     -->   P   Sr
+			 *        / \         / \
+			 *      (sl) sr      N  (sl)
+			 */
+			tmp2 = sibling->rb_left;
+			ES_WRITE_ONCE(parent->rb_right, tmp2);
+			ES_WRITE_ONCE(sibling->rb_left, parent);
+			es_rb_set_parent_color(tmp1, sibling, ES_RB_BLACK);
+			if (tmp2)
+				es_rb_set_parent(tmp2, parent);
+			__es_rb_rotate_set_parents(parent, sibling, root,
+					ES_RB_BLACK);
+			augment_rotate(parent, sibling);
+			break;
+		} else {
+			sibling = parent->rb_left;
+			if (es_rb_is_red(sibling)) {
+				/* Case 1 - right rotate at parent */
+				tmp1 = sibling->rb_right;
+				ES_WRITE_ONCE(parent->rb_left, tmp1);
+				ES_WRITE_ONCE(sibling->rb_right, parent);
+				es_rb_set_parent_color(tmp1, parent, ES_RB_BLACK);
+				__es_rb_rotate_set_parents(parent, sibling, root,
+						ES_RB_RED);
+				augment_rotate(parent, sibling);
+				sibling = tmp1;
+			}
+			tmp1 = sibling->rb_left;
+			if (!tmp1 || es_rb_is_black(tmp1)) {
+				tmp2 = sibling->rb_right;
+				if (!tmp2 || es_rb_is_black(tmp2)) {
+					/* Case 2 - sibling color flip */
+					es_rb_set_parent_color(sibling, parent,
+							ES_RB_RED);
+					if (es_rb_is_red(parent))
+						es_rb_set_black(parent);
+					else {
+						node = parent;
+						parent = es_rb_parent(node);
+						if (parent)
+							continue;
+					}
+					break;
+				}
+				/* Case 3 - left rotate at sibling */
+				tmp1 = tmp2->rb_left;
+				ES_WRITE_ONCE(sibling->rb_right, tmp1);
+				ES_WRITE_ONCE(tmp2->rb_left, sibling);
+				ES_WRITE_ONCE(parent->rb_left, tmp2);
+				if (tmp1)
+					es_rb_set_parent_color(tmp1, sibling,
+							ES_RB_BLACK);
+				augment_rotate(sibling, tmp2);
+				tmp1 = sibling;
+				sibling = tmp2;
+			}
+			/* Case 4 - right rotate at parent + color flips */
+			tmp2 = sibling->rb_right;
+			ES_WRITE_ONCE(parent->rb_left, tmp2);
+			ES_WRITE_ONCE(sibling->rb_right, parent);
+			es_rb_set_parent_color(tmp1, sibling, ES_RB_BLACK);
+			if (tmp2)
+				es_rb_set_parent(tmp2, parent);
+			__es_rb_rotate_set_parents(parent, sibling, root,
+					ES_RB_BLACK);
+			augment_rotate(parent, sibling);
+			break;
+		}
+	}
+}
+
+/* Non-inline version for es_rb_erase_augmented() use */
+void __es_rb_erase_color(struct es_rb_node *parent, struct es_rb_root *root,
+	void (*augment_rotate)(struct es_rb_node *old, struct es_rb_node *new))
+{
+	____es_rb_erase_color(parent, root, augment_rotate);
+}
+
+/*
+ * Non-augmented rbtree manipulation functions.
+ *
+ * We use dummy augmented callbacks here, and have the compiler optimize them
+ * out of the es_rb_insert_color() and es_rb_erase() function definitions.
+ */
+
+static inline void dummy_propagate(struct es_rb_node *node,
+				struct es_rb_node *stop) {}
+static inline void dummy_copy(struct es_rb_node *old,
+				struct es_rb_node *new) {}
+static inline void dummy_rotate(struct es_rb_node *old,
+				struct es_rb_node *new) {}
+
+static const struct es_rb_augment_callbacks dummy_callbacks = {
+	.propagate = dummy_propagate,
+	.copy = dummy_copy,
+	.rotate = dummy_rotate
+};
+
+/**
+ * es_rb_insert_color - rebalance the tree after linking a node
+ * @node: the node linked in with es_rb_link_node()
+ * @root: the tree
+ */
+void es_rb_insert_color(struct es_rb_node *node, struct es_rb_root *root)
+{
+	__es_rb_insert(node, root, dummy_rotate);
+}
+
+/**
+ * es_rb_erase - unlink a node from the tree and rebalance it
+ * @node: the node to be removed
+ * @root: the tree
+ */
+void es_rb_erase(struct es_rb_node *node, struct es_rb_root *root)
+{
+	struct es_rb_node *rebalance;
+
+	rebalance = __es_rb_erase_augmented(node, root, &dummy_callbacks);
+	if (rebalance)
+		____es_rb_erase_color(rebalance, root, dummy_rotate);
+}
+
+/*
+ * Augmented rbtree manipulation functions.
+ *
+ * This instantiates the same inline functions as in the non-augmented
+ * case, but this time with user-defined callbacks.
+ */
+
+void __es_rb_insert_augmented(struct es_rb_node *node, struct es_rb_root *root,
+	void (*augment_rotate)(struct es_rb_node *old, struct es_rb_node *new))
+{
+	__es_rb_insert(node, root, augment_rotate);
+}
+
+/*
+ * This function returns the first node (in sort order) of the tree.
+ */
+struct es_rb_node *es_rb_first(const struct es_rb_root *root)
+{
+	struct es_rb_node	*n;
+
+	n = root->rb_node;
+	if (!n)
+		return NULL;
+	while (n->rb_left)
+		n = n->rb_left;
+	return n;
+}
+
+struct es_rb_node *es_rb_last(const struct es_rb_root *root)
+{
+	struct es_rb_node	*n;
+
+	n = root->rb_node;
+	if (!n)
+		return NULL;
+	while (n->rb_right)
+		n = n->rb_right;
+	return n;
+}
+
+struct es_rb_node *es_rb_next(const struct es_rb_node *node)
+{
+	struct es_rb_node *parent;
+
+	if (ES_RB_EMPTY_NODE(node))
+		return NULL;
+
+	/*
+	 * If we have a right-hand child, go down and then left as far
+	 * as we can.
+	 */
+	if (node->rb_right) {
+		node = node->rb_right;
+		while (node->rb_left)
+			node = node->rb_left;
+		return (struct es_rb_node *)node;
+	}
+
+	/*
+	 * No right-hand children. Everything down and left is smaller than us,
+	 * so any 'next' node must be in the general direction of our parent.
+	 * Go up the tree; any time the ancestor is a right-hand child of its
+	 * parent, keep going up. First time it's a left-hand child of its
+	 * parent, said parent is our 'next' node.
+	 */
+	while ((parent = es_rb_parent(node)) && node == parent->rb_right)
+		node = parent;
+
+	return parent;
+}
+
+struct es_rb_node *es_rb_prev(const struct es_rb_node *node)
+{
+	struct es_rb_node *parent;
+
+	if (ES_RB_EMPTY_NODE(node))
+		return NULL;
+
+	/*
+	 * If we have a left-hand child, go down and then right as far
+	 * as we can.
+	 */
+	if (node->rb_left) {
+		node = node->rb_left;
+		while (node->rb_right)
+			node = node->rb_right;
+		return (struct es_rb_node *)node;
+	}
+
+	/*
+	 * No left-hand children. Go up till we find an ancestor which
+	 * is a right-hand child of its parent.
+	 */
+	while ((parent = es_rb_parent(node)) && node == parent->rb_left)
+		node = parent;
+
+	return parent;
+}
+
+void es_rb_replace_node(struct es_rb_node *victim, struct es_rb_node *new,
+			struct es_rb_root *root)
+{
+	struct es_rb_node *parent = es_rb_parent(victim);
+
+	/* Copy the pointers/colour from the victim to the replacement */
+	*new = *victim;
+
+	/* Set the surrounding nodes to point to the replacement */
+	if (victim->rb_left)
+		es_rb_set_parent(victim->rb_left, new);
+	if (victim->rb_right)
+		es_rb_set_parent(victim->rb_right, new);
+	__es_rb_change_child(victim, new, parent, root);
+}
+
+static struct es_rb_node *es_rb_left_deepest_node(const struct es_rb_node *node)
+{
+	for (;;) {
+		if (node->rb_left)
+			node = node->rb_left;
+		else if (node->rb_right)
+			node = node->rb_right;
+		else
+			return (struct es_rb_node *)node;
+	}
+}
+
+struct es_rb_node *es_rb_next_postorder(const struct es_rb_node *node)
+{
+	const struct es_rb_node *parent;
+
+	if (!node)
+		return NULL;
+	parent = es_rb_parent(node);
+
+	/* If we're sitting on node, we've already seen our children */
+	if (parent && node == parent->rb_left && parent->rb_right) {
+		/* If we are the parent's left node, go to the parent's right
+		 * node then all the way down to the left */
+		return es_rb_left_deepest_node(parent->rb_right);
+	} else
+		/* Otherwise we are the parent's right node, and the parent
+		 * should be next */
+		return (struct es_rb_node *)parent;
+}
+
+struct es_rb_node *es_rb_first_postorder(const struct es_rb_root *root)
+{
+	if (!root->rb_node)
+		return NULL;
+
+	return es_rb_left_deepest_node(root->rb_node);
+}
+
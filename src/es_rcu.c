@@ -0,0 +1,201 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rcu.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_rcu.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/* spins on a reader before yielding, yields before sleeping */
+#define ES_RCU_SPINS		100
+#define ES_RCU_YIELDS		100
+
+unsigned long es_rcu_gp_ctr = ES_RCU_GP_COUNT;
+__thread struct es_rcu_reader __es_rcu_reader;
+
+/* serializes grace periods and guards the reader list */
+static pthread_mutex_t es_rcu_gp_lock = PTHREAD_MUTEX_INITIALIZER;
+static ES_LIST_HEAD(es_rcu_readers);
+static pthread_key_t es_rcu_key;
+static pthread_once_t es_rcu_key_once = PTHREAD_ONCE_INIT;
+
+static void _es_rcu_unregister_thread(void *arg)
+{
+	struct es_rcu_reader *r = arg;
+
+	pthread_mutex_lock(&es_rcu_gp_lock);
+	es_list_del(&r->node);
+	r->registered = es_false;
+	pthread_mutex_unlock(&es_rcu_gp_lock);
+}
+
+static void _es_rcu_key_init(void)
+{
+	pthread_key_create(&es_rcu_key, _es_rcu_unregister_thread);
+}
+
+/**
+ * __es_rcu_register_thread - add the calling thread to the readers
+ *
+ * Done by the first es_rcu_read_lock() of a thread, the thread leaves
+ * the list again when it exits.
+ */
+void __es_rcu_register_thread(void)
+{
+	struct es_rcu_reader *r = &__es_rcu_reader;
+
+	pthread_once(&es_rcu_key_once, _es_rcu_key_init);
+
+	pthread_mutex_lock(&es_rcu_gp_lock);
+	r->ctr = 0;
+	es_list_add(&r->node, &es_rcu_readers);
+	r->registered = es_true;
+	pthread_mutex_unlock(&es_rcu_gp_lock);
+
+	pthread_setspecific(es_rcu_key, r);
+}
+
+/*
+ * _es_rcu_old_reader internal helper function, true while @r is inside
+ * a read-side section which started before the last phase flip
+ */
+static inline bool _es_rcu_old_reader(struct es_rcu_reader *r)
+{
+	unsigned long v = ES_READ_ONCE(r->ctr);
+
+	return (v & ES_RCU_GP_CTR_NEST_MASK) &&
+		((v ^ es_rcu_gp_ctr) & ES_RCU_GP_CTR_PHASE);
+}
+
+/*
+ * _es_rcu_backoff internal helper function for waiting the @i-th time on
+ * a reader: spin, then yield, then sleep
+ */
+static void _es_rcu_backoff(unsigned int i)
+{
+	struct timespec nap = {0, 100000};
+
+	if (i < ES_RCU_SPINS)
+		es_cpu_relax();
+	else if (i < ES_RCU_SPINS + ES_RCU_YIELDS)
+		sched_yield();
+	else
+		nanosleep(&nap, NULL);
+}
+
+static void _es_rcu_wait_reader(struct es_rcu_reader *r)
+{
+	unsigned int i;
+
+	for (i = 0; _es_rcu_old_reader(r); i++)
+		_es_rcu_backoff(i);
+}
+
+static void _es_rcu_flip_and_wait(void)
+{
+	struct es_rcu_reader *r;
+
+	ES_WRITE_ONCE(es_rcu_gp_ctr, es_rcu_gp_ctr ^ ES_RCU_GP_CTR_PHASE);
+	/* the new phase is visible before the readers are sampled */
+	es_smp_mb();
+
+	es_list_for_each_entry(r, &es_rcu_readers, node)
+		_es_rcu_wait_reader(r);
+}
+
+/**
+ * es_synchronize_rcu - wait until all pre-existing readers are done
+ *
+ * Returns once every read-side critical section which was running when
+ * it was called has ended, new ones may have started. Must not be called
+ * from inside a read-side critical section, the caller would wait for
+ * itself.
+ *
+ * Return 0, or ES_FAIL without waiting if called inside a read-side
+ * section.
+ */
+int es_synchronize_rcu(void)
+{
+	if (es_rcu_read_lock_held()) {
+		ES_PRINTF("es_rcu: synchronize inside a read-side section \n");
+		return ES_FAIL;
+	}
+
+	pthread_mutex_lock(&es_rcu_gp_lock);
+	/* the caller's unlinking is visible before the first flip */
+	es_smp_mb();
+
+	/*
+	 * Two flips: a reader delayed between loading the counter and
+	 * storing its snapshot stores a stale phase, which after one flip
+	 * per grace period may have come round again and look current.
+	 * Waiting for both phases closes that window.
+	 */
+	_es_rcu_flip_and_wait();
+	_es_rcu_flip_and_wait();
+
+	/* readers are done before the caller frees anything */
+	es_smp_mb();
+	pthread_mutex_unlock(&es_rcu_gp_lock);
+	return ES_SUCCESS;
+}
+
+static void _es_srcu_flip_and_wait(struct es_srcu_struct *sp)
+{
+	unsigned long idx = sp->idx;
+	unsigned int i;
+
+	ES_WRITE_ONCE(sp->idx, idx + 1);
+	/* new readers count on the other side before the old one is read */
+	es_smp_mb();
+
+	for (i = 0; ES_READ_ONCE(sp->readers[idx & 1]); i++)
+		_es_rcu_backoff(i);
+}
+
+/**
+ * es_synchronize_srcu - wait until the pre-existing readers of a domain
+ * are done
+ * @sp: the domain
+ *
+ * Like es_synchronize_rcu(), for the readers of @sp only. Must not be
+ * called inside a read-side section of @sp, other sections are fine.
+ */
+void es_synchronize_srcu(struct es_srcu_struct *sp)
+{
+	pthread_mutex_lock(&sp->lock);
+	/* the caller's unlinking is visible before the first flip */
+	es_smp_mb();
+
+	/*
+	 * Two flips: a reader delayed between loading the index and
+	 * bumping its counter counts on a stale side, which may be the
+	 * one a single flip does not wait for. Waiting for both sides
+	 * catches it; a reader counting on a side after it was waited
+	 * for already sees the unlinking.
+	 */
+	_es_srcu_flip_and_wait(sp);
+	_es_srcu_flip_and_wait(sp);
+
+	/* readers are done before the caller frees anything */
+	es_smp_mb();
+	pthread_mutex_unlock(&sp->lock);
+}
+
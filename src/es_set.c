@@ -0,0 +1,1010 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_set.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_set.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ES_SET_NEON
+#endif
+
+/* a bitmap may be this many words larger than twice its id count */
+#define ES_SET_BITMAP_SLACK	8
+
+/* intersect by binary search once one array is this much larger */
+#define ES_SET_GALLOP_RATIO	32
+
+#define ES_SET_BITS		64
+
+static inline unsigned int __es_set_nwords(uint32_t max_id)
+{
+	return max_id / ES_SET_BITS + 1;
+}
+
+/*
+ * a bitmap of @nwords is no larger than an array of @count ids, which
+ * is when new sets become bitmaps
+ */
+static inline bool __es_set_dense(unsigned int nwords, unsigned int count)
+{
+	return nwords <= count / 2;
+}
+
+/* an existing bitmap stays one up to four times that size */
+static inline bool __es_set_bitmap_fits(unsigned int nwords,
+		unsigned int count)
+{
+	return nwords <= 2 * count + ES_SET_BITMAP_SLACK;
+}
+
+/* murmur3 finalizer, the hmap takes the control byte from the low bits */
+static uint32_t _es_set_hash(const void *key, unsigned int ksize)
+{
+	uint32_t h = *(const uint32_t *)key;
+
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static int _es_set_eq(const void *a, const void *b, unsigned int ksize)
+{
+	return *(const uint32_t *)a == *(const uint32_t *)b;
+}
+
+static int _es_set_cmp(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* first index in @ids[@lo, @n) holding an id >= @id */
+static inline unsigned int __es_set_lower_bound(const uint32_t *ids,
+		unsigned int lo, unsigned int n, uint32_t id)
+{
+	unsigned int hi = n, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (ids[mid] < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Word kernels of the bitmap operations, 128 bits per step where the
+ * CPU has vectors
+ */
+#if defined(__SSE2__)
+#define __ES_SET_VOR(a, b)	_mm_or_si128(a, b)
+#define __ES_SET_VAND(a, b)	_mm_and_si128(a, b)
+#define __ES_SET_VANDNOT(a, b)	_mm_andnot_si128(b, a)
+#define __ES_SET_WORDS_LOOP(vop, sop) \
+	for (; i + 2 <= n; i += 2) { \
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i)); \
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i)); \
+		_mm_storeu_si128((__m128i *)(dst + i), vop(va, vb)); \
+	} \
+	for (; i < n; i++) \
+		dst[i] = a[i] sop b[i];
+#elif defined(ES_SET_NEON)
+#define __ES_SET_VOR(a, b)	vorrq_u64(a, b)
+#define __ES_SET_VAND(a, b)	vandq_u64(a, b)
+#define __ES_SET_VANDNOT(a, b)	vbicq_u64(a, b)
+#define __ES_SET_WORDS_LOOP(vop, sop) \
+	for (; i + 2 <= n; i += 2) \
+		vst1q_u64(dst + i, vop(vld1q_u64(a + i), vld1q_u64(b + i))); \
+	for (; i < n; i++) \
+		dst[i] = a[i] sop b[i];
+#else
+#define __ES_SET_WORDS_LOOP(vop, sop) \
+	for (; i < n; i++) \
+		dst[i] = a[i] sop b[i];
+#endif
+
+static inline unsigned int __es_set_popcount(const uint64_t *words,
+		unsigned int n)
+{
+	unsigned int i, cnt = 0;
+
+	for (i = 0; i < n; i++)
+		cnt += __builtin_popcountll(words[i]);
+	return cnt;
+}
+
+static void __es_set_words_or(uint64_t *dst, const uint64_t *a,
+		const uint64_t *b, unsigned int n)
+{
+	unsigned int i = 0;
+
+	__ES_SET_WORDS_LOOP(__ES_SET_VOR, |)
+}
+
+static void __es_set_words_and(uint64_t *dst, const uint64_t *a,
+		const uint64_t *b, unsigned int n)
+{
+	unsigned int i = 0;
+
+	__ES_SET_WORDS_LOOP(__ES_SET_VAND, &)
+}
+
+static void __es_set_words_andnot(uint64_t *dst, const uint64_t *a,
+		const uint64_t *b, unsigned int n)
+{
+	unsigned int i = 0;
+
+	__ES_SET_WORDS_LOOP(__ES_SET_VANDNOT, & ~)
+}
+
+/*
+ * __es_set_match4 internal helper function comparing the 4 ids at @a
+ * with the 4 ids at @b, all pairs, returns a mask of the ids of @a
+ * found in @b
+ */
+#if defined(__SSE2__)
+static inline unsigned int __es_set_match4(const uint32_t *a,
+		const uint32_t *b)
+{
+	__m128i va = _mm_loadu_si128((const __m128i *)a);
+	__m128i vb = _mm_loadu_si128((const __m128i *)b);
+	__m128i m0 = _mm_cmpeq_epi32(va, vb);
+	__m128i m1 = _mm_cmpeq_epi32(va,
+			_mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+	__m128i m2 = _mm_cmpeq_epi32(va,
+			_mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+	__m128i m3 = _mm_cmpeq_epi32(va,
+			_mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+	__m128i m = _mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3));
+
+	return _mm_movemask_ps(_mm_castsi128_ps(m));
+}
+#elif defined(ES_SET_NEON)
+static inline unsigned int __es_set_match4(const uint32_t *a,
+		const uint32_t *b)
+{
+	static const uint32_t lane_bits[4] = {1, 2, 4, 8};
+	uint32x4_t va = vld1q_u32(a), vb = vld1q_u32(b);
+	uint32x4_t m = vorrq_u32(
+		vorrq_u32(vceqq_u32(va, vb), vceqq_u32(va, vextq_u32(vb, vb, 1))),
+		vorrq_u32(vceqq_u32(va, vextq_u32(vb, vb, 2)),
+			vceqq_u32(va, vextq_u32(vb, vb, 3))));
+	uint32x4_t bits = vandq_u32(m, vld1q_u32(lane_bits));
+	uint32x2_t s = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+
+	return vget_lane_u32(vpadd_u32(s, s), 0);
+}
+#else
+static inline unsigned int __es_set_match4(const uint32_t *a,
+		const uint32_t *b)
+{
+	unsigned int i, m = 0;
+
+	for (i = 0; i < 4; i++)
+		m |= (a[i] == b[0] || a[i] == b[1] ||
+			a[i] == b[2] || a[i] == b[3]) << i;
+	return m;
+}
+#endif
+
+/*
+ * _es_set_array_match internal helper function for the ids of @a which
+ * are in @b (@diff false) or not in @b (@diff true), in order
+ *
+ * Both arrays are walked in blocks of 4, each pair of overlapping blocks
+ * is compared all against all, then the block with the smaller last id
+ * moves on. Much smaller @a binary searches @b instead.
+ */
+static unsigned int _es_set_array_match(uint32_t *out, const uint32_t *a,
+		unsigned int na, const uint32_t *b, unsigned int nb, bool diff)
+{
+	unsigned int i = 0, j = 0, n = 0, found = 0, m;
+	uint32_t amax, bmax;
+
+	if (nb / ES_SET_GALLOP_RATIO > na) {
+		for (i = 0; i < na; i++) {
+			j = __es_set_lower_bound(b, j, nb, a[i]);
+			if ((j < nb && b[j] == a[i]) != diff)
+				out[n++] = a[i];
+		}
+		return n;
+	}
+
+	while (i + 4 <= na && j + 4 <= nb) {
+		amax = a[i + 3];
+		bmax = b[j + 3];
+		found |= __es_set_match4(a + i, b + j);
+		if (amax <= bmax) {
+			/* nothing further in b can match this block */
+			m = diff ? ~found & 0xf : found;
+			while (m) {
+				out[n++] = a[i + __builtin_ctz(m)];
+				m &= m - 1;
+			}
+			i += 4;
+			found = 0;
+		}
+		if (bmax <= amax)
+			j += 4;
+	}
+
+	/* the rest one by one, @found still holds the current block */
+	for (; i < na; i++, found >>= 1) {
+		if (found & 1) {
+			if (!diff)
+				out[n++] = a[i];
+			continue;
+		}
+		while (j < nb && b[j] < a[i])
+			j++;
+		if ((j < nb && b[j] == a[i]) != diff)
+			out[n++] = a[i];
+	}
+	return n;
+}
+
+static unsigned int _es_set_array_merge(uint32_t *out, const uint32_t *a,
+		unsigned int na, const uint32_t *b, unsigned int nb)
+{
+	unsigned int i = 0, j = 0, n = 0;
+
+	while (i < na && j < nb) {
+		if (a[i] < b[j]) {
+			out[n++] = a[i++];
+		} else if (b[j] < a[i]) {
+			out[n++] = b[j++];
+		} else {
+			out[n++] = a[i++];
+			j++;
+		}
+	}
+	memcpy(out + n, a + i, (na - i) * sizeof(*out));
+	n += na - i;
+	memcpy(out + n, b + j, (nb - j) * sizeof(*out));
+	return n + nb - j;
+}
+
+/*
+ * _es_set_ids internal helper function for the ids of @set, ascending
+ * unless it is a hash and @sorted is false. An array set returns its own
+ * buffer (@owned false), the others a new one to be freed by the caller.
+ * NULL if out of memory.
+ */
+static uint32_t *_es_set_ids(struct es_set *set, bool *owned, bool sorted)
+{
+	struct es_hmap_iter iter;
+	uint32_t *ids;
+	uint64_t w;
+	void *key, *value;
+	unsigned int i, n = 0;
+
+	*owned = es_false;
+	if (set->type == ES_SET_ARRAY)
+		return set->array.ids;
+
+	ids = malloc((size_t)max(set->count, 1U) * sizeof(*ids));
+	if (!ids)
+		return NULL;
+	*owned = es_true;
+
+	if (set->type == ES_SET_BITMAP) {
+		for (i = 0; i < set->bitmap.nwords; i++) {
+			for (w = set->bitmap.words[i]; w; w &= w - 1)
+				ids[n++] = i * ES_SET_BITS + __builtin_ctzll(w);
+		}
+		return ids;
+	}
+
+	es_hmap_iter_init(&iter);
+	while (es_hmap_iter_next(&set->hash.map, &iter, &key, &value))
+		ids[n++] = *(uint32_t *)key;
+	if (sorted)
+		qsort(ids, n, sizeof(*ids), _es_set_cmp);
+	return ids;
+}
+
+/*
+ * _es_set_build internal helper function for making @set hold the @n
+ * unique ids at @ids in the representation which fits them best. Only
+ * an array needs them @sorted, it sorts them otherwise. With @adopt the
+ * buffer, malloc()ed and @n ids long at least, belongs to the set on
+ * success.
+ */
+static int _es_set_build(struct es_set *set, uint32_t *ids, unsigned int n,
+		bool sorted, bool adopt)
+{
+	unsigned int i, nwords;
+	uint32_t *copy, top;
+
+	es_set_init(set);
+	if (!n) {
+		if (adopt)
+			free(ids);
+		return ES_SUCCESS;
+	}
+
+	if (sorted) {
+		top = ids[n - 1];
+	} else {
+		for (top = ids[0], i = 1; i < n; i++)
+			top = max(top, ids[i]);
+	}
+
+	nwords = __es_set_nwords(top);
+	if (__es_set_dense(nwords, n)) {
+		set->bitmap.words = calloc(nwords, sizeof(uint64_t));
+		if (!set->bitmap.words)
+			return ES_FAIL;
+		for (i = 0; i < n; i++)
+			set->bitmap.words[ids[i] / ES_SET_BITS] |=
+				1ULL << (ids[i] % ES_SET_BITS);
+		set->bitmap.nwords = nwords;
+		set->type = ES_SET_BITMAP;
+	} else if (n <= ES_SET_ARRAY_MAX) {
+		if (!adopt) {
+			copy = malloc((size_t)n * sizeof(*ids));
+			if (!copy)
+				return ES_FAIL;
+			memcpy(copy, ids, (size_t)n * sizeof(*ids));
+			ids = copy;
+		}
+		if (!sorted)
+			qsort(ids, n, sizeof(*ids), _es_set_cmp);
+		set->array.ids = ids;
+		set->array.cap = n;
+		set->count = n;
+		return ES_SUCCESS;
+	} else {
+		if (es_hmap_init(&set->hash.map, sizeof(uint32_t), 0, n,
+			_es_set_hash, _es_set_eq))
+			return ES_FAIL;
+		for (i = 0; i < n; i++) {
+			if (!es_hmap_insert(&set->hash.map, &ids[i], NULL)) {
+				es_hmap_destroy(&set->hash.map);
+				es_set_init(set);
+				return ES_FAIL;
+			}
+		}
+		set->hash.max = top;
+		set->type = ES_SET_HASH;
+	}
+
+	set->count = n;
+	if (adopt)
+		free(ids);
+	return ES_SUCCESS;
+}
+
+/*
+ * _es_set_replace internal helper function for dropping the content of
+ * @set and taking the one of @tmp
+ */
+static void _es_set_replace(struct es_set *set, struct es_set *tmp)
+{
+	es_set_destroy(set);
+	*set = *tmp;
+}
+
+/*
+ * _es_set_rebuild internal helper function for moving @set to the
+ * representation which fits it best, it keeps the current one if
+ * memory runs out
+ */
+static int _es_set_rebuild(struct es_set *set)
+{
+	struct es_set tmp;
+	uint32_t *ids;
+	bool owned;
+
+	ids = _es_set_ids(set, &owned, es_false);
+	if (!ids)
+		return ES_FAIL;
+	if (_es_set_build(&tmp, ids, set->count, set->type != ES_SET_HASH,
+		es_true)) {
+		if (owned)
+			free(ids);
+		return ES_FAIL;
+	}
+	/* an array handed its buffer over */
+	if (!owned)
+		set->array.ids = NULL;
+	_es_set_replace(set, &tmp);
+	return ES_SUCCESS;
+}
+
+/*
+ * _es_set_tune internal helper function for checking the representation
+ * after an add or a delete. The bounds to leave one are wider than the
+ * ones to enter it, so a set near a bound does not flip back and forth.
+ */
+static void _es_set_tune(struct es_set *set)
+{
+	unsigned int cnt = set->count;
+	bool rebuild;
+
+	switch (set->type) {
+	case ES_SET_ARRAY:
+		rebuild = cnt > ES_SET_ARRAY_MAX || (cnt &&
+			__es_set_dense(__es_set_nwords(set->array.ids[cnt - 1]),
+				cnt));
+		break;
+	case ES_SET_BITMAP:
+		rebuild = !__es_set_bitmap_fits(set->bitmap.nwords, cnt);
+		break;
+	default:
+		rebuild = cnt < ES_SET_ARRAY_MAX / 2 ||
+			__es_set_dense(__es_set_nwords(set->hash.max), cnt);
+		break;
+	}
+
+	/* on failure the set works on in its current representation */
+	if (rebuild)
+		_es_set_rebuild(set);
+}
+
+/**
+ * es_set_init - initialize an empty set
+ * @set: the set to be initialized
+ *
+ * An empty set allocates no memory.
+ */
+void es_set_init(struct es_set *set)
+{
+	memset(set, 0, sizeof(*set));
+	set->type = ES_SET_ARRAY;
+}
+
+/**
+ * es_set_destroy - free the memory of a set
+ * @set: the set to be used.
+ *
+ * The set is empty afterwards and may be used again.
+ */
+void es_set_destroy(struct es_set *set)
+{
+	switch (set->type) {
+	case ES_SET_ARRAY:
+		free(set->array.ids);
+		break;
+	case ES_SET_BITMAP:
+		free(set->bitmap.words);
+		break;
+	case ES_SET_HASH:
+		es_hmap_destroy(&set->hash.map);
+		break;
+	}
+	es_set_init(set);
+}
+
+/**
+ * es_set_clear - remove all ids
+ * @set: the set to be used.
+ */
+void es_set_clear(struct es_set *set)
+{
+	es_set_destroy(set);
+}
+
+static int _es_set_array_add(struct es_set *set, uint32_t id)
+{
+	unsigned int pos = __es_set_lower_bound(set->array.ids, 0,
+					set->count, id);
+	uint32_t *ids;
+	unsigned int cap;
+
+	if (pos < set->count && set->array.ids[pos] == id)
+		return ES_SUCCESS;
+
+	if (set->count == set->array.cap) {
+		cap = max(set->array.cap * 2, 8U);
+		ids = realloc(set->array.ids, (size_t)cap * sizeof(*ids));
+		if (!ids)
+			return ES_FAIL;
+		set->array.ids = ids;
+		set->array.cap = cap;
+	}
+	memmove(set->array.ids + pos + 1, set->array.ids + pos,
+		(set->count - pos) * sizeof(*set->array.ids));
+	set->array.ids[pos] = id;
+	set->count++;
+	return ES_SUCCESS;
+}
+
+static int _es_set_bitmap_add(struct es_set *set, uint32_t id)
+{
+	unsigned int w = id / ES_SET_BITS, nwords, limit;
+	struct es_set tmp;
+	uint32_t *ids, *more;
+	uint64_t *words;
+	bool owned;
+
+	if (w >= set->bitmap.nwords) {
+		limit = 2 * (set->count + 1) + ES_SET_BITMAP_SLACK;
+		if (w >= limit) {
+			/* too sparse now, @id is larger than all others */
+			ids = _es_set_ids(set, &owned, es_true);
+			if (!ids)
+				return ES_FAIL;
+			more = realloc(ids, (size_t)(set->count + 1) * sizeof(*ids));
+			if (!more) {
+				free(ids);
+				return ES_FAIL;
+			}
+			ids = more;
+			ids[set->count] = id;
+			if (_es_set_build(&tmp, ids, set->count + 1, es_true,
+				es_true)) {
+				free(ids);
+				return ES_FAIL;
+			}
+			_es_set_replace(set, &tmp);
+			return ES_SUCCESS;
+		}
+
+		nwords = min(max(w + 1, set->bitmap.nwords * 3 / 2), limit);
+		words = realloc(set->bitmap.words, nwords * sizeof(*words));
+		if (!words)
+			return ES_FAIL;
+		memset(words + set->bitmap.nwords, 0,
+			(nwords - set->bitmap.nwords) * sizeof(*words));
+		set->bitmap.words = words;
+		set->bitmap.nwords = nwords;
+	}
+
+	if (!(set->bitmap.words[w] & (1ULL << (id % ES_SET_BITS)))) {
+		set->bitmap.words[w] |= 1ULL << (id % ES_SET_BITS);
+		set->count++;
+	}
+	return ES_SUCCESS;
+}
+
+/**
+ * es_set_add - add an id to the set
+ * @set: the set to be used.
+ * @id: the id to be added
+ *
+ * Adding an id which is in the set already is no error.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_set_add(struct es_set *set, uint32_t id)
+{
+	int existed, ret = ES_SUCCESS;
+
+	switch (set->type) {
+	case ES_SET_ARRAY:
+		ret = _es_set_array_add(set, id);
+		break;
+	case ES_SET_BITMAP:
+		return _es_set_bitmap_add(set, id);
+	case ES_SET_HASH:
+		if (!es_hmap_insert(&set->hash.map, &id, &existed))
+			return ES_FAIL;
+		if (existed)
+			return ES_SUCCESS;
+		set->count++;
+		set->hash.max = max(set->hash.max, id);
+		break;
+	}
+
+	if (!ret)
+		_es_set_tune(set);
+	return ret;
+}
+
+/**
+ * es_set_del - remove an id from the set
+ * @set: the set to be used.
+ * @id: the id to be removed
+ *
+ * Return 0 if removed, ES_FAIL if the id was not in the set
+ */
+int es_set_del(struct es_set *set, uint32_t id)
+{
+	unsigned int pos, w = id / ES_SET_BITS;
+
+	switch (set->type) {
+	case ES_SET_ARRAY:
+		pos = __es_set_lower_bound(set->array.ids, 0, set->count, id);
+		if (pos == set->count || set->array.ids[pos] != id)
+			return ES_FAIL;
+		memmove(set->array.ids + pos, set->array.ids + pos + 1,
+			(set->count - pos - 1) * sizeof(*set->array.ids));
+		break;
+	case ES_SET_BITMAP:
+		if (w >= set->bitmap.nwords ||
+			!(set->bitmap.words[w] & (1ULL << (id % ES_SET_BITS))))
+			return ES_FAIL;
+		set->bitmap.words[w] &= ~(1ULL << (id % ES_SET_BITS));
+		break;
+	case ES_SET_HASH:
+		if (es_hmap_erase(&set->hash.map, &id))
+			return ES_FAIL;
+		break;
+	}
+
+	set->count--;
+	_es_set_tune(set);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_set_contains - returns true if the id is in the set
+ * @set: the set to be used.
+ * @id: the id to look for
+ */
+bool es_set_contains(struct es_set *set, uint32_t id)
+{
+	unsigned int pos, w = id / ES_SET_BITS;
+
+	switch (set->type) {
+	case ES_SET_ARRAY:
+		pos = __es_set_lower_bound(set->array.ids, 0, set->count, id);
+		return pos < set->count && set->array.ids[pos] == id;
+	case ES_SET_BITMAP:
+		return w < set->bitmap.nwords &&
+			(set->bitmap.words[w] >> (id % ES_SET_BITS)) & 1;
+	default:
+		return es_hmap_find(&set->hash.map, &id) != NULL;
+	}
+}
+
+/**
+ * es_set_copy - copy a set
+ * @dst: an initialized set, its old ids are dropped
+ * @src: the set to be copied
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_set_copy(struct es_set *dst, struct es_set *src)
+{
+	struct es_set tmp;
+	uint32_t *ids;
+	bool owned;
+	int ret;
+
+	if (dst == src)
+		return ES_SUCCESS;
+
+	if (src->type == ES_SET_BITMAP) {
+		es_set_init(&tmp);
+		tmp.bitmap.words = malloc(src->bitmap.nwords * sizeof(uint64_t));
+		if (!tmp.bitmap.words)
+			return ES_FAIL;
+		memcpy(tmp.bitmap.words, src->bitmap.words,
+			src->bitmap.nwords * sizeof(uint64_t));
+		tmp.bitmap.nwords = src->bitmap.nwords;
+		tmp.type = ES_SET_BITMAP;
+		tmp.count = src->count;
+		_es_set_replace(dst, &tmp);
+		return ES_SUCCESS;
+	}
+
+	ids = _es_set_ids(src, &owned, es_false);
+	if (!ids && src->count)
+		return ES_FAIL;
+	ret = _es_set_build(&tmp, ids, src->count, src->type != ES_SET_HASH,
+		owned);
+	if (ret) {
+		if (owned)
+			free(ids);
+		return ret;
+	}
+	_es_set_replace(dst, &tmp);
+	return ES_SUCCESS;
+}
+
+/*
+ * _es_set_bitmap_op internal helper function running a word kernel over
+ * two bitmaps into @nwords words, words of the longer one past the end
+ * of the shorter are copied
+ */
+static int _es_set_bitmap_op(struct es_set *dst, struct es_set *a,
+		struct es_set *b, void (*op)(uint64_t *, const uint64_t *,
+			const uint64_t *, unsigned int), unsigned int nwords)
+{
+	unsigned int n = min(a->bitmap.nwords, b->bitmap.nwords);
+	struct es_set tmp;
+	uint64_t *words;
+
+	words = calloc(max(nwords, 1U), sizeof(*words));
+	if (!words)
+		return ES_FAIL;
+
+	op(words, a->bitmap.words, b->bitmap.words, min(n, nwords));
+	if (nwords > n)
+		memcpy(words + n, a->bitmap.nwords > n ?
+			a->bitmap.words + n : b->bitmap.words + n,
+			(nwords - n) * sizeof(*words));
+
+	es_set_init(&tmp);
+	tmp.type = ES_SET_BITMAP;
+	tmp.bitmap.words = words;
+	tmp.bitmap.nwords = nwords;
+	tmp.count = __es_set_popcount(words, nwords);
+	_es_set_replace(dst, &tmp);
+	_es_set_tune(dst);
+	return ES_SUCCESS;
+}
+
+/*
+ * _es_set_array_op internal helper function running an array kernel
+ * over the sorted ids of @a and @b
+ */
+static int _es_set_array_op(struct es_set *dst, struct es_set *a,
+		struct es_set *b, int op)
+{
+	uint32_t *ida, *idb, *out = NULL;
+	bool owna, ownb;
+	struct es_set tmp;
+	unsigned int n;
+	int ret = ES_FAIL;
+
+	ida = _es_set_ids(a, &owna, es_true);
+	idb = _es_set_ids(b, &ownb, es_true);
+	if ((!ida && a->count) || (!idb && b->count))
+		goto out;
+
+	if (op == '|')
+		n = a->count + b->count;
+	else
+		n = op == '&' ? min(a->count, b->count) : a->count;
+	out = malloc((size_t)max(n, 1U) * sizeof(*out));
+	if (!out)
+		goto out;
+
+	if (op == '|')
+		n = _es_set_array_merge(out, ida, a->count, idb, b->count);
+	else if (op == '&' && a->count > b->count)
+		n = _es_set_array_match(out, idb, b->count, ida, a->count,
+				es_false);
+	else
+		n = _es_set_array_match(out, ida, a->count, idb, b->count,
+				op == '-');
+
+	ret = _es_set_build(&tmp, out, n, es_true, es_true);
+	if (ret)
+		goto out;
+	out = NULL;
+	_es_set_replace(dst, &tmp);
+out:
+	free(out);
+	if (owna)
+		free(ida);
+	if (ownb)
+		free(idb);
+	return ret;
+}
+
+/*
+ * _es_set_filter internal helper function for the ids of @a which are
+ * (@keep true) or are not in @b, without listing the ids of @b
+ */
+static int _es_set_filter(struct es_set *dst, struct es_set *a,
+		struct es_set *b, bool keep)
+{
+	uint32_t *ids, *out;
+	struct es_set tmp;
+	unsigned int i, n = 0;
+	bool owned;
+	int ret;
+
+	ids = _es_set_ids(a, &owned, es_false);
+	if (!ids)
+		return ES_FAIL;
+	out = malloc((size_t)max(a->count, 1U) * sizeof(*out));
+	if (!out) {
+		if (owned)
+			free(ids);
+		return ES_FAIL;
+	}
+
+	for (i = 0; i < a->count; i++) {
+		if (es_set_contains(b, ids[i]) == keep)
+			out[n++] = ids[i];
+	}
+	if (owned)
+		free(ids);
+
+	ret = _es_set_build(&tmp, out, n, a->type != ES_SET_HASH, es_true);
+	if (ret) {
+		free(out);
+		return ret;
+	}
+	_es_set_replace(dst, &tmp);
+	return ES_SUCCESS;
+}
+
+static int _es_set_add_fn(uint32_t id, void *arg)
+{
+	return es_set_add(arg, id);
+}
+
+/**
+ * es_set_union - ids in @a or in @b
+ * @dst: an initialized set for the result, may be @a or @b
+ * @a: the first set
+ * @b: the second set
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_set_union(struct es_set *dst, struct es_set *a, struct es_set *b)
+{
+	struct es_set tmp, *big = a, *small = b;
+	int ret;
+
+	if (a->type == ES_SET_BITMAP && b->type == ES_SET_BITMAP)
+		return _es_set_bitmap_op(dst, a, b, __es_set_words_or,
+			max(a->bitmap.nwords, b->bitmap.nwords));
+	if (a->type == ES_SET_ARRAY && b->type == ES_SET_ARRAY)
+		return _es_set_array_op(dst, a, b, '|');
+
+	/* a bitmap or a hash takes the ids of the other cheaply */
+	if (b->type == ES_SET_BITMAP ||
+		(b->type == ES_SET_HASH && a->type == ES_SET_ARRAY)) {
+		big = b;
+		small = a;
+	}
+	es_set_init(&tmp);
+	ret = es_set_copy(&tmp, big);
+	/* grow the hash once, not while adding */
+	if (!ret && tmp.type == ES_SET_HASH)
+		ret = es_hmap_reserve(&tmp.hash.map, tmp.count + small->count);
+	if (!ret)
+		ret = es_set_for_each(small, _es_set_add_fn, &tmp);
+	if (ret) {
+		es_set_destroy(&tmp);
+		return ret;
+	}
+	_es_set_replace(dst, &tmp);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_set_intersect - ids in both @a and @b
+ * @dst: an initialized set for the result, may be @a or @b
+ * @a: the first set
+ * @b: the second set
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_set_intersect(struct es_set *dst, struct es_set *a, struct es_set *b)
+{
+	if (!a->count || !b->count) {
+		es_set_clear(dst);
+		return ES_SUCCESS;
+	}
+	if (a->type == ES_SET_BITMAP && b->type == ES_SET_BITMAP)
+		return _es_set_bitmap_op(dst, a, b, __es_set_words_and,
+			min(a->bitmap.nwords, b->bitmap.nwords));
+	if (a->type == ES_SET_ARRAY && b->type == ES_SET_ARRAY)
+		return _es_set_array_op(dst, a, b, '&');
+
+	/* list the smaller one, look its ids up in the other */
+	if (a->count <= b->count)
+		return _es_set_filter(dst, a, b, es_true);
+	return _es_set_filter(dst, b, a, es_true);
+}
+
+/**
+ * es_set_diff - ids in @a but not in @b
+ * @dst: an initialized set for the result, may be @a or @b
+ * @a: the first set
+ * @b: the second set
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_set_diff(struct es_set *dst, struct es_set *a, struct es_set *b)
+{
+	if (!a->count || !b->count)
+		return es_set_copy(dst, a);
+	if (a->type == ES_SET_BITMAP && b->type == ES_SET_BITMAP)
+		return _es_set_bitmap_op(dst, a, b, __es_set_words_andnot,
+			a->bitmap.nwords);
+	if (a->type == ES_SET_ARRAY && b->type == ES_SET_ARRAY)
+		return _es_set_array_op(dst, a, b, '-');
+	return _es_set_filter(dst, a, b, es_false);
+}
+
+/**
+ * es_set_to_array - copy the ids out of the set
+ * @set: the set to be used.
+ * @ids: where the ids must be copied
+ * @n: the number of ids @ids can hold
+ *
+ * The ids come in ascending order, the @n smallest if the set holds
+ * more. Returns the number of ids copied.
+ */
+unsigned int es_set_to_array(struct es_set *set, uint32_t *ids,
+				unsigned int n)
+{
+	uint32_t *all;
+	bool owned;
+
+	n = min(n, set->count);
+	if (!n)
+		return 0;
+
+	all = _es_set_ids(set, &owned, es_true);
+	if (!all)
+		return 0;
+	memcpy(ids, all, (size_t)n * sizeof(*ids));
+	if (owned)
+		free(all);
+	return n;
+}
+
+/**
+ * es_set_for_each - call a function for every id of the set
+ * @set: the set to be used.
+ * @fn: the function, a nonzero return ends the walk
+ * @arg: passed to @fn
+ *
+ * Array and bitmap sets are walked in ascending order, hash sets in no
+ * particular one. The set must not be changed from @fn.
+ * Returns the nonzero value of @fn, otherwise 0.
+ */
+int es_set_for_each(struct es_set *set, es_set_fn fn, void *arg)
+{
+	struct es_hmap_iter iter;
+	void *key, *value;
+	unsigned int i;
+	uint64_t w;
+	int ret;
+
+	switch (set->type) {
+	case ES_SET_ARRAY:
+		for (i = 0; i < set->count; i++) {
+			ret = fn(set->array.ids[i], arg);
+			if (ret)
+				return ret;
+		}
+		break;
+	case ES_SET_BITMAP:
+		for (i = 0; i < set->bitmap.nwords; i++) {
+			for (w = set->bitmap.words[i]; w; w &= w - 1) {
+				ret = fn(i * ES_SET_BITS + __builtin_ctzll(w),
+					arg);
+				if (ret)
+					return ret;
+			}
+		}
+		break;
+	case ES_SET_HASH:
+		es_hmap_iter_init(&iter);
+		while (es_hmap_iter_next(&set->hash.map, &iter, &key, &value)) {
+			ret = fn(*(uint32_t *)key, arg);
+			if (ret)
+				return ret;
+		}
+		break;
+	}
+	return ES_SUCCESS;
+}
+
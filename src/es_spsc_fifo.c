@@ -0,0 +1,193 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_spsc_fifo.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_spsc_fifo.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * es_spsc_fifo_init - initialize a SPSC FIFO using a preallocated buffer
+ * @fifo: the fifo to assign the buffer
+ * @buffer: the preallocated buffer to be used.
+ * @size: the size of the internal buffer, this has to be a power of 2.
+ *
+ * Return 0 if no error, otherwise ES_INVALID_PARAM
+ */
+int es_spsc_fifo_init(struct es_spsc_fifo *fifo, void *buffer,
+			unsigned int size)
+{
+	if (!buffer || !es_is_power_of_2(size))
+		return ES_INVALID_PARAM;
+
+	fifo->buffer = buffer;
+	fifo->mask = size - 1;
+	es_spsc_fifo_reset(fifo);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_spsc_fifo_alloc - allocates a new SPSC FIFO internal buffer
+ * @fifo: the fifo to assign then new buffer
+ * @size: the size of the buffer to be allocated.
+ *
+ * The size will be rounded-up to a power of 2.
+ * The buffer will be release with es_spsc_fifo_free().
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_spsc_fifo_alloc(struct es_spsc_fifo *fifo, unsigned int size)
+{
+	void *buffer;
+
+	if (size < 2)
+		return ES_INVALID_PARAM;
+
+	size = es_roundup_pow_of_two(size);
+	if (posix_memalign(&buffer, ES_CACHELINE_SIZE, size))
+		return ES_FAIL;
+
+	return es_spsc_fifo_init(fifo, buffer, size);
+}
+
+/**
+ * es_spsc_fifo_free - frees the SPSC FIFO internal buffer
+ * @fifo: the fifo to be freed.
+ */
+void es_spsc_fifo_free(struct es_spsc_fifo *fifo)
+{
+	free(fifo->buffer);
+	fifo->buffer = NULL;
+	fifo->mask = 0;
+	es_spsc_fifo_reset(fifo);
+}
+
+static inline void __es_spsc_copy_in(struct es_spsc_fifo *fifo,
+		const void *from, unsigned int len, unsigned int in)
+{
+	unsigned int off = in & fifo->mask;
+	unsigned int l = min(len, fifo->mask + 1 - off);
+
+	memcpy(fifo->buffer + off, from, l);
+	memcpy(fifo->buffer, from + l, len - l);
+}
+
+static inline void __es_spsc_copy_out(struct es_spsc_fifo *fifo,
+		void *to, unsigned int len, unsigned int out)
+{
+	unsigned int off = out & fifo->mask;
+	unsigned int l = min(len, fifo->mask + 1 - off);
+
+	memcpy(to, fifo->buffer + off, l);
+	memcpy(to + l, fifo->buffer, len - l);
+}
+
+/**
+ * es_spsc_fifo_in - puts some data into the FIFO, producer side
+ * @fifo: the fifo to be used.
+ * @from: the data to be added.
+ * @len: the length of the data to be added.
+ *
+ * This function copies at most @len bytes from the @from buffer into
+ * the FIFO depending on the free space, and returns the number of
+ * bytes copied.
+ */
+unsigned int es_spsc_fifo_in(struct es_spsc_fifo *fifo, const void *from,
+				unsigned int len)
+{
+	unsigned int in = fifo->in;
+	unsigned int size = fifo->mask + 1;
+	unsigned int avail;
+
+	avail = size - (in - fifo->out_cache);
+	if (avail < len) {
+		/*
+		 * pairs with the release in es_spsc_fifo_out(): the consumer
+		 * is done reading the bytes up to out before we overwrite them
+		 */
+		fifo->out_cache = es_smp_load_acquire(&fifo->out);
+		avail = size - (in - fifo->out_cache);
+		len = min(avail, len);
+	}
+
+	if (!len)
+		return 0;
+
+	__es_spsc_copy_in(fifo, from, len, in);
+	/* publish the data before the new index */
+	es_smp_store_release(&fifo->in, in + len);
+	return len;
+}
+
+/**
+ * es_spsc_fifo_out - gets some data from the FIFO, consumer side
+ * @fifo: the fifo to be used.
+ * @to: where the data must be copied.
+ * @len: the size of the destination buffer.
+ *
+ * This function copies at most @len bytes from the FIFO into the
+ * @to buffer and returns the number of copied bytes.
+ */
+unsigned int es_spsc_fifo_out(struct es_spsc_fifo *fifo, void *to,
+				unsigned int len)
+{
+	unsigned int out = fifo->out;
+	unsigned int used;
+
+	used = fifo->in_cache - out;
+	if (used < len) {
+		/* pairs with the release in es_spsc_fifo_in() */
+		fifo->in_cache = es_smp_load_acquire(&fifo->in);
+		used = fifo->in_cache - out;
+		len = min(used, len);
+	}
+
+	if (!len)
+		return 0;
+
+	__es_spsc_copy_out(fifo, to, len, out);
+	/* finish reading the data before handing the space back */
+	es_smp_store_release(&fifo->out, out + len);
+	return len;
+}
+
+/**
+ * es_spsc_fifo_out_peek - copy some data from the FIFO, but do not remove it
+ * @fifo: the fifo to be used.
+ * @to: where the data must be copied.
+ * @len: the size of the destination buffer.
+ *
+ * Consumer side only. Returns the number of copied bytes.
+ */
+unsigned int es_spsc_fifo_out_peek(struct es_spsc_fifo *fifo, void *to,
+				unsigned int len)
+{
+	unsigned int out = fifo->out;
+	unsigned int used;
+
+	used = fifo->in_cache - out;
+	if (used < len) {
+		fifo->in_cache = es_smp_load_acquire(&fifo->in);
+		used = fifo->in_cache - out;
+		len = min(used, len);
+	}
+
+	__es_spsc_copy_out(fifo, to, len, out);
+	return len;
+}
+
@@ -0,0 +1,327 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_timer.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_timer.h>
+
+/* index of a tick in level @n above tv1 */
+#define ES_TVN_INDEX(t, n) \
+	(((t) >> (ES_TVR_BITS + (n) * ES_TVN_BITS)) & ES_TVN_MASK)
+
+/* the farthest a timer is placed ahead, later ones are cascaded again */
+#define ES_TIMER_MAX_IDX	0xffffffffULL
+
+/*
+ * _es_timer_enqueue internal helper function for putting @timer into the
+ * bucket its expiry falls in, relative to the next tick of @wheel
+ */
+static void _es_timer_enqueue(struct es_timer_wheel *wheel,
+			struct es_timer *timer)
+{
+	uint64_t expires = timer->expires;
+	uint64_t idx = expires - wheel->now;
+	unsigned int i, lvl;
+
+	if ((int64_t)idx < 0) {
+		/* already due, expire it with the next tick */
+		expires = wheel->now;
+		idx = 0;
+	}
+
+	if (idx < ES_TVR_SIZE) {
+		i = expires & ES_TVR_MASK;
+		es_list_add_tail(&timer->entry, &wheel->tv1[i]);
+		wheel->tv1_map[i / 64] |= 1ULL << (i % 64);
+		return;
+	}
+
+	if (idx > ES_TIMER_MAX_IDX)
+		expires = wheel->now + ES_TIMER_MAX_IDX;
+	for (lvl = 0; lvl < ES_TVN_LEVELS - 1; lvl++)
+		if (idx < 1ULL << (ES_TVR_BITS + (lvl + 1) * ES_TVN_BITS))
+			break;
+
+	i = ES_TVN_INDEX(expires, lvl);
+	es_list_add_tail(&timer->entry, &wheel->tvn[lvl][i]);
+	wheel->tvn_map[lvl] |= 1ULL << i;
+}
+
+/*
+ * _es_timer_cascade internal helper function for breaking up the buckets
+ * of the upper levels which come due as tv1 starts a new turn
+ */
+static void _es_timer_cascade(struct es_timer_wheel *wheel)
+{
+	struct es_timer *timer, *tmp;
+	unsigned int lvl, i;
+	ES_LIST_HEAD(tv);
+
+	for (lvl = 0; lvl < ES_TVN_LEVELS; lvl++) {
+		i = ES_TVN_INDEX(wheel->now, lvl);
+		if (wheel->tvn_map[lvl] & (1ULL << i)) {
+			wheel->tvn_map[lvl] &= ~(1ULL << i);
+			es_list_splice_init(&wheel->tvn[lvl][i], &tv);
+			es_list_for_each_entry_safe(timer, tmp, &tv, entry)
+				_es_timer_enqueue(wheel, timer);
+			/* each one went to another bucket, tv is garbage now */
+			INIT_ES_LIST_HEAD(&tv);
+		}
+		/* the level above only turns when this one wraps */
+		if (i)
+			break;
+	}
+}
+
+/*
+ * _es_timer_next_slot internal helper function for finding the first
+ * occupied tv1 slot at or after @index, ES_TVR_SIZE if none
+ */
+static unsigned int _es_timer_next_slot(struct es_timer_wheel *wheel,
+			unsigned int index)
+{
+	unsigned int w = index / 64;
+	uint64_t bits = wheel->tv1_map[w] & (~0ULL << (index % 64));
+
+	for (;;) {
+		if (bits)
+			return w * 64 + __builtin_ctzll(bits);
+		if (++w == ES_TVR_SIZE / 64)
+			return ES_TVR_SIZE;
+		bits = wheel->tv1_map[w];
+	}
+}
+
+/*
+ * _es_timer_tv1_empty internal helper function for checking that no tv1
+ * bucket may hold a timer
+ */
+static bool _es_timer_tv1_empty(struct es_timer_wheel *wheel)
+{
+	uint64_t any = 0;
+	unsigned int i;
+
+	for (i = 0; i < ES_TVR_SIZE / 64; i++)
+		any |= wheel->tv1_map[i];
+	return !any;
+}
+
+/*
+ * _es_timer_next_cascade internal helper function for finding the first
+ * tick past the current one at which an occupied bucket of the upper
+ * levels may cascade, UINT64_MAX if they are all empty
+ */
+static uint64_t _es_timer_next_cascade(struct es_timer_wheel *wheel)
+{
+	unsigned int lvl, shift, cur;
+	uint64_t bits, turn;
+
+	for (lvl = 0; lvl < ES_TVN_LEVELS; lvl++) {
+		if (!wheel->tvn_map[lvl])
+			continue;
+		shift = ES_TVR_BITS + lvl * ES_TVN_BITS;
+		cur = ES_TVN_INDEX(wheel->now, lvl);
+		turn = wheel->now >> (shift + ES_TVN_BITS) << (shift + ES_TVN_BITS);
+		/* later in this turn of the level */
+		bits = wheel->tvn_map[lvl] & (~1ULL << cur);
+		if (bits)
+			return turn + ((uint64_t)__builtin_ctzll(bits) << shift);
+		/* in the next turn, after the level above cascades */
+		return turn + (1ULL << (shift + ES_TVN_BITS));
+	}
+	return UINT64_MAX;
+}
+
+/**
+ * es_timer_wheel_init - initialize a timing wheel
+ * @wheel: the wheel to be initialized
+ * @now: the current tick
+ */
+void es_timer_wheel_init(struct es_timer_wheel *wheel, uint64_t now)
+{
+	unsigned int i, lvl;
+
+	wheel->now = now;
+	for (i = 0; i < ES_TVR_SIZE / 64; i++)
+		wheel->tv1_map[i] = 0;
+	for (i = 0; i < ES_TVR_SIZE; i++)
+		INIT_ES_LIST_HEAD(&wheel->tv1[i]);
+	for (lvl = 0; lvl < ES_TVN_LEVELS; lvl++) {
+		wheel->tvn_map[lvl] = 0;
+		for (i = 0; i < ES_TVN_SIZE; i++)
+			INIT_ES_LIST_HEAD(&wheel->tvn[lvl][i]);
+	}
+}
+
+/**
+ * es_timer_add - arm a timer
+ * @wheel: the wheel to be used.
+ * @timer: the timer, set up with es_timer_setup() and not pending
+ * @expires: the tick to expire at
+ *
+ * A timer already due expires with the next tick the wheel processes.
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_timer_add(struct es_timer_wheel *wheel, struct es_timer *timer,
+			uint64_t expires)
+{
+	if (es_timer_pending(timer))
+		return ES_FAIL;
+
+	timer->expires = expires;
+	_es_timer_enqueue(wheel, timer);
+	return ES_SUCCESS;
+}
+
+/**
+ * es_timer_mod - modify the expiry of a timer
+ * @wheel: the wheel to be used.
+ * @timer: the timer, pending or not
+ * @expires: the new tick to expire at
+ *
+ * Equivalent to es_timer_del() followed by es_timer_add(), O(1).
+ * May be called from the expiry callbacks to re-arm a timer.
+ * Return 1 if the timer was pending, 0 otherwise.
+ */
+int es_timer_mod(struct es_timer_wheel *wheel, struct es_timer *timer,
+			uint64_t expires)
+{
+	int ret = es_timer_del(timer);
+
+	timer->expires = expires;
+	_es_timer_enqueue(wheel, timer);
+	return ret;
+}
+
+/**
+ * es_timer_wheel_advance - expire all timers due up to a tick
+ * @wheel: the wheel to be used.
+ * @now: the current tick, all timers expiring at or before it are due
+ * @fn: gets the expired timers of a tick as one list
+ * @arg: passed to @fn
+ *
+ * @fn is called once per tick with expired timers, in tick order. It may
+ * take timers off the list, re-arm them with es_timer_mod() or add and
+ * cancel other timers. Timers it leaves on the list are detached
+ * afterwards, they are not pending any more.
+ */
+void es_timer_wheel_advance(struct es_timer_wheel *wheel, uint64_t now,
+			es_timer_batch_fn_t fn, void *arg)
+{
+	unsigned int index, next;
+	uint64_t target;
+	ES_LIST_HEAD(batch);
+
+	while (wheel->now <= now) {
+		index = wheel->now & ES_TVR_MASK;
+		if (!index)
+			_es_timer_cascade(wheel);
+
+		next = _es_timer_next_slot(wheel, index);
+		if (next != index) {
+			/*
+			 * nothing due, jump to the next slot, to the next turn
+			 * or, with tv1 empty, to the next cascade
+			 */
+			if (next < ES_TVR_SIZE || !_es_timer_tv1_empty(wheel))
+				target = wheel->now + (next - index);
+			else
+				target = _es_timer_next_cascade(wheel);
+			if (target > now) {
+				wheel->now = now + 1;
+				break;
+			}
+			wheel->now = target;
+			continue;
+		}
+
+		wheel->tv1_map[index / 64] &= ~(1ULL << (index % 64));
+		es_list_splice_init(&wheel->tv1[index], &batch);
+		wheel->now++;
+		if (es_list_empty(&batch))
+			continue;
+
+		fn(&batch, arg);
+		while (!es_list_empty(&batch))
+			es_list_del_init(batch.next);
+	}
+}
+
+/*
+ * _es_timer_run_batch internal helper function for calling the function
+ * of each expired timer
+ */
+static void _es_timer_run_batch(struct es_list_head *expired, void *arg)
+{
+	unsigned long *count = arg;
+	struct es_timer *timer;
+
+	while (!es_list_empty(expired)) {
+		timer = es_list_first_entry(expired, struct es_timer, entry);
+		es_list_del_init(&timer->entry);
+		(*count)++;
+		if (timer->function)
+			timer->function(timer);
+	}
+}
+
+/**
+ * es_timer_wheel_run - expire all timers due up to a tick, one by one
+ * @wheel: the wheel to be used.
+ * @now: the current tick
+ *
+ * Calls the ->function of each expired timer, which is no longer pending
+ * by then and may be re-armed. Return the number of expired timers.
+ */
+unsigned long es_timer_wheel_run(struct es_timer_wheel *wheel, uint64_t now)
+{
+	unsigned long count = 0;
+
+	es_timer_wheel_advance(wheel, now, _es_timer_run_batch, &count);
+	return count;
+}
+
+/**
+ * es_timer_wheel_next - when is the wheel due next?
+ * @wheel: the wheel to be used.
+ *
+ * Exact for timers expiring in the current turn of tv1, otherwise a lower
+ * bound: the next turn or cascade, which may bring timers in. An event loop can
+ * sleep until then and advance. Return UINT64_MAX if no timer is pending.
+ */
+uint64_t es_timer_wheel_next(struct es_timer_wheel *wheel)
+{
+	unsigned int index = wheel->now & ES_TVR_MASK;
+	unsigned int next, lvl, i;
+
+	/* a cascade is pending for this very tick */
+	if (!index)
+		for (lvl = 0; lvl < ES_TVN_LEVELS; lvl++) {
+			i = ES_TVN_INDEX(wheel->now, lvl);
+			if (wheel->tvn_map[lvl] & (1ULL << i))
+				return wheel->now;
+			if (i)
+				break;
+		}
+
+	next = _es_timer_next_slot(wheel, index);
+	if (next < ES_TVR_SIZE || !_es_timer_tv1_empty(wheel))
+		return wheel->now + (next - index);
+	return _es_timer_next_cascade(wheel);
+}
+
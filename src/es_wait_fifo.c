@@ -0,0 +1,368 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_wait_fifo.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_wait_fifo.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_futex)
+#define ES_WAIT_FIFO_HAVE_FUTEX
+#endif
+
+/*
+ * _es_futex_wait internal helper function for sleeping while *@uaddr
+ * still holds @val, at most @rel (NULL means forever)
+ */
+static void _es_futex_wait(unsigned int *uaddr, unsigned int val,
+		const struct timespec *rel)
+{
+#ifdef ES_WAIT_FIFO_HAVE_FUTEX
+	syscall(SYS_futex, uaddr, FUTEX_WAIT_PRIVATE, val, rel, NULL, 0);
+#else
+	/* no futex: take a short nap and let the caller re-check */
+	struct timespec nap = {0, 1000000};
+
+	if (rel && rel->tv_sec == 0 && rel->tv_nsec < nap.tv_nsec)
+		nap = *rel;
+	nanosleep(&nap, NULL);
+#endif
+}
+
+static void _es_futex_wake(unsigned int *uaddr)
+{
+#ifdef ES_WAIT_FIFO_HAVE_FUTEX
+	syscall(SYS_futex, uaddr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+static void _es_deadline(struct timespec *deadline, int timeout_ms)
+{
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeout_ms / 1000;
+	deadline->tv_nsec += (timeout_ms % 1000) * 1000000L;
+	if (deadline->tv_nsec >= 1000000000L) {
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
+
+/*
+ * _es_remaining internal helper function for the time left until
+ * @deadline, returns false once it has passed
+ */
+static bool _es_remaining(const struct timespec *deadline,
+		struct timespec *rel)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	rel->tv_sec = deadline->tv_sec - now.tv_sec;
+	rel->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+	if (rel->tv_nsec < 0) {
+		rel->tv_sec--;
+		rel->tv_nsec += 1000000000L;
+	}
+	return rel->tv_sec >= 0 && (rel->tv_sec > 0 || rel->tv_nsec > 0);
+}
+
+static inline bool __es_wait_fifo_ready(struct es_wait_fifo *wf,
+		bool for_data, unsigned int len)
+{
+	if (for_data)
+		return es_fifo_len(&wf->fifo) >= len;
+	return es_fifo_avail(&wf->fifo) >= len;
+}
+
+/*
+ * __es_wait_fifo_wait internal helper function for sleeping until @len
+ * bytes of data (@for_data) or space are there, or @deadline passed
+ * (NULL means forever)
+ */
+static int __es_wait_fifo_wait(struct es_wait_fifo *wf, bool for_data,
+		unsigned int len, const struct timespec *deadline)
+{
+	unsigned int *waiters = for_data ? &wf->rd_waiters : &wf->wr_waiters;
+	unsigned int *seqp = for_data ? &wf->rd_seq : &wf->wr_seq;
+	struct timespec rel;
+	unsigned int seq;
+	bool ready;
+
+	len = min(len, es_fifo_size(&wf->fifo));
+
+	for (;;) {
+		/*
+		 * announce ourselves -before- the last check, the waker
+		 * publishes its index -before- it looks at the counter, so
+		 * at least one of us sees the other
+		 */
+		es_atomic_fetch_add(waiters, 1);
+		seq = ES_READ_ONCE(*seqp);
+		es_smp_mb();
+
+		ready = __es_wait_fifo_ready(wf, for_data, len);
+		if (!ready) {
+			if (deadline && !_es_remaining(deadline, &rel)) {
+				es_atomic_fetch_sub(waiters, 1);
+				return ES_TIMEOUT;
+			}
+			_es_futex_wait(seqp, seq, deadline ? &rel : NULL);
+		}
+
+		es_atomic_fetch_sub(waiters, 1);
+		if (ready || __es_wait_fifo_ready(wf, for_data, len))
+			return ES_SUCCESS;
+	}
+}
+
+static inline void __es_wait_fifo_wake(unsigned int *waiters,
+		unsigned int *seqp)
+{
+	/* pairs with the barrier in __es_wait_fifo_wait() */
+	es_smp_mb();
+
+	if (ES_READ_ONCE(*waiters)) {
+		es_atomic_fetch_add(seqp, 1);
+		_es_futex_wake(seqp);
+	}
+}
+
+/**
+ * es_wait_fifo_init - initialize the wait layer of a fifo
+ * @wf: the fifo, wf->fifo must be allocated or initialized already
+ * @flags: ES_WAIT_FIFO_F_* flags
+ *
+ * Return 0 if no error, otherwise the an error code
+ */
+int es_wait_fifo_init(struct es_wait_fifo *wf, unsigned int flags)
+{
+	wf->rd_waiters = wf->wr_waiters = 0;
+	wf->rd_seq = wf->wr_seq = 0;
+	wf->fd_armed = 0;
+	wf->efd = -1;
+
+	if (flags & ES_WAIT_FIFO_F_EVENTFD) {
+#ifdef __linux__
+		wf->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+		if (wf->efd < 0)
+			return ES_FAIL;
+	}
+	return ES_SUCCESS;
+}
+
+/**
+ * es_wait_fifo_exit - release the wait layer of a fifo
+ * @wf: the fifo to be used.
+ *
+ * The fifo itself is left alone, free it with es_fifo_free().
+ */
+void es_wait_fifo_exit(struct es_wait_fifo *wf)
+{
+	if (wf->efd >= 0)
+		close(wf->efd);
+	wf->efd = -1;
+}
+
+/**
+ * es_wait_fifo_wait_data - wait until some data is queued
+ * @wf: the fifo to be used.
+ * @len: the number of bytes to wait for
+ * @timeout_ms: 0 to only check, negative to wait forever
+ *
+ * Consumer side. Return ES_SUCCESS if at least @len bytes (or a full
+ * fifo for larger @len) are queued, ES_TIMEOUT otherwise.
+ */
+int es_wait_fifo_wait_data(struct es_wait_fifo *wf, unsigned int len,
+			int timeout_ms)
+{
+	struct timespec deadline;
+
+	len = min(len, es_fifo_size(&wf->fifo));
+	if (__es_wait_fifo_ready(wf, es_true, len))
+		return ES_SUCCESS;
+	if (timeout_ms == 0)
+		return ES_TIMEOUT;
+	if (timeout_ms < 0)
+		return __es_wait_fifo_wait(wf, es_true, len, NULL);
+
+	_es_deadline(&deadline, timeout_ms);
+	return __es_wait_fifo_wait(wf, es_true, len, &deadline);
+}
+
+/**
+ * es_wait_fifo_wait_space - wait until some space is free
+ * @wf: the fifo to be used.
+ * @len: the number of bytes to wait for
+ * @timeout_ms: 0 to only check, negative to wait forever
+ *
+ * Producer side. Return ES_SUCCESS if at least @len bytes (or an empty
+ * fifo for larger @len) are free, ES_TIMEOUT otherwise.
+ */
+int es_wait_fifo_wait_space(struct es_wait_fifo *wf, unsigned int len,
+			int timeout_ms)
+{
+	struct timespec deadline;
+
+	len = min(len, es_fifo_size(&wf->fifo));
+	if (__es_wait_fifo_ready(wf, es_false, len))
+		return ES_SUCCESS;
+	if (timeout_ms == 0)
+		return ES_TIMEOUT;
+	if (timeout_ms < 0)
+		return __es_wait_fifo_wait(wf, es_false, len, NULL);
+
+	_es_deadline(&deadline, timeout_ms);
+	return __es_wait_fifo_wait(wf, es_false, len, &deadline);
+}
+
+/**
+ * es_wait_fifo_wake_readers - wake consumers after publishing data
+ * @wf: the fifo to be used.
+ *
+ * es_fifo_in_wait() does this itself; call it after adding data by
+ * other means (es_fifo_in_rec(), es_fifo_commit_write(), ...). Costs
+ * one barrier unless a consumer sleeps or the eventfd is armed.
+ */
+void es_wait_fifo_wake_readers(struct es_wait_fifo *wf)
+{
+	uint64_t one = 1;
+
+	__es_wait_fifo_wake(&wf->rd_waiters, &wf->rd_seq);
+
+	if (wf->efd >= 0 && ES_READ_ONCE(wf->fd_armed) &&
+		es_xchg(&wf->fd_armed, 0)) {
+		if (write(wf->efd, &one, sizeof(one)) < 0)
+			ES_PRINTF("es_wait_fifo: eventfd write failed \n");
+	}
+}
+
+/**
+ * es_wait_fifo_wake_writers - wake producers after removing data
+ * @wf: the fifo to be used.
+ *
+ * es_fifo_out_wait() does this itself; call it after removing data by
+ * other means (es_fifo_out_rec(), es_fifo_release_read(), ...).
+ */
+void es_wait_fifo_wake_writers(struct es_wait_fifo *wf)
+{
+	__es_wait_fifo_wake(&wf->wr_waiters, &wf->wr_seq);
+}
+
+/**
+ * es_wait_fifo_arm_fd - ask for a notification on the eventfd
+ * @wf: the fifo to be used.
+ *
+ * Consumer side, call it when the fifo has been drained and before
+ * going back to poll()/epoll_wait(). The eventfd is reset and becomes
+ * readable once new data is published.
+ *
+ * Return 0 if armed, 1 if data is already queued (drain it and arm
+ * again), ES_FAIL if the fifo has no eventfd.
+ */
+int es_wait_fifo_arm_fd(struct es_wait_fifo *wf)
+{
+	uint64_t cnt;
+
+	if (wf->efd < 0)
+		return ES_FAIL;
+
+	/* reset the counter, the fd is non-blocking */
+	if (read(wf->efd, &cnt, sizeof(cnt)) < 0)
+		cnt = 0;
+
+	ES_WRITE_ONCE(wf->fd_armed, 1);
+	es_smp_mb();
+
+	if (!es_fifo_is_empty(&wf->fifo)) {
+		es_xchg(&wf->fd_armed, 0);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * es_fifo_in_wait - puts data into the FIFO, waiting for space
+ * @wf: the fifo to be used.
+ * @from: the data to be added.
+ * @len: the length of the data to be added.
+ * @timeout_ms: 0 to never block, negative to wait forever
+ *
+ * This function copies @len bytes from the @from buffer into the FIFO,
+ * sleeping while the FIFO is full, and returns the number of bytes
+ * copied, which is less than @len only on timeout.
+ */
+unsigned int es_fifo_in_wait(struct es_wait_fifo *wf, const void *from,
+				unsigned int len, int timeout_ms)
+{
+	struct timespec deadline;
+	unsigned int done = 0, n;
+
+	if (timeout_ms > 0)
+		_es_deadline(&deadline, timeout_ms);
+
+	for (;;) {
+		n = es_fifo_in(&wf->fifo, from + done, len - done);
+		if (n) {
+			done += n;
+			es_wait_fifo_wake_readers(wf);
+		}
+		if (done == len || timeout_ms == 0)
+			break;
+
+		if (__es_wait_fifo_wait(wf, es_false, 1,
+			timeout_ms > 0 ? &deadline : NULL))
+			break;
+	}
+	return done;
+}
+
+/**
+ * es_fifo_out_wait - gets data from the FIFO, waiting for some to arrive
+ * @wf: the fifo to be used.
+ * @to: where the data must be copied.
+ * @len: the size of the destination buffer.
+ * @timeout_ms: 0 to never block, negative to wait forever
+ *
+ * This function sleeps until the FIFO is not empty, then copies at most
+ * @len bytes into the @to buffer and returns the number of copied
+ * bytes, 0 on timeout.
+ */
+unsigned int es_fifo_out_wait(struct es_wait_fifo *wf, void *to,
+				unsigned int len, int timeout_ms)
+{
+	unsigned int n;
+
+	if (es_wait_fifo_wait_data(wf, 1, timeout_ms))
+		return 0;
+
+	n = es_fifo_out(&wf->fifo, to, len);
+	if (n)
+		es_wait_fifo_wake_writers(wf);
+	return n;
+}
+
@@ -0,0 +1,170 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_arena_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_arena.h>
+#include <es_fifo.h>
+#include <es_list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Per request scratch memory, es_arena against malloc()/free():
+ *  - a request builds a list of nodes of mixed sizes with a string
+ *    each, walks it and throws everything away again
+ *  - a request sets up a short lived fifo, pushes some data through it
+ *    and frees it
+ */
+
+#define BENCH_REQUESTS	20000
+#define BENCH_FIFOS	200000
+
+struct node {
+	struct es_list_head list;
+	char *name;
+	unsigned int len;
+	unsigned char data[];
+};
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long walk(struct es_list_head *head)
+{
+	struct node *n;
+	unsigned long sum = 0;
+
+	es_list_for_each_entry(n, head, list)
+		sum += n->len + n->data[0] + n->name[0];
+	return sum;
+}
+
+static double bench_list_malloc(unsigned int nodes, unsigned long *sum)
+{
+	struct node *n, *tmp;
+	double start = now();
+	unsigned int r, i;
+	char name[32];
+	ES_LIST_HEAD(head);
+
+	for (r = 0; r < BENCH_REQUESTS; r++) {
+		for (i = 0; i < nodes; i++) {
+			n = malloc(sizeof(*n) + 16 + (i & 63));
+			snprintf(name, sizeof(name), "node%u", i);
+			n->name = strdup(name);
+			n->len = 16 + (i & 63);
+			n->data[0] = i;
+			es_list_add_tail(&n->list, &head);
+		}
+		*sum += walk(&head);
+		es_list_for_each_entry_safe(n, tmp, &head, list) {
+			es_list_del(&n->list);
+			free(n->name);
+			free(n);
+		}
+	}
+	return (now() - start) * 1e9 / BENCH_REQUESTS;
+}
+
+static double bench_list_arena(unsigned int nodes, unsigned long *sum)
+{
+	struct es_arena arena;
+	struct node *n;
+	double start = now();
+	unsigned int r, i;
+	char name[32];
+	ES_LIST_HEAD(head);
+
+	es_arena_init(&arena, 0);
+	for (r = 0; r < BENCH_REQUESTS; r++) {
+		INIT_ES_LIST_HEAD(&head);
+		for (i = 0; i < nodes; i++) {
+			n = es_arena_alloc(&arena, sizeof(*n) + 16 + (i & 63));
+			snprintf(name, sizeof(name), "node%u", i);
+			n->name = es_arena_strdup(&arena, name);
+			n->len = 16 + (i & 63);
+			n->data[0] = i;
+			es_list_add_tail(&n->list, &head);
+		}
+		*sum += walk(&head);
+		es_arena_reset(&arena);
+	}
+	es_arena_destroy(&arena);
+	return (now() - start) * 1e9 / BENCH_REQUESTS;
+}
+
+static double bench_fifo(int use_arena, unsigned int size)
+{
+	struct es_arena arena;
+	struct es_fifo fifo;
+	unsigned char buf[256];
+	double start;
+	unsigned int i;
+
+	memset(buf, 0x5a, sizeof(buf));
+	es_arena_init(&arena, 0);
+	start = now();
+	for (i = 0; i < BENCH_FIFOS; i++) {
+		if (use_arena)
+			es_fifo_alloc_arena(&fifo, size, &arena);
+		else
+			es_fifo_alloc(&fifo, size);
+		es_fifo_in(&fifo, buf, sizeof(buf));
+		es_fifo_out(&fifo, buf, sizeof(buf));
+		es_fifo_free(&fifo);
+		if (use_arena)
+			es_arena_reset(&arena);
+	}
+	start = now() - start;
+	es_arena_destroy(&arena);
+	return start * 1e9 / BENCH_FIFOS;
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int nodes[] = {10, 100, 1000, 5000};
+	static const unsigned int sizes[] = {1024, 16384, 262144};
+	unsigned long sum = 0;
+	unsigned int i;
+
+	printf("list request ns \n");
+	printf("%8s %12s %12s \n", "nodes", "malloc", "es_arena");
+	for (i = 0; i < sizeof(nodes) / sizeof(nodes[0]); i++) {
+		printf("%8u %12.0f", nodes[i], bench_list_malloc(nodes[i], &sum));
+		printf(" %12.0f \n", bench_list_arena(nodes[i], &sum));
+	}
+
+	printf("\nshort lived fifo ns \n");
+	printf("%8s %12s %12s \n", "size", "malloc", "es_arena");
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+		printf("%8u %12.0f %12.0f \n", sizes[i], bench_fifo(0, sizes[i]),
+			bench_fifo(1, sizes[i]));
+
+	if (!sum)
+		printf("nothing walked \n");
+	return 0;
+}
+
@@ -0,0 +1,315 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_arena_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_arena.h>
+#include <es_fifo.h>
+#include <es_pool.h>
+#include <es_list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "es_test.h"
+
+#define TEST_BLOCK	4096
+#define TEST_NODES	10000
+
+struct node {
+	unsigned int id;
+	struct es_list_head list;
+};
+
+static int _test_basic(struct es_arena *arena)
+{
+	struct es_arena_stats st;
+	unsigned char *p, *q, *big;
+	unsigned int i, n;
+	char *s;
+
+	es_arena_get_stats(arena, &st);
+	TEST_CHECK(!st.blocks && !st.held && !st.used);
+
+	/* default alignment, distinct and writable */
+	p = es_arena_alloc(arena, 1);
+	q = es_arena_alloc(arena, 1);
+	TEST_CHECK(p && q && p != q);
+	TEST_CHECK(!((uintptr_t)p % ES_ARENA_ALIGN));
+	TEST_CHECK(!((uintptr_t)q % ES_ARENA_ALIGN));
+	*p = 1;
+	*q = 2;
+
+	for (i = 1; i <= 4096; i <<= 1) {
+		p = es_arena_alloc_aligned(arena, 3, i);
+		TEST_CHECK(p && !((uintptr_t)p % i));
+	}
+
+	/* zero sized allocations still differ */
+	p = es_arena_alloc(arena, 0);
+	q = es_arena_alloc(arena, 0);
+	TEST_CHECK(p && q && p != q);
+
+	s = es_arena_strdup(arena, "es_arena");
+	TEST_CHECK(s && !strcmp(s, "es_arena"));
+	p = es_arena_calloc(arena, 100, 7);
+	TEST_CHECK(p);
+	for (i = 0; i < 700; i++)
+		TEST_CHECK(!p[i]);
+	TEST_CHECK(!es_arena_calloc(arena, (size_t)-1 / 2, 4));
+
+	/*
+	 * chain one more normal block, it becomes a spare on reset; the
+	 * aligned ones above may or may not have needed a block of their
+	 * own, depending on where malloc() put the first one
+	 */
+	es_arena_get_stats(arena, &st);
+	n = st.blocks;
+	do {
+		TEST_CHECK(es_arena_alloc(arena, TEST_BLOCK / 8));
+		es_arena_get_stats(arena, &st);
+	} while (st.blocks == n);
+
+	/* large allocations get a block of their own and are freed */
+	big = es_arena_alloc(arena, 10 * TEST_BLOCK);
+	TEST_CHECK(big);
+	memset(big, 0xa5, 10 * TEST_BLOCK);
+	es_arena_get_stats(arena, &st);
+	TEST_CHECK(st.held >= 10 * TEST_BLOCK + TEST_BLOCK);
+	TEST_CHECK(st.used <= st.held && st.peak >= st.held);
+
+	es_arena_reset(arena);
+	es_arena_get_stats(arena, &st);
+	TEST_CHECK(st.blocks == 1 && !st.used && st.held == TEST_BLOCK);
+	TEST_CHECK(st.spares >= 1 && st.spare == st.spares * TEST_BLOCK);
+	p = es_arena_alloc(arena, 1);
+	es_arena_get_stats(arena, &st);
+	TEST_CHECK(p && st.blocks == 1 && st.used == 1);
+
+	es_arena_trim(arena);
+	es_arena_get_stats(arena, &st);
+	TEST_CHECK(!st.spares && !st.spare);
+
+	/* destroy frees the first block as well */
+	es_arena_destroy(arena);
+	es_arena_get_stats(arena, &st);
+	TEST_CHECK(!st.blocks && !st.held && !st.spares);
+
+	es_arena_destroy(arena);
+	return 0;
+}
+
+/* the arena is destroyed however the checks end */
+static int test_basic(void)
+{
+	struct es_arena arena;
+	int ret;
+
+	TEST_CHECK(!es_arena_init(&arena, TEST_BLOCK));
+	ret = _test_basic(&arena);
+	es_arena_destroy(&arena);
+	return ret;
+}
+
+static int test_mark(void)
+{
+	struct es_arena arena;
+	struct es_arena_mark outer, inner;
+	struct es_arena_stats st, st2;
+	unsigned int *a[64];
+	unsigned int i, j, *p;
+
+	TEST_CHECK(!es_arena_init(&arena, TEST_BLOCK));
+	p = es_arena_alloc(&arena, sizeof(*p));
+	TEST_CHECK(p);
+	*p = 0xdeadbeef;
+
+	es_arena_mark(&arena, &outer);
+	es_arena_get_stats(&arena, &st);
+
+	for (j = 0; j < 3; j++) {
+		/* several blocks worth, with a nested scope in the middle */
+		for (i = 0; i < 64; i++) {
+			if (i == 32)
+				es_arena_mark(&arena, &inner);
+			a[i] = es_arena_alloc(&arena, 300);
+			TEST_CHECK(a[i]);
+			memset(a[i], i, 300);
+		}
+		es_arena_rewind(&arena, &inner);
+		TEST_CHECK(es_arena_alloc(&arena, 300) == a[32]);
+		for (i = 0; i < 32; i++)
+			TEST_CHECK(((unsigned char *)a[i])[299] == i);
+
+		es_arena_rewind(&arena, &outer);
+		es_arena_get_stats(&arena, &st2);
+		TEST_CHECK(st2.used == st.used && st2.blocks == st.blocks);
+		TEST_CHECK(*p == 0xdeadbeef);
+	}
+
+	/* the spares settle, no growth over the rounds */
+	es_arena_get_stats(&arena, &st2);
+	TEST_CHECK(st2.spares * TEST_BLOCK + st2.held <= st2.peak);
+
+	es_arena_destroy(&arena);
+	return 0;
+}
+
+static int test_realloc(void)
+{
+	struct es_arena arena;
+	unsigned int *v = NULL, *first = NULL, *other;
+	unsigned int i;
+
+	TEST_CHECK(!es_arena_init(&arena, TEST_BLOCK));
+
+	/* the newest allocation grows in place while the block has room */
+	for (i = 0; i < 256; i++) {
+		v = es_arena_realloc(&arena, v, i * sizeof(*v),
+				(i + 1) * sizeof(*v));
+		TEST_CHECK(v);
+		if (!first)
+			first = v;
+		TEST_CHECK(v == first);
+		v[i] = i;
+	}
+
+	/* then it moves */
+	other = es_arena_alloc(&arena, 4);
+	TEST_CHECK(other);
+	for (i = 256; i < 4096; i++) {
+		v = es_arena_realloc(&arena, v, i * sizeof(*v),
+				(i + 1) * sizeof(*v));
+		TEST_CHECK(v);
+		v[i] = i;
+	}
+	TEST_CHECK(v != first);
+	for (i = 0; i < 4096; i++)
+		TEST_CHECK(v[i] == i);
+
+	/* shrinking keeps the data */
+	v = es_arena_realloc(&arena, v, 4096 * sizeof(*v), 10 * sizeof(*v));
+	for (i = 0; i < 10; i++)
+		TEST_CHECK(v[i] == i);
+
+	es_arena_destroy(&arena);
+	return 0;
+}
+
+static int test_list(void)
+{
+	struct es_arena arena;
+	struct es_arena_mark mark;
+	struct node *n;
+	unsigned int i, round;
+	ES_LIST_HEAD(head);
+
+	TEST_CHECK(!es_arena_init(&arena, 0));
+
+	for (round = 0; round < 10; round++) {
+		es_arena_mark(&arena, &mark);
+		INIT_ES_LIST_HEAD(&head);
+		for (i = 0; i < TEST_NODES; i++) {
+			n = es_arena_alloc(&arena, sizeof(*n));
+			TEST_CHECK(n);
+			n->id = i;
+			es_list_add_tail(&n->list, &head);
+		}
+		i = 0;
+		es_list_for_each_entry(n, &head, list)
+			TEST_CHECK(n->id == i++);
+		TEST_CHECK(i == TEST_NODES);
+		/* no es_list_del(), no free(), all at once */
+		es_arena_rewind(&arena, &mark);
+	}
+
+	es_arena_destroy(&arena);
+	return 0;
+}
+
+static int test_fifo(void)
+{
+	struct es_arena arena;
+	struct es_arena_stats st;
+	struct es_fifo fifo;
+	unsigned char in[1000], out[1000];
+	unsigned int i;
+
+	for (i = 0; i < sizeof(in); i++)
+		in[i] = i * 7;
+
+	TEST_CHECK(!es_arena_init(&arena, 0));
+	TEST_CHECK(es_fifo_alloc_arena(&fifo, 100, NULL) == ES_INVALID_PARAM);
+	TEST_CHECK(!es_fifo_alloc_arena(&fifo, 1000, &arena));
+	TEST_CHECK(es_fifo_size(&fifo) == 1024);
+	TEST_CHECK(!((uintptr_t)fifo.buffer % ES_CACHELINE_SIZE));
+
+	for (i = 0; i < 10; i++) {
+		TEST_CHECK(es_fifo_in(&fifo, in, sizeof(in)) == sizeof(in));
+		TEST_CHECK(es_fifo_out(&fifo, out, sizeof(out)) == sizeof(out));
+		TEST_CHECK(!memcmp(in, out, sizeof(in)));
+	}
+	es_arena_get_stats(&arena, &st);
+	TEST_CHECK(st.used >= 1024);
+
+	/* the buffer stays with the arena */
+	es_fifo_free(&fifo);
+	es_arena_destroy(&arena);
+	return 0;
+}
+
+static int test_pool(void)
+{
+	struct es_arena arena;
+	struct es_arena_stats st;
+	struct es_pool pool;
+	struct node *n[1000];
+	unsigned int i;
+
+	TEST_CHECK(!es_arena_init(&arena, 0));
+	TEST_CHECK(!es_pool_init(&pool, "arena", sizeof(struct node), 0,
+			NULL, NULL));
+	es_pool_set_arena(&pool, &arena);
+
+	for (i = 0; i < 1000; i++) {
+		n[i] = es_pool_alloc(&pool);
+		TEST_CHECK(n[i]);
+		n[i]->id = i;
+	}
+	for (i = 0; i < 1000; i++) {
+		TEST_CHECK(n[i]->id == i);
+		es_pool_free(&pool, n[i]);
+	}
+
+	es_arena_get_stats(&arena, &st);
+	TEST_CHECK(st.used >= pool.nr_slabs * pool.slab_size);
+
+	es_pool_destroy(&pool);
+	es_arena_destroy(&arena);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_basic() || test_mark() || test_realloc() || test_list() ||
+			test_fifo() || test_pool())
+		return 1;
+
+	printf("es_arena test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,148 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_rec_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_MSGS	(4 * 1024 * 1024)
+#define BENCH_FIFO_SIZE	(64 * 1024)
+#define BENCH_BATCH	16
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* fixed size messages as a plain byte stream */
+static double bench_raw(struct es_fifo *fifo, unsigned int msg)
+{
+	unsigned char buf[256] = {0};
+	unsigned int done = 0;
+	double start = now();
+
+	while (done < BENCH_MSGS) {
+		while (es_fifo_avail(fifo) >= msg)
+			es_fifo_in(fifo, buf, msg);
+		while (es_fifo_out(fifo, buf, msg) == msg)
+			done++;
+	}
+	return done / (now() - start) / 1e6;
+}
+
+static double bench_rec(struct es_fifo *fifo, unsigned int msg,
+			unsigned int recsize)
+{
+	unsigned char buf[256] = {0};
+	unsigned int done = 0, total;
+	double start = now();
+
+	while (done < BENCH_MSGS) {
+		while (es_fifo_in_rec(fifo, buf, msg, recsize) == 0)
+			;
+		while (!es_fifo_is_empty(fifo)) {
+			es_fifo_out_rec(fifo, buf, sizeof(buf), recsize, &total);
+			done++;
+		}
+	}
+	return done / (now() - start) / 1e6;
+}
+
+static double bench_recs(struct es_fifo *fifo, unsigned int msg,
+			unsigned int recsize)
+{
+	unsigned char buf[BENCH_BATCH][256] = {{0}};
+	struct iovec vec[BENCH_BATCH];
+	unsigned int done = 0, i, n;
+	double start = now();
+
+	while (done < BENCH_MSGS) {
+		do {
+			for (i = 0; i < BENCH_BATCH; i++) {
+				vec[i].iov_base = buf[i];
+				vec[i].iov_len = msg;
+			}
+		} while (es_fifo_in_recs(fifo, vec, BENCH_BATCH, recsize) ==
+				BENCH_BATCH);
+		do {
+			for (i = 0; i < BENCH_BATCH; i++) {
+				vec[i].iov_base = buf[i];
+				vec[i].iov_len = sizeof(buf[i]);
+			}
+			n = es_fifo_out_recs(fifo, vec, BENCH_BATCH, recsize);
+			done += n;
+		} while (n);
+	}
+	return done / (now() - start) / 1e6;
+}
+
+static int drain_cb(void *arg, const struct iovec *vec, unsigned int nvec)
+{
+	(*(unsigned int *)arg)++;
+	return 0;
+}
+
+static double bench_drain(struct es_fifo *fifo, unsigned int msg,
+			unsigned int recsize)
+{
+	unsigned char buf[256] = {0};
+	unsigned int done = 0;
+	double start = now();
+
+	while (done < BENCH_MSGS) {
+		while (es_fifo_in_rec(fifo, buf, msg, recsize) == 0)
+			;
+		es_fifo_drain_recs(fifo, recsize, ~0u, drain_cb, &done);
+	}
+	return done / (now() - start) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int msgs[] = {8, 32, 128, 255};
+	struct es_fifo fifo;
+	unsigned int i;
+
+	if (es_fifo_alloc(&fifo, BENCH_FIFO_SIZE))
+		return 1;
+
+	printf("%6s %10s %10s %10s %14s %16s \n", "msg", "raw Mm/s",
+		"rec1 Mm/s", "rec2 Mm/s", "rec2 x16 Mm/s", "rec2 drain Mm/s");
+	for (i = 0; i < sizeof(msgs) / sizeof(msgs[0]); i++) {
+		printf("%6u", msgs[i]);
+		es_fifo_reset(&fifo);
+		printf(" %10.2f", bench_raw(&fifo, msgs[i]));
+		es_fifo_reset(&fifo);
+		printf(" %10.2f", bench_rec(&fifo, msgs[i], 1));
+		es_fifo_reset(&fifo);
+		printf(" %10.2f", bench_rec(&fifo, msgs[i], 2));
+		es_fifo_reset(&fifo);
+		printf(" %14.2f", bench_recs(&fifo, msgs[i], 2));
+		es_fifo_reset(&fifo);
+		printf(" %16.2f \n", bench_drain(&fifo, msgs[i], 2));
+	}
+
+	es_fifo_free(&fifo);
+	return 0;
+}
+
@@ -0,0 +1,191 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_stats_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo_stats.h>
+#include <es_arena.h>
+#include <stdio.h>
+#include <string.h>
+#include "es_test.h"
+
+#ifdef ES_FIFO_STATS
+struct find_ctx {
+	struct es_fifo *fifo;
+	const char *name;
+	int found;
+};
+
+static int find_cb(struct es_fifo *fifo, const char *name,
+		const struct es_fifo_stats *st, void *arg)
+{
+	struct find_ctx *ctx = arg;
+
+	if (fifo != ctx->fifo)
+		return 0;
+	ctx->found++;
+	ctx->name = name;
+	return 0;
+}
+
+static int registered(struct es_fifo *fifo, const char *name)
+{
+	struct find_ctx ctx = { fifo, NULL, 0 };
+
+	es_fifo_stats_for_each(find_cb, &ctx);
+	if (ctx.found > 1 || (ctx.found && ctx.name != name))
+		return -1;
+	return ctx.found;
+}
+
+static int test_counters(void)
+{
+	struct es_fifo fifo;
+	struct es_fifo_stats st;
+	unsigned char buf[512];
+	struct iovec rec;
+
+	memset(buf, 0x11, sizeof(buf));
+	TEST_CHECK(es_fifo_alloc(&fifo, 256) == 0);
+
+	TEST_CHECK(es_fifo_out(&fifo, buf, 16) == 0);
+	TEST_CHECK(es_fifo_in(&fifo, buf, 3) == 3);
+	TEST_CHECK(es_fifo_in(&fifo, buf, 100) == 100);
+	TEST_CHECK(es_fifo_out(&fifo, buf, 50) == 50);
+	TEST_CHECK(es_fifo_in(&fifo, buf, 300) == 203);
+
+	es_fifo_stats_get(&fifo, &st);
+	TEST_CHECK(st.bytes_in == 306 && st.bytes_out == 50);
+	TEST_CHECK(st.short_writes == 1 && st.empty_reads == 1);
+	TEST_CHECK(st.peak == 256);
+	TEST_CHECK(st.hist_in[1] == 1 && st.hist_in[6] == 1 &&
+		st.hist_in[7] == 1);
+	TEST_CHECK(st.hist_out[5] == 1);
+
+	/* the record and batch paths are counted too */
+	es_fifo_reset(&fifo);
+	es_fifo_stats_reset(&fifo);
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf, 10, 1) == 0);
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf, 300, 1) > 300);
+	rec.iov_base = buf;
+	rec.iov_len = sizeof(buf);
+	TEST_CHECK(es_fifo_out_recs(&fifo, &rec, 1, 1) == 1);
+	TEST_CHECK(es_fifo_out_recs(&fifo, &rec, 1, 1) == 0);
+	es_fifo_stats_get(&fifo, &st);
+	TEST_CHECK(st.bytes_in == 11 && st.bytes_out == 11);
+	TEST_CHECK(st.short_writes == 1 && st.empty_reads == 1);
+
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+/* fifos in the registry, stops at 100 in case the links are broken */
+static int count_cb(struct es_fifo *fifo, const char *name,
+		const struct es_fifo_stats *st, void *arg)
+{
+	return ++*(int *)arg >= 100;
+}
+
+static int registry_count(void)
+{
+	int n = 0;
+
+	es_fifo_stats_for_each(count_cb, &n);
+	return n;
+}
+
+static int test_reinit(void)
+{
+	static unsigned char sbuf[64];
+	struct es_arena arena;
+	struct es_fifo a, b, c;
+	int n = registry_count();
+
+	TEST_CHECK(es_arena_init(&arena, 4096) == 0);
+	TEST_CHECK(es_fifo_alloc_arena(&a, 64, &arena) == 0);
+	TEST_CHECK(es_fifo_alloc_arena(&b, 64, &arena) == 0);
+	TEST_CHECK(es_fifo_init(&c, sbuf, sizeof(sbuf)) == 0);
+	TEST_CHECK(es_fifo_stats_register(&c, "static") == 0);
+	TEST_CHECK(registry_count() == n + 3);
+
+	/* a registered fifo initialized again is linked once */
+	TEST_CHECK(es_fifo_alloc_arena(&a, 128, &arena) == 0);
+	TEST_CHECK(registered(&a, NULL) == 1);
+	TEST_CHECK(registry_count() == n + 3);
+
+	/* and only while an alloc call registers it */
+	TEST_CHECK(es_fifo_init(&c, sbuf, sizeof(sbuf)) == 0);
+	TEST_CHECK(registered(&c, NULL) == 0);
+	TEST_CHECK(registry_count() == n + 2);
+
+	es_fifo_free(&b);
+	TEST_CHECK(registered(&a, NULL) == 1);
+	TEST_CHECK(registry_count() == n + 1);
+	es_fifo_free(&a);
+	TEST_CHECK(registry_count() == n);
+	es_arena_destroy(&arena);
+	return 0;
+}
+
+static int test_registry(void)
+{
+	static unsigned char sbuf[64];
+	struct es_fifo a, b, c;
+
+	TEST_CHECK(es_fifo_alloc(&a, 64) == 0);
+	TEST_CHECK(es_fifo_alloc(&b, 64) == 0);
+	TEST_CHECK(es_fifo_init(&c, sbuf, sizeof(sbuf)) == 0);
+
+	TEST_CHECK(registered(&a, NULL) == 1);
+	TEST_CHECK(registered(&b, NULL) == 1);
+	TEST_CHECK(registered(&c, NULL) == 0);
+
+	TEST_CHECK(es_fifo_stats_register(&c, "static") == 0);
+	TEST_CHECK(es_fifo_stats_register(&a, "rx") == 0);
+	TEST_CHECK(registered(&c, "static") == 1);
+	TEST_CHECK(registered(&a, "rx") == 1);
+
+	TEST_CHECK(es_fifo_in(&a, "hello", 5) == 5);
+	es_fifo_stats_dump(stdout);
+
+	es_fifo_free(&b);
+	es_fifo_stats_unregister(&c);
+	es_fifo_stats_unregister(&c);
+	TEST_CHECK(registered(&b, NULL) == 0);
+	TEST_CHECK(registered(&c, NULL) == 0);
+	TEST_CHECK(registered(&a, "rx") == 1);
+
+	es_fifo_free(&a);
+	TEST_CHECK(registered(&a, NULL) == 0);
+	return 0;
+}
+#endif
+
+int main(int argc, char **argv)
+{
+#ifdef ES_FIFO_STATS
+	if (test_counters() || test_registry() || test_reinit())
+		return 1;
+
+	printf("es_fifo_stats test OK! \n");
+#else
+	printf("es_fifo_stats test OK! (built without ES_FIFO_STATS) \n");
+#endif
+	return 0;
+}
+
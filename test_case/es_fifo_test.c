@@ -19,7 +19,567 @@
 * @comment           
 *******************************************************************************/
 #include <es_fifo.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "es_test.h"
+
+static int test_zero_copy(void)
+{
+	struct es_fifo src, dst;
+	struct iovec vec[2];
+	unsigned char buf[64];
+	unsigned int n, i, len;
+	int fds[2];
+
+	TEST_CHECK(es_fifo_alloc(&src, 64) == 0);
+	TEST_CHECK(es_fifo_alloc(&dst, 64) == 0);
+	TEST_CHECK(pipe(fds) == 0);
+
+	/* move the indices so the free space wraps around */
+	memset(buf, 0, sizeof(buf));
+	es_fifo_in(&src, buf, 40);
+	es_fifo_out(&src, buf, 40);
+
+	n = es_fifo_prepare_write(&src, vec, 100);
+	TEST_CHECK(n == 2);
+	TEST_CHECK(vec[0].iov_len == 24 && vec[1].iov_len == 40);
+	for (i = 0; i < vec[0].iov_len; i++)
+		((unsigned char *)vec[0].iov_base)[i] = i;
+	for (i = 0; i < vec[1].iov_len; i++)
+		((unsigned char *)vec[1].iov_base)[i] = vec[0].iov_len + i;
+	TEST_CHECK(es_fifo_is_empty(&src));
+	es_fifo_commit_write(&src, 64);
+	TEST_CHECK(es_fifo_is_full(&src));
+
+	/* src ring -> pipe -> dst ring without a bounce buffer */
+	n = es_fifo_peek_read(&src, vec, 64);
+	TEST_CHECK(n == 2);
+	TEST_CHECK(writev(fds[1], vec, n) == 64);
+	es_fifo_release_read(&src, 64);
+	TEST_CHECK(es_fifo_is_empty(&src));
+
+	n = es_fifo_prepare_write(&dst, vec, 64);
+	TEST_CHECK(n == 1);
+	TEST_CHECK(readv(fds[0], vec, n) == 64);
+	es_fifo_commit_write(&dst, 64);
+
+	len = es_fifo_out(&dst, buf, sizeof(buf));
+	TEST_CHECK(len == 64);
+	for (i = 0; i < len; i++)
+		TEST_CHECK(buf[i] == i);
+
+	TEST_CHECK(es_fifo_peek_read(&dst, vec, 64) == 0);
+
+	close(fds[0]);
+	close(fds[1]);
+	es_fifo_free(&src);
+	es_fifo_free(&dst);
+	return 0;
+}
+
+static int test_mirror(void)
+{
+	struct es_fifo fifo;
+	struct iovec vec[2];
+	unsigned char buf[256];
+	unsigned int i, size;
+
+	TEST_CHECK(es_fifo_alloc_mirror(&fifo, 100) == 0);
+	printf("mirror fifo: size %u, mirrored %d \n", es_fifo_size(&fifo),
+		es_fifo_is_mirrored(&fifo));
+	if (!es_fifo_is_mirrored(&fifo)) {
+		/* fell back to malloc, nothing more to check */
+		es_fifo_free(&fifo);
+		return 0;
+	}
+
+	size = es_fifo_size(&fifo);
+	TEST_CHECK(es_is_power_of_2(size) && size >= 100);
+
+	/* both views alias the same pages */
+	fifo.buffer[0] = 0x5a;
+	TEST_CHECK(fifo.buffer[size] == 0x5a);
+
+	/* park the indices right before the end of the buffer */
+	fifo.in = fifo.out = size - 100;
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i;
+	TEST_CHECK(es_fifo_in(&fifo, buf, sizeof(buf)) == sizeof(buf));
+
+	/* the wrapped region is handed out as one span */
+	TEST_CHECK(es_fifo_peek_read(&fifo, vec, sizeof(buf)) == 1);
+	TEST_CHECK(vec[0].iov_len == sizeof(buf));
+	TEST_CHECK(memcmp(vec[0].iov_base, buf, sizeof(buf)) == 0);
+	TEST_CHECK(fifo.buffer[0] == 100);
+
+	memset(buf, 0, sizeof(buf));
+	TEST_CHECK(es_fifo_out(&fifo, buf, sizeof(buf)) == sizeof(buf));
+	for (i = 0; i < sizeof(buf); i++)
+		TEST_CHECK(buf[i] == i);
+
+	es_fifo_free(&fifo);
+	TEST_CHECK(!es_fifo_initialized(&fifo));
+	return 0;
+}
+
+static int test_records(void)
+{
+	struct es_fifo fifo;
+	struct iovec recs[4];
+	unsigned char buf[300], out[4][300];
+	unsigned int total, i, recsize;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i;
+
+	for (recsize = 1; recsize <= 2; recsize++) {
+		TEST_CHECK(es_fifo_alloc(&fifo, 512) == 0);
+		TEST_CHECK(es_fifo_peek_rec(&fifo, recsize) == 0);
+		TEST_CHECK(es_fifo_out_rec(&fifo, out[0], 10, recsize, &total) == 0);
+		TEST_CHECK(total == 0);
+
+		TEST_CHECK(es_fifo_in_rec(&fifo, buf, 5, recsize) == 0);
+		TEST_CHECK(es_fifo_in_rec(&fifo, buf + 5, 0, recsize) == 0);
+		TEST_CHECK(es_fifo_in_rec(&fifo, buf, 7, recsize) == 0);
+		TEST_CHECK(es_fifo_len(&fifo) == 12 + 3 * recsize);
+
+		/* longer than a 1 byte header can describe */
+		if (recsize == 1)
+			TEST_CHECK(es_fifo_in_rec(&fifo, buf, 256, recsize) == 257);
+		/* larger than the free space */
+		TEST_CHECK(es_fifo_in_rec(&fifo, buf, es_fifo_avail(&fifo),
+			recsize) > es_fifo_avail(&fifo) - 1);
+
+		TEST_CHECK(es_fifo_peek_rec(&fifo, recsize) == 5);
+		/* too small a buffer leaves the record in place */
+		TEST_CHECK(es_fifo_out_rec(&fifo, out[0], 4, recsize, &total) == 5);
+		TEST_CHECK(total == 5);
+		TEST_CHECK(es_fifo_out_rec(&fifo, out[0], 10, recsize, &total) == 0);
+		TEST_CHECK(total == 5 && memcmp(out[0], buf, 5) == 0);
+
+		TEST_CHECK(es_fifo_out_rec(&fifo, out[0], 10, recsize, &total) == 0);
+		TEST_CHECK(total == 0 && !es_fifo_is_empty(&fifo));
+		es_fifo_skip_rec(&fifo, recsize);
+		TEST_CHECK(es_fifo_is_empty(&fifo));
+
+		/* batches straddling the end of the buffer */
+		for (i = 0; i < 4; i++) {
+			recs[i].iov_base = buf + i;
+			recs[i].iov_len = recsize == 1 ? 100 + i : 200 + i;
+		}
+		fifo.in = fifo.out = 500;
+		TEST_CHECK(es_fifo_in_recs(&fifo, recs, 4, recsize) ==
+			(recsize == 1 ? 4 : 2));
+
+		for (i = 0; i < 4; i++) {
+			recs[i].iov_base = out[i];
+			recs[i].iov_len = sizeof(out[i]);
+		}
+		recs[1].iov_len = 10;
+		TEST_CHECK(es_fifo_out_recs(&fifo, recs, 4, recsize) == 1);
+		for (i = 0; i < 3; i++) {
+			recs[i].iov_base = out[i + 1];
+			recs[i].iov_len = sizeof(out[i + 1]);
+		}
+		TEST_CHECK(es_fifo_out_recs(&fifo, recs, 4, recsize) ==
+			(recsize == 1 ? 3 : 1));
+		TEST_CHECK(es_fifo_is_empty(&fifo));
+		TEST_CHECK(memcmp(out[0], buf, recsize == 1 ? 100 : 200) == 0);
+		TEST_CHECK(memcmp(out[1], buf + 1, recsize == 1 ? 101 : 201) == 0);
+		if (recsize == 1)
+			TEST_CHECK(recs[2].iov_len == 103 &&
+				memcmp(out[3], buf + 3, 103) == 0);
+
+		es_fifo_free(&fifo);
+	}
+
+	/* a header of more than 2 bytes is refused, nothing is touched */
+	TEST_CHECK(es_fifo_alloc(&fifo, 512) == 0);
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf, 5, 1) == 0);
+	for (recsize = 3; recsize <= 8; recsize++) {
+		TEST_CHECK(es_fifo_in_rec(&fifo, buf, 5, recsize) ==
+			(unsigned int)ES_INVALID_PARAM);
+		TEST_CHECK(es_fifo_avail_rec(&fifo, recsize) == 0);
+		TEST_CHECK(es_fifo_peek_rec(&fifo, recsize) == 0);
+		total = 1;
+		TEST_CHECK(es_fifo_out_rec(&fifo, out[0], 10, recsize, &total) ==
+			(unsigned int)ES_INVALID_PARAM);
+		TEST_CHECK(total == 0);
+		es_fifo_skip_rec(&fifo, recsize);
+		TEST_CHECK(es_fifo_len(&fifo) == 6);
+	}
+	TEST_CHECK(es_fifo_out_rec(&fifo, out[0], 10, 1, &total) == 0);
+	TEST_CHECK(total == 5 && memcmp(out[0], buf, 5) == 0);
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+struct drain_ctx {
+	unsigned int count;
+	unsigned int bytes;
+	unsigned int stop_at;
+	unsigned char data[512];
+};
+
+static int drain_cb(void *arg, const struct iovec *vec, unsigned int nvec)
+{
+	struct drain_ctx *ctx = arg;
+	unsigned int i;
+
+	if (ctx->count == ctx->stop_at)
+		return 1;
+
+	for (i = 0; i < nvec; i++) {
+		memcpy(ctx->data + ctx->bytes, vec[i].iov_base, vec[i].iov_len);
+		ctx->bytes += vec[i].iov_len;
+	}
+	ctx->count++;
+	return 0;
+}
+
+static int test_batch(void)
+{
+	struct es_fifo fifo;
+	struct drain_ctx ctx;
+	unsigned int elems[16], i;
+	unsigned char buf[64];
+
+	TEST_CHECK(es_fifo_alloc(&fifo, 64) == 0);
+
+	/* elements of a size which does not divide the buffer size */
+	fifo.in = fifo.out = 60;
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i;
+	TEST_CHECK(es_fifo_in(&fifo, buf, 62) == 62);
+	TEST_CHECK(es_fifo_out_elems(&fifo, elems, 3, 2) == 2);
+	TEST_CHECK(memcmp(elems, buf, 6) == 0);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.stop_at = 5;
+	TEST_CHECK(es_fifo_drain_elems(&fifo, 3, 100, drain_cb, &ctx) == 5);
+	TEST_CHECK(ctx.bytes == 15 && memcmp(ctx.data, buf + 6, 15) == 0);
+	TEST_CHECK(es_fifo_len(&fifo) == 62 - 21);
+
+	ctx.stop_at = ~0u;
+	TEST_CHECK(es_fifo_drain_elems(&fifo, 3, 100, drain_cb, &ctx) == 13);
+	TEST_CHECK(ctx.bytes == 54 && memcmp(ctx.data, buf + 6, 54) == 0);
+	TEST_CHECK(es_fifo_len(&fifo) == 2);
+	es_fifo_reset(&fifo);
+
+	/* records, including an empty one and one wrapping around */
+	fifo.in = fifo.out = 50;
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf, 10, 1) == 0);
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf, 0, 1) == 0);
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf + 10, 20, 1) == 0);
+	TEST_CHECK(es_fifo_in_rec(&fifo, buf + 30, 5, 1) == 0);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.stop_at = ~0u;
+	TEST_CHECK(es_fifo_drain_recs(&fifo, 1, 3, drain_cb, &ctx) == 3);
+	TEST_CHECK(ctx.bytes == 30 && memcmp(ctx.data, buf, 30) == 0);
+	TEST_CHECK(es_fifo_peek_rec(&fifo, 1) == 5);
+	TEST_CHECK(es_fifo_drain_recs(&fifo, 1, 3, drain_cb, &ctx) == 1);
+	TEST_CHECK(ctx.bytes == 35 && memcmp(ctx.data, buf, 35) == 0);
+	TEST_CHECK(es_fifo_is_empty(&fifo));
+	TEST_CHECK(es_fifo_drain_recs(&fifo, 1, 3, drain_cb, &ctx) == 0);
+
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+/* a peek at an offset copies at most len bytes, into a buffer of len */
+static int test_peek(void)
+{
+	struct es_fifo fifo;
+	unsigned char buf[32], out[16], *exact;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i;
+
+	TEST_CHECK(es_fifo_alloc(&fifo, 32) == 0);
+	fifo.in = fifo.out = 28;
+	TEST_CHECK(es_fifo_in(&fifo, buf, 20) == 20);
+
+	memset(out, 0xee, sizeof(out));
+	TEST_CHECK(es_fifo_out_peek(&fifo, out, 5, 3) == 5);
+	TEST_CHECK(memcmp(out, buf + 3, 5) == 0);
+	for (i = 5; i < sizeof(out); i++)
+		TEST_CHECK(out[i] == 0xee);
+
+	exact = malloc(5);
+	TEST_CHECK(exact);
+	TEST_CHECK(es_fifo_out_peek(&fifo, exact, 5, 14) == 5);
+	TEST_CHECK(memcmp(exact, buf + 14, 5) == 0);
+	TEST_CHECK(es_fifo_out_peek(&fifo, exact, 5, 17) == 3);
+	TEST_CHECK(memcmp(exact, buf + 17, 3) == 0);
+	free(exact);
+
+	TEST_CHECK(es_fifo_out_peek(&fifo, out, 5, 20) == 0);
+	TEST_CHECK(es_fifo_out_peek(&fifo, out, 5, 100) == 0);
+	TEST_CHECK(es_fifo_len(&fifo) == 20);
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+static int test_sizes(void)
+{
+	DEFINE_ES_FIFO(static_fifo, 128);
+	struct es_fifo fifo;
+	static unsigned char raw[1000];
+	unsigned char buf[3000], out[3000];
+	unsigned int i;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 7;
+
+	TEST_CHECK(es_fifo_size(&static_fifo) == 128);
+
+	/* not a power of 2: rounded up on alloc, down on init */
+	TEST_CHECK(es_fifo_alloc(&fifo, 1000) == 0);
+	TEST_CHECK(es_fifo_size(&fifo) == 1024);
+	for (i = 0; i < 5; i++) {
+		TEST_CHECK(es_fifo_in(&fifo, buf, 1000) == 1000);
+		TEST_CHECK(es_fifo_out(&fifo, out, sizeof(out)) == 1000);
+		TEST_CHECK(memcmp(buf, out, 1000) == 0);
+	}
+	es_fifo_free(&fifo);
+
+	TEST_CHECK(es_fifo_init(&fifo, raw, sizeof(raw)) == 0);
+	TEST_CHECK(es_fifo_size(&fifo) == 512);
+	TEST_CHECK(es_fifo_in(&fifo, buf, 1000) == 512);
+	TEST_CHECK(es_fifo_out(&fifo, out, 300) == 300);
+	TEST_CHECK(es_fifo_in(&fifo, buf + 512, 300) == 300);
+	TEST_CHECK(es_fifo_out(&fifo, out + 300, 512) == 512);
+	TEST_CHECK(memcmp(buf, out, 812) == 0);
+
+	TEST_CHECK(es_fifo_alloc(&fifo, 0) == ES_INVALID_PARAM);
+	TEST_CHECK(es_fifo_alloc(&fifo, 1) == ES_INVALID_PARAM);
+	TEST_CHECK(es_fifo_init(&fifo, NULL, 64) == ES_INVALID_PARAM);
+	TEST_CHECK(!es_fifo_initialized(&fifo));
+
+	TEST_CHECK(es_fifo_alloc_flags(&fifo, 3000,
+		ES_FIFO_ALLOC_CACHEALIGN) == 0);
+	TEST_CHECK(es_fifo_size(&fifo) == 4096);
+	TEST_CHECK(((unsigned long)fifo.buffer & (ES_CACHELINE_SIZE - 1)) == 0);
+	es_fifo_free(&fifo);
+
+	/* large ring, huge pages if the system has them */
+	TEST_CHECK(es_fifo_alloc_flags(&fifo, 3 * 1024 * 1024,
+		ES_FIFO_ALLOC_HUGEPAGE) == 0);
+	TEST_CHECK(es_fifo_size(&fifo) == 4 * 1024 * 1024);
+	fifo.in = fifo.out = es_fifo_size(&fifo) - 1000;
+	TEST_CHECK(es_fifo_in(&fifo, buf, sizeof(buf)) == sizeof(buf));
+	TEST_CHECK(es_fifo_out(&fifo, out, sizeof(out)) == sizeof(out));
+	TEST_CHECK(memcmp(buf, out, sizeof(buf)) == 0);
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+#define LOSSY_WORDS	(1024 * 1024)
+
+static void *lossy_producer(void *arg)
+{
+	struct es_fifo *fifo = arg;
+	unsigned long long words[13];
+	unsigned long long pos = 0;
+	unsigned int i, n = 1;
+
+	while (pos < LOSSY_WORDS) {
+		n = n % 13 + 1;
+		n = min((unsigned long long)n, LOSSY_WORDS - pos);
+		for (i = 0; i < n; i++)
+			words[i] = pos + i;
+		es_fifo_in(fifo, words, n * sizeof(words[0]));
+		pos += n;
+	}
+	return NULL;
+}
+
+static int test_overwrite(void)
+{
+	struct es_fifo fifo;
+	unsigned char buf[64], out[64];
+	unsigned long long words[32], last = 0, got = 0;
+	struct iovec vec[2];
+	unsigned int i, n;
+	pthread_t tid;
+	int first = 1;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i;
+
+	TEST_CHECK(es_fifo_alloc(&fifo, 16) == 0);
+	es_fifo_set_overwrite(&fifo, 1);
+
+	/* keeps the newest bytes */
+	TEST_CHECK(es_fifo_in(&fifo, buf, 10) == 10);
+	TEST_CHECK(es_fifo_in(&fifo, buf + 10, 10) == 10);
+	TEST_CHECK(es_fifo_dropped(&fifo) == 4);
+	TEST_CHECK(es_fifo_out(&fifo, out, 3) == 3);
+	TEST_CHECK(memcmp(out, buf + 4, 3) == 0);
+	TEST_CHECK(es_fifo_in(&fifo, buf + 20, 40) == 40);
+	TEST_CHECK(es_fifo_dropped(&fifo) == 4 + 13 + 24);
+	TEST_CHECK(es_fifo_len(&fifo) == 16);
+	TEST_CHECK(es_fifo_out(&fifo, out, sizeof(out)) == 16);
+	TEST_CHECK(memcmp(out, buf + 44, 16) == 0);
+
+	/* peek and skip take part in the cmpxchg, zero-copy is refused */
+	TEST_CHECK(es_fifo_in(&fifo, buf, 20) == 20);
+	TEST_CHECK(es_fifo_out_peek(&fifo, out, 5, 2) == 5);
+	TEST_CHECK(memcmp(out, buf + 6, 5) == 0);
+	TEST_CHECK(es_fifo_out_peek(&fifo, out, 30, 10) == 6);
+	TEST_CHECK(es_fifo_out_peek(&fifo, out, 5, 16) == 0);
+	TEST_CHECK(es_fifo_peek_read(&fifo, vec, 16) == 0);
+	es_fifo_release_read(&fifo, 8);
+	TEST_CHECK(es_fifo_len(&fifo) == 16);
+	TEST_CHECK(es_fifo_to_fd(&fifo, 1, 16) == -1 && errno == EINVAL);
+	es_fifo_skip(&fifo, 10);
+	TEST_CHECK(es_fifo_out(&fifo, out, sizeof(out)) == 6);
+	TEST_CHECK(memcmp(out, buf + 14, 6) == 0);
+	es_fifo_skip(&fifo, 10);
+	TEST_CHECK(es_fifo_is_empty(&fifo));
+	es_fifo_free(&fifo);
+
+	/* concurrent reader, words must arrive whole and in order */
+	TEST_CHECK(es_fifo_alloc(&fifo, 256) == 0);
+	es_fifo_set_overwrite(&fifo, 1);
+	pthread_create(&tid, NULL, lossy_producer, &fifo);
+	while (first || last + 1 < LOSSY_WORDS) {
+		n = es_fifo_out(&fifo, words, sizeof(words));
+		TEST_CHECK(n % sizeof(words[0]) == 0);
+		for (i = 0; i < n / sizeof(words[0]); i++) {
+			TEST_CHECK(first || words[i] > last);
+			/* whole chunks are contiguous, gaps only between them */
+			TEST_CHECK(i == 0 || words[i] == words[i - 1] + 1);
+			last = words[i];
+			first = 0;
+			got++;
+		}
+	}
+	pthread_join(tid, NULL);
+	printf("overwrite: %llu words read, %lu bytes dropped \n", got,
+		es_fifo_dropped(&fifo));
+	TEST_CHECK(got * sizeof(words[0]) + es_fifo_dropped(&fifo) ==
+		LOSSY_WORDS * sizeof(words[0]));
+	es_fifo_free(&fifo);
+
+	/* the same through peek and skip, no torn or stale words */
+	TEST_CHECK(es_fifo_alloc(&fifo, 256) == 0);
+	es_fifo_set_overwrite(&fifo, 1);
+	first = 1;
+	pthread_create(&tid, NULL, lossy_producer, &fifo);
+	while (first || last + 1 < LOSSY_WORDS) {
+		n = es_fifo_out_peek(&fifo, words, sizeof(words), 0);
+		TEST_CHECK(n % sizeof(words[0]) == 0);
+		for (i = 0; i < n / sizeof(words[0]); i++) {
+			TEST_CHECK(first || words[i] > last);
+			TEST_CHECK(i == 0 || words[i] == words[i - 1] + 1);
+			last = words[i];
+			first = 0;
+		}
+		es_fifo_skip(&fifo, n);
+	}
+	pthread_join(tid, NULL);
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+static int test_stream(void)
+{
+	static unsigned char buf[3 * 8192], out[3 * 8192];
+	struct es_fifo fifo;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 7;
+
+	TEST_CHECK(es_fifo_alloc(&fifo, 16384) == 0);
+	es_fifo_set_stream(&fifo, 1);
+
+	/* large wrapping copies on both sides, then small ones */
+	for (i = 0; i < 4; i++) {
+		memset(out, 0, sizeof(out));
+		TEST_CHECK(es_fifo_in(&fifo, buf, 12000) == 12000);
+		TEST_CHECK(es_fifo_out(&fifo, out, 12000) == 12000);
+		TEST_CHECK(memcmp(buf, out, 12000) == 0);
+	}
+	for (i = 0; i < 300; i++) {
+		TEST_CHECK(es_fifo_in(&fifo, buf + i, i % 70) == i % 70);
+		TEST_CHECK(es_fifo_out(&fifo, out, i % 70) == i % 70);
+		TEST_CHECK(memcmp(buf + i, out, i % 70) == 0);
+	}
+
+	es_fifo_free(&fifo);
+	return 0;
+}
+
+static int test_fd(void)
+{
+	struct es_fifo up, down;
+	unsigned char buf[3000], out[3000];
+	int a[2], b[2], spl[2];
+	unsigned int i;
+	FILE *file;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 13;
+
+	TEST_CHECK(es_fifo_alloc(&up, 1024) == 0);
+	TEST_CHECK(es_fifo_alloc(&down, 1024) == 0);
+	TEST_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, a) == 0);
+	TEST_CHECK(socketpair(AF_UNIX, SOCK_STREAM, 0, b) == 0);
+	TEST_CHECK(pipe(spl) == 0);
+
+	/* byte pump a[1] -> up -> b[0], wrapping in the ring */
+	up.in = up.out = 1000;
+	TEST_CHECK(write(a[0], buf, 700) == 700);
+	TEST_CHECK(es_fifo_from_fd(&up, a[1], 4096) == 700);
+	TEST_CHECK(es_fifo_to_fd(&up, b[0], 4096) == 700);
+	TEST_CHECK(es_fifo_is_empty(&up));
+	TEST_CHECK(read(b[1], out, sizeof(out)) == 700);
+	TEST_CHECK(memcmp(buf, out, 700) == 0);
+	TEST_CHECK(es_fifo_to_fd(&up, b[0], 4096) == 0);
+
+	/* full fifo is reported, not mistaken for end of file */
+	TEST_CHECK(es_fifo_in(&up, buf, 1024) == 1024);
+	TEST_CHECK(es_fifo_from_fd(&up, a[1], 10) == -1 && errno == ENOBUFS);
+
+	/* the splice path, into a file only; a socket would keep the pages */
+	TEST_CHECK(es_fifo_in(&down, buf, 900) == 900);
+	TEST_CHECK(es_fifo_out(&down, out, 900) == 900);
+	TEST_CHECK(es_fifo_in(&down, buf, 1000) == 1000);
+	TEST_CHECK(es_fifo_to_fd_splice(&down, spl, a[1], 4096) == -1 &&
+		errno == EINVAL);
+	TEST_CHECK(es_fifo_len(&down) == 1000);
+	file = tmpfile();
+	TEST_CHECK(file);
+	TEST_CHECK(es_fifo_to_fd_splice(&down, spl, fileno(file), 4096) ==
+		1000);
+	TEST_CHECK(es_fifo_is_empty(&down));
+	/* the producer reuses the space, the file keeps its copy */
+	TEST_CHECK(es_fifo_in(&down, out, 1024) == 1024);
+	memset(out, 0, sizeof(out));
+	TEST_CHECK(pread(fileno(file), out, sizeof(out), 0) == 1000);
+	TEST_CHECK(memcmp(buf, out, 1000) == 0);
+	fclose(file);
+
+	close(a[0]);
+	close(a[1]);
+	close(b[0]);
+	close(b[1]);
+	close(spl[0]);
+	close(spl[1]);
+	es_fifo_free(&up);
+	es_fifo_free(&down);
+	return 0;
+}
 
 int main(int argc, char **argv)
 {
@@ -42,6 +602,12 @@ int main(int argc, char **argv)
 	}
 	
 	es_fifo_free(&fifo);
+
+	if (test_zero_copy() || test_mirror() || test_records() ||
+		test_batch() || test_sizes() || test_overwrite() ||
+		test_fd() || test_stream() || test_peek())
+		return 1;
+
 	printf("es_fifo test OK! \n");
 	return 0;
 }
@@ -0,0 +1,108 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_fifo_typed_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo_typed.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+
+#define TEST_COUNT	(1024 * 1024)
+
+struct test_msg {
+	unsigned int seq;
+	unsigned int check;
+	unsigned short tag;
+};
+
+DECLARE_ES_FIFO_TYPED(msg_fifo, struct test_msg, 64);
+
+static struct msg_fifo fifo;
+
+static void *producer(void *arg)
+{
+	struct test_msg msg[5];
+	unsigned int seq = 0, i, n;
+
+	while (seq < TEST_COUNT) {
+		/* alternate single pushes and batches */
+		if (seq & 1) {
+			msg[0].seq = seq;
+			msg[0].check = ~seq;
+			seq += msg_fifo_push(&fifo, &msg[0]);
+			continue;
+		}
+		n = min(5u, TEST_COUNT - seq);
+		for (i = 0; i < n; i++) {
+			msg[i].seq = seq + i;
+			msg[i].check = ~(seq + i);
+		}
+		n = msg_fifo_in(&fifo, msg, n);
+		if (!n)
+			sched_yield();
+		seq += n;
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	struct test_msg msg, batch[7];
+	unsigned int seq = 0, i, n;
+	pthread_t tid;
+
+	msg_fifo_init(&fifo);
+	if (!msg_fifo_is_empty(&fifo) || msg_fifo_avail(&fifo) != 64 ||
+		msg_fifo_peek(&fifo) || msg_fifo_pop(&fifo, &msg))
+		return 1;
+
+	for (i = 0; i < 64; i++) {
+		msg.seq = i;
+		if (!msg_fifo_push(&fifo, &msg))
+			return 1;
+	}
+	if (!msg_fifo_is_full(&fifo) || msg_fifo_push(&fifo, &msg) ||
+		msg_fifo_peek(&fifo)->seq != 0)
+		return 1;
+	for (i = 0; i < 64; i++)
+		if (!msg_fifo_pop(&fifo, &msg) || msg.seq != i)
+			return 1;
+	printf("single element OK \n");
+
+	pthread_create(&tid, NULL, producer, NULL);
+	while (seq < TEST_COUNT) {
+		if (seq & 2) {
+			n = msg_fifo_pop(&fifo, batch);
+		} else {
+			n = msg_fifo_out(&fifo, batch, 7);
+		}
+		if (!n)
+			sched_yield();
+		for (i = 0; i < n; i++, seq++)
+			if (batch[i].seq != seq || batch[i].check != ~seq) {
+				printf("got %u, expected %u \n", batch[i].seq, seq);
+				return 1;
+			}
+	}
+	pthread_join(tid, NULL);
+
+	printf("es_fifo_typed test OK! \n");
+	return 0;
+}
+
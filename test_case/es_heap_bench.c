@@ -0,0 +1,232 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_heap_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_heap.h>
+#include <es_list.h>
+#include <es_rbtree.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Deadline scheduling with n queued jobs: insert with random deadlines,
+ * move random jobs to an earlier deadline, pop all in deadline order.
+ * es_heap against an es_list kept sorted on insert, which stops at
+ * BENCH_LIST_MAX jobs, and an es_rb_root_cached.
+ *
+ * Then loading n jobs at once: es_heap_push_bulk() against pushing them
+ * one by one, for random and for descending deadlines.
+ */
+
+#define BENCH_MAX	(1U << 20)
+#define BENCH_LIST_MAX	(1U << 14)
+
+struct job {
+	unsigned int deadline;
+	struct es_heap_node node;
+	struct es_list_head list;
+	struct es_rb_node rb;
+};
+
+static struct job *jobs;
+static struct es_heap_node **batch;
+static unsigned int *deadlines;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned int rand32(void)
+{
+	return ((unsigned int)rand() << 16) ^ rand();
+}
+
+static bool job_less(const struct es_heap_node *a, const struct es_heap_node *b)
+{
+	return es_heap_entry(a, struct job, node)->deadline <
+		es_heap_entry(b, struct job, node)->deadline;
+}
+
+static bool job_rb_less(struct es_rb_node *a, const struct es_rb_node *b)
+{
+	return es_rb_entry(a, struct job, rb)->deadline <
+		es_rb_entry(b, struct job, rb)->deadline;
+}
+
+static void list_insert(struct es_list_head *head, struct job *job)
+{
+	struct job *pos;
+
+	es_list_for_each_entry(pos, head, list)
+		if (job->deadline < pos->deadline)
+			break;
+	es_list_add_tail(&job->list, &pos->list);
+}
+
+static void print_row(unsigned int n, const char *name, double t_ins,
+			double t_dec, double t_pop)
+{
+	printf("%9u %-10s %10.1f %10.1f %10.1f \n", n, name, t_ins * 1e9 / n,
+		t_dec * 1e9 / (n / 4), t_pop * 1e9 / n);
+}
+
+static void bench_queue(unsigned int n)
+{
+	struct es_rb_root_cached root = ES_RB_ROOT_CACHED;
+	struct es_heap heap;
+	struct es_rb_node *first;
+	struct job *j;
+	unsigned int i;
+	double t_ins, t_dec, t_pop;
+	ES_LIST_HEAD(head);
+
+	for (i = 0; i < n; i++)
+		deadlines[i] = rand32();
+
+	es_heap_init(&heap, 0, job_less);
+	t_ins = now();
+	for (i = 0; i < n; i++) {
+		jobs[i].deadline = deadlines[i];
+		es_heap_node_init(&jobs[i].node);
+		es_heap_push(&heap, &jobs[i].node);
+	}
+	t_ins = now() - t_ins;
+	t_dec = now();
+	for (i = 0; i < n / 4; i++) {
+		j = &jobs[deadlines[i] % n];
+		j->deadline /= 2;
+		es_heap_decrease(&heap, &j->node);
+	}
+	t_dec = now() - t_dec;
+	t_pop = now();
+	while (es_heap_pop(&heap))
+		;
+	t_pop = now() - t_pop;
+	es_heap_destroy(&heap);
+	print_row(n, "es_heap", t_ins, t_dec, t_pop);
+
+	t_ins = now();
+	for (i = 0; i < n; i++) {
+		jobs[i].deadline = deadlines[i];
+		es_rb_add_cached(&jobs[i].rb, &root, job_rb_less);
+	}
+	t_ins = now() - t_ins;
+	t_dec = now();
+	for (i = 0; i < n / 4; i++) {
+		j = &jobs[deadlines[i] % n];
+		es_rb_erase_cached(&j->rb, &root);
+		j->deadline /= 2;
+		es_rb_add_cached(&j->rb, &root, job_rb_less);
+	}
+	t_dec = now() - t_dec;
+	t_pop = now();
+	while ((first = es_rb_first_cached(&root)))
+		es_rb_erase_cached(first, &root);
+	t_pop = now() - t_pop;
+	print_row(n, "es_rbtree", t_ins, t_dec, t_pop);
+
+	if (n > BENCH_LIST_MAX)
+		return;
+
+	t_ins = now();
+	for (i = 0; i < n; i++) {
+		jobs[i].deadline = deadlines[i];
+		list_insert(&head, &jobs[i]);
+	}
+	t_ins = now() - t_ins;
+	t_dec = now();
+	for (i = 0; i < n / 4; i++) {
+		j = &jobs[deadlines[i] % n];
+		es_list_del(&j->list);
+		j->deadline /= 2;
+		list_insert(&head, j);
+	}
+	t_dec = now() - t_dec;
+	t_pop = now();
+	while (!es_list_empty(&head))
+		es_list_del(head.next);
+	t_pop = now() - t_pop;
+	print_row(n, "es_list", t_ins, t_dec, t_pop);
+}
+
+static void bench_load(unsigned int n, bool descending)
+{
+	struct es_heap heap;
+	double t_push, t_bulk;
+	unsigned int i;
+
+	es_heap_init(&heap, n, job_less);
+	for (i = 0; i < n; i++) {
+		jobs[i].deadline = descending ? n - i : rand32();
+		es_heap_node_init(&jobs[i].node);
+		batch[i] = &jobs[i].node;
+	}
+	t_push = now();
+	for (i = 0; i < n; i++)
+		es_heap_push(&heap, batch[i]);
+	t_push = now() - t_push;
+
+	while (es_heap_pop(&heap))
+		;
+	t_bulk = now();
+	es_heap_push_bulk(&heap, batch, n);
+	t_bulk = now() - t_bulk;
+	es_heap_destroy(&heap);
+
+	printf("%9u %-10s %10.1f %10.1f \n", n,
+		descending ? "descending" : "random",
+		t_push * 1e9 / n, t_bulk * 1e9 / n);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int n;
+
+	jobs = malloc(BENCH_MAX * sizeof(*jobs));
+	batch = malloc(BENCH_MAX * sizeof(*batch));
+	deadlines = malloc(BENCH_MAX * sizeof(*deadlines));
+	if (!jobs || !batch || !deadlines)
+		return 1;
+	srand(25);
+
+	printf("ns per op \n");
+	printf("%9s %-10s %10s %10s %10s \n", "jobs", "", "insert",
+		"decrease", "pop min");
+	for (n = 1024; n <= BENCH_MAX; n *= 4)
+		bench_queue(n);
+
+	printf("\nload, ns per job \n");
+	printf("%9s %-10s %10s %10s \n", "jobs", "deadlines", "push",
+		"push_bulk");
+	for (n = 1024; n <= BENCH_MAX; n *= 32) {
+		bench_load(n, es_false);
+		bench_load(n, es_true);
+	}
+
+	free(jobs);
+	free(batch);
+	free(deadlines);
+	return 0;
+}
+
@@ -0,0 +1,208 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_heap_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_heap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+#define TEST_ITEMS	3000
+
+struct job {
+	unsigned int deadline;
+	struct es_heap_node node;
+};
+
+static struct job jobs[TEST_ITEMS];
+static struct es_heap_node *batch[TEST_ITEMS];
+
+static bool job_less(const struct es_heap_node *a, const struct es_heap_node *b)
+{
+	return es_heap_entry(a, struct job, node)->deadline <
+		es_heap_entry(b, struct job, node)->deadline;
+}
+
+/* heap order, back indices, and the queued jobs are the ones in it */
+static int check_heap(struct es_heap *heap)
+{
+	unsigned int i, queued = 0;
+
+	for (i = 0; i < heap->nr; i++) {
+		TEST_CHECK(heap->nodes[i]->index == i);
+		if (i)
+			TEST_CHECK(!job_less(heap->nodes[i],
+				heap->nodes[(i - 1) / ES_HEAP_ARITY]));
+	}
+	for (i = 0; i < TEST_ITEMS; i++)
+		if (es_heap_queued(&jobs[i].node)) {
+			TEST_CHECK(jobs[i].node.index < heap->nr);
+			TEST_CHECK(heap->nodes[jobs[i].node.index] ==
+				&jobs[i].node);
+			queued++;
+		}
+	TEST_CHECK(queued == heap->nr);
+	return 0;
+}
+
+/* the smallest deadline of the queued jobs */
+static unsigned int min_deadline(void)
+{
+	unsigned int i, m = ~0U;
+
+	for (i = 0; i < TEST_ITEMS; i++)
+		if (es_heap_queued(&jobs[i].node) && jobs[i].deadline < m)
+			m = jobs[i].deadline;
+	return m;
+}
+
+static int test_random(void)
+{
+	struct es_heap heap;
+	struct es_heap_node *n;
+	struct job *j;
+	unsigned int i, r;
+
+	TEST_CHECK(es_heap_init(&heap, 0, NULL) == ES_INVALID_PARAM);
+	TEST_CHECK(es_heap_init(&heap, 0, job_less) == ES_SUCCESS);
+	TEST_CHECK(es_heap_empty(&heap) && !es_heap_peek(&heap));
+	TEST_CHECK(!es_heap_pop(&heap));
+	for (i = 0; i < TEST_ITEMS; i++)
+		es_heap_node_init(&jobs[i].node);
+
+	srand(25);
+	for (r = 0; r < 30; r++) {
+		for (i = 0; i < TEST_ITEMS; i++) {
+			j = &jobs[i];
+			if (rand() % 4)
+				continue;
+			if (!es_heap_queued(&j->node)) {
+				/* few distinct deadlines, many ties */
+				j->deadline = rand() % 500;
+				TEST_CHECK(es_heap_push(&heap, &j->node) == 0);
+				TEST_CHECK(es_heap_push(&heap, &j->node) ==
+					ES_FAIL);
+			} else if (rand() % 3 == 0) {
+				es_heap_remove(&heap, &j->node);
+				TEST_CHECK(!es_heap_queued(&j->node));
+			} else if (rand() % 2) {
+				if (j->deadline)
+					j->deadline -= rand() % j->deadline + 1;
+				es_heap_decrease(&heap, &j->node);
+			} else {
+				j->deadline = rand() % 500;
+				es_heap_update(&heap, &j->node);
+			}
+		}
+		if (check_heap(&heap))
+			return -1;
+		TEST_CHECK(es_heap_empty(&heap) ||
+			es_heap_entry(es_heap_peek(&heap), struct job,
+				node)->deadline == min_deadline());
+
+		/* pop a few, in order */
+		for (i = 0; i < 50 && !es_heap_empty(&heap); i++) {
+			unsigned int m = min_deadline();
+
+			n = es_heap_pop(&heap);
+			TEST_CHECK(!es_heap_queued(n));
+			TEST_CHECK(es_heap_entry(n, struct job, node)->deadline ==
+				m);
+		}
+	}
+
+	/* drain sorted */
+	r = 0;
+	while ((n = es_heap_pop(&heap))) {
+		j = es_heap_entry(n, struct job, node);
+		TEST_CHECK(j->deadline >= r);
+		r = j->deadline;
+	}
+	TEST_CHECK(!es_heap_count(&heap));
+	if (check_heap(&heap))
+		return -1;
+	es_heap_destroy(&heap);
+	return 0;
+}
+
+static int test_bulk(void)
+{
+	struct es_heap heap;
+	struct es_heap_node *n;
+	unsigned int i, k, prev, count;
+
+	TEST_CHECK(es_heap_init(&heap, 100, job_less) == 0);
+	srand(26);
+	for (i = 0; i < TEST_ITEMS; i++) {
+		es_heap_node_init(&jobs[i].node);
+		jobs[i].deadline = rand() % 100000;
+		batch[i] = &jobs[i].node;
+	}
+
+	/* into an empty heap, heapified; then a large and a small batch */
+	TEST_CHECK(es_heap_push_bulk(&heap, batch, 1000) == 0);
+	if (check_heap(&heap))
+		return -1;
+	TEST_CHECK(es_heap_push_bulk(&heap, batch + 1000, 1500) == 0);
+	if (check_heap(&heap))
+		return -1;
+	TEST_CHECK(es_heap_push_bulk(&heap, batch + 2500, 500) == 0);
+	if (check_heap(&heap))
+		return -1;
+	TEST_CHECK(es_heap_count(&heap) == TEST_ITEMS);
+
+	/* nothing is queued when one of them is already */
+	TEST_CHECK(es_heap_push_bulk(&heap, batch, 1) == ES_FAIL);
+	TEST_CHECK(es_heap_count(&heap) == TEST_ITEMS);
+
+	/* descending keys, the worst case of pushing one by one */
+	for (k = 0; k < 2; k++) {
+		for (i = 0; i < TEST_ITEMS; i++)
+			es_heap_remove(&heap, &jobs[i].node);
+		TEST_CHECK(es_heap_empty(&heap));
+		for (i = 0; i < TEST_ITEMS; i++)
+			jobs[i].deadline = TEST_ITEMS - i;
+		TEST_CHECK(es_heap_push_bulk(&heap, batch, k ? 1 : 0) == 0);
+		TEST_CHECK(es_heap_push_bulk(&heap, batch + k,
+			TEST_ITEMS - k) == 0);
+		if (check_heap(&heap))
+			return -1;
+	}
+
+	prev = 0;
+	count = 0;
+	while ((n = es_heap_pop(&heap))) {
+		TEST_CHECK(es_heap_entry(n, struct job, node)->deadline > prev);
+		prev = es_heap_entry(n, struct job, node)->deadline;
+		count++;
+	}
+	TEST_CHECK(count == TEST_ITEMS);
+	es_heap_destroy(&heap);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_random() || test_bulk())
+		return 1;
+
+	printf("es_heap test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,226 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_hmap_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_hmap.h>
+#include <es_htable.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * es_hmap against the chained es_htable:
+ *  - lookups at several load factors of the open addressing table,
+ *    each with 100%, 90%, 50% and 0% of the queries hitting
+ *  - growth from empty: mean and worst single insert with the
+ *    incremental rehash, with a stop-the-world rehash at the same points
+ *    and with the final size reserved up front
+ */
+
+enum {
+	GROW_INCREMENTAL,
+	GROW_FULL,
+	GROW_RESERVED,
+};
+
+#define BENCH_CAP	(1U << 20)
+#define BENCH_QUERIES	(1U << 21)
+
+struct obj {
+	unsigned long long key;
+	unsigned long long val;
+	struct es_hlist_node node;
+};
+
+static unsigned long long *keys;
+static unsigned long long *queries;
+static struct obj *objs;
+
+static uint32_t key_hash(const void *key)
+{
+	return es_hash_64(*(const unsigned long long *)key, 32);
+}
+
+static uint32_t obj_hash(const struct es_hlist_node *node)
+{
+	return key_hash(&es_hlist_entry(node, struct obj, node)->key);
+}
+
+static int obj_match(const struct es_hlist_node *node, const void *key)
+{
+	return es_hlist_entry(node, struct obj, node)->key ==
+		*(const unsigned long long *)key;
+}
+
+static const struct es_htable_ops obj_ops = {
+	.hashfn		= key_hash,
+	.obj_hashfn	= obj_hash,
+	.matchfn	= obj_match,
+};
+
+static uint32_t map_hash(const void *key, unsigned int ksize)
+{
+	return key_hash(key);
+}
+
+static int map_eq(const void *a, const void *b, unsigned int ksize)
+{
+	return *(const unsigned long long *)a == *(const unsigned long long *)b;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long long rand64(void)
+{
+	return ((unsigned long long)rand() << 42) ^
+		((unsigned long long)rand() << 21) ^ rand();
+}
+
+/* present keys are even, absent ones odd */
+static void make_queries(unsigned int n, unsigned int hit_pct)
+{
+	unsigned int i;
+
+	for (i = 0; i < BENCH_QUERIES; i++) {
+		queries[i] = keys[rand() % n];
+		if ((unsigned int)(rand() % 100) >= hit_pct)
+			queries[i] |= 1;
+	}
+}
+
+static double bench_hmap_find(struct es_hmap *map, unsigned long *found)
+{
+	double start = now();
+	unsigned int i;
+
+	for (i = 0; i < BENCH_QUERIES; i++)
+		*found += es_hmap_find(map, &queries[i]) != NULL;
+	return (now() - start) * 1e9 / BENCH_QUERIES;
+}
+
+static double bench_htable_find(struct es_htable *ht, unsigned long *found)
+{
+	double start = now();
+	unsigned int i;
+
+	for (i = 0; i < BENCH_QUERIES; i++)
+		*found += es_htable_lookup(ht, &queries[i]) != NULL;
+	return (now() - start) * 1e9 / BENCH_QUERIES;
+}
+
+static void bench_load(unsigned int n)
+{
+	static const unsigned int hit_pcts[] = {100, 90, 50, 0};
+	struct es_hmap map;
+	struct es_htable ht;
+	unsigned long found = 0;
+	unsigned int i;
+
+	/* fixed capacity, so n sets the load factor */
+	es_hmap_init(&map, sizeof(*keys), sizeof(*keys), BENCH_CAP / 8 * 7 - 1,
+		map_hash, map_eq);
+	es_htable_init(&ht, &obj_ops, n, 0);
+	for (i = 0; i < n; i++) {
+		es_hmap_put(&map, &keys[i], &keys[i]);
+		objs[i].key = keys[i];
+		es_htable_add(&ht, &objs[i].node);
+	}
+
+	for (i = 0; i < sizeof(hit_pcts) / sizeof(hit_pcts[0]); i++) {
+		make_queries(n, hit_pcts[i]);
+		printf("%7.1f%% %6u%% %10.1f", 100.0 * n / es_hmap_capacity(&map),
+			hit_pcts[i], bench_hmap_find(&map, &found));
+		printf(" %10.1f \n", bench_htable_find(&ht, &found));
+	}
+
+	es_htable_destroy(&ht);
+	es_hmap_destroy(&map);
+	if (!found)
+		printf("nothing found \n");
+}
+
+static void bench_growth(unsigned int n, int mode)
+{
+	static const char * const names[] = {
+		"incremental rehash", "full rehash", "reserved",
+	};
+	struct es_hmap map;
+	double start, t, worst = 0, total;
+	unsigned int i, cap;
+
+	es_hmap_init(&map, sizeof(*keys), sizeof(*keys), 0, map_hash, map_eq);
+	if (mode == GROW_RESERVED)
+		es_hmap_reserve(&map, n);
+
+	total = now();
+	for (i = 0; i < n; i++) {
+		start = now();
+		cap = es_hmap_capacity(&map);
+		/* rehash everything in one go where the map would start to */
+		if (mode == GROW_FULL && es_hmap_count(&map) >= cap - cap / 8)
+			es_hmap_reserve(&map, es_hmap_count(&map) + 1);
+		es_hmap_put(&map, &keys[i], &keys[i]);
+		t = now() - start;
+		if (t > worst)
+			worst = t;
+	}
+	total = now() - total;
+	printf("%-22s %10.1f %12.1f \n", names[mode], total * 1e9 / n,
+		worst * 1e6);
+	es_hmap_destroy(&map);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int loads[] = {25, 50, 75, 87};
+	unsigned int i, n = BENCH_CAP / 8 * 7 - 1;
+
+	keys = malloc(n * sizeof(*keys));
+	queries = malloc(BENCH_QUERIES * sizeof(*queries));
+	objs = malloc(n * sizeof(*objs));
+	if (!keys || !queries || !objs)
+		return 1;
+
+	srand(3);
+	for (i = 0; i < n; i++)
+		keys[i] = rand64() & ~1ULL;
+
+	printf("lookup ns, %u slots \n", BENCH_CAP);
+	printf("%8s %7s %10s %10s \n", "load", "hits", "es_hmap", "es_htable");
+	for (i = 0; i < sizeof(loads) / sizeof(loads[0]); i++)
+		bench_load((unsigned long long)BENCH_CAP * loads[i] / 100);
+
+	printf("\ngrowth to %u entries \n", n);
+	printf("%-22s %10s %12s \n", "", "mean ns", "worst us");
+	bench_growth(n, GROW_INCREMENTAL);
+	bench_growth(n, GROW_FULL);
+	bench_growth(n, GROW_RESERVED);
+
+	free(keys);
+	free(queries);
+	free(objs);
+	return 0;
+}
+
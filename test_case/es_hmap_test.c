@@ -0,0 +1,185 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_hmap_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_hmap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "es_test.h"
+
+#define TEST_KEYS	20000
+#define TEST_OPS	400000
+
+struct session {
+	unsigned int addr;
+	unsigned short port;
+	unsigned short proto;
+};
+
+struct stats {
+	unsigned long long pkts;
+	unsigned int flags;
+};
+
+static uint32_t port_hash(const void *key, unsigned int ksize)
+{
+	/* deliberately poor, the map has to cope with it */
+	return ((const struct session *)key)->port;
+}
+
+static int session_eq(const void *a, const void *b, unsigned int ksize)
+{
+	const struct session *x = a, *y = b;
+
+	return x->addr == y->addr && x->port == y->port &&
+		x->proto == y->proto;
+}
+
+/* random inserts and erases against a flat reference array */
+static int test_random(void)
+{
+	static unsigned int ref[TEST_KEYS];	/* value + 1, 0 if absent */
+	struct es_hmap map;
+	struct es_hmap_iter it;
+	unsigned int i, key, count = 0, seen, rehashes = 0, *v, *k;
+	int existed;
+
+	TEST_CHECK(es_hmap_init(&map, sizeof(key), sizeof(unsigned int), 0,
+		NULL, NULL) == 0);
+	TEST_CHECK(es_hmap_capacity(&map) == 16);
+
+	srand(7);
+	for (i = 0; i < TEST_OPS; i++) {
+		key = rand() % TEST_KEYS;
+		/* grow for most of the run, then mostly shrink */
+		if (rand() % 100 < (i < TEST_OPS / 2 ? 70 : 20)) {
+			v = es_hmap_insert(&map, &key, &existed);
+			TEST_CHECK(v && existed == (ref[key] != 0));
+			if (existed)
+				TEST_CHECK(*v == ref[key] - 1);
+			else
+				count++;
+			*v = i;
+			ref[key] = i + 1;
+		} else {
+			TEST_CHECK((es_hmap_erase(&map, &key) == 0) ==
+				(ref[key] != 0));
+			if (ref[key])
+				count--;
+			ref[key] = 0;
+		}
+		rehashes += es_hmap_rehashing(&map);
+		TEST_CHECK(es_hmap_count(&map) == count);
+
+		if (i % 997 == 0) {
+			key = rand() % TEST_KEYS;
+			v = es_hmap_find(&map, &key);
+			TEST_CHECK(ref[key] ? v && *v == ref[key] - 1 : !v);
+		}
+	}
+	TEST_CHECK(rehashes > 0);
+
+	for (key = 0; key < TEST_KEYS; key++) {
+		v = es_hmap_find(&map, &key);
+		TEST_CHECK(ref[key] ? v && *v == ref[key] - 1 : !v);
+	}
+
+	seen = 0;
+	es_hmap_iter_init(&it);
+	while (es_hmap_iter_next(&map, &it, (void **)&k, (void **)&v)) {
+		TEST_CHECK(ref[*k] == *v + 1);
+		seen++;
+	}
+	TEST_CHECK(seen == count);
+
+	es_hmap_clear(&map);
+	TEST_CHECK(es_hmap_count(&map) == 0);
+	key = 1;
+	TEST_CHECK(!es_hmap_find(&map, &key));
+
+	es_hmap_destroy(&map);
+	return 0;
+}
+
+static int test_struct_keys(void)
+{
+	struct es_hmap map;
+	struct session s;
+	struct stats st, *p;
+	unsigned int i;
+
+	TEST_CHECK(es_hmap_init(&map, sizeof(s), sizeof(st), 100, port_hash,
+		session_eq) == 0);
+	TEST_CHECK(es_hmap_reserve(&map, 5000) == 0);
+	TEST_CHECK(es_hmap_capacity(&map) == 8192);
+
+	memset(&s, 0, sizeof(s));
+	for (i = 0; i < 5000; i++) {
+		s.addr = 0x0a000000 + i;
+		s.port = i % 3;
+		s.proto = 6;
+		st.pkts = i;
+		st.flags = 0;
+		TEST_CHECK(es_hmap_put(&map, &s, &st) == 0);
+	}
+	/* no growth after the reservation */
+	TEST_CHECK(es_hmap_capacity(&map) == 8192 && !es_hmap_rehashing(&map));
+
+	for (i = 0; i < 5000; i++) {
+		s.addr = 0x0a000000 + i;
+		s.port = i % 3;
+		p = es_hmap_find(&map, &s);
+		TEST_CHECK(p && p->pkts == i);
+		s.proto = 17;
+		TEST_CHECK(!es_hmap_find(&map, &s));
+		s.proto = 6;
+	}
+	es_hmap_destroy(&map);
+	return 0;
+}
+
+static int test_set(void)
+{
+	struct es_hmap map;
+	unsigned long long key;
+	int existed;
+
+	/* a value size of 0 makes a set */
+	TEST_CHECK(es_hmap_init(&map, sizeof(key), 0, 0, NULL, NULL) == 0);
+	for (key = 0; key < 1000; key++)
+		TEST_CHECK(es_hmap_insert(&map, &key, &existed) && !existed);
+	for (key = 0; key < 1000; key += 2)
+		TEST_CHECK(es_hmap_insert(&map, &key, &existed) && existed);
+	TEST_CHECK(es_hmap_count(&map) == 1000);
+	es_hmap_destroy(&map);
+
+	TEST_CHECK(es_hmap_init(&map, 0, 4, 0, NULL, NULL) == ES_INVALID_PARAM);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_random() || test_struct_keys() || test_set())
+		return 1;
+
+	printf("es_hmap test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,194 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_htable_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_htable.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * es_htable against the same table built from es_list_head buckets,
+ * same hash, same bucket count, same objects. Reports the bucket array
+ * size and ns per insert, hit lookup, miss lookup and delete.
+ */
+
+#define BENCH_NR	(1U << 20)
+
+struct obj {
+	unsigned long key;
+	struct es_hlist_node hnode;
+	struct es_list_head lnode;
+};
+
+static uint32_t key_hash(const void *key)
+{
+	return es_hash_long(*(const unsigned long *)key, 32);
+}
+
+static uint32_t obj_hash(const struct es_hlist_node *node)
+{
+	return key_hash(&es_hlist_entry(node, struct obj, hnode)->key);
+}
+
+static int obj_match(const struct es_hlist_node *node, const void *key)
+{
+	return es_hlist_entry(node, struct obj, hnode)->key ==
+		*(const unsigned long *)key;
+}
+
+static const struct es_htable_ops obj_ops = {
+	.hashfn		= key_hash,
+	.obj_hashfn	= obj_hash,
+	.matchfn	= obj_match,
+};
+
+/* the es_list_head chained table, fixed size like es_htable after growth */
+struct list_table {
+	struct es_list_head *buckets;
+	unsigned int bits;
+};
+
+static struct es_list_head *list_bucket(struct list_table *lt,
+				unsigned long key)
+{
+	return &lt->buckets[es_hash_32(key_hash(&key), lt->bits)];
+}
+
+static struct obj *list_lookup(struct list_table *lt, unsigned long key)
+{
+	struct es_list_head *head = list_bucket(lt, key);
+	struct obj *o;
+
+	es_list_for_each_entry(o, head, lnode) {
+		if (o->key == key)
+			return o;
+	}
+	return NULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, size_t bucket_bytes, double t[4])
+{
+	printf("%-10s %10zu KB %8.1f %8.1f %8.1f %8.1f \n", name,
+		bucket_bytes / 1024, t[0], t[1], t[2], t[3]);
+}
+
+int main(int argc, char **argv)
+{
+	struct obj *objs = malloc(BENCH_NR * sizeof(*objs));
+	unsigned int *order = malloc(BENCH_NR * sizeof(*order));
+	struct es_htable ht;
+	struct list_table lt;
+	unsigned long key, hits = 0;
+	double start, t[4];
+	unsigned int i, j, tmp;
+
+	if (!objs || !order)
+		return 1;
+
+	srand(1);
+	for (i = 0; i < BENCH_NR; i++) {
+		objs[i].key = ((unsigned long)rand() << 16) ^ rand();
+		objs[i].key = objs[i].key * 2;	/* odd keys always miss */
+		order[i] = i;
+	}
+	/* look up in random order, not in insertion order */
+	for (i = BENCH_NR - 1; i > 0; i--) {
+		j = rand() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	printf("%u objects, ns per operation \n", BENCH_NR);
+	printf("%-10s %13s %8s %8s %8s %8s \n", "table", "buckets",
+		"insert", "hit", "miss", "delete");
+
+	/* es_htable, grows from its minimal size on the way */
+	es_htable_init(&ht, &obj_ops, 0, 0);
+	start = now();
+	for (i = 0; i < BENCH_NR; i++)
+		es_htable_add(&ht, &objs[i].hnode);
+	t[0] = (now() - start) * 1e9 / BENCH_NR;
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++) {
+		key = objs[order[i]].key;
+		hits += es_htable_lookup(&ht, &key) != NULL;
+	}
+	t[1] = (now() - start) * 1e9 / BENCH_NR;
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++) {
+		key = objs[order[i]].key + 1;
+		hits += es_htable_lookup(&ht, &key) != NULL;
+	}
+	t[2] = (now() - start) * 1e9 / BENCH_NR;
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++)
+		es_htable_del(&ht, &objs[order[i]].hnode);
+	t[3] = (now() - start) * 1e9 / BENCH_NR;
+	report("es_htable", sizeof(struct es_hlist_head) << ht.bits, t);
+
+	/* es_list_head buckets, as many as es_htable ended up with */
+	lt.bits = ht.bits;
+	lt.buckets = malloc(sizeof(*lt.buckets) << lt.bits);
+	if (!lt.buckets)
+		return 1;
+	for (i = 0; i < (1U << lt.bits); i++)
+		INIT_ES_LIST_HEAD(&lt.buckets[i]);
+	es_htable_destroy(&ht);
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++)
+		es_list_add(&objs[i].lnode, list_bucket(&lt, objs[i].key));
+	t[0] = (now() - start) * 1e9 / BENCH_NR;
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++)
+		hits += list_lookup(&lt, objs[order[i]].key) != NULL;
+	t[1] = (now() - start) * 1e9 / BENCH_NR;
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++)
+		hits += list_lookup(&lt, objs[order[i]].key + 1) != NULL;
+	t[2] = (now() - start) * 1e9 / BENCH_NR;
+
+	start = now();
+	for (i = 0; i < BENCH_NR; i++)
+		es_list_del(&objs[order[i]].lnode);
+	t[3] = (now() - start) * 1e9 / BENCH_NR;
+	report("es_list", sizeof(struct es_list_head) << lt.bits, t);
+
+	printf("%lu hits \n", hits);
+	free(lt.buckets);
+	free(objs);
+	free(order);
+	return 0;
+}
+
@@ -0,0 +1,203 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_htable_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_htable.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "es_test.h"
+
+#define TEST_NR	10000
+
+struct obj {
+	unsigned int key;
+	unsigned int val;
+	struct es_hlist_node node;
+};
+
+static uint32_t key_hash(const void *key)
+{
+	/* identity, the table mixes the bits itself */
+	return *(const unsigned int *)key;
+}
+
+static uint32_t obj_hash(const struct es_hlist_node *node)
+{
+	return es_hlist_entry(node, struct obj, node)->key;
+}
+
+static int obj_match(const struct es_hlist_node *node, const void *key)
+{
+	return es_hlist_entry(node, struct obj, node)->key ==
+		*(const unsigned int *)key;
+}
+
+static const struct es_htable_ops obj_ops = {
+	.hashfn		= key_hash,
+	.obj_hashfn	= obj_hash,
+	.matchfn	= obj_match,
+};
+
+static struct obj *lookup(struct es_htable *ht, unsigned int key)
+{
+	struct es_hlist_node *node = es_htable_lookup(ht, &key);
+
+	return node ? es_hlist_entry(node, struct obj, node) : NULL;
+}
+
+static int test_basic(struct obj *objs)
+{
+	struct es_htable ht;
+	struct es_hlist_node *tmp;
+	struct obj *o, dup;
+	unsigned int i, bkt, n;
+
+	TEST_CHECK(es_htable_init(&ht, &obj_ops, 0, 0) == 0);
+	TEST_CHECK(es_htable_size(&ht) == 2);
+
+	for (i = 0; i < TEST_NR; i++) {
+		objs[i].key = i * 7919;
+		objs[i].val = i;
+		TEST_CHECK(es_htable_insert(&ht, &objs[i].node,
+			&objs[i].key) == NULL);
+	}
+	TEST_CHECK(es_htable_count(&ht) == TEST_NR);
+	TEST_CHECK(es_htable_size(&ht) >= TEST_NR);
+	TEST_CHECK(es_htable_size(&ht) <= 2 * TEST_NR);
+
+	/* a duplicate key is refused and the holder returned */
+	dup.key = 5 * 7919;
+	TEST_CHECK(es_htable_insert(&ht, &dup.node, &dup.key) ==
+		&objs[5].node);
+
+	for (i = 0; i < TEST_NR; i++) {
+		o = lookup(&ht, i * 7919);
+		TEST_CHECK(o && o->val == i);
+		TEST_CHECK(!lookup(&ht, i * 7919 + 1));
+	}
+
+	/* drop the odd ones while walking, then fit the array */
+	n = 0;
+	es_htable_for_each_entry_safe(&ht, bkt, tmp, o, node) {
+		if (o->val & 1)
+			es_htable_del(&ht, &o->node);
+		n++;
+	}
+	TEST_CHECK(n == TEST_NR);
+	TEST_CHECK(es_htable_count(&ht) == TEST_NR / 2);
+	TEST_CHECK(es_htable_resize(&ht, 0) == 0);
+	TEST_CHECK(es_htable_size(&ht) < TEST_NR);
+
+	for (i = 0; i < TEST_NR; i++)
+		TEST_CHECK((lookup(&ht, i * 7919) == NULL) == (i & 1));
+
+	for (i = 0; i < TEST_NR; i += 2)
+		TEST_CHECK(es_htable_remove(&ht, &objs[i].key) == &objs[i].node);
+	TEST_CHECK(es_htable_count(&ht) == 0);
+	TEST_CHECK(es_htable_remove(&ht, &objs[0].key) == NULL);
+
+	n = 0;
+	es_htable_for_each_entry(&ht, bkt, o, node)
+		n++;
+	TEST_CHECK(n == 0);
+
+	es_htable_destroy(&ht);
+	return 0;
+}
+
+static int test_fixed(struct obj *objs)
+{
+	struct es_htable ht;
+	struct obj *o;
+	unsigned int i, n = 0;
+
+	TEST_CHECK(es_htable_init(&ht, &obj_ops, 16, ES_HTABLE_F_FIXED) == 0);
+	TEST_CHECK(es_htable_size(&ht) == 16);
+
+	/* duplicates through es_htable_add, all on one chain */
+	for (i = 0; i < 100; i++) {
+		objs[i].key = 42;
+		objs[i].val = i;
+		es_htable_add(&ht, &objs[i].node);
+	}
+	TEST_CHECK(es_htable_size(&ht) == 16);
+	TEST_CHECK(lookup(&ht, 42)->val == 99);
+
+	es_htable_for_each_possible(&ht, o, node, 42) {
+		if (o->key == 42)
+			n++;
+	}
+	TEST_CHECK(n == 100);
+
+	es_htable_destroy(&ht);
+	TEST_CHECK(es_htable_init(&ht, NULL, 0, 0) == ES_INVALID_PARAM);
+	return 0;
+}
+
+/* duplicates keep their order when the table grows and shrinks */
+static int test_dup_resize(struct obj *objs)
+{
+	struct es_htable ht;
+	struct obj *o;
+	unsigned int i, last;
+
+	TEST_CHECK(es_htable_init(&ht, &obj_ops, 0, 0) == 0);
+	for (i = 0; i < 1000; i++) {
+		/* every fourth one shares the key, the rest make it grow */
+		objs[i].key = i % 4 ? 1000 + i : 42;
+		objs[i].val = i;
+		es_htable_add(&ht, &objs[i].node);
+		TEST_CHECK(lookup(&ht, 42)->val == i / 4 * 4);
+	}
+	TEST_CHECK(es_htable_size(&ht) >= 1000);
+
+	/* newest first along the chain */
+	last = ~0U;
+	es_htable_for_each_possible(&ht, o, node, 42) {
+		if (o->key != 42)
+			continue;
+		TEST_CHECK(o->val < last);
+		last = o->val;
+	}
+	TEST_CHECK(last == 0);
+
+	for (i = 0; i < 1000; i++)
+		if (i % 4)
+			es_htable_del(&ht, &objs[i].node);
+	TEST_CHECK(es_htable_resize(&ht, 0) == 0);
+	TEST_CHECK(lookup(&ht, 42)->val == 996);
+
+	es_htable_destroy(&ht);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	struct obj *objs = calloc(TEST_NR, sizeof(*objs));
+
+	if (!objs || test_basic(objs) || test_fixed(objs) ||
+	    test_dup_resize(objs))
+		return 1;
+
+	free(objs);
+	printf("es_htable test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,196 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_idr_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_idr.h>
+#include <es_list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Handle tables with n live IDs, es_idr against what they replace:
+ *  - an es_list of handles scanned for the ID
+ *  - a plain array indexed by ID, scanned for the first free slot
+ * Lookups of random live IDs, and churn: free a random ID and allocate
+ * the lowest free one. The scans are linear, they stop at
+ * BENCH_SCAN_MAX handles.
+ *
+ * Then the memory per ID of es_idr for dense IDs and for IDs spread
+ * over 2^32, where a flat array would need 32G.
+ */
+
+#define BENCH_MAX	(1U << 20)
+#define BENCH_SCAN_MAX	(1U << 14)
+#define BENCH_OPS	(1U << 18)
+
+struct handle {
+	unsigned long id;
+	struct es_list_head list;
+};
+
+static struct handle *handles;
+static unsigned int *picks;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned int rand32(void)
+{
+	return ((unsigned int)rand() << 16) ^ rand();
+}
+
+static struct handle *list_find(struct es_list_head *head, unsigned long id)
+{
+	struct handle *h;
+
+	es_list_for_each_entry(h, head, list)
+		if (h->id == id)
+			return h;
+	return NULL;
+}
+
+static void bench(unsigned int n)
+{
+	struct es_idr idr;
+	struct handle *h, **array;
+	unsigned long id, sum = 0;
+	unsigned int i, ops;
+	double t_find, t_churn, t_lfind, t_afind, t_achurn;
+	ES_LIST_HEAD(head);
+
+	for (i = 0; i < BENCH_OPS; i++)
+		picks[i] = rand32() % n;
+
+	es_idr_init(&idr);
+	for (i = 0; i < n; i++) {
+		id = 0;
+		es_idr_alloc(&idr, &handles[i], &id, ~0UL);
+		handles[i].id = id;
+	}
+	t_find = now();
+	for (i = 0; i < BENCH_OPS; i++) {
+		h = es_idr_find(&idr, picks[i]);
+		sum += h->id;
+	}
+	t_find = now() - t_find;
+	t_churn = now();
+	for (i = 0; i < BENCH_OPS; i++) {
+		h = es_idr_remove(&idr, picks[i]);
+		id = 0;
+		es_idr_alloc(&idr, h, &id, ~0UL);
+		sum += id;
+	}
+	t_churn = now() - t_churn;
+	es_idr_destroy(&idr);
+
+	if (n > BENCH_SCAN_MAX) {
+		printf("%9u %10.1f %10s %10s %12.1f %12s \n", n,
+			t_find * 1e9 / BENCH_OPS, "-", "-",
+			t_churn * 1e9 / BENCH_OPS, "-");
+		return;
+	}
+
+	ops = BENCH_OPS / (n / 256 + 1);
+	for (i = 0; i < n; i++)
+		es_list_add_tail(&handles[i].list, &head);
+	t_lfind = now();
+	for (i = 0; i < ops; i++)
+		sum += list_find(&head, picks[i])->id;
+	t_lfind = now() - t_lfind;
+
+	array = calloc(n, sizeof(*array));
+	if (!array)
+		return;
+	for (i = 0; i < n; i++)
+		array[handles[i].id] = &handles[i];
+	t_afind = now();
+	for (i = 0; i < BENCH_OPS; i++)
+		sum += array[picks[i]]->id;
+	t_afind = now() - t_afind;
+	t_achurn = now();
+	for (i = 0; i < ops; i++) {
+		h = array[picks[i]];
+		array[picks[i]] = NULL;
+		for (id = 0; array[id]; id++)
+			;
+		array[id] = h;
+		sum += id;
+	}
+	t_achurn = now() - t_achurn;
+	free(array);
+
+	printf("%9u %10.1f %10.1f %10.1f %12.1f %12.1f \n", n,
+		t_find * 1e9 / BENCH_OPS, t_lfind * 1e9 / ops,
+		t_afind * 1e9 / BENCH_OPS, t_churn * 1e9 / BENCH_OPS,
+		t_achurn * 1e9 / ops);
+	if (!sum)
+		printf("no sum \n");
+}
+
+static void bench_memory(unsigned int n, unsigned long space)
+{
+	struct es_idr idr;
+	unsigned long id;
+	unsigned int i;
+
+	es_idr_init(&idr);
+	for (i = 0; i < n; i++) {
+		id = space ? rand32() % space : 0;
+		es_idr_alloc(&idr, &handles[i], &id, ~0UL);
+	}
+	printf("%9u %14lu %10lu %10.1f \n", n, space ? space : n,
+		idr.nr_nodes,
+		(double)idr.nr_nodes * sizeof(struct es_idr_node) / n);
+	es_idr_destroy(&idr);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int n;
+
+	handles = malloc(BENCH_MAX * sizeof(*handles));
+	picks = malloc(BENCH_OPS * sizeof(*picks));
+	if (!handles || !picks)
+		return 1;
+	srand(24);
+
+	printf("ns per op \n");
+	printf("%9s %10s %10s %10s %12s %12s \n", "ids", "idr find",
+		"list find", "array find", "idr realloc", "array realloc");
+	for (n = 1024; n <= BENCH_MAX; n *= 4)
+		bench(n);
+
+	printf("\nmemory \n");
+	printf("%9s %14s %10s %10s \n", "ids", "space", "nodes", "bytes/id");
+	bench_memory(BENCH_MAX, 0);
+	bench_memory(BENCH_MAX / 16, 0);
+	bench_memory(BENCH_MAX / 16, 1UL << 32);
+	bench_memory(BENCH_MAX / 16, 1UL << 24);
+
+	free(handles);
+	free(picks);
+	return 0;
+}
+
@@ -0,0 +1,276 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_idr_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_idr.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+#define TEST_IDS	20000
+#define TEST_READERS	3
+
+struct obj {
+	unsigned long id;
+	unsigned int magic;
+};
+
+#define OBJ_ALIVE	0x600d
+#define OBJ_DEAD	0xdead
+
+static struct obj objs[TEST_IDS];
+static void *model[TEST_IDS];	/* pointer of each ID, NULL if free */
+
+/* the lowest free ID of the model in [start, max] */
+static unsigned long model_free(unsigned long start, unsigned long max)
+{
+	unsigned long i;
+
+	for (i = start; i <= max && i < TEST_IDS; i++)
+		if (!model[i])
+			return i;
+	return i;
+}
+
+static int check_model(struct es_idr *idr)
+{
+	unsigned long id, i, n = 0;
+	void *entry;
+
+	for (i = 0; i < TEST_IDS; i++)
+		TEST_CHECK(es_idr_find(idr, i) == model[i]);
+
+	/* the iteration sees the same IDs, in order */
+	i = 0;
+	es_idr_for_each_entry(idr, entry, id) {
+		while (i < id)
+			TEST_CHECK(!model[i++]);
+		TEST_CHECK(model[i++] == entry);
+		n++;
+	}
+	while (i < TEST_IDS)
+		TEST_CHECK(!model[i++]);
+	TEST_CHECK(es_idr_is_empty(idr) == !n);
+	return 0;
+}
+
+static int test_model(void)
+{
+	struct es_idr idr;
+	unsigned long id, start, max, want;
+	unsigned int r, i;
+	int ret;
+
+	es_idr_init(&idr);
+	TEST_CHECK(es_idr_is_empty(&idr));
+	TEST_CHECK(!es_idr_find(&idr, 0));
+	id = 0;
+	TEST_CHECK(es_idr_alloc(&idr, NULL, &id, 10) == ES_INVALID_PARAM);
+	id = 11;
+	TEST_CHECK(es_idr_alloc(&idr, &objs[0], &id, 10) == ES_INVALID_PARAM);
+
+	srand(24);
+	for (r = 0; r < 40; r++) {
+		/* fill densely, then free a random share */
+		for (i = 0; i < TEST_IDS / 4; i++) {
+			start = rand() % 8 ? 0 : rand() % TEST_IDS;
+			max = rand() % 8 ? TEST_IDS - 1 : start + rand() % 64;
+			want = model_free(start, max);
+			id = start;
+			ret = es_idr_alloc(&idr, &objs[i], &id, max);
+			if (want > max) {
+				TEST_CHECK(ret == ES_FAIL);
+				continue;
+			}
+			TEST_CHECK(ret == ES_SUCCESS);
+			TEST_CHECK(id == want);
+			/* past the model, give it back */
+			if (want >= TEST_IDS)
+				TEST_CHECK(es_idr_remove(&idr, id) == &objs[i]);
+			else
+				model[id] = &objs[i];
+		}
+		for (i = 0; i < TEST_IDS; i++) {
+			if (!model[i] || rand() % 3)
+				continue;
+			TEST_CHECK(es_idr_remove(&idr, i) == model[i]);
+			TEST_CHECK(!es_idr_remove(&idr, i));
+			model[i] = NULL;
+		}
+		if (check_model(&idr))
+			return -1;
+	}
+
+	/* replace only touches allocated IDs */
+	id = model_free(0, TEST_IDS - 1);
+	TEST_CHECK(!es_idr_replace(&idr, &objs[1], id));
+	TEST_CHECK(!es_idr_find(&idr, id));
+	TEST_CHECK(es_idr_alloc(&idr, &objs[0], &id, id) == ES_SUCCESS);
+	TEST_CHECK(es_idr_alloc(&idr, &objs[0], &id, id) == ES_FAIL);
+	TEST_CHECK(es_idr_replace(&idr, &objs[1], id) == &objs[0]);
+	TEST_CHECK(es_idr_find(&idr, id) == &objs[1]);
+	model[id] = &objs[1];
+	if (check_model(&idr))
+		return -1;
+
+	/* emptied nodes are freed by es_idr_shrink() only */
+	for (i = 0; i < TEST_IDS; i++)
+		if (model[i]) {
+			es_idr_remove(&idr, i);
+			model[i] = NULL;
+		}
+	TEST_CHECK(es_idr_is_empty(&idr));
+	TEST_CHECK(idr.nr_nodes > 0);
+	es_idr_shrink(&idr);
+	TEST_CHECK(!idr.nr_nodes && !idr.root);
+	es_idr_destroy(&idr);
+	return 0;
+}
+
+/* IDs all over the range of unsigned long */
+static int test_sparse(void)
+{
+	static const unsigned long ids[] = {
+		0, 63, 64, 4095, 4096, 1UL << 30, (1UL << 40) + 5,
+		~0UL >> 1, ~0UL - 64, ~0UL - 1, ~0UL,
+	};
+	ES_DEFINE_IDR(idr);
+	unsigned long id, n = sizeof(ids) / sizeof(ids[0]), i;
+	void *entry;
+
+	for (i = n; i-- > 0;) {
+		id = ids[i];
+		TEST_CHECK(es_idr_alloc(&idr, &objs[i], &id, ids[i]) == 0);
+		TEST_CHECK(id == ids[i]);
+	}
+	for (i = 0; i < n; i++)
+		TEST_CHECK(es_idr_find(&idr, ids[i]) == &objs[i]);
+	TEST_CHECK(!es_idr_find(&idr, 1));
+	TEST_CHECK(!es_idr_find(&idr, ~0UL - 2));
+
+	i = 0;
+	es_idr_for_each_entry(&idr, entry, id) {
+		TEST_CHECK(id == ids[i] && entry == &objs[i]);
+		if (id == ~0UL)
+			break;
+		i++;
+	}
+	TEST_CHECK(i == n - 1);
+
+	/* the lowest free ID above a start, and none at the very top */
+	id = 63;
+	TEST_CHECK(es_idr_alloc(&idr, &objs[0], &id, ~0UL) == 0 && id == 65);
+	id = ~0UL - 1;
+	TEST_CHECK(es_idr_alloc(&idr, &objs[0], &id, ~0UL) == ES_FAIL);
+	id = ~0UL - 64;
+	TEST_CHECK(es_idr_alloc(&idr, &objs[0], &id, ~0UL) == 0 &&
+		id == ~0UL - 63);
+
+	/* the tree gets low again once the high IDs are gone */
+	for (i = 0; i < n; i++)
+		if (ids[i] > 4096)
+			TEST_CHECK(es_idr_remove(&idr, ids[i]) == &objs[i]);
+	es_idr_remove(&idr, ~0UL - 63);
+	es_idr_shrink(&idr);
+	/* 4096 needs two levels */
+	TEST_CHECK(idr.root->shift == 2 * ES_IDR_BITS);
+	TEST_CHECK(es_idr_find(&idr, 4096) == &objs[4]);
+	TEST_CHECK(es_idr_find(&idr, 65) == &objs[0]);
+	es_idr_destroy(&idr);
+	return 0;
+}
+
+static ES_DEFINE_IDR(shared);
+static struct obj reserved;	/* holds an ID until its object is ready */
+static volatile int stop;
+static volatile int bad;
+
+static void *reader(void *arg)
+{
+	unsigned long id, n = 0;
+	struct obj *o;
+
+	while (!stop) {
+		id = rand() % TEST_IDS;
+		es_rcu_read_lock();
+		o = es_idr_find(&shared, id);
+		if (o && o != &reserved &&
+		    (ES_READ_ONCE(o->magic) != OBJ_ALIVE ||
+		     ES_READ_ONCE(o->id) != id))
+			bad = 1;
+		es_rcu_read_unlock();
+		if (++n % 256 == 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+/*
+ * readers look IDs up while the writer allocates, removes and shrinks,
+ * a pointer found is always the live object of that ID
+ */
+static int test_concurrent(void)
+{
+	pthread_t tid[TEST_READERS];
+	unsigned int i, r;
+	unsigned long id;
+
+	for (i = 0; i < TEST_READERS; i++)
+		TEST_CHECK(pthread_create(&tid[i], NULL, reader, NULL) == 0);
+
+	for (r = 0; r < 20; r++) {
+		for (i = 0; i < TEST_IDS; i++) {
+			id = rand() % TEST_IDS;
+			TEST_CHECK(es_idr_alloc(&shared, &reserved, &id,
+				~0UL) == 0);
+			objs[i].magic = OBJ_ALIVE;
+			objs[i].id = id;
+			/* published complete */
+			TEST_CHECK(es_idr_replace(&shared, &objs[i], id) ==
+				&reserved);
+		}
+		for (i = 0; i < TEST_IDS; i++)
+			es_idr_remove(&shared, objs[i].id);
+		es_synchronize_rcu();
+		for (i = 0; i < TEST_IDS; i++) {
+			objs[i].magic = OBJ_DEAD;
+			objs[i].id = ~0UL;
+		}
+		es_idr_shrink(&shared);
+	}
+
+	stop = 1;
+	for (i = 0; i < TEST_READERS; i++)
+		pthread_join(tid[i], NULL);
+	TEST_CHECK(!bad);
+	TEST_CHECK(!shared.root);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_model() || test_sparse() || test_concurrent())
+		return 1;
+
+	printf("es_idr test OK! \n");
+	return 0;
+}
+
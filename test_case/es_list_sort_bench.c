@@ -0,0 +1,197 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_list_sort_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * es_list_sort() against copying the entries into an array, qsort() and
+ * relinking, from 1K to 10M nodes. The nodes are linked in random
+ * memory order as a list built over time would be, and in memory order,
+ * which favours the pointer chasing of the merges. Also es_list_merge()
+ * of two sorted halves.
+ */
+
+#define BENCH_MAX	(10 * 1000 * 1000)
+
+struct elem {
+	unsigned int key;
+	struct es_list_head list;
+};
+
+static struct elem *elems;
+static unsigned int *order;
+static struct es_list_head **array;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int elem_cmp(void *priv, const struct es_list_head *a,
+			const struct es_list_head *b)
+{
+	return es_list_entry(a, struct elem, list)->key >
+		es_list_entry(b, struct elem, list)->key;
+}
+
+static int elem_qsort_cmp(const void *a, const void *b)
+{
+	unsigned int ka, kb;
+
+	ka = es_list_entry(*(struct es_list_head * const *)a,
+			struct elem, list)->key;
+	kb = es_list_entry(*(struct es_list_head * const *)b,
+			struct elem, list)->key;
+	return (ka > kb) - (ka < kb);
+}
+
+/* link @n nodes with random keys, in random or in memory order */
+static void build(struct es_list_head *head, unsigned int n, int shuffled)
+{
+	unsigned int i, j, t;
+
+	for (i = 0; i < n; i++)
+		order[i] = i;
+	if (shuffled) {
+		for (i = n - 1; i > 0; i--) {
+			j = rand() % (i + 1);
+			t = order[i];
+			order[i] = order[j];
+			order[j] = t;
+		}
+	}
+
+	INIT_ES_LIST_HEAD(head);
+	for (i = 0; i < n; i++) {
+		elems[order[i]].key = rand();
+		es_list_add_tail(&elems[order[i]].list, head);
+	}
+}
+
+static double bench_qsort(struct es_list_head *head, unsigned int n)
+{
+	struct es_list_head *pos;
+	double start = now();
+	unsigned int i = 0;
+
+	es_list_for_each(pos, head)
+		array[i++] = pos;
+	qsort(array, n, sizeof(*array), elem_qsort_cmp);
+	INIT_ES_LIST_HEAD(head);
+	for (i = 0; i < n; i++)
+		es_list_add_tail(array[i], head);
+	return now() - start;
+}
+
+static double bench_sort(struct es_list_head *head)
+{
+	double start = now();
+
+	es_list_sort(NULL, head, elem_cmp);
+	return now() - start;
+}
+
+static double bench_merge(struct es_list_head *head, unsigned int n)
+{
+	struct es_list_head *pos;
+	unsigned int i = 0;
+	double start;
+	ES_LIST_HEAD(other);
+
+	/* two sorted halves, interleaved in memory */
+	es_list_for_each(pos, head)
+		if (++i == n / 2)
+			break;
+	es_list_cut_position(&other, head, pos);
+	es_list_sort(NULL, &other, elem_cmp);
+	es_list_sort(NULL, head, elem_cmp);
+
+	start = now();
+	es_list_merge(NULL, head, &other, elem_cmp);
+	return now() - start;
+}
+
+static int check(struct es_list_head *head)
+{
+	struct elem *e;
+	unsigned int last = 0;
+
+	es_list_for_each_entry(e, head, list) {
+		if (e->key < last)
+			return -1;
+		last = e->key;
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int sizes[] = {
+		1000, 10000, 100000, 1000000, 10000000,
+	};
+	unsigned int i, n, rounds, r, shuffled;
+	double t_qsort, t_sort, t_merge;
+	ES_LIST_HEAD(head);
+
+	elems = malloc(BENCH_MAX * sizeof(*elems));
+	order = malloc(BENCH_MAX * sizeof(*order));
+	array = malloc(BENCH_MAX * sizeof(*array));
+	if (!elems || !order || !array)
+		return 1;
+	srand(21);
+
+	printf("ns per node \n");
+	printf("%9s %9s %12s %12s %12s \n", "nodes", "layout", "qsort+relink",
+		"es_list_sort", "es_list_merge");
+	for (shuffled = 0; shuffled < 2; shuffled++) {
+		for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+			n = sizes[i];
+			rounds = n < 100000 ? 1000000 / n : 1;
+			t_qsort = t_sort = t_merge = 0;
+			for (r = 0; r < rounds; r++) {
+				build(&head, n, shuffled);
+				t_qsort += bench_qsort(&head, n);
+				build(&head, n, shuffled);
+				t_sort += bench_sort(&head);
+				if (check(&head))
+					printf("not sorted \n");
+				build(&head, n, shuffled);
+				t_merge += bench_merge(&head, n);
+			}
+			printf("%9u %9s %12.1f %12.1f %12.1f \n", n,
+				shuffled ? "random" : "memory",
+				t_qsort * 1e9 / rounds / n,
+				t_sort * 1e9 / rounds / n,
+				t_merge * 1e9 / rounds / n);
+		}
+	}
+
+	free(elems);
+	free(order);
+	free(array);
+	return 0;
+}
+
@@ -20,12 +20,185 @@
 *******************************************************************************/
 #include <es_list.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+struct item {
+	int val;
+	struct es_hlist_node node;
+};
+
+/* concatenated values of the es_hlist, 0 for an empty one */
+static int hlist_digits(struct es_hlist_head *head)
+{
+	struct item *it;
+	int ret = 0;
+
+	es_hlist_for_each_entry(it, head, node)
+		ret = ret * 10 + it->val;
+	return ret;
+}
+
+static int test_hlist(void)
+{
+	ES_HLIST_HEAD(head);
+	struct es_hlist_head other = ES_HLIST_HEAD_INIT;
+	struct item items[5], *it;
+	struct es_hlist_node *tmp;
+	int i;
+
+	for (i = 0; i < 5; i++) {
+		items[i].val = i + 1;
+		INIT_ES_HLIST_NODE(&items[i].node);
+		TEST_CHECK(es_hlist_unhashed(&items[i].node));
+	}
+	TEST_CHECK(es_hlist_empty(&head));
+
+	es_hlist_add_head(&items[2].node, &head);
+	es_hlist_add_head(&items[0].node, &head);
+	es_hlist_add_behind(&items[3].node, &items[2].node);
+	es_hlist_add_before(&items[1].node, &items[2].node);
+	es_hlist_add_behind(&items[4].node, &items[3].node);
+	TEST_CHECK(hlist_digits(&head) == 12345);
+
+	es_hlist_del(&items[0].node);
+	es_hlist_del_init(&items[2].node);
+	es_hlist_del_init(&items[2].node);
+	TEST_CHECK(es_hlist_unhashed(&items[2].node));
+	es_hlist_del(&items[4].node);
+	TEST_CHECK(hlist_digits(&head) == 24);
+
+	es_hlist_move_list(&head, &other);
+	TEST_CHECK(es_hlist_empty(&head) && hlist_digits(&other) == 24);
+
+	es_hlist_for_each_entry_safe(it, tmp, &other, node)
+		es_hlist_del_init(&it->node);
+	TEST_CHECK(es_hlist_empty(&other));
+	return 0;
+}
+
+struct elem {
+	unsigned int key;
+	unsigned int seq;	/* insertion order, checks stability */
+	struct es_list_head list;
+};
+
+static int elem_cmp(void *priv, const struct es_list_head *a,
+			const struct es_list_head *b)
+{
+	if (priv)
+		(*(unsigned long *)priv)++;
+	return es_list_entry(a, struct elem, list)->key >
+		es_list_entry(b, struct elem, list)->key;
+}
+
+/* sorted by key, equal keys in seq order, prev links intact */
+static int check_sorted(struct es_list_head *head, unsigned int n)
+{
+	struct es_list_head *pos;
+	struct elem *e, *prev = NULL;
+	unsigned int count = 0;
+
+	es_list_for_each(pos, head) {
+		TEST_CHECK(pos->next->prev == pos);
+		e = es_list_entry(pos, struct elem, list);
+		if (prev) {
+			TEST_CHECK(prev->key <= e->key);
+			TEST_CHECK(prev->key < e->key || prev->seq < e->seq);
+		}
+		prev = e;
+		count++;
+	}
+	TEST_CHECK(head->next->prev == head);
+	TEST_CHECK(count == n);
+	return 0;
+}
+
+static int test_sort(void)
+{
+	static const unsigned int sizes[] = {
+		0, 1, 2, 3, 7, 8, 9, 100, 1023, 1024, 1025, 10000,
+	};
+	struct elem *elems;
+	unsigned long ncmp;
+	unsigned int i, j, n, log2n, mode;
+	ES_LIST_HEAD(head);
+
+	elems = malloc(10000 * sizeof(*elems));
+	TEST_CHECK(elems);
+	srand(21);
+
+	for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+		n = sizes[j];
+		/* random with many dups, sorted, reversed, all equal */
+		for (mode = 0; mode < 4; mode++) {
+			INIT_ES_LIST_HEAD(&head);
+			for (i = 0; i < n; i++) {
+				switch (mode) {
+				case 0:
+					elems[i].key = rand() % (n / 4 + 1);
+					break;
+				case 1:
+					elems[i].key = i;
+					break;
+				case 2:
+					elems[i].key = n - i;
+					break;
+				default:
+					elems[i].key = 7;
+				}
+				elems[i].seq = i;
+				es_list_add_tail(&elems[i].list, &head);
+			}
+
+			ncmp = 0;
+			es_list_sort(&ncmp, &head, elem_cmp);
+			if (check_sorted(&head, n))
+				return -1;
+
+			for (log2n = 0; (1U << log2n) < n; log2n++)
+				;
+			TEST_CHECK(ncmp <= (unsigned long)n * log2n);
+		}
+	}
+
+	free(elems);
+	return 0;
+}
+
+static int test_merge(void)
+{
+	struct elem elems[300];
+	unsigned int i, na;
+	ES_LIST_HEAD(a);
+	ES_LIST_HEAD(b);
+
+	for (na = 0; na <= 300; na += 50) {
+		INIT_ES_LIST_HEAD(&a);
+		INIT_ES_LIST_HEAD(&b);
+		/* seq follows the lists, a first, so ties keep a before b */
+		for (i = 0; i < 300; i++) {
+			elems[i].key = (i < na ? i * 3 : (i - na) * 2) / 5;
+			elems[i].seq = i;
+			es_list_add_tail(&elems[i].list, i < na ? &a : &b);
+		}
+
+		es_list_merge(NULL, &a, &b, elem_cmp);
+		TEST_CHECK(es_list_empty(&b));
+		if (check_sorted(&a, 300))
+			return -1;
+	}
+	return 0;
+}
 
 int main(int argc, char **argv)
 {
 	ES_LIST_HEAD(test_list);
 
 	INIT_ES_LIST_HEAD(&test_list);
+	if (test_hlist() || test_sort() || test_merge())
+		return 1;
+
 	printf("es_list test OK! \n");
 	return 0;
 }
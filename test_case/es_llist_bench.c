@@ -0,0 +1,140 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_llist_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_list.h>
+#include <es_llist.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Many producers hand nodes to one consumer which takes them all at
+ * once: es_llist against es_list_add_tail() and a splice under a mutex.
+ */
+
+#define BENCH_NODES	1000000	/* per producer */
+
+struct item {
+	unsigned long val;
+	struct es_llist_node lnode;
+	struct es_list_head node;
+};
+
+static ES_LLIST_HEAD(lqueue);
+static ES_LIST_HEAD(queue);
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct item *items;
+static unsigned int producers_left;
+static int use_llist;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *producer(void *arg)
+{
+	struct item *it = items + (unsigned long)arg * BENCH_NODES;
+	unsigned int i;
+
+	for (i = 0; i < BENCH_NODES; i++) {
+		if (use_llist) {
+			es_llist_add(&it[i].lnode, &lqueue);
+		} else {
+			pthread_mutex_lock(&queue_lock);
+			es_list_add_tail(&it[i].node, &queue);
+			pthread_mutex_unlock(&queue_lock);
+		}
+	}
+	es_atomic_fetch_sub(&producers_left, 1);
+	return NULL;
+}
+
+static unsigned long consume(void)
+{
+	struct es_llist_node *batch;
+	struct item *pos, *n;
+	unsigned long sum = 0;
+	ES_LIST_HEAD(local);
+
+	if (use_llist) {
+		batch = es_llist_reverse_order(es_llist_del_all(&lqueue));
+		es_llist_for_each_entry(pos, batch, lnode)
+			sum += pos->val;
+		return sum;
+	}
+
+	pthread_mutex_lock(&queue_lock);
+	es_list_splice_init(&queue, &local);
+	pthread_mutex_unlock(&queue_lock);
+	es_list_for_each_entry_safe(pos, n, &local, node)
+		sum += pos->val;
+	return sum;
+}
+
+static double bench(unsigned int threads)
+{
+	pthread_t tid[8];
+	unsigned long sum = 0, i;
+	double start = now();
+	unsigned int left;
+
+	producers_left = threads;
+	for (i = 0; i < threads; i++)
+		pthread_create(&tid[i], NULL, producer, (void *)i);
+	do {
+		left = es_smp_load_acquire(&producers_left);
+		sum += consume();
+	} while (left);
+	for (i = 0; i < threads; i++)
+		pthread_join(tid[i], NULL);
+
+	if (sum != (unsigned long)threads * BENCH_NODES)
+		printf("lost nodes: %lu \n", sum);
+	return (now() - start) * 1e9 / ((double)threads * BENCH_NODES);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int threads[] = {1, 2, 4, 8};
+	unsigned int i;
+
+	items = malloc(sizeof(*items) * 8 * BENCH_NODES);
+	if (!items)
+		return 1;
+	for (i = 0; i < 8 * BENCH_NODES; i++)
+		items[i].val = 1;
+
+	printf("ns per node handed over \n");
+	printf("%9s %10s %12s \n", "producers", "es_llist", "mutex+list");
+	for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		use_llist = 1;
+		printf("%9u %10.1f", threads[i], bench(threads[i]));
+		use_llist = 0;
+		printf(" %12.1f \n", bench(threads[i]));
+	}
+	free(items);
+	return 0;
+}
+
@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_llist_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_llist.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+#define TEST_PRODUCERS	4
+#define TEST_NODES	100000	/* per producer */
+#define TEST_BATCH	4
+
+struct item {
+	unsigned int producer;
+	unsigned int seq;
+	struct es_llist_node node;
+};
+
+static int test_basic(void)
+{
+	ES_LLIST_HEAD(head);
+	struct item items[5], *pos, *n;
+	struct es_llist_node *first;
+	unsigned int i, cnt;
+
+	TEST_CHECK(es_llist_empty(&head));
+	TEST_CHECK(!es_llist_del_first(&head) && !es_llist_del_all(&head));
+
+	for (i = 0; i < 5; i++) {
+		items[i].seq = i;
+		es_init_llist_node(&items[i].node);
+		TEST_CHECK(!es_llist_on_list(&items[i].node));
+		TEST_CHECK(es_llist_add(&items[i].node, &head) == (i == 0));
+		TEST_CHECK(es_llist_on_list(&items[i].node));
+	}
+
+	/* newest first */
+	first = es_llist_del_first(&head);
+	TEST_CHECK(es_llist_entry(first, struct item, node)->seq == 4);
+
+	first = es_llist_del_all(&head);
+	TEST_CHECK(es_llist_empty(&head));
+	cnt = 4;
+	es_llist_for_each_entry(pos, first, node)
+		TEST_CHECK(pos->seq == --cnt);
+	TEST_CHECK(cnt == 0);
+
+	/* oldest first after reversing */
+	first = es_llist_reverse_order(first);
+	cnt = 0;
+	es_llist_for_each_entry_safe(pos, n, first, node) {
+		TEST_CHECK(pos->seq == cnt++);
+		pos->node.next = NULL;
+	}
+	TEST_CHECK(cnt == 4);
+	TEST_CHECK(es_llist_reverse_order(NULL) == NULL);
+
+	/* the lock-free and the plain variants mix */
+	TEST_CHECK(__es_llist_add(&items[0].node, &head));
+	TEST_CHECK(!es_llist_add(&items[1].node, &head));
+	TEST_CHECK(__es_llist_del_all(&head) == &items[1].node);
+	TEST_CHECK(items[1].node.next == &items[0].node);
+	return 0;
+}
+
+static ES_LLIST_HEAD(queue);
+static struct item *items;
+static unsigned int done_producers;
+
+static void *producer(void *arg)
+{
+	unsigned int id = (unsigned long)arg, i, k;
+	struct item *it = items + id * TEST_NODES;
+
+	for (i = 0; i < TEST_NODES; i += TEST_BATCH) {
+		if ((i / TEST_BATCH) & 1) {
+			/* a pre-linked batch, newest first like the list */
+			for (k = TEST_BATCH - 1; k > 0; k--)
+				it[i + k].node.next = &it[i + k - 1].node;
+			es_llist_add_batch(&it[i + TEST_BATCH - 1].node,
+				&it[i].node, &queue);
+		} else {
+			for (k = 0; k < TEST_BATCH; k++)
+				es_llist_add(&it[i + k].node, &queue);
+		}
+		if (i % 1024 == 0)
+			sched_yield();
+	}
+	es_atomic_fetch_add(&done_producers, 1);
+	return NULL;
+}
+
+/* many producers, one consumer taking everything at once */
+static int test_mpsc(void)
+{
+	pthread_t tid[TEST_PRODUCERS];
+	unsigned int next[TEST_PRODUCERS] = {0}, i, j, total = 0, finished;
+	struct es_llist_node *batch;
+	struct item *pos;
+
+	items = malloc(sizeof(*items) * TEST_PRODUCERS * TEST_NODES);
+	TEST_CHECK(items);
+	for (i = 0; i < TEST_PRODUCERS; i++) {
+		for (j = 0; j < TEST_NODES; j++) {
+			items[i * TEST_NODES + j].producer = i;
+			items[i * TEST_NODES + j].seq = j;
+		}
+	}
+	for (i = 0; i < TEST_PRODUCERS; i++)
+		TEST_CHECK(pthread_create(&tid[i], NULL, producer,
+			(void *)(unsigned long)i) == 0);
+
+	do {
+		finished = es_smp_load_acquire(&done_producers);
+		batch = es_llist_reverse_order(es_llist_del_all(&queue));
+		/* in order per producer, nothing lost, nothing twice */
+		es_llist_for_each_entry(pos, batch, node) {
+			TEST_CHECK(pos->seq == next[pos->producer]);
+			next[pos->producer]++;
+			total++;
+		}
+	} while (finished < TEST_PRODUCERS || !es_llist_empty(&queue));
+
+	for (i = 0; i < TEST_PRODUCERS; i++) {
+		pthread_join(tid[i], NULL);
+		TEST_CHECK(next[i] == TEST_NODES);
+	}
+	TEST_CHECK(total == TEST_PRODUCERS * TEST_NODES);
+	free(items);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_basic() || test_mpsc())
+		return 1;
+
+	printf("es_llist test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,168 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_memcpy_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo.h>
+#include <es_memcpy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Sweeps the transfer size for every es_memcpy_stream() implementation
+ * the cpu supports, then for an es_fifo pipe with and without
+ * ES_FIFO_F_STREAM. Sizes larger than the last level cache are where the
+ * streaming stores pay off.
+ */
+
+#define BENCH_BYTES	(512UL * 1024 * 1024)
+#define BENCH_MAX_LEN	(32UL * 1024 * 1024)
+#define BENCH_FIFO_SIZE	(4U * 1024 * 1024)
+#define BENCH_FIFO_BYTES	(256UL * 1024 * 1024)
+
+static struct es_fifo fifo;
+static unsigned int chunk;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double bench_copy(unsigned char *dst, const unsigned char *src,
+			size_t len, int small)
+{
+	unsigned long rounds = BENCH_BYTES / len, i;
+	double start = now();
+
+	/* walk the buffer so every round copies cold data once it is large */
+	for (i = 0; i < rounds; i++) {
+		size_t off = (i * len) % BENCH_MAX_LEN;
+
+		if (small)
+			es_memcpy_small(dst + off, src + off, len);
+		else
+			es_memcpy_stream(dst + off, src + off, len);
+	}
+	return (double)rounds * len / (now() - start) / (1024 * 1024);
+}
+
+static void *producer(void *arg)
+{
+	unsigned char *buf = arg;
+	unsigned long done = 0;
+	unsigned int ret;
+
+	while (done < BENCH_FIFO_BYTES) {
+		ret = es_fifo_in(&fifo, buf, chunk);
+		if (!ret)
+			sched_yield();
+		done += ret;
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	unsigned char *buf = arg;
+	unsigned long done = 0;
+	unsigned int ret;
+
+	while (done < BENCH_FIFO_BYTES) {
+		ret = es_fifo_out(&fifo, buf, chunk);
+		if (!ret)
+			sched_yield();
+		done += ret;
+	}
+	return NULL;
+}
+
+static double bench_fifo(unsigned char *in, unsigned char *out, int stream)
+{
+	pthread_t prod, cons;
+	double start;
+
+	es_fifo_reset(&fifo);
+	es_fifo_set_stream(&fifo, stream);
+
+	start = now();
+	pthread_create(&cons, NULL, consumer, out);
+	pthread_create(&prod, NULL, producer, in);
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+	return BENCH_FIFO_BYTES / (now() - start) / (1024 * 1024);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int chunks[] = {64, 1024, 16384, 262144, 1048576};
+	unsigned char *src, *dst;
+	enum es_memcpy_impl impl;
+	size_t len;
+	unsigned int i;
+
+	src = malloc(BENCH_MAX_LEN * 2);
+	dst = malloc(BENCH_MAX_LEN * 2);
+	if (!src || !dst || es_fifo_alloc(&fifo, BENCH_FIFO_SIZE))
+		return 1;
+	memset(src, 0x5a, BENCH_MAX_LEN * 2);
+	memset(dst, 0, BENCH_MAX_LEN * 2);
+
+	printf("%10s", "len");
+	printf(" %10s", "small");
+	for (impl = ES_MEMCPY_LIBC; impl < ES_MEMCPY_IMPL_MAX; impl++)
+		if (es_memcpy_impl_supported(impl))
+			printf(" %10s", es_memcpy_impl_name(impl));
+	printf("   (MB/s) \n");
+
+	for (len = 16; len <= BENCH_MAX_LEN; len *= 4) {
+		printf("%10zu", len);
+		if (len <= ES_MEMCPY_SMALL_MAX)
+			printf(" %10.0f", bench_copy(dst, src, len, 1));
+		else
+			printf(" %10s", "-");
+		for (impl = ES_MEMCPY_LIBC; impl < ES_MEMCPY_IMPL_MAX; impl++) {
+			if (es_memcpy_set_impl(impl))
+				continue;
+			printf(" %10.0f", bench_copy(dst, src, len, 0));
+		}
+		printf(" \n");
+	}
+
+	es_memcpy_set_impl(ES_MEMCPY_AUTO);
+	printf("\nes_fifo pipe, stream copy %s \n",
+		es_memcpy_impl_name(es_memcpy_get_impl()));
+	printf("%10s %14s %14s \n", "chunk", "memcpy MB/s", "stream MB/s");
+	for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+		chunk = chunks[i];
+		printf("%10u %14.1f", chunk, bench_fifo(src, dst, 0));
+		printf(" %14.1f \n", bench_fifo(src, dst, 1));
+	}
+
+	es_fifo_free(&fifo);
+	free(src);
+	free(dst);
+	return 0;
+}
+
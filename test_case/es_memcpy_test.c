@@ -0,0 +1,120 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_memcpy_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_memcpy.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "es_test.h"
+
+#define TEST_BUF_SIZE	(256 * 1024)
+
+static unsigned char *src, *dst;
+
+static void fill(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < TEST_BUF_SIZE; i++)
+		src[i] = (unsigned char)((i * 2654435761u) >> 24);
+	memset(dst, 0xa5, TEST_BUF_SIZE);
+}
+
+/* the copy must match and must not touch a byte around the destination */
+static int check(size_t doff, size_t soff, size_t len)
+{
+	TEST_CHECK(memcmp(dst + doff, src + soff, len) == 0);
+	TEST_CHECK(doff == 0 || dst[doff - 1] == 0xa5);
+	TEST_CHECK(dst[doff + len] == 0xa5);
+	return 0;
+}
+
+static int test_small(void)
+{
+	size_t len, off;
+
+	for (len = 0; len <= ES_MEMCPY_SMALL_MAX; len++) {
+		for (off = 0; off < 8; off++) {
+			fill();
+			es_memcpy_small(dst + off + 1, src + off, len);
+			if (check(off + 1, off, len))
+				return -1;
+		}
+	}
+	return 0;
+}
+
+static int test_stream(enum es_memcpy_impl impl)
+{
+	static const size_t lens[] = {
+		0, 1, 63, 64, 255, 256, 257, 1000, 4096, 65536 + 13,
+		TEST_BUF_SIZE - 64,
+	};
+	size_t i, doff, soff;
+
+	TEST_CHECK(es_memcpy_set_impl(impl) == 0);
+	TEST_CHECK(impl == ES_MEMCPY_AUTO || es_memcpy_get_impl() == impl);
+
+	for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		for (doff = 1; doff < 64; doff += 13) {
+			for (soff = 0; soff < 64; soff += 17) {
+				fill();
+				es_memcpy_stream(dst + doff, src + soff, lens[i]);
+				if (check(doff, soff, lens[i])) {
+					printf("%s: len %zu doff %zu soff %zu \n",
+						es_memcpy_impl_name(impl), lens[i],
+						doff, soff);
+					return -1;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	enum es_memcpy_impl impl;
+
+	src = malloc(TEST_BUF_SIZE);
+	dst = malloc(TEST_BUF_SIZE);
+	if (!src || !dst)
+		return 1;
+
+	if (test_small())
+		return 1;
+
+	for (impl = ES_MEMCPY_AUTO; impl < ES_MEMCPY_IMPL_MAX; impl++) {
+		if (!es_memcpy_impl_supported(impl)) {
+			if (es_memcpy_set_impl(impl) != ES_INVALID_PARAM)
+				return 1;
+			continue;
+		}
+		if (test_stream(impl))
+			return 1;
+	}
+	es_memcpy_set_impl(ES_MEMCPY_AUTO);
+
+	free(src);
+	free(dst);
+	printf("es_memcpy test OK! \n");
+	return 0;
+}
+
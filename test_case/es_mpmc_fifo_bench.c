@@ -0,0 +1,146 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_mpmc_fifo_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo.h>
+#include <es_mpmc_fifo.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_RECORDS	(4 * 1024 * 1024)
+#define BENCH_RECSIZE	32
+#define BENCH_SLOTS	4096
+
+static struct es_mpmc_fifo mpmc;
+static struct es_fifo fifo;
+static pthread_mutex_t fifo_lock = PTHREAD_MUTEX_INITIALIZER;
+static int use_mpmc;
+static unsigned int per_thread;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int put(const void *rec)
+{
+	unsigned int ret;
+
+	if (use_mpmc)
+		return es_mpmc_fifo_in(&mpmc, rec, 1);
+
+	pthread_mutex_lock(&fifo_lock);
+	ret = es_fifo_avail(&fifo) >= BENCH_RECSIZE ?
+		es_fifo_in(&fifo, rec, BENCH_RECSIZE) : 0;
+	pthread_mutex_unlock(&fifo_lock);
+	return ret != 0;
+}
+
+static int get(void *rec)
+{
+	unsigned int ret;
+
+	if (use_mpmc)
+		return es_mpmc_fifo_out(&mpmc, rec, 1);
+
+	pthread_mutex_lock(&fifo_lock);
+	ret = es_fifo_out(&fifo, rec, BENCH_RECSIZE);
+	pthread_mutex_unlock(&fifo_lock);
+	return ret != 0;
+}
+
+static void *producer(void *arg)
+{
+	unsigned char rec[BENCH_RECSIZE] = {0};
+	unsigned int i;
+
+	for (i = 0; i < per_thread; i++)
+		while (!put(rec))
+			sched_yield();
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	unsigned char rec[BENCH_RECSIZE];
+	unsigned int i;
+
+	for (i = 0; i < per_thread; i++)
+		while (!get(rec))
+			sched_yield();
+	return NULL;
+}
+
+static double run(unsigned int threads)
+{
+	pthread_t prod[threads], cons[threads];
+	unsigned int i;
+	double start;
+
+	per_thread = BENCH_RECORDS / threads;
+	start = now();
+	for (i = 0; i < threads; i++) {
+		pthread_create(&cons[i], NULL, consumer, NULL);
+		pthread_create(&prod[i], NULL, producer, NULL);
+	}
+	for (i = 0; i < threads; i++) {
+		pthread_join(prod[i], NULL);
+		pthread_join(cons[i], NULL);
+	}
+	return per_thread * threads / (now() - start) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int max_threads, threads;
+	double lock_rate, mpmc_rate;
+
+	max_threads = argc > 1 ? atoi(argv[1]) : sysconf(_SC_NPROCESSORS_ONLN);
+	if (max_threads < 1)
+		max_threads = 1;
+
+	if (es_mpmc_fifo_alloc(&mpmc, BENCH_RECSIZE, BENCH_SLOTS) ||
+		es_fifo_alloc(&fifo, BENCH_SLOTS * BENCH_RECSIZE))
+		return 1;
+
+	printf("%8s %18s %18s \n", "threads", "mutex es_fifo Mr/s",
+		"es_mpmc_fifo Mr/s");
+	/* 1, 2, 4, ... and max_threads itself */
+	for (threads = 1; ; threads = min(threads * 2, max_threads)) {
+		use_mpmc = 0;
+		lock_rate = run(threads);
+		use_mpmc = 1;
+		mpmc_rate = run(threads);
+		printf("%8u %18.2f %18.2f \n", threads, lock_rate, mpmc_rate);
+		if (threads == max_threads)
+			break;
+	}
+
+	es_mpmc_fifo_free(&mpmc);
+	es_fifo_free(&fifo);
+	return 0;
+}
+
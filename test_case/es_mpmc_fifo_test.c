@@ -0,0 +1,141 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_mpmc_fifo_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_mpmc_fifo.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_THREADS	4
+#define TEST_PER_THREAD	200000
+
+struct test_rec {
+	unsigned int producer;
+	unsigned int seq;
+	unsigned long long payload;
+};
+
+static struct es_mpmc_fifo fifo;
+static unsigned long long consumed_sum[TEST_THREADS];
+static unsigned int consumed_cnt[TEST_THREADS];
+static int order_errors;
+
+static void *producer(void *arg)
+{
+	struct test_rec rec;
+	unsigned int id = (unsigned long)arg;
+
+	rec.producer = id;
+	for (rec.seq = 0; rec.seq < TEST_PER_THREAD; rec.seq++) {
+		rec.payload = (unsigned long long)id << 32 | rec.seq;
+		while (!es_mpmc_fifo_in(&fifo, &rec, 1))
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	struct test_rec recs[16];
+	unsigned int last[TEST_THREADS];
+	unsigned long long sum[TEST_THREADS] = {0};
+	unsigned int cnt[TEST_THREADS] = {0};
+	unsigned int total = 0, ret, i, id;
+
+	memset(last, 0xff, sizeof(last));
+	while (total < TEST_PER_THREAD) {
+		ret = es_mpmc_fifo_out(&fifo, recs,
+			min(16u, TEST_PER_THREAD - total));
+		if (!ret) {
+			sched_yield();
+			continue;
+		}
+		for (i = 0; i < ret; i++) {
+			id = recs[i].producer;
+			/* each consumer sees one producer's records in order */
+			if (last[id] != ~0u && recs[i].seq <= last[id])
+				__atomic_fetch_add(&order_errors, 1, __ATOMIC_RELAXED);
+			if (recs[i].payload != ((unsigned long long)id << 32 | recs[i].seq))
+				__atomic_fetch_add(&order_errors, 1, __ATOMIC_RELAXED);
+			last[id] = recs[i].seq;
+			sum[id] += recs[i].seq;
+			cnt[id]++;
+		}
+		total += ret;
+	}
+
+	for (i = 0; i < TEST_THREADS; i++) {
+		__atomic_fetch_add(&consumed_sum[i], sum[i], __ATOMIC_RELAXED);
+		__atomic_fetch_add(&consumed_cnt[i], cnt[i], __ATOMIC_RELAXED);
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t prod[TEST_THREADS], cons[TEST_THREADS];
+	unsigned long long expect = (unsigned long long)TEST_PER_THREAD *
+					(TEST_PER_THREAD - 1) / 2;
+	struct test_rec rec = {0};
+	unsigned long i;
+	int ret;
+
+	ret = es_mpmc_fifo_alloc(&fifo, sizeof(struct test_rec), 1000);
+	printf("alloc ret is %d, size is %u \n", ret, es_mpmc_fifo_size(&fifo));
+	if (ret || es_mpmc_fifo_size(&fifo) != 1024)
+		return 1;
+
+	/* fill up, one more must fail, then drain */
+	for (i = 0; i < 1024; i++)
+		if (es_mpmc_fifo_in(&fifo, &rec, 1) != 1)
+			return 1;
+	if (es_mpmc_fifo_in(&fifo, &rec, 1) != 0 || es_mpmc_fifo_len(&fifo) != 1024)
+		return 1;
+	for (i = 0; i < 1024; i++)
+		if (es_mpmc_fifo_out(&fifo, &rec, 1) != 1)
+			return 1;
+	if (es_mpmc_fifo_out(&fifo, &rec, 1) != 0 || !es_mpmc_fifo_is_empty(&fifo))
+		return 1;
+
+	for (i = 0; i < TEST_THREADS; i++) {
+		pthread_create(&cons[i], NULL, consumer, NULL);
+		pthread_create(&prod[i], NULL, producer, (void *)i);
+	}
+	for (i = 0; i < TEST_THREADS; i++) {
+		pthread_join(prod[i], NULL);
+		pthread_join(cons[i], NULL);
+	}
+
+	for (i = 0; i < TEST_THREADS; i++) {
+		printf("producer %lu: %u records consumed \n", i, consumed_cnt[i]);
+		if (consumed_cnt[i] != TEST_PER_THREAD || consumed_sum[i] != expect)
+			return 1;
+	}
+	if (order_errors) {
+		printf("%d ordering errors \n", order_errors);
+		return 1;
+	}
+
+	es_mpmc_fifo_free(&fifo);
+	printf("es_mpmc_fifo test OK! \n");
+	return 0;
+}
+
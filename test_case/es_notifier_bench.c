@@ -0,0 +1,131 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_notifier_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_notifier.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+ * Events published to 32 subscribers by 1 to 8 threads, through an
+ * atomic notifier chain (lock-free walk) and through the same list
+ * walked under a mutex and under a read-write lock.
+ */
+
+#define BENCH_SUBSCRIBERS	32
+#define BENCH_EVENTS		200000
+
+enum {
+	CHAIN_RCU,
+	CHAIN_MUTEX,
+	CHAIN_RWLOCK,
+};
+
+static ES_ATOMIC_NOTIFIER_HEAD(chain);
+static ES_RAW_NOTIFIER_HEAD(raw_chain);
+static pthread_mutex_t chain_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_rwlock_t chain_rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static struct es_notifier_block subs[BENCH_SUBSCRIBERS];
+static struct es_notifier_block raw_subs[BENCH_SUBSCRIBERS];
+static int mode;
+
+static int count_cb(struct es_notifier_block *nb, unsigned long action,
+		void *data)
+{
+	(*(unsigned long *)data)++;
+	return ES_NOTIFY_DONE;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *publisher(void *arg)
+{
+	unsigned long calls = 0;
+	unsigned int i;
+
+	for (i = 0; i < BENCH_EVENTS; i++) {
+		switch (mode) {
+		case CHAIN_RCU:
+			es_atomic_notifier_call_chain(&chain, i, &calls);
+			break;
+		case CHAIN_MUTEX:
+			pthread_mutex_lock(&chain_mutex);
+			es_raw_notifier_call_chain(&raw_chain, i, &calls);
+			pthread_mutex_unlock(&chain_mutex);
+			break;
+		default:
+			pthread_rwlock_rdlock(&chain_rwlock);
+			es_raw_notifier_call_chain(&raw_chain, i, &calls);
+			pthread_rwlock_unlock(&chain_rwlock);
+			break;
+		}
+	}
+	*(unsigned long *)arg = calls;
+	return NULL;
+}
+
+static double bench(unsigned int threads)
+{
+	pthread_t tid[8];
+	unsigned long calls[8];
+	double start = now();
+	unsigned int i;
+
+	for (i = 0; i < threads; i++)
+		pthread_create(&tid[i], NULL, publisher, &calls[i]);
+	for (i = 0; i < threads; i++) {
+		pthread_join(tid[i], NULL);
+		if (calls[i] != (unsigned long)BENCH_EVENTS * BENCH_SUBSCRIBERS)
+			printf("lost calls: %lu \n", calls[i]);
+	}
+	return (now() - start) * 1e9 / ((double)BENCH_EVENTS * threads);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int threads[] = {1, 2, 4, 8};
+	unsigned int i;
+
+	for (i = 0; i < BENCH_SUBSCRIBERS; i++) {
+		subs[i].notifier_call = count_cb;
+		subs[i].priority = i % 4;
+		es_atomic_notifier_chain_register(&chain, &subs[i]);
+		raw_subs[i] = subs[i];
+		es_raw_notifier_chain_register(&raw_chain, &raw_subs[i]);
+	}
+
+	printf("ns per event, %u subscribers \n", BENCH_SUBSCRIBERS);
+	printf("%8s %10s %10s %10s \n", "threads", "lock-free", "mutex",
+		"rwlock");
+	for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		printf("%8u", threads[i]);
+		for (mode = CHAIN_RCU; mode <= CHAIN_RWLOCK; mode++)
+			printf(" %10.1f", bench(threads[i]));
+		printf(" \n");
+	}
+	return 0;
+}
+
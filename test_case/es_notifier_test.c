@@ -0,0 +1,354 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_notifier_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_notifier.h>
+#include <es_idr.h>
+#include <es_rcu.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "es_test.h"
+
+#define TEST_PUBLISHERS	3
+#define TEST_CYCLES	1000
+
+#define BLOCK_ALIVE	0x600d
+#define BLOCK_DEAD	0xdead
+
+struct listener {
+	struct es_notifier_block nb;
+	int id;
+	int ret;		/* what the callback returns */
+	unsigned int magic;
+	unsigned long calls;
+};
+
+static int order[16];
+static int norder;
+
+static int record_cb(struct es_notifier_block *nb, unsigned long action,
+		void *data)
+{
+	struct listener *l = container_of(nb, struct listener, nb);
+
+	order[norder++] = l->id;
+	l->calls++;
+	return l->ret;
+}
+
+static int test_order(void)
+{
+	ES_RAW_NOTIFIER_HEAD(chain);
+	static const int prio[] = {0, 10, -5, 10, 3};
+	struct listener l[5];
+	unsigned int i;
+
+	for (i = 0; i < 5; i++) {
+		l[i].nb.notifier_call = record_cb;
+		l[i].nb.priority = prio[i];
+		l[i].id = i;
+		l[i].ret = ES_NOTIFY_OK;
+		TEST_CHECK(es_raw_notifier_chain_register(&chain, &l[i].nb) == 0);
+	}
+	TEST_CHECK(es_raw_notifier_chain_register(&chain, &l[2].nb) == ES_FAIL);
+
+	/* by priority, equal ones in registration order */
+	norder = 0;
+	TEST_CHECK(es_raw_notifier_call_chain(&chain, 1, NULL) == ES_NOTIFY_OK);
+	TEST_CHECK(norder == 5 && order[0] == 1 && order[1] == 3 &&
+		order[2] == 4 && order[3] == 0 && order[4] == 2);
+
+	/* a veto stops the walk and carries an error code */
+	l[4].ret = es_notifier_from_errno(ES_INVALID_PARAM);
+	norder = 0;
+	i = es_raw_notifier_call_chain(&chain, 2, NULL);
+	TEST_CHECK(norder == 3 && (i & ES_NOTIFY_STOP_MASK));
+	TEST_CHECK(es_notifier_to_errno(i) == ES_INVALID_PARAM);
+	TEST_CHECK(es_notifier_to_errno(ES_NOTIFY_OK) == 0);
+
+	TEST_CHECK(es_raw_notifier_chain_unregister(&chain, &l[4].nb) == 0);
+	TEST_CHECK(es_raw_notifier_chain_unregister(&chain, &l[4].nb) ==
+		ES_FAIL);
+	norder = 0;
+	TEST_CHECK(es_raw_notifier_call_chain(&chain, 3, NULL) == ES_NOTIFY_OK);
+	TEST_CHECK(norder == 4 && order[2] == 0);
+	return 0;
+}
+
+static struct es_raw_notifier_head self_chain;
+
+static int self_unregister_cb(struct es_notifier_block *nb,
+		unsigned long action, void *data)
+{
+	record_cb(nb, action, data);
+	es_raw_notifier_chain_unregister(&self_chain, nb);
+	return ES_NOTIFY_DONE;
+}
+
+/* a raw chain callback may take itself off the chain */
+static int test_self_unregister(void)
+{
+	struct listener l[3];
+	unsigned int i;
+
+	INIT_ES_RAW_NOTIFIER_HEAD(&self_chain);
+	for (i = 0; i < 3; i++) {
+		l[i].nb.notifier_call = i == 1 ? self_unregister_cb : record_cb;
+		l[i].nb.priority = 0;
+		l[i].id = i;
+		l[i].ret = ES_NOTIFY_DONE;
+		TEST_CHECK(es_raw_notifier_chain_register(&self_chain,
+			&l[i].nb) == 0);
+	}
+	norder = 0;
+	es_raw_notifier_call_chain(&self_chain, 0, NULL);
+	TEST_CHECK(norder == 3);
+	norder = 0;
+	es_raw_notifier_call_chain(&self_chain, 0, NULL);
+	TEST_CHECK(norder == 2 && order[0] == 0 && order[1] == 2);
+	return 0;
+}
+
+static ES_ATOMIC_NOTIFIER_HEAD(atomic_chain);
+static ES_BLOCKING_NOTIFIER_HEAD(blocking_chain);
+static volatile int stop;
+static volatile int used_dead;
+
+static int check_cb(struct es_notifier_block *nb, unsigned long action,
+		void *data)
+{
+	struct listener *l = container_of(nb, struct listener, nb);
+
+	if (ES_READ_ONCE(l->magic) != BLOCK_ALIVE)
+		used_dead = 1;
+	es_atomic_fetch_add(&l->calls, 1);
+	return ES_NOTIFY_DONE;
+}
+
+static void *publisher(void *arg)
+{
+	unsigned long n = 0;
+
+	while (!stop) {
+		es_atomic_notifier_call_chain(&atomic_chain, n, NULL);
+		es_blocking_notifier_call_chain(&blocking_chain, n, NULL);
+		/* leave the cpu to the writer now and then */
+		if (++n % 64 == 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+/*
+ * publishers walk the chains while blocks come and go, no walk may see
+ * a block after its unregister returned
+ */
+static int test_concurrent(void)
+{
+	struct listener fixed = { .nb = { .notifier_call = check_cb } };
+	struct listener *l;
+	pthread_t tid[TEST_PUBLISHERS];
+	unsigned int i;
+
+	fixed.magic = BLOCK_ALIVE;
+	TEST_CHECK(es_atomic_notifier_chain_register(&atomic_chain,
+		&fixed.nb) == 0);
+	for (i = 0; i < TEST_PUBLISHERS; i++)
+		TEST_CHECK(pthread_create(&tid[i], NULL, publisher, NULL) == 0);
+
+	for (i = 0; i < TEST_CYCLES; i++) {
+		l = calloc(1, sizeof(*l));
+		TEST_CHECK(l);
+		l->nb.notifier_call = check_cb;
+		l->nb.priority = i % 7;
+		l->magic = BLOCK_ALIVE;
+		if (i & 1) {
+			TEST_CHECK(es_atomic_notifier_chain_register(
+				&atomic_chain, &l->nb) == 0);
+			sched_yield();
+			TEST_CHECK(es_atomic_notifier_chain_unregister(
+				&atomic_chain, &l->nb) == 0);
+		} else {
+			TEST_CHECK(es_blocking_notifier_chain_register(
+				&blocking_chain, &l->nb) == 0);
+			sched_yield();
+			TEST_CHECK(es_blocking_notifier_chain_unregister(
+				&blocking_chain, &l->nb) == 0);
+		}
+		l->magic = BLOCK_DEAD;
+		free(l);
+	}
+
+	stop = 1;
+	for (i = 0; i < TEST_PUBLISHERS; i++)
+		pthread_join(tid[i], NULL);
+	TEST_CHECK(!used_dead);
+	TEST_CHECK(fixed.calls > 0);
+	TEST_CHECK(es_atomic_notifier_chain_unregister(&atomic_chain,
+		&fixed.nb) == 0);
+	return 0;
+}
+
+static volatile int reader_in;
+
+static void *slow_reader(void *arg)
+{
+	es_rcu_read_lock();
+	es_rcu_read_lock();
+	reader_in = 1;
+	usleep(50000);
+	es_rcu_read_unlock();
+	usleep(50000);
+	es_rcu_read_unlock();
+	return NULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* a grace period waits for the outermost read-side section */
+static int test_grace_period(void)
+{
+	pthread_t tid;
+	double start;
+
+	TEST_CHECK(pthread_create(&tid, NULL, slow_reader, NULL) == 0);
+	while (!reader_in)
+		sched_yield();
+	start = now();
+	es_synchronize_rcu();
+	TEST_CHECK(now() - start > 0.08);
+	pthread_join(tid, NULL);
+
+	/* nothing to wait for now */
+	start = now();
+	es_synchronize_rcu();
+	TEST_CHECK(now() - start < 0.05);
+	return 0;
+}
+
+static ES_BLOCKING_NOTIFIER_HEAD(other_chain);
+static struct listener other = { .nb = { .notifier_call = record_cb } };
+static struct es_idr cross_idr;
+
+/* unregisters from another chain and shrinks an idr, from a callback */
+static int cross_cb(struct es_notifier_block *nb, unsigned long action,
+		void *data)
+{
+	es_blocking_notifier_chain_unregister(&other_chain, &other.nb);
+	es_idr_shrink(&cross_idr);
+	return ES_NOTIFY_DONE;
+}
+
+static int sleepy_cb(struct es_notifier_block *nb, unsigned long action,
+		void *data)
+{
+	reader_in = 1;
+	usleep(100000);
+	return ES_NOTIFY_DONE;
+}
+
+static void *sleepy_publisher(void *arg)
+{
+	es_blocking_notifier_call_chain(arg, 0, NULL);
+	return NULL;
+}
+
+/* every chain is a grace period domain of its own */
+static int test_cross_chain(void)
+{
+	ES_ATOMIC_NOTIFIER_HEAD(chain);
+	ES_BLOCKING_NOTIFIER_HEAD(sleepy_chain);
+	struct es_notifier_block cross = { .notifier_call = cross_cb };
+	struct es_notifier_block sleepy = { .notifier_call = sleepy_cb };
+	unsigned long id, nodes;
+	pthread_t tid;
+	double start;
+	int dummy;
+
+	es_idr_init(&cross_idr);
+	id = 5000;
+	TEST_CHECK(es_idr_alloc(&cross_idr, &dummy, &id, ~0UL) == 0);
+	TEST_CHECK(es_idr_remove(&cross_idr, id) == &dummy);
+	nodes = cross_idr.nr_nodes;
+	TEST_CHECK(nodes > 0);
+
+	TEST_CHECK(es_blocking_notifier_chain_register(&other_chain,
+		&other.nb) == 0);
+	TEST_CHECK(es_atomic_notifier_chain_register(&chain, &cross) == 0);
+	es_atomic_notifier_call_chain(&chain, 0, NULL);
+	TEST_CHECK(es_blocking_notifier_chain_unregister(&other_chain,
+		&other.nb) == ES_FAIL);
+	TEST_CHECK(cross_idr.nr_nodes < nodes);
+	TEST_CHECK(es_atomic_notifier_chain_unregister(&chain, &cross) == 0);
+
+	/* the global domain refuses to wait for its own caller */
+	id = 5000;
+	TEST_CHECK(es_idr_alloc(&cross_idr, &dummy, &id, ~0UL) == 0);
+	TEST_CHECK(es_idr_remove(&cross_idr, id) == &dummy);
+	nodes = cross_idr.nr_nodes;
+	es_rcu_read_lock();
+	TEST_CHECK(es_synchronize_rcu() == ES_FAIL);
+	es_idr_shrink(&cross_idr);
+	TEST_CHECK(cross_idr.nr_nodes == nodes);
+	es_rcu_read_unlock();
+	TEST_CHECK(es_synchronize_rcu() == ES_SUCCESS);
+	es_idr_destroy(&cross_idr);
+
+	/* a sleeping callback holds up its own chain only */
+	TEST_CHECK(es_blocking_notifier_chain_register(&sleepy_chain,
+		&sleepy) == 0);
+	TEST_CHECK(es_blocking_notifier_chain_register(&other_chain,
+		&other.nb) == 0);
+	reader_in = 0;
+	TEST_CHECK(pthread_create(&tid, NULL, sleepy_publisher,
+		&sleepy_chain) == 0);
+	while (!reader_in)
+		sched_yield();
+	start = now();
+	TEST_CHECK(es_blocking_notifier_chain_unregister(&other_chain,
+		&other.nb) == 0);
+	es_synchronize_rcu();
+	TEST_CHECK(now() - start < 0.05);
+	TEST_CHECK(es_blocking_notifier_chain_unregister(&sleepy_chain,
+		&sleepy) == 0);
+	TEST_CHECK(now() - start > 0.05);
+	pthread_join(tid, NULL);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_order() || test_self_unregister() || test_concurrent() ||
+		test_grace_period() || test_cross_chain())
+		return 1;
+
+	printf("es_notifier test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,174 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_pool_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_pool.h>
+#include <es_llist.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * es_pool against glibc malloc:
+ *  - churn: every thread replaces random objects of a window of live
+ *    ones, alloc and free on the same thread
+ *  - handoff: producers allocate, one consumer frees what they pass
+ *    on through an es_llist, so objects change threads
+ */
+
+#define BENCH_OPS	2000000	/* per thread */
+#define BENCH_WINDOW	1024
+
+struct node {
+	struct es_list_head list;
+	struct es_llist_node lnode;
+	unsigned long data[4];
+};
+
+static struct es_pool pool;
+static int use_pool;
+static ES_LLIST_HEAD(handoff);
+static unsigned int producers_left;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline struct node *node_alloc(void)
+{
+	return use_pool ? es_pool_alloc(&pool) : malloc(sizeof(struct node));
+}
+
+static inline void node_free(struct node *n)
+{
+	if (use_pool)
+		es_pool_free(&pool, n);
+	else
+		free(n);
+}
+
+static void *churn(void *arg)
+{
+	struct node **window = calloc(BENCH_WINDOW, sizeof(*window));
+	unsigned int i, slot, seed = (unsigned long)arg;
+
+	for (i = 0; i < BENCH_OPS; i++) {
+		slot = rand_r(&seed) % BENCH_WINDOW;
+		if (window[slot])
+			node_free(window[slot]);
+		window[slot] = node_alloc();
+		window[slot]->data[0] = i;
+	}
+	for (slot = 0; slot < BENCH_WINDOW; slot++) {
+		if (window[slot])
+			node_free(window[slot]);
+	}
+	free(window);
+	return NULL;
+}
+
+static void *producer(void *arg)
+{
+	struct node *n;
+	unsigned int i;
+
+	for (i = 0; i < BENCH_OPS; i++) {
+		n = node_alloc();
+		n->data[0] = i;
+		es_llist_add(&n->lnode, &handoff);
+	}
+	es_atomic_fetch_sub(&producers_left, 1);
+	return NULL;
+}
+
+static void drain(void)
+{
+	struct es_llist_node *batch = es_llist_del_all(&handoff), *next;
+
+	for (; batch; batch = next) {
+		next = batch->next;
+		node_free(es_llist_entry(batch, struct node, lnode));
+	}
+}
+
+static double bench_churn(unsigned int threads)
+{
+	pthread_t tid[8];
+	double start = now();
+	unsigned long i;
+
+	for (i = 0; i < threads; i++)
+		pthread_create(&tid[i], NULL, churn, (void *)(i + 1));
+	for (i = 0; i < threads; i++)
+		pthread_join(tid[i], NULL);
+	return (now() - start) * 1e9 / ((double)threads * BENCH_OPS);
+}
+
+static double bench_handoff(unsigned int threads)
+{
+	pthread_t tid[8];
+	double start = now();
+	unsigned int i, left;
+
+	producers_left = threads;
+	for (i = 0; i < threads; i++)
+		pthread_create(&tid[i], NULL, producer, NULL);
+	do {
+		left = es_smp_load_acquire(&producers_left);
+		drain();
+	} while (left);
+	for (i = 0; i < threads; i++)
+		pthread_join(tid[i], NULL);
+	return (now() - start) * 1e9 / ((double)threads * BENCH_OPS);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int threads[] = {1, 2, 4, 8};
+	unsigned int i;
+
+	if (es_pool_init(&pool, "bench", sizeof(struct node), 0, NULL, NULL))
+		return 1;
+
+	printf("ns per alloc+free, %u byte objects \n",
+		(unsigned int)sizeof(struct node));
+	printf("%8s %10s %10s %12s %12s \n", "threads", "churn pool",
+		"malloc", "handoff pool", "malloc");
+	for (i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		printf("%8u", threads[i]);
+		use_pool = 1;
+		printf(" %10.1f", bench_churn(threads[i]));
+		use_pool = 0;
+		printf(" %10.1f", bench_churn(threads[i]));
+		use_pool = 1;
+		printf(" %12.1f", bench_handoff(threads[i]));
+		use_pool = 0;
+		printf(" %12.1f \n", bench_handoff(threads[i]));
+	}
+
+	es_pool_dump(&pool, stdout);
+	es_pool_destroy(&pool);
+	return 0;
+}
+
@@ -0,0 +1,228 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_pool_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_pool.h>
+#include <es_llist.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+#define TEST_OBJS	10000
+#define TEST_THREADS	4
+#define TEST_ROUNDS	200000
+#define TEST_WINDOW	256
+
+#define OBJ_MAGIC	0x5eed5eedU
+
+struct obj {
+	unsigned int magic;
+	unsigned int id;
+	struct es_list_head node;
+	struct es_llist_node lnode;
+	char payload[13];
+};
+
+static void obj_ctor(void *p, void *arg)
+{
+	struct obj *o = p;
+
+	o->magic = OBJ_MAGIC;
+	INIT_ES_LIST_HEAD(&o->node);
+	/* threads carve slabs concurrently */
+	es_atomic_fetch_add((unsigned int *)arg, 1);
+}
+
+static int test_basic(void)
+{
+	static struct obj *objs[TEST_OBJS];
+	struct es_pool pool;
+	struct es_pool_stats st;
+	ES_LIST_HEAD(live);
+	struct obj *o, *n;
+	unsigned int i, slabs;
+
+	TEST_CHECK(es_pool_init(&pool, "basic", 0, 0, NULL, NULL) ==
+		ES_INVALID_PARAM);
+	TEST_CHECK(es_pool_init(&pool, "basic", 8, 3, NULL, NULL) ==
+		ES_INVALID_PARAM);
+	TEST_CHECK(es_pool_init(&pool, "basic", sizeof(struct obj), 32,
+		NULL, NULL) == 0);
+
+	for (i = 0; i < TEST_OBJS; i++) {
+		objs[i] = es_pool_alloc(&pool);
+		TEST_CHECK(objs[i] && ((unsigned long)objs[i] & 31) == 0);
+		objs[i]->id = i;
+		es_list_add_tail(&objs[i]->node, &live);
+	}
+	i = 0;
+	es_list_for_each_entry(o, &live, node)
+		TEST_CHECK(o->id == i++);
+
+	es_pool_get_stats(&pool, &st);
+	TEST_CHECK(st.allocs == TEST_OBJS && st.frees == 0);
+	TEST_CHECK(st.objs_total >= TEST_OBJS && st.caches == 1);
+	slabs = st.slabs;
+
+	es_list_for_each_entry_safe(o, n, &live, node) {
+		es_list_del(&o->node);
+		es_pool_free(&pool, o);
+	}
+
+	/* freed objects come back, no new slab */
+	for (i = 0; i < TEST_OBJS; i++)
+		TEST_CHECK((objs[i] = es_pool_alloc(&pool)) != NULL);
+	for (i = 0; i < TEST_OBJS; i++)
+		es_pool_free(&pool, objs[i]);
+	es_pool_flush_cache(&pool);
+
+	es_pool_get_stats(&pool, &st);
+	TEST_CHECK(st.slabs == slabs);
+	TEST_CHECK(st.allocs == 2 * TEST_OBJS && st.frees == 2 * TEST_OBJS);
+	TEST_CHECK(st.objs_cached == 0 && st.objs_depot == st.objs_total);
+	TEST_CHECK(st.refills > 0 && st.flushes > 0);
+
+	es_pool_destroy(&pool);
+	return 0;
+}
+
+/* constructed once per object, the state survives free and alloc */
+static int test_ctor(void)
+{
+	static struct obj *objs[TEST_OBJS];
+	struct es_pool pool;
+	struct es_pool_stats st;
+	unsigned int i, calls = 0;
+
+	TEST_CHECK(es_pool_init(&pool, "ctor", sizeof(struct obj), 0,
+		obj_ctor, &calls) == 0);
+	TEST_CHECK(calls == 0);
+
+	for (i = 0; i < TEST_OBJS; i++) {
+		objs[i] = es_pool_alloc(&pool);
+		TEST_CHECK(objs[i] && objs[i]->magic == OBJ_MAGIC);
+		TEST_CHECK(es_list_empty(&objs[i]->node));
+	}
+	for (i = 0; i < TEST_OBJS; i++)
+		es_pool_free(&pool, objs[i]);
+	for (i = 0; i < TEST_OBJS; i++) {
+		objs[i] = es_pool_alloc(&pool);
+		TEST_CHECK(objs[i] && objs[i]->magic == OBJ_MAGIC);
+		TEST_CHECK(es_list_empty(&objs[i]->node));
+	}
+
+	es_pool_get_stats(&pool, &st);
+	TEST_CHECK(calls == st.objs_total);
+	es_pool_destroy(&pool);
+	return 0;
+}
+
+static struct es_pool shared;
+static ES_LLIST_HEAD(handoff);
+static unsigned int shared_calls;
+
+/* alloc and free in a window, every 4th object freed by another thread */
+static void *churn(void *arg)
+{
+	struct obj *window[TEST_WINDOW] = {NULL}, *o;
+	struct es_llist_node *batch, *next;
+	unsigned int i, slot, seed = (unsigned long)arg;
+	long bad = 0;
+
+	for (i = 0; i < TEST_ROUNDS; i++) {
+		slot = rand_r(&seed) % TEST_WINDOW;
+		o = window[slot];
+		if (o) {
+			if (o->magic != OBJ_MAGIC || o->id != slot)
+				bad++;
+			if (i % 4 == 0)
+				es_llist_add(&o->lnode, &handoff);
+			else
+				es_pool_free(&shared, o);
+		}
+		o = es_pool_alloc(&shared);
+		if (!o || o->magic != OBJ_MAGIC) {
+			bad++;
+			break;
+		}
+		o->id = slot;
+		window[slot] = o;
+
+		if (i % 64 == 0) {
+			batch = es_llist_del_all(&handoff);
+			for (; batch; batch = next) {
+				next = batch->next;
+				es_pool_free(&shared, es_llist_entry(batch,
+					struct obj, lnode));
+			}
+		}
+	}
+	for (slot = 0; slot < TEST_WINDOW; slot++) {
+		if (window[slot])
+			es_pool_free(&shared, window[slot]);
+	}
+	return (void *)bad;
+}
+
+static int test_threads(void)
+{
+	pthread_t tid[TEST_THREADS];
+	struct es_pool_stats st;
+	struct es_llist_node *batch, *next;
+	unsigned int i;
+	void *bad;
+
+	TEST_CHECK(es_pool_init(&shared, "shared", sizeof(struct obj), 0,
+		obj_ctor, &shared_calls) == 0);
+	for (i = 0; i < TEST_THREADS; i++)
+		TEST_CHECK(pthread_create(&tid[i], NULL, churn,
+			(void *)(unsigned long)(i + 1)) == 0);
+	for (i = 0; i < TEST_THREADS; i++) {
+		pthread_join(tid[i], &bad);
+		TEST_CHECK(bad == NULL);
+	}
+	batch = es_llist_del_all(&handoff);
+	for (; batch; batch = next) {
+		next = batch->next;
+		es_pool_free(&shared, es_llist_entry(batch, struct obj, lnode));
+	}
+	es_pool_flush_cache(&shared);
+
+	/* the exited threads gave their magazines back */
+	es_pool_get_stats(&shared, &st);
+	TEST_CHECK(st.caches == 1 && st.objs_cached == 0);
+	TEST_CHECK(st.allocs == st.frees);
+	TEST_CHECK(st.allocs == (unsigned long)TEST_THREADS * TEST_ROUNDS);
+	TEST_CHECK(st.objs_depot == st.objs_total);
+	TEST_CHECK(shared_calls == st.objs_total);
+	es_pool_dump(&shared, stdout);
+	es_pool_destroy(&shared);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_basic() || test_ctor() || test_threads())
+		return 1;
+
+	printf("es_pool test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,270 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rbtree_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_rbtree.h>
+#include <es_interval_tree.h>
+#include <es_list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * es_rbtree against a sorted es_list walked with es_list_for_each_entry:
+ *  - insertion of random keys, lookup of random keys and in-order
+ *    removal of the smallest key (es_rb_root_cached)
+ *  - stabbing queries on es_interval_tree against a scan of a list of
+ *    ranges sorted by start
+ * The sorted list is quadratic, it stops at BENCH_LIST_MAX entries.
+ */
+
+#define BENCH_MAX	(1U << 20)
+#define BENCH_LIST_MAX	(1U << 15)
+#define BENCH_LOOKUPS	(1U << 18)
+
+struct obj {
+	unsigned int key;
+	struct es_rb_node rb;
+	struct es_list_head list;
+};
+
+struct range {
+	struct es_interval_tree_node it;
+	struct es_list_head list;
+};
+
+static struct obj *objs;
+static struct range *ranges;
+static unsigned int *lookups;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned int rand32(void)
+{
+	return ((unsigned int)rand() << 16) ^ rand();
+}
+
+static void rb_insert(struct es_rb_root_cached *root, struct obj *obj)
+{
+	struct es_rb_node **link = &root->rb_root.rb_node, *parent = NULL;
+	bool leftmost = es_true;
+
+	while (*link) {
+		parent = *link;
+		if (obj->key < es_rb_entry(parent, struct obj, rb)->key) {
+			link = &parent->rb_left;
+		} else {
+			link = &parent->rb_right;
+			leftmost = es_false;
+		}
+	}
+	es_rb_link_node(&obj->rb, parent, link);
+	es_rb_insert_color_cached(&obj->rb, root, leftmost);
+}
+
+static struct obj *rb_lookup(struct es_rb_root_cached *root, unsigned int key)
+{
+	struct es_rb_node *n = root->rb_root.rb_node;
+	struct obj *obj;
+
+	while (n) {
+		obj = es_rb_entry(n, struct obj, rb);
+		if (key < obj->key)
+			n = n->rb_left;
+		else if (key > obj->key)
+			n = n->rb_right;
+		else
+			return obj;
+	}
+	return NULL;
+}
+
+static void list_insert(struct es_list_head *head, struct obj *obj)
+{
+	struct obj *pos;
+
+	es_list_for_each_entry(pos, head, list)
+		if (obj->key < pos->key)
+			break;
+	es_list_add_tail(&obj->list, &pos->list);
+}
+
+static struct obj *list_lookup(struct es_list_head *head, unsigned int key)
+{
+	struct obj *pos;
+
+	es_list_for_each_entry(pos, head, list) {
+		if (pos->key == key)
+			return pos;
+		if (pos->key > key)
+			break;
+	}
+	return NULL;
+}
+
+static void bench_ordered(unsigned int n)
+{
+	struct es_rb_root_cached root = ES_RB_ROOT_CACHED;
+	struct es_rb_node *first;
+	unsigned int i, found = 0, lookups_n;
+	double t_ins, t_find, t_pop;
+	ES_LIST_HEAD(head);
+
+	for (i = 0; i < n; i++)
+		objs[i].key = rand32();
+	for (i = 0; i < BENCH_LOOKUPS; i++)
+		lookups[i] = rand() & 1 ? objs[rand32() % n].key : rand32();
+
+	t_ins = now();
+	for (i = 0; i < n; i++)
+		rb_insert(&root, &objs[i]);
+	t_ins = now() - t_ins;
+	t_find = now();
+	for (i = 0; i < BENCH_LOOKUPS; i++)
+		found += rb_lookup(&root, lookups[i]) != NULL;
+	t_find = now() - t_find;
+	t_pop = now();
+	while ((first = es_rb_first_cached(&root)))
+		es_rb_erase_cached(first, &root);
+	t_pop = now() - t_pop;
+	printf("%9u %-10s %10.1f %10.1f %10.1f \n", n, "es_rbtree",
+		t_ins * 1e9 / n, t_find * 1e9 / BENCH_LOOKUPS, t_pop * 1e9 / n);
+
+	if (n > BENCH_LIST_MAX)
+		return;
+
+	/* fewer lookups, each one walks half the list */
+	lookups_n = BENCH_LOOKUPS / (n / 1024 + 1);
+	t_ins = now();
+	for (i = 0; i < n; i++)
+		list_insert(&head, &objs[i]);
+	t_ins = now() - t_ins;
+	t_find = now();
+	for (i = 0; i < lookups_n; i++)
+		found += list_lookup(&head, lookups[i]) != NULL;
+	t_find = now() - t_find;
+	t_pop = now();
+	while (!es_list_empty(&head))
+		es_list_del(head.next);
+	t_pop = now() - t_pop;
+	printf("%9u %-10s %10.1f %10.1f %10.1f \n", n, "es_list",
+		t_ins * 1e9 / n, t_find * 1e9 / lookups_n, t_pop * 1e9 / n);
+
+	if (!found)
+		printf("nothing found \n");
+}
+
+static void bench_interval(unsigned int n)
+{
+	struct es_rb_root_cached root = ES_RB_ROOT_CACHED;
+	struct es_interval_tree_node *it;
+	struct range *pos;
+	unsigned long hits = 0, tree_hits;
+	unsigned int i, q, queries = BENCH_LOOKUPS / 4;
+	uint64_t space = (uint64_t)n * 64, point;
+	double t_tree, t_list;
+	ES_LIST_HEAD(head);
+
+	/* ranges of up to 256 in a space of 64 per range, ~2 hits a query */
+	for (i = 0; i < n; i++) {
+		ranges[i].it.start = ((uint64_t)rand32() << 16 ^ rand32()) % space;
+		ranges[i].it.last = ranges[i].it.start + rand() % 256;
+		es_interval_tree_insert(&ranges[i].it, &root);
+	}
+
+	t_tree = now();
+	for (q = 0; q < queries; q++) {
+		point = lookups[q] % space;
+		for (it = es_interval_tree_iter_first(&root, point, point); it;
+		     it = es_interval_tree_iter_next(it, point, point))
+			hits++;
+	}
+	t_tree = now() - t_tree;
+
+	for (i = 0; i < n; i++)
+		es_interval_tree_remove(&ranges[i].it, &root);
+	tree_hits = hits;
+	if (n > BENCH_LIST_MAX) {
+		printf("%9u %12.1f %12s %8.2f \n", n, t_tree * 1e9 / queries,
+			"-", (double)tree_hits / queries);
+		return;
+	}
+
+	/* list sorted by start, a scan stops at the first start past it */
+	for (i = 0; i < n; i++) {
+		struct range *r = &ranges[i], *p;
+
+		es_list_for_each_entry(p, &head, list)
+			if (r->it.start < p->it.start)
+				break;
+		es_list_add_tail(&r->list, &p->list);
+	}
+	queries /= n / 1024 + 1;
+	t_list = now();
+	for (q = 0; q < queries; q++) {
+		point = lookups[q] % space;
+		es_list_for_each_entry(pos, &head, list) {
+			if (pos->it.start > point)
+				break;
+			if (pos->it.last >= point)
+				hits++;
+		}
+	}
+	t_list = now() - t_list;
+
+	printf("%9u %12.1f %12.1f %8.2f \n", n,
+		t_tree * 1e9 / (BENCH_LOOKUPS / 4), t_list * 1e9 / queries,
+		(double)tree_hits / (BENCH_LOOKUPS / 4));
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int n;
+
+	objs = malloc(BENCH_MAX * sizeof(*objs));
+	ranges = malloc(BENCH_MAX * sizeof(*ranges));
+	lookups = malloc(BENCH_LOOKUPS * sizeof(*lookups));
+	if (!objs || !ranges || !lookups)
+		return 1;
+	srand(22);
+
+	printf("ns per op \n");
+	printf("%9s %-10s %10s %10s %10s \n", "entries", "", "insert",
+		"lookup", "pop first");
+	for (n = 1024; n <= BENCH_MAX; n *= 4)
+		bench_ordered(n);
+
+	printf("\nstabbing query ns \n");
+	printf("%9s %12s %12s %8s \n", "ranges", "interval", "es_list",
+		"hits");
+	for (n = 1024; n <= BENCH_MAX; n *= 4)
+		bench_interval(n);
+
+	free(objs);
+	free(ranges);
+	free(lookups);
+	return 0;
+}
+
@@ -0,0 +1,360 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_rbtree_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_rbtree_augmented.h>
+#include <es_interval_tree.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+#define TEST_NODES	2000
+#define TEST_ROUNDS	20
+
+struct item {
+	unsigned int key;
+	unsigned int seq;
+	int inserted;
+	struct es_rb_node node;
+};
+
+static struct item items[TEST_NODES];
+
+static bool item_less(struct es_rb_node *a, const struct es_rb_node *b)
+{
+	return es_rb_entry(a, struct item, node)->key <
+		es_rb_entry(b, struct item, node)->key;
+}
+
+static int item_cmp(const void *key, const struct es_rb_node *n)
+{
+	unsigned int k = *(const unsigned int *)key;
+	unsigned int nk = es_rb_entry(n, struct item, node)->key;
+
+	return (k > nk) - (k < nk);
+}
+
+static int item_node_cmp(struct es_rb_node *a, const struct es_rb_node *b)
+{
+	return item_cmp(&es_rb_entry(a, struct item, node)->key, b);
+}
+
+/*
+ * check the red-black properties below @node, returns its black height
+ * or -1
+ */
+static int check_subtree(struct es_rb_node *node, struct es_rb_node *parent)
+{
+	int lh, rh;
+
+	if (!node)
+		return 1;
+	if (es_rb_parent(node) != parent)
+		return -1;
+	if (es_rb_is_red(node) && parent && es_rb_is_red(parent))
+		return -1;
+
+	lh = check_subtree(node->rb_left, node);
+	rh = check_subtree(node->rb_right, node);
+	if (lh < 0 || lh != rh)
+		return -1;
+	return lh + es_rb_is_black(node);
+}
+
+/* properties, order (stable for equal keys), count and both directions */
+static int check_tree(struct es_rb_root *root, unsigned int count)
+{
+	struct es_rb_node *n, *prev = NULL;
+	struct item *it, *last = NULL;
+	unsigned int i = 0;
+
+	TEST_CHECK(!root->rb_node || es_rb_is_black(root->rb_node));
+	TEST_CHECK(check_subtree(root->rb_node, NULL) > 0);
+
+	for (n = es_rb_first(root); n; n = es_rb_next(n)) {
+		it = es_rb_entry(n, struct item, node);
+		TEST_CHECK(it->inserted);
+		if (last) {
+			TEST_CHECK(last->key <= it->key);
+			TEST_CHECK(last->key < it->key || last->seq < it->seq);
+		}
+		TEST_CHECK(es_rb_prev(n) == prev);
+		last = it;
+		prev = n;
+		i++;
+	}
+	TEST_CHECK(i == count);
+	TEST_CHECK(es_rb_last(root) == prev);
+	return 0;
+}
+
+static int test_basic(void)
+{
+	struct es_rb_root root = ES_RB_ROOT;
+	struct es_rb_node *n;
+	struct item *pos, *tmp, repl;
+	unsigned int i, r, key, count, seq = 0;
+
+	TEST_CHECK(ES_RB_EMPTY_ROOT(&root));
+	TEST_CHECK(!es_rb_first(&root) && !es_rb_last(&root));
+	TEST_CHECK(!es_rb_first_postorder(&root));
+
+	srand(22);
+	for (i = 0; i < TEST_NODES; i++)
+		ES_RB_CLEAR_NODE(&items[i].node);
+
+	for (r = 0, count = 0; r < TEST_ROUNDS; r++) {
+		/* toggle a random half, keys with many duplicates */
+		for (i = 0; i < TEST_NODES; i++) {
+			if (rand() & 1)
+				continue;
+			if (items[i].inserted) {
+				es_rb_erase(&items[i].node, &root);
+				ES_RB_CLEAR_NODE(&items[i].node);
+				TEST_CHECK(!es_rb_next(&items[i].node));
+				items[i].inserted = 0;
+				count--;
+			} else {
+				items[i].key = rand() % (TEST_NODES / 2);
+				items[i].seq = seq++;
+				es_rb_add(&items[i].node, &root, item_less);
+				items[i].inserted = 1;
+				count++;
+			}
+		}
+		if (check_tree(&root, count))
+			return -1;
+	}
+
+	/* lookups against the array */
+	for (key = 0; key < TEST_NODES / 2; key++) {
+		unsigned int want = 0, got = 0, first_seq = ~0U;
+
+		for (i = 0; i < TEST_NODES; i++)
+			if (items[i].inserted && items[i].key == key) {
+				want++;
+				if (items[i].seq < first_seq)
+					first_seq = items[i].seq;
+			}
+
+		n = es_rb_find(&key, &root, item_cmp);
+		TEST_CHECK(!n == !want);
+		if (n)
+			TEST_CHECK(es_rb_entry(n, struct item, node)->key == key);
+		n = es_rb_find_first(&key, &root, item_cmp);
+		TEST_CHECK(!n == !want);
+		if (n)
+			TEST_CHECK(es_rb_entry(n, struct item, node)->seq ==
+				first_seq);
+		es_rb_for_each(n, &key, &root, item_cmp)
+			got++;
+		TEST_CHECK(got == want);
+	}
+
+	/* es_rb_find_add() only adds a new key */
+	for (i = 0; i < TEST_NODES && items[i].inserted; i++)
+		;
+	if (i < TEST_NODES) {
+		items[i].key = TEST_NODES;
+		items[i].seq = seq++;
+		TEST_CHECK(!es_rb_find_add(&items[i].node, &root,
+				item_node_cmp));
+		items[i].inserted = 1;
+		count++;
+		repl.key = TEST_NODES;
+		TEST_CHECK(es_rb_find_add(&repl.node, &root, item_node_cmp) ==
+			&items[i].node);
+
+		/* replace it in place */
+		repl.seq = items[i].seq;
+		repl.inserted = 1;
+		es_rb_replace_node(&items[i].node, &repl.node, &root);
+		items[i].inserted = 0;
+		if (check_tree(&root, count))
+			return -1;
+		es_rb_erase(&repl.node, &root);
+		count--;
+	}
+
+	/* postorder visits every node once, children first */
+	i = 0;
+	es_rbtree_postorder_for_each_entry_safe(pos, tmp, &root, node) {
+		if (pos->node.rb_left)
+			TEST_CHECK(!es_rb_entry(pos->node.rb_left, struct item,
+				node)->inserted);
+		if (pos->node.rb_right)
+			TEST_CHECK(!es_rb_entry(pos->node.rb_right, struct item,
+				node)->inserted);
+		pos->inserted = 0;
+		i++;
+	}
+	TEST_CHECK(i == count);
+	return 0;
+}
+
+static int test_cached(void)
+{
+	struct es_rb_root_cached root = ES_RB_ROOT_CACHED;
+	struct es_rb_node *n, *leftmost;
+	unsigned int i, r, count = 0;
+
+	srand(23);
+	for (i = 0; i < TEST_NODES; i++)
+		items[i].inserted = 0;
+
+	for (r = 0; r < TEST_ROUNDS; r++) {
+		for (i = 0; i < TEST_NODES; i++) {
+			if (rand() & 1)
+				continue;
+			if (items[i].inserted) {
+				leftmost = es_rb_first_cached(&root);
+				n = es_rb_erase_cached(&items[i].node, &root);
+				TEST_CHECK(n == (leftmost == &items[i].node ?
+					es_rb_first_cached(&root) : NULL));
+				items[i].inserted = 0;
+				count--;
+			} else {
+				items[i].key = rand();
+				items[i].seq = i + r * TEST_NODES;
+				n = es_rb_add_cached(&items[i].node, &root,
+						item_less);
+				TEST_CHECK(!n || n == &items[i].node);
+				items[i].inserted = 1;
+				count++;
+			}
+			TEST_CHECK(es_rb_first_cached(&root) ==
+				es_rb_first(&root.rb_root));
+		}
+		if (check_tree(&root.rb_root, count))
+			return -1;
+	}
+
+	/* drain from the left, as a timer queue would */
+	while ((n = es_rb_first_cached(&root))) {
+		es_rb_erase_cached(n, &root);
+		TEST_CHECK(es_rb_first_cached(&root) ==
+			es_rb_first(&root.rb_root));
+		count--;
+	}
+	TEST_CHECK(!count && ES_RB_EMPTY_ROOT(&root.rb_root));
+	return 0;
+}
+
+#define IT_NODES	1000
+#define IT_SPACE	100000
+
+static struct es_interval_tree_node ranges[IT_NODES];
+static int in_tree[IT_NODES];
+
+/* ->__subtree_last is the max ->last below every node */
+static uint64_t check_augmented(struct es_rb_node *rb)
+{
+	struct es_interval_tree_node *n;
+	uint64_t max, sub;
+
+	if (!rb)
+		return 0;
+	n = es_rb_entry(rb, struct es_interval_tree_node, rb);
+	max = n->last;
+	sub = check_augmented(rb->rb_left);
+	if (sub > max)
+		max = sub;
+	sub = check_augmented(rb->rb_right);
+	if (sub > max)
+		max = sub;
+	return max == n->__subtree_last ? max : ~0ULL;
+}
+
+static int test_interval(void)
+{
+	struct es_rb_root_cached root = ES_RB_ROOT_CACHED;
+	struct es_interval_tree_node *n;
+	uint64_t start, last;
+	unsigned int i, q, r, want, got;
+
+	srand(24);
+	TEST_CHECK(!es_interval_tree_iter_first(&root, 0, ~0ULL));
+
+	for (r = 0; r < 10; r++) {
+		for (i = 0; i < IT_NODES; i++) {
+			if (rand() % 3)
+				continue;
+			if (in_tree[i]) {
+				es_interval_tree_remove(&ranges[i], &root);
+				in_tree[i] = 0;
+			} else {
+				/* mostly short ranges, a few long ones */
+				ranges[i].start = rand() % IT_SPACE;
+				ranges[i].last = ranges[i].start +
+					(rand() % 10 ? rand() % 100 :
+					 rand() % (IT_SPACE / 4));
+				es_interval_tree_insert(&ranges[i], &root);
+				in_tree[i] = 1;
+			}
+		}
+		TEST_CHECK(check_augmented(root.rb_root.rb_node) != ~0ULL);
+		TEST_CHECK(check_subtree(root.rb_root.rb_node, NULL) > 0);
+
+		for (q = 0; q < 200; q++) {
+			start = rand() % (IT_SPACE + 1000);
+			last = start + (q & 1 ? 0 : rand() % 1000);
+
+			want = 0;
+			for (i = 0; i < IT_NODES; i++)
+				if (in_tree[i] && ranges[i].start <= last &&
+						start <= ranges[i].last)
+					want++;
+
+			got = 0;
+			for (n = es_interval_tree_iter_first(&root, start, last);
+			     n; n = es_interval_tree_iter_next(n, start, last)) {
+				TEST_CHECK(n->start <= last && start <= n->last);
+				got++;
+			}
+			TEST_CHECK(got == want);
+		}
+	}
+
+	/* endpoints are inclusive */
+	for (i = 0; i < IT_NODES; i++)
+		if (in_tree[i]) {
+			es_interval_tree_remove(&ranges[i], &root);
+			in_tree[i] = 0;
+		}
+	ranges[0].start = 10;
+	ranges[0].last = 20;
+	es_interval_tree_insert(&ranges[0], &root);
+	TEST_CHECK(es_interval_tree_iter_first(&root, 20, 30) == &ranges[0]);
+	TEST_CHECK(es_interval_tree_iter_first(&root, 0, 10) == &ranges[0]);
+	TEST_CHECK(!es_interval_tree_iter_first(&root, 21, 30));
+	TEST_CHECK(!es_interval_tree_iter_first(&root, 0, 9));
+	es_interval_tree_remove(&ranges[0], &root);
+	TEST_CHECK(ES_RB_EMPTY_ROOT(&root.rb_root));
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_basic() || test_cached() || test_interval())
+		return 1;
+
+	printf("es_rbtree test OK! \n");
+	return 0;
+}
+
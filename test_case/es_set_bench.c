@@ -0,0 +1,171 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_set_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_set.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * es_set algebra on sets of device ids of several shapes, against a
+ * plain merge of two sorted arrays. Times are per operation.
+ */
+
+#define BENCH_IDS	100000
+#define BENCH_ROUNDS	200
+
+static const struct {
+	const char *name;
+	uint32_t universe;
+	unsigned int count;
+} shapes[] = {
+	{ "dense 4K of 8K",	8192,		4096 },
+	{ "sparse 4K of 1M",	1U << 20,	4000 },
+	{ "sparse 50K of 4G",	~0U,		50000 },
+};
+
+static uint32_t ids_a[BENCH_IDS], ids_b[BENCH_IDS], out[2 * BENCH_IDS];
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_id(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static unsigned int make_ids(uint32_t *ids, unsigned int n, uint32_t universe)
+{
+	unsigned int i, k = 0;
+
+	for (i = 0; i < n; i++)
+		ids[i] = (((uint32_t)rand() << 16) ^ (uint32_t)rand()) % universe;
+	qsort(ids, n, sizeof(*ids), cmp_id);
+	for (i = 0; i < n; i++) {
+		if (!k || ids[i] != ids[k - 1])
+			ids[k++] = ids[i];
+	}
+	return k;
+}
+
+/* the baseline: scalar merges over sorted arrays */
+static unsigned int merge(const uint32_t *a, unsigned int na,
+		const uint32_t *b, unsigned int nb, int op)
+{
+	unsigned int i = 0, j = 0, n = 0;
+
+	while (i < na && j < nb) {
+		if (a[i] < b[j]) {
+			if (op != '&')
+				out[n++] = a[i];
+			i++;
+		} else if (b[j] < a[i]) {
+			if (op == '|')
+				out[n++] = b[j];
+			j++;
+		} else {
+			if (op != '-')
+				out[n++] = a[i];
+			i++;
+			j++;
+		}
+	}
+	while (op != '&' && i < na)
+		out[n++] = a[i++];
+	while (op == '|' && j < nb)
+		out[n++] = b[j++];
+	return n;
+}
+
+static double bench_set(struct es_set *a, struct es_set *b, int op,
+		unsigned long *sum)
+{
+	struct es_set r;
+	double start = now();
+	unsigned int i;
+
+	es_set_init(&r);
+	for (i = 0; i < BENCH_ROUNDS; i++) {
+		if (op == '|')
+			es_set_union(&r, a, b);
+		else if (op == '&')
+			es_set_intersect(&r, a, b);
+		else
+			es_set_diff(&r, a, b);
+		*sum += es_set_count(&r);
+	}
+	es_set_destroy(&r);
+	return (now() - start) * 1e6 / BENCH_ROUNDS;
+}
+
+static double bench_merge(unsigned int na, unsigned int nb, int op,
+		unsigned long *sum)
+{
+	double start = now();
+	unsigned int i;
+
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		*sum += merge(ids_a, na, ids_b, nb, op);
+	return (now() - start) * 1e6 / BENCH_ROUNDS;
+}
+
+int main(int argc, char **argv)
+{
+	static const int ops[] = {'|', '&', '-'};
+	static const char * const type_names[] = {"array", "bitmap", "hash"};
+	struct es_set a, b;
+	unsigned long sum = 0, ref = 0;
+	unsigned int s, i, na, nb;
+
+	srand(9);
+	printf("%-18s %-7s %3s %12s %12s \n", "shape", "type", "op",
+		"es_set us", "merge us");
+	for (s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+		na = make_ids(ids_a, shapes[s].count, shapes[s].universe);
+		nb = make_ids(ids_b, shapes[s].count, shapes[s].universe);
+		es_set_init(&a);
+		es_set_init(&b);
+		for (i = 0; i < na; i++)
+			es_set_add(&a, ids_a[i]);
+		for (i = 0; i < nb; i++)
+			es_set_add(&b, ids_b[i]);
+
+		for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+			printf("%-18s %-7s  %c  %12.2f", shapes[s].name,
+				type_names[es_set_type(&a)], ops[i],
+				bench_set(&a, &b, ops[i], &sum));
+			printf(" %12.2f \n", bench_merge(na, nb, ops[i], &ref));
+		}
+		es_set_destroy(&a);
+		es_set_destroy(&b);
+	}
+
+	if (sum != ref)
+		printf("result sizes differ: %lu %lu \n", sum, ref);
+	return 0;
+}
+
@@ -0,0 +1,268 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_set_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_set.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "es_test.h"
+
+#define TEST_MAX_IDS	40000
+
+/* universe and size of the sets of each representation */
+static const struct {
+	uint32_t universe;
+	unsigned int count;
+	enum es_set_type type;
+} shapes[] = {
+	{ 4096,		2000,	ES_SET_BITMAP },
+	{ 1U << 20,	3000,	ES_SET_ARRAY },
+	{ 1U << 31,	20000,	ES_SET_HASH },
+};
+
+static uint32_t ref_a[TEST_MAX_IDS], ref_b[TEST_MAX_IDS];
+static uint32_t expect[2 * TEST_MAX_IDS], got[2 * TEST_MAX_IDS];
+
+static int cmp_id(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static uint32_t rand_id(uint32_t universe)
+{
+	return (((uint32_t)rand() << 16) ^ (uint32_t)rand()) % universe;
+}
+
+/*
+ * @n sorted unique ids below @universe, returns how many. A third of
+ * them comes from the lowest 4096, so sets of any shape overlap.
+ */
+static unsigned int make_ids(uint32_t *ids, unsigned int n, uint32_t universe)
+{
+	unsigned int i, k = 0;
+
+	for (i = 0; i < n; i++)
+		ids[i] = rand_id(i % 3 ? universe : 4096);
+	qsort(ids, n, sizeof(*ids), cmp_id);
+	for (i = 0; i < n; i++) {
+		if (!k || ids[i] != ids[k - 1])
+			ids[k++] = ids[i];
+	}
+	return k;
+}
+
+static int in_ref(const uint32_t *ids, unsigned int n, uint32_t id)
+{
+	return bsearch(&id, ids, n, sizeof(*ids), cmp_id) != NULL;
+}
+
+static int fill(struct es_set *set, const uint32_t *ids, unsigned int n)
+{
+	unsigned int i;
+
+	es_set_init(set);
+	/* add in reverse, the worst order for the array */
+	for (i = n; i-- > 0;)
+		TEST_CHECK(es_set_add(set, ids[i]) == 0);
+	TEST_CHECK(es_set_count(set) == n);
+	return 0;
+}
+
+static int check_equal(struct es_set *set, const uint32_t *ids,
+		unsigned int n)
+{
+	TEST_CHECK(es_set_count(set) == n);
+	TEST_CHECK(es_set_to_array(set, got, 2 * TEST_MAX_IDS) == n);
+	TEST_CHECK(memcmp(got, ids, n * sizeof(*ids)) == 0);
+	return 0;
+}
+
+static int sum_fn(uint32_t id, void *arg)
+{
+	*(unsigned long long *)arg += id;
+	return 0;
+}
+
+/* every pair of representations, every operation, against sorted arrays */
+static int test_ops(void)
+{
+	struct es_set a, b, r;
+	unsigned int sa, sb, na, nb, i, j, n;
+	unsigned long long sum, ref_sum;
+
+	srand(11);
+	for (sa = 0; sa < 3; sa++) {
+		for (sb = 0; sb < 3; sb++) {
+			na = make_ids(ref_a, shapes[sa].count, shapes[sa].universe);
+			nb = make_ids(ref_b, shapes[sb].count, shapes[sb].universe);
+			if (fill(&a, ref_a, na) || fill(&b, ref_b, nb))
+				return -1;
+			TEST_CHECK(es_set_type(&a) == shapes[sa].type);
+			TEST_CHECK(es_set_type(&b) == shapes[sb].type);
+			es_set_init(&r);
+
+			/* union */
+			for (i = j = n = 0; i < na || j < nb;) {
+				if (j == nb || (i < na && ref_a[i] < ref_b[j]))
+					expect[n++] = ref_a[i++];
+				else if (i == na || ref_b[j] < ref_a[i])
+					expect[n++] = ref_b[j++];
+				else
+					expect[n++] = ref_a[i++], j++;
+			}
+			TEST_CHECK(es_set_union(&r, &a, &b) == 0);
+			if (check_equal(&r, expect, n))
+				return -1;
+
+			/* intersection */
+			for (i = n = 0; i < na; i++) {
+				if (in_ref(ref_b, nb, ref_a[i]))
+					expect[n++] = ref_a[i];
+			}
+			TEST_CHECK(es_set_intersect(&r, &a, &b) == 0);
+			if (check_equal(&r, expect, n))
+				return -1;
+			TEST_CHECK(es_set_intersect(&r, &b, &a) == 0);
+			if (check_equal(&r, expect, n))
+				return -1;
+
+			/* difference, in place */
+			for (i = n = 0; i < na; i++) {
+				if (!in_ref(ref_b, nb, ref_a[i]))
+					expect[n++] = ref_a[i];
+			}
+			TEST_CHECK(es_set_copy(&r, &a) == 0);
+			TEST_CHECK(es_set_diff(&r, &r, &b) == 0);
+			if (check_equal(&r, expect, n))
+				return -1;
+			for (i = 0; i < nb; i++)
+				TEST_CHECK(!es_set_contains(&r, ref_b[i]));
+
+			sum = ref_sum = 0;
+			for (i = 0; i < n; i++)
+				ref_sum += expect[i];
+			TEST_CHECK(es_set_for_each(&r, sum_fn, &sum) == 0);
+			TEST_CHECK(sum == ref_sum);
+
+			es_set_destroy(&a);
+			es_set_destroy(&b);
+			es_set_destroy(&r);
+		}
+	}
+	return 0;
+}
+
+/* the representation follows the content */
+static int test_adapt(void)
+{
+	struct es_set set;
+	uint32_t id;
+
+	es_set_init(&set);
+	TEST_CHECK(es_set_type(&set) == ES_SET_ARRAY && es_set_is_empty(&set));
+
+	/* 0..1023 becomes a bitmap of 16 words */
+	for (id = 0; id < 1024; id++)
+		TEST_CHECK(es_set_add(&set, id) == 0);
+	TEST_CHECK(es_set_type(&set) == ES_SET_BITMAP);
+	TEST_CHECK(es_set_add(&set, 5) == 0 && es_set_count(&set) == 1024);
+
+	/* one far away id makes it sparse */
+	TEST_CHECK(es_set_add(&set, 1U << 30) == 0);
+	TEST_CHECK(es_set_type(&set) == ES_SET_ARRAY);
+	TEST_CHECK(es_set_contains(&set, 1U << 30) && es_set_contains(&set, 7));
+	TEST_CHECK(es_set_del(&set, 1U << 30) == 0);
+	TEST_CHECK(es_set_type(&set) == ES_SET_BITMAP);
+
+	/* grows in place, and emptying it goes back to an array */
+	for (id = 1024; id < 8192; id++)
+		TEST_CHECK(es_set_add(&set, id) == 0);
+	TEST_CHECK(es_set_type(&set) == ES_SET_BITMAP);
+	for (id = 0; id < 8150; id++)
+		TEST_CHECK(es_set_del(&set, id) == 0);
+	TEST_CHECK(es_set_del(&set, 0) == ES_FAIL);
+	TEST_CHECK(es_set_type(&set) == ES_SET_ARRAY);
+	TEST_CHECK(es_set_count(&set) == 42 && es_set_contains(&set, 8191));
+
+	/* many sparse ids need a hash */
+	for (id = 0; id <= ES_SET_ARRAY_MAX; id++)
+		TEST_CHECK(es_set_add(&set, id * 7919 + 100000) == 0);
+	TEST_CHECK(es_set_type(&set) == ES_SET_HASH);
+	TEST_CHECK(es_set_count(&set) == ES_SET_ARRAY_MAX + 43);
+	TEST_CHECK(es_set_contains(&set, 100000 + 7919) &&
+		!es_set_contains(&set, 100001));
+
+	/* and shrink back below half the array limit */
+	for (id = 0; id <= ES_SET_ARRAY_MAX / 2 + 100; id++)
+		TEST_CHECK(es_set_del(&set, id * 7919 + 100000) == 0);
+	TEST_CHECK(es_set_type(&set) == ES_SET_ARRAY);
+
+	es_set_clear(&set);
+	TEST_CHECK(es_set_is_empty(&set) && !es_set_contains(&set, 8191));
+	es_set_destroy(&set);
+	return 0;
+}
+
+/* random adds and deletes against a flag array */
+static int test_random(void)
+{
+	static unsigned char ref[1 << 16];
+	struct es_set set;
+	unsigned int i, count = 0, universe;
+	uint32_t id;
+
+	es_set_init(&set);
+	srand(5);
+	for (i = 0; i < 300000; i++) {
+		/* drift between a small and a wide universe */
+		universe = (i / 50000) & 1 ? 1 << 16 : 1 << 10;
+		id = rand_id(universe);
+		if (rand() % 100 < ((i / 25000) & 1 ? 30 : 70)) {
+			TEST_CHECK(es_set_add(&set, id) == 0);
+			count += !ref[id];
+			ref[id] = 1;
+		} else {
+			TEST_CHECK((es_set_del(&set, id) == 0) == ref[id]);
+			count -= ref[id];
+			ref[id] = 0;
+		}
+		TEST_CHECK(es_set_count(&set) == count);
+		if (i % 101 == 0) {
+			id = rand_id(1 << 16);
+			TEST_CHECK(es_set_contains(&set, id) == ref[id]);
+		}
+	}
+	for (id = 0; id < (1 << 16); id++)
+		TEST_CHECK(es_set_contains(&set, id) == ref[id]);
+	es_set_destroy(&set);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_ops() || test_adapt() || test_random())
+		return 1;
+
+	printf("es_set test OK! \n");
+	return 0;
+}
+
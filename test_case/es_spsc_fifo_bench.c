@@ -0,0 +1,121 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_spsc_fifo_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo.h>
+#include <es_spsc_fifo.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_BYTES	(256UL * 1024 * 1024)
+#define BENCH_FIFO_SIZE	(64 * 1024)
+
+static struct es_spsc_fifo spsc_fifo;
+static struct es_fifo fifo;
+static int use_spsc;
+static unsigned int chunk;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *producer(void *arg)
+{
+	unsigned char buf[4096] = {0};
+	unsigned long done = 0;
+	unsigned int ret;
+
+	while (done < BENCH_BYTES) {
+		if (use_spsc)
+			ret = es_spsc_fifo_in(&spsc_fifo, buf, chunk);
+		else
+			ret = es_fifo_in(&fifo, buf, chunk);
+		if (!ret)
+			sched_yield();
+		done += ret;
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	unsigned char buf[4096];
+	unsigned long done = 0;
+	unsigned int ret;
+
+	while (done < BENCH_BYTES) {
+		if (use_spsc)
+			ret = es_spsc_fifo_out(&spsc_fifo, buf, chunk);
+		else
+			ret = es_fifo_out(&fifo, buf, chunk);
+		if (!ret)
+			sched_yield();
+		done += ret;
+	}
+	return NULL;
+}
+
+static double run(void)
+{
+	pthread_t prod, cons;
+	double start;
+
+	es_spsc_fifo_reset(&spsc_fifo);
+	es_fifo_reset(&fifo);
+
+	start = now();
+	pthread_create(&cons, NULL, consumer, NULL);
+	pthread_create(&prod, NULL, producer, NULL);
+	pthread_join(prod, NULL);
+	pthread_join(cons, NULL);
+	return BENCH_BYTES / (now() - start) / (1024 * 1024);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int chunks[] = {8, 64, 512, 4096};
+	unsigned int i;
+	double fifo_mbs, spsc_mbs;
+
+	if (es_spsc_fifo_alloc(&spsc_fifo, BENCH_FIFO_SIZE) ||
+		es_fifo_alloc(&fifo, BENCH_FIFO_SIZE))
+		return 1;
+
+	printf("%8s %14s %14s \n", "chunk", "es_fifo MB/s", "spsc MB/s");
+	for (i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+		chunk = chunks[i];
+		use_spsc = 0;
+		fifo_mbs = run();
+		use_spsc = 1;
+		spsc_mbs = run();
+		printf("%8u %14.1f %14.1f \n", chunk, fifo_mbs, spsc_mbs);
+	}
+
+	es_spsc_fifo_free(&spsc_fifo);
+	es_fifo_free(&fifo);
+	return 0;
+}
+
@@ -0,0 +1,148 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_spsc_fifo_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_fifo.h>
+#include <es_spsc_fifo.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_BYTES	(16 * 1024 * 1024)
+#define TEST_FIFO_SIZE	4096
+
+static struct es_spsc_fifo spsc_fifo;
+static struct es_fifo fifo;
+static int use_spsc;
+
+/* byte expected at stream position @pos */
+static inline unsigned char pattern(unsigned int pos)
+{
+	return (unsigned char)((pos * 2654435761u) >> 24);
+}
+
+static void *producer(void *arg)
+{
+	unsigned char buf[1024];
+	unsigned int pos = 0;
+	unsigned int chunk = 1;
+	unsigned int i, ret;
+
+	while (pos < TEST_BYTES) {
+		/* odd chunk sizes so the copies straddle the wrap point */
+		chunk = (chunk * 7 + 13) % sizeof(buf) + 1;
+		if (chunk > TEST_BYTES - pos)
+			chunk = TEST_BYTES - pos;
+		for (i = 0; i < chunk; i++)
+			buf[i] = pattern(pos + i);
+
+		i = 0;
+		while (i < chunk) {
+			if (use_spsc)
+				ret = es_spsc_fifo_in(&spsc_fifo, buf + i, chunk - i);
+			else
+				ret = es_fifo_in(&fifo, buf + i, chunk - i);
+			if (!ret)
+				sched_yield();
+			i += ret;
+		}
+		pos += chunk;
+	}
+	return NULL;
+}
+
+static void *consumer(void *arg)
+{
+	unsigned char buf[777];
+	unsigned int pos = 0;
+	unsigned int i, ret;
+	long errors = 0;
+
+	while (pos < TEST_BYTES) {
+		if (use_spsc)
+			ret = es_spsc_fifo_out(&spsc_fifo, buf, sizeof(buf));
+		else
+			ret = es_fifo_out(&fifo, buf, sizeof(buf));
+		if (!ret) {
+			sched_yield();
+			continue;
+		}
+		for (i = 0; i < ret; i++)
+			if (buf[i] != pattern(pos + i))
+				errors++;
+		pos += ret;
+	}
+	return (void *)errors;
+}
+
+static int run_stress(const char *name)
+{
+	pthread_t prod, cons;
+	void *errors;
+
+	pthread_create(&cons, NULL, consumer, NULL);
+	pthread_create(&prod, NULL, producer, NULL);
+	pthread_join(prod, NULL);
+	pthread_join(cons, &errors);
+
+	printf("%s stress: %d bytes, %ld corrupted \n", name, TEST_BYTES,
+		(long)errors);
+	return errors ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	int ret = 0;
+	unsigned char tmp[8];
+	static struct es_spsc_fifo small;
+
+	ret = es_spsc_fifo_alloc(&small, 5);
+	printf("alloc ret is %d, size is %u \n", ret, es_spsc_fifo_size(&small));
+	if (ret || es_spsc_fifo_size(&small) != 8)
+		return 1;
+	if (es_spsc_fifo_in(&small, "abcdefghij", 10) != 8 ||
+		!es_spsc_fifo_is_full(&small))
+		return 1;
+	if (es_spsc_fifo_out_peek(&small, tmp, 3) != 3 ||
+		es_spsc_fifo_len(&small) != 8)
+		return 1;
+	if (es_spsc_fifo_out(&small, tmp, sizeof(tmp)) != 8 ||
+		tmp[0] != 'a' || tmp[7] != 'h' || !es_spsc_fifo_is_empty(&small))
+		return 1;
+	es_spsc_fifo_free(&small);
+
+	if (es_spsc_fifo_alloc(&spsc_fifo, TEST_FIFO_SIZE) ||
+		es_fifo_alloc(&fifo, TEST_FIFO_SIZE))
+		return 1;
+
+	use_spsc = 1;
+	ret |= run_stress("es_spsc_fifo");
+	use_spsc = 0;
+	ret |= run_stress("es_fifo");
+
+	es_spsc_fifo_free(&spsc_fifo);
+	es_fifo_free(&fifo);
+	if (ret)
+		return 1;
+
+	printf("es_spsc_fifo test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,36 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_test.h
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-17
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#ifndef _ES_TEST_H_
+#define _ES_TEST_H_
+#include <stdio.h>
+
+/*
+ * Shared by the unit tests: TEST_CHECK() reports the failed condition
+ * with its function and line, and makes the test function return -1.
+ */
+#define TEST_CHECK(cond) do { \
+	if (!(cond)) { \
+		printf("%s:%d: check '%s' failed \n", __func__, __LINE__, #cond); \
+		return -1; \
+	} \
+} while (0)
+
+#endif /* ifndef _ES_TEST_H_.2026-10-17 09:12:30 zcz */
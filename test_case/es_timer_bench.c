@@ -0,0 +1,224 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_timer_bench.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_timer.h>
+#include <es_rbtree.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Timer churn with BENCH_TIMERS outstanding timeouts, the way a server
+ * with that many connections uses them: every tick a share of the
+ * timers is pushed back (traffic on the connection), a few are cancelled
+ * and re-added, and the wheel advances by one tick, expiring the few
+ * that ran out. Timeouts are spread up to BENCH_SPAN ticks.
+ *
+ * Against the same churn on an es_rb_root_cached ordered by expiry,
+ * which is O(log n) per operation and pops the leftmost on expiry.
+ */
+
+#define BENCH_TIMERS	(1U << 20)
+#define BENCH_SPAN	(1U << 16)
+#define BENCH_TICKS	500
+#define BENCH_MODS	(BENCH_TIMERS / 64)	/* per tick */
+#define BENCH_READDS	(BENCH_TIMERS / 1024)
+
+struct conn {
+	struct es_timer timer;
+	struct es_rb_node rb;
+	uint64_t expires;
+};
+
+static struct conn *conns;
+static unsigned int *picks;
+static unsigned long fired;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned int rand32(void)
+{
+	return ((unsigned int)rand() << 16) ^ rand();
+}
+
+static void expire(struct es_timer *timer)
+{
+	fired++;
+}
+
+static void rb_add(struct es_rb_root_cached *root, struct conn *c)
+{
+	struct es_rb_node **link = &root->rb_root.rb_node, *parent = NULL;
+	bool leftmost = es_true;
+
+	while (*link) {
+		parent = *link;
+		if (c->expires < es_rb_entry(parent, struct conn, rb)->expires) {
+			link = &parent->rb_left;
+		} else {
+			link = &parent->rb_right;
+			leftmost = es_false;
+		}
+	}
+	es_rb_link_node(&c->rb, parent, link);
+	es_rb_insert_color_cached(&c->rb, root, leftmost);
+}
+
+static void bench_wheel(void)
+{
+	static struct es_timer_wheel wheel;
+	double t_add, t_churn, t_mod = 0, t_readd = 0, t_tick = 0, t;
+	unsigned int i, tick, p = 0;
+	uint64_t cur = 0;
+
+	es_timer_wheel_init(&wheel, cur);
+	fired = 0;
+	t_add = now();
+	for (i = 0; i < BENCH_TIMERS; i++) {
+		es_timer_setup(&conns[i].timer, expire);
+		es_timer_add(&wheel, &conns[i].timer, 1 + rand32() % BENCH_SPAN);
+	}
+	t_add = now() - t_add;
+
+	t_churn = now();
+	for (tick = 0; tick < BENCH_TICKS; tick++) {
+		t = now();
+		for (i = 0; i < BENCH_MODS; i++, p++)
+			es_timer_mod(&wheel, &conns[picks[p % BENCH_TIMERS]].timer,
+				cur + BENCH_SPAN - (p & 255));
+		t_mod += now() - t;
+
+		t = now();
+		for (i = 0; i < BENCH_READDS; i++, p++) {
+			struct es_timer *timer = &conns[picks[p % BENCH_TIMERS]].timer;
+
+			es_timer_del(timer);
+			es_timer_add(&wheel, timer, cur + 1 + (p % BENCH_SPAN));
+		}
+		t_readd += now() - t;
+
+		t = now();
+		es_timer_wheel_run(&wheel, ++cur);
+		t_tick += now() - t;
+	}
+	t_churn = now() - t_churn;
+
+	printf("%-10s %8.1f %8.1f %8.1f %10.1f %10.2f %8lu \n", "es_timer",
+		t_add * 1e9 / BENCH_TIMERS,
+		t_mod * 1e9 / (BENCH_MODS * BENCH_TICKS),
+		t_readd * 1e9 / (BENCH_READDS * BENCH_TICKS),
+		t_tick * 1e6 / BENCH_TICKS, t_churn * 1e3, fired);
+
+	for (i = 0; i < BENCH_TIMERS; i++)
+		es_timer_del(&conns[i].timer);
+}
+
+static void bench_rbtree(void)
+{
+	struct es_rb_root_cached root = ES_RB_ROOT_CACHED;
+	double t_add, t_churn, t_mod = 0, t_readd = 0, t_tick = 0, t;
+	unsigned int i, tick, p = 0;
+	struct es_rb_node *first;
+	struct conn *c;
+	uint64_t cur = 0;
+
+	fired = 0;
+	t_add = now();
+	for (i = 0; i < BENCH_TIMERS; i++) {
+		conns[i].expires = 1 + rand32() % BENCH_SPAN;
+		rb_add(&root, &conns[i]);
+	}
+	t_add = now() - t_add;
+
+	t_churn = now();
+	for (tick = 0; tick < BENCH_TICKS; tick++) {
+		t = now();
+		for (i = 0; i < BENCH_MODS; i++, p++) {
+			c = &conns[picks[p % BENCH_TIMERS]];
+			if (!ES_RB_EMPTY_NODE(&c->rb))
+				es_rb_erase_cached(&c->rb, &root);
+			c->expires = cur + BENCH_SPAN - (p & 255);
+			rb_add(&root, c);
+		}
+		t_mod += now() - t;
+
+		t = now();
+		for (i = 0; i < BENCH_READDS; i++, p++) {
+			c = &conns[picks[p % BENCH_TIMERS]];
+			if (!ES_RB_EMPTY_NODE(&c->rb))
+				es_rb_erase_cached(&c->rb, &root);
+			c->expires = cur + 1 + (p % BENCH_SPAN);
+			rb_add(&root, c);
+		}
+		t_readd += now() - t;
+
+		t = now();
+		cur++;
+		while ((first = es_rb_first_cached(&root))) {
+			c = es_rb_entry(first, struct conn, rb);
+			if (c->expires > cur)
+				break;
+			es_rb_erase_cached(first, &root);
+			ES_RB_CLEAR_NODE(first);
+			expire(&c->timer);
+		}
+		t_tick += now() - t;
+	}
+	t_churn = now() - t_churn;
+
+	printf("%-10s %8.1f %8.1f %8.1f %10.1f %10.2f %8lu \n", "es_rbtree",
+		t_add * 1e9 / BENCH_TIMERS,
+		t_mod * 1e9 / (BENCH_MODS * BENCH_TICKS),
+		t_readd * 1e9 / (BENCH_READDS * BENCH_TICKS),
+		t_tick * 1e6 / BENCH_TICKS, t_churn * 1e3, fired);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int i;
+
+	conns = malloc(BENCH_TIMERS * sizeof(*conns));
+	picks = malloc(BENCH_TIMERS * sizeof(*picks));
+	if (!conns || !picks)
+		return 1;
+	for (i = 0; i < BENCH_TIMERS; i++)
+		picks[i] = rand32() % BENCH_TIMERS;
+
+	printf("%u timers, %u ticks, %u mods and %u re-adds a tick \n",
+		BENCH_TIMERS, BENCH_TICKS, BENCH_MODS, BENCH_READDS);
+	printf("%-10s %8s %8s %8s %10s %10s %8s \n", "", "add ns", "mod ns",
+		"re-add ns", "tick us", "total ms", "expired");
+
+	srand(23);
+	bench_wheel();
+	srand(23);
+	bench_rbtree();
+
+	free(conns);
+	free(picks);
+	return 0;
+}
+
@@ -0,0 +1,266 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_timer_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_timer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "es_test.h"
+
+#define TEST_TIMERS	3000
+
+struct item {
+	struct es_timer timer;
+	uint64_t due;		/* tick it must expire at */
+	int armed;
+	unsigned int fired;
+};
+
+static struct item items[TEST_TIMERS];
+static struct es_timer_wheel wheel;
+static int errors;
+static unsigned long expired;
+
+static uint64_t rand64(void)
+{
+	return ((uint64_t)rand() << 32) ^ ((uint64_t)rand() << 16) ^ rand();
+}
+
+/* a random delay, spread over all the levels */
+static uint64_t rand_delay(void)
+{
+	switch (rand() % 6) {
+	case 0:
+		return rand() % 4;
+	case 1:
+		return rand() % ES_TVR_SIZE;
+	case 2:
+		return rand() % (1 << 14);
+	case 3:
+		return rand() % (1 << 20);
+	case 4:
+		return rand() % (1 << 26);
+	default:
+		return rand64() % (1ULL << 33);
+	}
+}
+
+static void arm(struct item *it, uint64_t expires)
+{
+	uint64_t now = es_timer_wheel_now(&wheel);
+
+	es_timer_mod(&wheel, &it->timer, expires);
+	it->due = expires < now ? now : expires;
+	it->armed = 1;
+}
+
+static void check_batch(struct es_list_head *list, void *arg)
+{
+	uint64_t tick = es_timer_wheel_now(&wheel) - 1;
+	struct es_timer *timer;
+	struct item *it;
+
+	es_list_for_each_entry(timer, list, entry) {
+		it = container_of(timer, struct item, timer);
+		if (!it->armed || it->due != tick)
+			errors++;
+		it->armed = 0;
+		it->fired++;
+		expired++;
+	}
+}
+
+/* the wheel against the expiry tick of each timer */
+static int test_random(void)
+{
+	unsigned int i, r, want;
+	uint64_t to, next;
+
+	srand(23);
+	/* start close to a wrap of the upper levels */
+	es_timer_wheel_init(&wheel, (1ULL << 32) - 1000);
+	for (i = 0; i < TEST_TIMERS; i++)
+		es_timer_setup(&items[i].timer, NULL);
+	TEST_CHECK(es_timer_wheel_next(&wheel) == UINT64_MAX);
+
+	for (r = 0; r < 400; r++) {
+		for (i = 0; i < TEST_TIMERS; i++) {
+			if (rand() % 8)
+				continue;
+			switch (rand() % 3) {
+			case 0:
+				TEST_CHECK(es_timer_del(&items[i].timer) ==
+					items[i].armed);
+				items[i].armed = 0;
+				break;
+			default:
+				arm(&items[i], es_timer_wheel_now(&wheel) -
+					(rand() % 16 ? 0 : rand() % 100) +
+					rand_delay());
+				break;
+			}
+		}
+
+		/* next is never past the earliest due timer */
+		next = UINT64_MAX;
+		for (i = 0; i < TEST_TIMERS; i++)
+			if (items[i].armed && items[i].due < next)
+				next = items[i].due;
+		TEST_CHECK(es_timer_wheel_next(&wheel) <= next);
+
+		/* small steps, and now and then a long stretch */
+		to = es_timer_wheel_now(&wheel) +
+			(r % 50 ? rand() % 2000 : rand64() % (1ULL << 30));
+		want = 0;
+		for (i = 0; i < TEST_TIMERS; i++)
+			if (items[i].armed && items[i].due <= to)
+				want++;
+		expired = 0;
+		es_timer_wheel_advance(&wheel, to, check_batch, NULL);
+		TEST_CHECK(!errors);
+		TEST_CHECK(expired == want);
+		TEST_CHECK(es_timer_wheel_now(&wheel) == to + 1);
+		for (i = 0; i < TEST_TIMERS; i++)
+			TEST_CHECK(es_timer_pending(&items[i].timer) ==
+				items[i].armed);
+	}
+
+	for (i = 0; i < TEST_TIMERS; i++)
+		es_timer_del(&items[i].timer);
+	return 0;
+}
+
+static unsigned int batches, batch_size;
+
+static void count_batch(struct es_list_head *list, void *arg)
+{
+	struct es_timer *timer;
+
+	batches++;
+	batch_size = 0;
+	es_list_for_each_entry(timer, list, entry)
+		batch_size++;
+}
+
+static void take_one(struct es_list_head *list, void *arg)
+{
+	/* keep the first one armed, 10 ticks later */
+	es_timer_mod(&wheel, es_list_first_entry(list, struct es_timer, entry),
+		es_timer_wheel_now(&wheel) + 9);
+}
+
+static int test_batch(void)
+{
+	unsigned int i;
+
+	es_timer_wheel_init(&wheel, 0);
+	for (i = 0; i < 100; i++) {
+		es_timer_setup(&items[i].timer, NULL);
+		TEST_CHECK(es_timer_add(&wheel, &items[i].timer, 1000) ==
+			ES_SUCCESS);
+	}
+	TEST_CHECK(es_timer_add(&wheel, &items[0].timer, 5) == ES_FAIL);
+	/* the bucket of tv2 which holds it cascades at 768 */
+	TEST_CHECK(es_timer_wheel_next(&wheel) == 3 * ES_TVR_SIZE);
+
+	/* one call for the whole tick */
+	batches = 0;
+	es_timer_wheel_advance(&wheel, 999, count_batch, NULL);
+	TEST_CHECK(!batches);
+	TEST_CHECK(es_timer_wheel_next(&wheel) == 1000);
+	es_timer_wheel_advance(&wheel, 1000, count_batch, NULL);
+	TEST_CHECK(batches == 1 && batch_size == 100);
+	for (i = 0; i < 100; i++)
+		TEST_CHECK(!es_timer_pending(&items[i].timer));
+
+	/* timers left on the list are detached, the one taken stays */
+	for (i = 0; i < 100; i++)
+		es_timer_add(&wheel, &items[i].timer, 2000);
+	es_timer_wheel_advance(&wheel, 2000, take_one, NULL);
+	TEST_CHECK(es_timer_pending(&items[0].timer));
+	TEST_CHECK(items[0].timer.expires == 2010);
+	for (i = 1; i < 100; i++)
+		TEST_CHECK(!es_timer_pending(&items[i].timer));
+	batches = 0;
+	es_timer_wheel_advance(&wheel, 2010, count_batch, NULL);
+	TEST_CHECK(batches == 1 && batch_size == 1);
+	TEST_CHECK(es_timer_wheel_next(&wheel) == UINT64_MAX);
+	return 0;
+}
+
+static unsigned int periodic_runs;
+
+static void periodic(struct es_timer *timer)
+{
+	if (es_timer_pending(timer))
+		errors++;
+	periodic_runs++;
+	es_timer_add(&wheel, timer, timer->expires + 100);
+}
+
+static void one_shot(struct es_timer *timer)
+{
+	/* cancels its sibling due at the same tick */
+	es_timer_del(&items[2].timer);
+}
+
+static int test_run(void)
+{
+	unsigned long n;
+
+	es_timer_wheel_init(&wheel, 0);
+	es_timer_setup(&items[0].timer, periodic);
+	es_timer_setup(&items[1].timer, one_shot);
+	es_timer_setup(&items[2].timer, one_shot);
+	es_timer_add(&wheel, &items[0].timer, 100);
+	es_timer_add(&wheel, &items[1].timer, 500);
+	es_timer_add(&wheel, &items[2].timer, 500);
+
+	n = es_timer_wheel_run(&wheel, 1000);
+	TEST_CHECK(!errors);
+	TEST_CHECK(periodic_runs == 10);
+	TEST_CHECK(n == 11);
+	TEST_CHECK(es_timer_pending(&items[0].timer));
+	TEST_CHECK(!es_timer_pending(&items[2].timer));
+
+	/* modify a pending timer back and forth across the levels */
+	TEST_CHECK(es_timer_mod(&wheel, &items[0].timer, 1ULL << 40) == 1);
+	TEST_CHECK(es_timer_mod(&wheel, &items[0].timer, 1001) == 1);
+	TEST_CHECK(es_timer_mod(&wheel, &items[1].timer, 1ULL << 20) == 0);
+	TEST_CHECK(es_timer_del(&items[1].timer) == 1);
+	n = es_timer_wheel_run(&wheel, 1001);
+	TEST_CHECK(n == 1 && periodic_runs == 11);
+	es_timer_del(&items[0].timer);
+
+	/* beyond 2^32 ticks, the timer is cascaded again on the way */
+	es_timer_add(&wheel, &items[1].timer, (1ULL << 34) + 7);
+	TEST_CHECK(es_timer_wheel_run(&wheel, (1ULL << 34) + 6) == 0);
+	TEST_CHECK(es_timer_wheel_run(&wheel, (1ULL << 34) + 7) == 1);
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	if (test_random() || test_batch() || test_run())
+		return 1;
+
+	printf("es_timer test OK! \n");
+	return 0;
+}
+
@@ -0,0 +1,138 @@
+/*******************************************************************************
+* Copyright (C), 2000-2016,  Electronic Technology Co., Ltd.
+*
+* @filename: es_wait_fifo_test.c
+*
+* @author: Clarence.Chow <zhou_chenz@163.com>
+*
+* @version:
+*
+* @date: 2026-10-16
+*
+* @brief:
+*
+*
+* @details:
+*
+*
+*
+* @comment
+*******************************************************************************/
+#include <es_wait_fifo.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TEST_BYTES	(4 * 1024 * 1024)
+
+static struct es_wait_fifo wf;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *producer(void *arg)
+{
+	unsigned char buf[300];
+	unsigned int pos = 0, i, n;
+
+	while (pos < TEST_BYTES) {
+		n = min((unsigned int)sizeof(buf), TEST_BYTES - pos);
+		for (i = 0; i < n; i++)
+			buf[i] = (unsigned char)(pos + i);
+		if (es_fifo_in_wait(&wf, buf, n, -1) != n)
+			return (void *)1;
+		pos += n;
+	}
+	return NULL;
+}
+
+static void *late_producer(void *arg)
+{
+	usleep(50000);
+	es_fifo_in_wait(&wf, "x", 1, 0);
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned char buf[1000];
+	unsigned int pos = 0, i, n;
+	long errors = 0;
+	pthread_t tid;
+	struct pollfd pfd;
+	void *ret;
+	double start;
+
+	if (es_fifo_alloc(&wf.fifo, 256) ||
+		es_wait_fifo_init(&wf, ES_WAIT_FIFO_F_EVENTFD))
+		return 1;
+
+	/* timeouts */
+	start = now();
+	if (es_fifo_out_wait(&wf, buf, sizeof(buf), 0) != 0 ||
+		es_fifo_out_wait(&wf, buf, sizeof(buf), 30) != 0 ||
+		now() - start < 0.029)
+		return 1;
+	if (es_fifo_in_wait(&wf, buf, 256, 0) != 256 ||
+		es_fifo_in_wait(&wf, buf, 1, 20) != 0 ||
+		es_wait_fifo_wait_space(&wf, 1, 0) != ES_TIMEOUT ||
+		es_wait_fifo_wait_data(&wf, 256, 0) != ES_SUCCESS)
+		return 1;
+	es_fifo_reset(&wf.fifo);
+	printf("timeouts OK \n");
+
+	/* blocking consumer against a delayed producer */
+	pthread_create(&tid, NULL, late_producer, NULL);
+	start = now();
+	n = es_fifo_out_wait(&wf, buf, sizeof(buf), -1);
+	pthread_join(tid, NULL);
+	printf("woken after %.3f s \n", now() - start);
+	if (n != 1 || buf[0] != 'x')
+		return 1;
+
+	/* eventfd readiness */
+	if (es_wait_fifo_arm_fd(&wf) != 0)
+		return 1;
+	pfd.fd = es_wait_fifo_fd(&wf);
+	pfd.events = POLLIN;
+	if (poll(&pfd, 1, 0) != 0)
+		return 1;
+	pthread_create(&tid, NULL, late_producer, NULL);
+	if (poll(&pfd, 1, 5000) != 1 || !(pfd.revents & POLLIN))
+		return 1;
+	pthread_join(tid, NULL);
+	if (es_wait_fifo_arm_fd(&wf) != 1 ||
+		es_fifo_out_wait(&wf, buf, sizeof(buf), 0) != 1 ||
+		es_wait_fifo_arm_fd(&wf) != 0 || poll(&pfd, 1, 0) != 0)
+		return 1;
+	printf("eventfd OK \n");
+
+	/* both sides blocking on a small fifo */
+	pthread_create(&tid, NULL, producer, NULL);
+	while (pos < TEST_BYTES) {
+		n = es_fifo_out_wait(&wf, buf, sizeof(buf), 5000);
+		if (!n)
+			break;
+		for (i = 0; i < n; i++)
+			if (buf[i] != (unsigned char)(pos + i))
+				errors++;
+		pos += n;
+	}
+	pthread_join(tid, &ret);
+	printf("stream: %u bytes, %ld corrupted \n", pos, errors);
+	if (ret || errors || pos != TEST_BYTES)
+		return 1;
+
+	es_wait_fifo_exit(&wf);
+	es_fifo_free(&wf.fifo);
+	printf("es_wait_fifo test OK! \n");
+	return 0;
+}
+